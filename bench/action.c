@@ -0,0 +1,216 @@
+/**
+ * @file   action.c
+ * @brief  Input action map evaluation benchmark.
+ * @details
+ * Evaluates a map with many actions and bindings against changing
+ * input snapshots and compares it with walking bindings one by one.
+ *
+ * Arguments:
+ *   -actions <n>  Number of actions. (default = 256)
+ *   -bindings <n> Bindings per action. (default = 4)
+ *   Arguments shared by every benchmark, see bench.h.
+ *
+ * Build and run:
+ *   ./cbuild bench
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 22, 2024
+*/
+// IWYU pragma: begin_keep
+#define _POSIX_C_SOURCE 200809L
+#include <math.h>
+#include "bench/bench.h"
+#include "media/input.h"
+#include "media/input/action.h"
+// IWYU pragma: end_keep
+
+#define SNAPSHOT_COUNT        (64)
+#define EVALUATES_PER_SAMPLE  (64)
+#define COMPILE_SAMPLE_CAP    (32)
+
+static volatile float sink = 0.0f;
+
+static uint32_t rng_state = 0x12345678;
+static uint32_t rng_next(void) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return rng_state >> 8;
+}
+
+/// Reference evaluation, tests every binding against snapshot.
+static float evaluate_naive(
+    uint32_t binding_count, const InputBinding* bindings,
+    const InputSnapshot* snapshot, float* values
+) {
+    for( uint32_t i = 0; i < binding_count; ++i ) {
+        const InputBinding* binding = bindings + i;
+        float sign = binding->is_negative ? -1.0f : 1.0f;
+        _Bool is_active = false;
+        switch( binding->type ) {
+            case INPUT_BINDING_TYPE_KEY:
+                is_active = keyboard_state_get_key( &snapshot->keys, binding->key );
+                break;
+            case INPUT_BINDING_TYPE_SCANCODE:
+                is_active = keyboard_state_get_key( &snapshot->scancodes, binding->key );
+                break;
+            case INPUT_BINDING_TYPE_MOUSE_BUTTON:
+                is_active = (snapshot->mouse & binding->mouse) != 0;
+                break;
+            case INPUT_BINDING_TYPE_GAMEPAD_BUTTON:
+                for( uint32_t gp = 0; gp < GAMEPAD_MAX_COUNT; ++gp ) {
+                    if(
+                        (binding->gamepad == gp ||
+                        binding->gamepad == INPUT_BINDING_ANY_GAMEPAD) &&
+                        (snapshot->gamepad_connected & (1 << gp)) &&
+                        (snapshot->gamepads[gp].buttons & binding->gamepad_button)
+                    ) {
+                        is_active = true;
+                    }
+                }
+                break;
+            case INPUT_BINDING_TYPE_GAMEPAD_AXIS:
+                break;
+        }
+        values[binding->action] += is_active ? sign : 0.0f;
+    }
+    return values[0];
+}
+
+int main( int argc, char** argv ) {
+    uint32_t actions    = 256;
+    uint32_t per_action = 4;
+    for( int i = 1; i < argc; ++i ) {
+        if( bench_parse_arg( argc, argv, &i ) ) {
+            continue;
+        }
+        if( strcmp( argv[i], "-actions" ) == 0 && i + 1 < argc ) {
+            actions = (uint32_t)strtoul( argv[++i], 0, 10 );
+        } else if( strcmp( argv[i], "-bindings" ) == 0 && i + 1 < argc ) {
+            per_action = (uint32_t)strtoul( argv[++i], 0, 10 );
+        } else {
+            fprintf( stderr, "unrecognized argument '%s'\n", argv[i] );
+            return -1;
+        }
+    }
+    if( !actions || actions > INPUT_ACTION_MAX_COUNT ) {
+        actions = 256;
+    }
+    if( !per_action ) {
+        per_action = 1;
+    }
+
+    // NOTE(alicia): every eighth binding is a gamepad axis, rest are
+    // keys, scancodes, mouse and gamepad buttons.
+    uint32_t binding_count = actions * per_action;
+    InputBinding* bindings = calloc( binding_count, sizeof(InputBinding) );
+    for( uint32_t i = 0; i < binding_count; ++i ) {
+        InputBinding* binding = bindings + i;
+        binding->action      = (uint16_t)(i % actions);
+        binding->is_negative = (rng_next() & 1) != 0;
+        switch( i % 8 ) {
+            case 0: case 3: case 4:
+                binding->type = INPUT_BINDING_TYPE_KEY;
+                binding->key  = (KeyboardCode)(1 + rng_next() % (KB_COUNT - 1));
+                break;
+            case 1:
+                binding->type = INPUT_BINDING_TYPE_SCANCODE;
+                binding->key  = (KeyboardCode)(1 + rng_next() % (KB_COUNT - 1));
+                break;
+            case 2:
+                binding->type  = INPUT_BINDING_TYPE_MOUSE_BUTTON;
+                binding->mouse = (MouseButton)(1 << (rng_next() % 5));
+                break;
+            case 5: case 6:
+                binding->type           = INPUT_BINDING_TYPE_GAMEPAD_BUTTON;
+                binding->gamepad        = INPUT_BINDING_ANY_GAMEPAD;
+                binding->gamepad_button = (GamepadButton)(1 << (rng_next() % 16));
+                break;
+            default:
+                binding->type                  = INPUT_BINDING_TYPE_GAMEPAD_AXIS;
+                binding->gamepad               = (uint8_t)(rng_next() % GAMEPAD_MAX_COUNT);
+                binding->gamepad_axis.axis     =
+                    (InputGamepadAxis)(rng_next() % INPUT_GAMEPAD_AXIS_COUNT);
+                binding->gamepad_axis.deadzone = 0.15f;
+                break;
+        }
+    }
+
+    InputSnapshot* snapshots = calloc( SNAPSHOT_COUNT, sizeof(InputSnapshot) );
+    for( uint32_t s = 0; s < SNAPSHOT_COUNT; ++s ) {
+        InputSnapshot* snapshot = snapshots + s;
+        for( uint32_t k = 0; k < 6; ++k ) {
+            keyboard_state_set_key(
+                &snapshot->keys, (KeyboardCode)(1 + rng_next() % (KB_COUNT - 1)), true );
+            keyboard_state_set_key(
+                &snapshot->scancodes, (KeyboardCode)(1 + rng_next() % (KB_COUNT - 1)), true );
+        }
+        snapshot->mouse             = (MouseButton)(rng_next() & 0x1F);
+        snapshot->gamepad_connected = 0x3;
+        for( uint32_t gp = 0; gp < 2; ++gp ) {
+            GamepadState* state = snapshot->gamepads + gp;
+            float t = (float)s * 0.1f + (float)gp;
+            state->buttons       = (GamepadButton)(rng_next() & 0xF30F);
+            state->stick_left_x  = (int16_t)(sinf( t ) * 32767.0f);
+            state->stick_left_y  = (int16_t)(cosf( t ) * 32767.0f);
+            state->stick_right_x = (int16_t)(sinf( t * 1.7f ) * 20000.0f);
+            state->stick_right_y = (int16_t)(cosf( t * 0.6f ) * 20000.0f);
+            state->trigger_left  = (uint8_t)(s * 4);
+            state->trigger_right = (uint8_t)(255 - s * 4);
+        }
+    }
+
+    uintptr_t size = input_action_map_query_memory_requirement(
+        actions, binding_count, bindings );
+    InputActionMap* map = aligned_alloc( 64, (size + 63) & ~(uintptr_t)63 );
+
+    const char* name = "action.compile";
+    uint32_t count = bench_sample_count > COMPILE_SAMPLE_CAP ?
+        COMPILE_SAMPLE_CAP : bench_sample_count;
+    for( uint32_t i = 0; i < count; ++i ) {
+        double start = bench_now_ns();
+        if( !input_action_map_compile( actions, binding_count, bindings, map ) ) {
+            fprintf( stderr, "failed to compile action map!\n" );
+            return -1;
+        }
+        bench_samples[i] = bench_now_ns() - start;
+    }
+    if( bench_enabled( name ) ) {
+        bench_record( name, "call", size, count );
+    }
+
+    uint32_t at = 0;
+    name = "action.evaluate";
+    if( bench_enabled( name ) ) {
+        for( uint32_t i = 0; i < bench_sample_count; ++i ) {
+            double start = bench_now_ns();
+            for( uint32_t j = 0; j < EVALUATES_PER_SAMPLE; ++j, ++at ) {
+                input_action_map_evaluate( map, snapshots + (at % SNAPSHOT_COUNT) );
+                sink += input_action_query_value( map, at % actions );
+            }
+            bench_samples[i] =
+                (bench_now_ns() - start) / (double)EVALUATES_PER_SAMPLE;
+        }
+        bench_record( name, "evaluation", 0, bench_sample_count );
+    }
+
+    // NOTE(alicia): digital bindings only, axes are not evaluated.
+    float* values = calloc( actions, sizeof(float) );
+    name = "action.evaluate.naive";
+    if( bench_enabled( name ) ) {
+        for( uint32_t i = 0; i < bench_sample_count; ++i ) {
+            double start = bench_now_ns();
+            for( uint32_t j = 0; j < EVALUATES_PER_SAMPLE; ++j, ++at ) {
+                memset( values, 0, sizeof(float) * actions );
+                sink += evaluate_naive(
+                    binding_count, bindings, snapshots + (at % SNAPSHOT_COUNT), values );
+            }
+            bench_samples[i] =
+                (bench_now_ns() - start) / (double)EVALUATES_PER_SAMPLE;
+        }
+        bench_record( name, "evaluation", 0, bench_sample_count );
+    }
+
+    free( values );
+    free( map );
+    free( snapshots );
+    free( bindings );
+    return bench_finish();
+}
@@ -0,0 +1,462 @@
+/**
+ * @file   bench.c
+ * @brief  Media library benchmark suite.
+ * @details
+ * Runs without user interaction and writes results as JSON to stdout
+ * (or to path given with -o). Human readable progress goes to stderr.
+ * Benchmarks that need a subsystem the platform does not provide
+ * are reported as skipped.
+ *
+ * Arguments:
+ *   -o <path>        Write JSON to path instead of stdout.
+ *   -filter <string> Only run benchmarks with string in their name.
+ *   -samples <n>     Number of samples per benchmark. (default = 200)
+ *
+ * Build and run:
+ *   ./cbuild bench
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 16, 2024
+*/
+// IWYU pragma: begin_keep
+#define _POSIX_C_SOURCE 200809L
+#include "bench/bench.h"
+#include "media/lib.h"
+#include "media/surface.h"
+#include "media/input.h"
+#include "media/opengl.h"
+#include "media/audio.h"
+#include "media/internal/unicode.h"
+#include "media/time.h"
+#include "media/trace.h"
+#include "media/internal/trace.h"
+// IWYU pragma: end_keep
+
+#define text( lit ) sizeof(lit) - 1, lit
+
+#define PUMP_EVENTS_PER_SAMPLE (256)
+#define TRACE_SCOPES_PER_SAMPLE (1024)
+#define TIME_CALLS_PER_SAMPLE   (1024)
+#define TIME_SLEEP_NS           (1000000ULL)
+
+static volatile uintptr_t sink = 0;
+
+// NOTE(alicia): called through volatile pointers so that
+// compiler can't replace them with builtins. In static builds,
+// these resolve to media library's replacements.
+static void* (*volatile bench_memcpy)( void*, const void*, size_t )  = memcpy;
+static void* (*volatile bench_memset)( void*, int, size_t )          = memset;
+static void* (*volatile bench_memmove)( void*, const void*, size_t ) = memmove;
+
+void logging_callback(
+    MediaLoggingLevel level, uint32_t len, const char* message, void* params
+) {
+    unused(level, params);
+    fprintf( stderr, "%.*s\n", len, message );
+}
+void surface_callback(
+    const SurfaceHandle* surface, const SurfaceCallbackData* data, void* params
+) {
+    unused( surface, params );
+    sink += data->type;
+}
+
+static void bench_cstdlib(void) {
+    static const uintptr_t sizes[] = { 64, 4096, 1024 * 1024 };
+    static const char* names[][3] = {
+        { "cstdlib.memcpy.64",  "cstdlib.memcpy.4k",  "cstdlib.memcpy.1m"  },
+        { "cstdlib.memset.64",  "cstdlib.memset.4k",  "cstdlib.memset.1m"  },
+        { "cstdlib.memmove.64", "cstdlib.memmove.4k", "cstdlib.memmove.1m" },
+    };
+
+    uint8_t* a = malloc( sizes[2] * 2 );
+    uint8_t* b = malloc( sizes[2] * 2 );
+    memset( a, 1, sizes[2] * 2 );
+    memset( b, 2, sizes[2] * 2 );
+
+    for( uint32_t fn = 0; fn < 3; ++fn ) {
+        for( uint32_t s = 0; s < 3; ++s ) {
+            const char* name = names[fn][s];
+            if( !bench_enabled( name ) ) {
+                continue;
+            }
+            uintptr_t size  = sizes[s];
+            uint32_t  iters = size >= sizes[2] ? 1 : 64;
+            for( uint32_t i = 0; i < bench_sample_count; ++i ) {
+                double start = bench_now_ns();
+                for( uint32_t j = 0; j < iters; ++j ) {
+                    switch( fn ) {
+                        case 0: bench_memcpy( a, b, size ); break;
+                        case 1: bench_memset( a, (int)j, size ); break;
+                        case 2: bench_memmove( a + 1, a, size ); break;
+                    }
+                }
+                bench_samples[i] = (bench_now_ns() - start) / iters;
+            }
+            bench_record( name, "call", size, bench_sample_count );
+        }
+    }
+
+    free( a );
+    free( b );
+}
+static void bench_unicode(void) {
+    const char* name = "unicode.utf8_to_utf16.4k";
+    if( !bench_enabled( name ) ) {
+        return;
+    }
+    static const char sample[] = "Caf\xC3\xA9 \xE6\x97\xA5\xE6\x9C\xAC ascii text \xF0\x9F\x98\x80 ";
+    char     utf8[4096];
+    uint16_t utf16[4096];
+    uintptr_t len = 0;
+    while( len + sizeof(sample) - 1 <= sizeof(utf8) ) {
+        memcpy( utf8 + len, sample, sizeof(sample) - 1 );
+        len += sizeof(sample) - 1;
+    }
+
+    for( uint32_t i = 0; i < bench_sample_count; ++i ) {
+        double start = bench_now_ns();
+        sink += media_utf8_to_utf16( len, utf8, 4096, utf16, 0 );
+        bench_samples[i] = bench_now_ns() - start;
+    }
+    bench_record( name, "call", len, bench_sample_count );
+}
+static void bench_time(void) {
+    const char* name = "time.ns";
+    if( bench_enabled( name ) ) {
+        for( uint32_t i = 0; i < bench_sample_count; ++i ) {
+            double start = bench_now_ns();
+            for( uint32_t j = 0; j < TIME_CALLS_PER_SAMPLE; ++j ) {
+                sink += media_time_ns();
+            }
+            bench_samples[i] =
+                (bench_now_ns() - start) / (double)TIME_CALLS_PER_SAMPLE;
+        }
+        bench_record( name, "call", 0, bench_sample_count );
+    }
+
+    name = "time.ticks";
+    if( bench_enabled( name ) ) {
+        for( uint32_t i = 0; i < bench_sample_count; ++i ) {
+            double start = bench_now_ns();
+            for( uint32_t j = 0; j < TIME_CALLS_PER_SAMPLE; ++j ) {
+                sink += media_time_ticks();
+            }
+            bench_samples[i] =
+                (bench_now_ns() - start) / (double)TIME_CALLS_PER_SAMPLE;
+        }
+        bench_record( name, "call", 0, bench_sample_count );
+    }
+
+    // NOTE(alicia): samples are how late each wake up was, not call duration.
+    name = "time.sleep_until.1ms.jitter";
+    if( bench_enabled( name ) ) {
+        uint64_t deadline = media_time_ns();
+        for( uint32_t i = 0; i < bench_sample_count; ++i ) {
+            deadline += TIME_SLEEP_NS;
+            uint64_t woke = media_time_sleep_until_ns( deadline );
+            bench_samples[i] = (double)(woke - deadline);
+        }
+        bench_record( name, "wake", 0, bench_sample_count );
+    }
+}
+static void bench_trace(void) {
+    const char* name = "trace.scope";
+    if( !bench_enabled( name ) ) {
+        return;
+    }
+    if( !media_trace_is_enabled() ) {
+        bench_skip( name, "library built without -trace" );
+        return;
+    }
+#if defined(MEDIA_ENABLE_TRACE)
+    for( uint32_t i = 0; i < bench_sample_count; ++i ) {
+        double start = bench_now_ns();
+        for( uint32_t j = 0; j < TRACE_SCOPES_PER_SAMPLE; ++j ) {
+            media_trace_scope( "bench" );
+            sink++;
+        }
+        bench_samples[i] =
+            (bench_now_ns() - start) / (double)TRACE_SCOPES_PER_SAMPLE;
+    }
+    bench_record( name, "scope", 0, bench_sample_count );
+    media_trace_clear();
+#endif
+}
+#if defined(MEDIA_PLATFORM_WINDOWS)
+static void bench_surface_create_destroy( SurfaceHandle* surface ) {
+    const char* name = "surface.create_destroy";
+    if( !bench_enabled( name ) ) {
+        return;
+    }
+    uint32_t count = bench_sample_count > 32 ? 32 : bench_sample_count;
+    for( uint32_t i = 0; i < count; ++i ) {
+        double start = bench_now_ns();
+        if( !surface_create(
+            text("Bench Create"), 0, 0, 320, 240,
+            SURFACE_CREATE_FLAG_HIDDEN, NULL, NULL, NULL, surface
+        ) ) {
+            bench_skip( name, "surface_create failed" );
+            return;
+        }
+        surface_destroy( surface );
+        bench_samples[i] = bench_now_ns() - start;
+    }
+    bench_record( name, "call", 0, count );
+}
+static void bench_pump_events( SurfaceHandle* surface ) {
+    const char* name = "surface.pump_events";
+    if( !bench_enabled( name ) ) {
+        return;
+    }
+    HWND hwnd = surface_get_platform_handle( surface );
+    for( uint32_t i = 0; i < bench_sample_count; ++i ) {
+        for( uint32_t j = 0; j < PUMP_EVENTS_PER_SAMPLE; ++j ) {
+            PostMessageW( hwnd, WM_MOUSEMOVE, 0, MAKELPARAM( j & 0xFF, i & 0xFF ) );
+        }
+        double start = bench_now_ns();
+        surface_pump_events();
+        bench_samples[i] = (bench_now_ns() - start) / PUMP_EVENTS_PER_SAMPLE;
+    }
+    bench_record( name, "event", 0, bench_sample_count );
+
+    name = "surface.pump_events.empty";
+    if( !bench_enabled( name ) ) {
+        return;
+    }
+    for( uint32_t i = 0; i < bench_sample_count; ++i ) {
+        double start = bench_now_ns();
+        surface_pump_events();
+        bench_samples[i] = bench_now_ns() - start;
+    }
+    bench_record( name, "call", 0, bench_sample_count );
+}
+static void bench_input_update( _Bool has_input ) {
+    const char* name = "input.update";
+    if( !bench_enabled( name ) ) {
+        return;
+    }
+    if( !has_input ) {
+        bench_skip( name, "input subsystem unavailable" );
+        return;
+    }
+    for( uint32_t i = 0; i < bench_sample_count; ++i ) {
+        double start = bench_now_ns();
+        input_subsystem_update();
+        bench_samples[i] = bench_now_ns() - start;
+    }
+    bench_record( name, "call", 0, bench_sample_count );
+}
+static void bench_opengl( SurfaceHandle* surface ) {
+    const char* name = "opengl.context_create_destroy";
+    if( !bench_enabled( name ) ) {
+        return;
+    }
+    if( !opengl_initialize() ) {
+        bench_skip( name, "opengl unavailable" );
+        return;
+    }
+    if( !surface_create(
+        text("Bench OpenGL"), 0, 0, 320, 240,
+        SURFACE_CREATE_FLAG_HIDDEN | SURFACE_CREATE_FLAG_OPENGL,
+        NULL, NULL, NULL, surface
+    ) ) {
+        bench_skip( name, "surface_create failed" );
+        return;
+    }
+
+    uint32_t count = bench_sample_count > 32 ? 32 : bench_sample_count;
+    for( uint32_t i = 0; i < count; ++i ) {
+        double start = bench_now_ns();
+        OpenGLRenderContext* glrc = opengl_context_create( surface, NULL );
+        if( !glrc ) {
+            surface_destroy( surface );
+            bench_skip( name, "opengl_context_create failed" );
+            return;
+        }
+        opengl_context_unbind();
+        opengl_context_destroy( glrc );
+        bench_samples[i] = bench_now_ns() - start;
+    }
+    bench_record( name, "call", 0, count );
+    surface_destroy( surface );
+}
+static void bench_audio(void) {
+    const char* name = "audio.buffer_lock_unlock";
+    if( !bench_enabled( name ) ) {
+        return;
+    }
+    uintptr_t list_size   = audio_device_list_query_memory_requirement();
+    uintptr_t device_size = audio_device_query_memory_requirement();
+    uint8_t* buffer = calloc( 1, list_size + device_size );
+    AudioDeviceList* list   = buffer;
+    AudioDevice*     device = buffer + list_size;
+
+    if( !audio_device_list_create( list ) ) {
+        bench_skip( name, "audio unavailable" );
+        free( buffer );
+        return;
+    }
+    if( !audio_device_open(
+        list, NULL, 50, AUDIO_DEVICE_TYPE_OUTPUT, AUDIO_DEVICE_DEFAULT, 0, device
+    ) ) {
+        bench_skip( name, "no output device" );
+        audio_device_list_destroy( list );
+        free( buffer );
+        return;
+    }
+    audio_device_start( device );
+
+    for( uint32_t i = 0; i < bench_sample_count; ++i ) {
+        struct AudioBuffer audio_buffer;
+        double start = bench_now_ns();
+        if( audio_device_buffer_lock( device, &audio_buffer ) ) {
+            audio_device_buffer_unlock( device, &audio_buffer );
+        }
+        bench_samples[i] = bench_now_ns() - start;
+    }
+    bench_record( name, "call", 0, bench_sample_count );
+
+    audio_device_stop( device );
+    audio_device_close( device );
+    audio_device_list_destroy( list );
+    free( buffer );
+}
+static void bench_audio_low_latency(void) {
+    const char* name = "audio.low_latency.refill_latency";
+    if( !bench_enabled( name ) ) {
+        return;
+    }
+    uintptr_t list_size   = audio_device_list_query_memory_requirement();
+    uintptr_t device_size = audio_device_query_memory_requirement();
+    uint8_t* buffer = calloc( 1, list_size + device_size );
+    AudioDeviceList* list   = buffer;
+    AudioDevice*     device = buffer + list_size;
+
+    if( !audio_device_list_create( list ) ) {
+        bench_skip( name, "audio unavailable" );
+        free( buffer );
+        return;
+    }
+    if( !audio_device_open(
+        list, NULL, 10, AUDIO_DEVICE_TYPE_OUTPUT, AUDIO_DEVICE_DEFAULT,
+        AUDIO_DEVICE_OPEN_FLAG_LOW_LATENCY, device
+    ) ) {
+        bench_skip( name, "no output device" );
+        audio_device_list_destroy( list );
+        free( buffer );
+        return;
+    }
+    audio_device_start( device );
+
+    // NOTE(alicia): each sample is estimated output latency
+    // right after device requested a refill.
+    uint32_t count = 0;
+    for( uint32_t i = 0; i < bench_sample_count; ++i ) {
+        if( !audio_device_wait( device, 100 ) ) {
+            break;
+        }
+        struct AudioBuffer audio_buffer;
+        if( audio_device_buffer_lock( device, &audio_buffer ) ) {
+            memset( audio_buffer.start, 0, audio_buffer.size );
+            audio_device_buffer_unlock( device, &audio_buffer );
+        }
+        struct AudioDeviceStats stats;
+        if( !audio_device_query_stats( device, &stats ) ) {
+            break;
+        }
+        bench_samples[count++] = (double)stats.latency_ns;
+    }
+    if( count ) {
+        bench_record( name, "refill", 0, count );
+    } else {
+        bench_skip( name, "device is not event driven" );
+    }
+
+    audio_device_stop( device );
+    audio_device_close( device );
+    audio_device_list_destroy( list );
+    free( buffer );
+}
+
+static void bench_platform(void) {
+    uintptr_t lib_size     = media_lib_query_memory_requirement();
+    uintptr_t surface_size = surface_query_memory_requirement();
+    uintptr_t input_size   = input_subsystem_query_memory_requirement();
+
+    uint8_t* buf = calloc( 1, lib_size + surface_size * 2 + input_size );
+    void*          lib_buf    = buf;
+    SurfaceHandle* surface    = buf + lib_size;
+    SurfaceHandle* surface_gl = buf + lib_size + surface_size;
+    void*          input_buf  = buf + lib_size + surface_size * 2;
+
+    if( !media_lib_initialize(
+        MEDIA_LOGGING_LEVEL_WARN, logging_callback, 0, lib_buf
+    ) ) {
+        bench_skip( "media_lib", "media_lib_initialize failed" );
+    } else {
+        bench_surface_create_destroy( surface );
+
+        _Bool has_surface = surface_create(
+            text("Bench"), 0, 0, 320, 240,
+            SURFACE_CREATE_FLAG_HIDDEN, surface_callback, NULL, NULL, surface );
+        if( has_surface ) {
+            bench_pump_events( surface );
+        } else {
+            bench_skip( "surface.pump_events", "surface_create failed" );
+        }
+
+        _Bool has_input = input_subsystem_initialize( input_buf );
+        bench_input_update( has_input );
+        if( has_input ) {
+            input_subsystem_shutdown();
+        }
+
+        bench_opengl( surface_gl );
+        bench_audio();
+        bench_audio_low_latency();
+
+        if( has_surface ) {
+            surface_destroy( surface );
+        }
+        media_lib_shutdown();
+    }
+    free( buf );
+}
+#else /* MEDIA_PLATFORM_WINDOWS */
+// NOTE(alicia): library has no platform layer here yet,
+// only headless benchmarks can run.
+static void bench_platform(void) {
+    static const char* names[] = {
+        "surface.create_destroy",
+        "surface.pump_events",
+        "surface.pump_events.empty",
+        "input.update",
+        "opengl.context_create_destroy",
+        "audio.buffer_lock_unlock",
+        "audio.low_latency.refill_latency",
+    };
+    for( uint32_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i ) {
+        if( bench_enabled( names[i] ) ) {
+            bench_skip( names[i], "no platform layer" );
+        }
+    }
+}
+#endif /* MEDIA_PLATFORM_WINDOWS */
+
+int main( int argc, char** argv ) {
+    for( int i = 1; i < argc; ++i ) {
+        if( !bench_parse_arg( argc, argv, &i ) ) {
+            fprintf( stderr, "unrecognized argument '%s'\n", argv[i] );
+            return -1;
+        }
+    }
+
+    bench_cstdlib();
+    bench_unicode();
+    bench_time();
+    bench_trace();
+
+    bench_platform();
+
+    return bench_finish();
+}
@@ -0,0 +1,189 @@
+#if !defined(MEDIA_BENCH_H)
+#define MEDIA_BENCH_H
+/**
+ * @file   bench.h
+ * @brief  Benchmark harness.
+ * @details
+ * Collects nanosecond samples per benchmark, computes percentiles
+ * and writes results as JSON.
+ * Included once by each benchmark program, programs are linked
+ * against media library and share arguments:
+ *   -o <path>        Write JSON to path instead of stdout.
+ *   -filter <string> Only run benchmarks with string in their name.
+ *   -samples <n>     Number of samples per benchmark. (default = 200)
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 16, 2024
+*/
+// IWYU pragma: begin_keep
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "media/defines.h"
+#include "media/types.h"
+#include "media/time.h"
+// IWYU pragma: end_keep
+
+#if defined(MEDIA_PLATFORM_WINDOWS)
+    #define BENCH_PLATFORM "win32"
+#elif defined(MEDIA_PLATFORM_LINUX)
+    #define BENCH_PLATFORM "linux"
+#else
+    #define BENCH_PLATFORM "unknown"
+#endif
+
+#define BENCH_RESULT_CAP  (64)
+#define BENCH_SAMPLE_CAP  (4096)
+
+typedef struct BenchResult {
+    const char* name;
+    /// @brief What one operation is, e.g. "call" or "event".
+    const char* per;
+    /// @brief Reason benchmark was skipped, NULL if it ran.
+    const char* skipped;
+    /// @brief Bytes processed per operation, 0 if not applicable.
+    uint64_t bytes;
+    uint32_t samples;
+    double min, p50, p90, p99, max, mean;
+} BenchResult;
+
+static BenchResult bench_results[BENCH_RESULT_CAP];
+static uint32_t    bench_result_count = 0;
+static double      bench_samples[BENCH_SAMPLE_CAP];
+static const char* bench_filter = NULL;
+static const char* bench_output_path  = NULL;
+static uint32_t    bench_sample_count = 200;
+
+/// @brief Read monotonic clock.
+static double bench_now_ns(void) {
+    return (double)media_time_ns();
+}
+/// @brief Parse argument shared by every benchmark program.
+/// @param         argc Number of arguments.
+/// @param[in]     argv Arguments.
+/// @param[in,out] at   Index of argument, moved to its value if it has one.
+/// @return False if argument is not a shared argument.
+static _Bool bench_parse_arg( int argc, char** argv, int* at ) {
+    if( *at + 1 >= argc ) {
+        return false;
+    }
+    const char* arg = argv[*at];
+    if( strcmp( arg, "-o" ) == 0 ) {
+        bench_output_path = argv[++(*at)];
+    } else if( strcmp( arg, "-filter" ) == 0 ) {
+        bench_filter = argv[++(*at)];
+    } else if( strcmp( arg, "-samples" ) == 0 ) {
+        bench_sample_count = (uint32_t)strtoul( argv[++(*at)], 0, 10 );
+        if( !bench_sample_count ) {
+            bench_sample_count = 1;
+        }
+        if( bench_sample_count > BENCH_SAMPLE_CAP ) {
+            bench_sample_count = BENCH_SAMPLE_CAP;
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/// @brief Check if benchmark should run with current filter.
+static _Bool bench_enabled( const char* name ) {
+    return !bench_filter || strstr( name, bench_filter );
+}
+static int bench_compare( const void* a, const void* b ) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+static double bench_percentile( uint32_t count, double p ) {
+    uint32_t index = (uint32_t)(p * (double)(count - 1) + 0.5);
+    return bench_samples[index];
+}
+/// @brief Record a skipped benchmark.
+attr_unused static void bench_skip( const char* name, const char* reason ) {
+    if( bench_result_count >= BENCH_RESULT_CAP ) {
+        return;
+    }
+    BenchResult* result = bench_results + bench_result_count++;
+    memset( result, 0, sizeof(*result) );
+    result->name    = name;
+    result->skipped = reason;
+    fprintf( stderr, "%-40s skipped: %s\n", name, reason );
+}
+/// @brief Record samples stored in bench_samples.
+/// @param name  Name of benchmark.
+/// @param per   What one operation is.
+/// @param bytes Bytes processed per operation or 0.
+/// @param count Number of samples, each is nanoseconds per operation.
+static void bench_record(
+    const char* name, const char* per, uint64_t bytes, uint32_t count
+) {
+    if( !count || bench_result_count >= BENCH_RESULT_CAP ) {
+        return;
+    }
+    qsort( bench_samples, count, sizeof(bench_samples[0]), bench_compare );
+
+    double sum = 0.0;
+    for( uint32_t i = 0; i < count; ++i ) {
+        sum += bench_samples[i];
+    }
+
+    BenchResult* result = bench_results + bench_result_count++;
+    memset( result, 0, sizeof(*result) );
+    result->name    = name;
+    result->per     = per;
+    result->bytes   = bytes;
+    result->samples = count;
+    result->min     = bench_samples[0];
+    result->p50     = bench_percentile( count, 0.50 );
+    result->p90     = bench_percentile( count, 0.90 );
+    result->p99     = bench_percentile( count, 0.99 );
+    result->max     = bench_samples[count - 1];
+    result->mean    = sum / (double)count;
+
+    fprintf( stderr, "%-40s p50 %12.1fns  p99 %12.1fns  (per %s)\n",
+        name, result->p50, result->p99, per );
+}
+/// @brief Write results as JSON.
+static void bench_write_json( FILE* file, const char* platform ) {
+    fprintf( file, "{\n" );
+    fprintf( file, "  \"platform\": \"%s\",\n", platform );
+    fprintf( file, "  \"unit\": \"ns\",\n" );
+    fprintf( file, "  \"results\": [\n" );
+    for( uint32_t i = 0; i < bench_result_count; ++i ) {
+        BenchResult* r = bench_results + i;
+        const char* comma = i + 1 < bench_result_count ? "," : "";
+        if( r->skipped ) {
+            fprintf( file,
+                "    { \"name\": \"%s\", \"skipped\": \"%s\" }%s\n",
+                r->name, r->skipped, comma );
+            continue;
+        }
+        fprintf( file,
+            "    { \"name\": \"%s\", \"per\": \"%s\", \"bytes\": %llu, "
+            "\"samples\": %u, \"min\": %.1f, \"p50\": %.1f, \"p90\": %.1f, "
+            "\"p99\": %.1f, \"max\": %.1f, \"mean\": %.1f }%s\n",
+            r->name, r->per, (unsigned long long)r->bytes, r->samples,
+            r->min, r->p50, r->p90, r->p99, r->max, r->mean, comma );
+    }
+    fprintf( file, "  ]\n" );
+    fprintf( file, "}\n" );
+}
+/// @brief Write results as JSON to bench_output_path or stdout.
+/// @return Exit code of benchmark program.
+static int bench_finish(void) {
+    FILE* file = stdout;
+    if( bench_output_path ) {
+        file = fopen( bench_output_path, "w" );
+        if( !file ) {
+            fprintf( stderr, "failed to open '%s'!\n", bench_output_path );
+            return -1;
+        }
+    }
+    bench_write_json( file, BENCH_PLATFORM );
+    if( bench_output_path ) {
+        fclose( file );
+    }
+    return 0;
+}
+
+#endif /* header guard */
@@ -0,0 +1,104 @@
+/**
+ * @file   gamepad_processor.c
+ * @brief  Gamepad processor benchmark.
+ * @details
+ * Updates four connected gamepads playing synthetic stick traces
+ * with every stage enabled (radial deadzone, response curves and
+ * one-euro smoothing) and reports cost of a single update.
+ *
+ * Arguments:
+ *   Arguments shared by every benchmark, see bench.h.
+ *
+ * Build and run:
+ *   ./cbuild bench
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 22, 2024
+*/
+// IWYU pragma: begin_keep
+#define _POSIX_C_SOURCE 200809L
+#include <math.h>
+#include "bench/bench.h"
+#include "media/input.h"
+#include "media/input/gamepad_processor.h"
+// IWYU pragma: end_keep
+
+#define FRAME_COUNT        (1024)
+#define UPDATES_PER_SAMPLE (256)
+
+static volatile float sink = 0.0f;
+
+int main( int argc, char** argv ) {
+    for( int i = 1; i < argc; ++i ) {
+        if( !bench_parse_arg( argc, argv, &i ) ) {
+            fprintf( stderr, "unrecognized argument '%s'\n", argv[i] );
+            return -1;
+        }
+    }
+    const char* name = "gamepad_processor.update";
+    if( !bench_enabled( name ) ) {
+        return bench_finish();
+    }
+
+    float curve[17];
+    for( uint32_t i = 0; i < 17; ++i ) {
+        float t  = (float)i / 16.0f;
+        curve[i] = t * t * t;
+    }
+
+    GamepadProcessorDesc desc;
+    memset( &desc, 0, sizeof(desc) );
+    desc.stick_deadzone_type       = GAMEPAD_DEADZONE_TYPE_RADIAL;
+    desc.stick_deadzone_inner      = 0.12f;
+    desc.stick_deadzone_outer      = 0.95f;
+    desc.trigger_deadzone_inner    = 0.05f;
+    desc.stick_curve.point_count   = 17;
+    desc.stick_curve.points        = curve;
+    desc.trigger_curve.point_count = 17;
+    desc.trigger_curve.points      = curve;
+    desc.smoothing_min_cutoff      = 1.0f;
+    desc.smoothing_beta            = 5.0f;
+
+    GamepadProcessor* gp = malloc( gamepad_processor_query_memory_requirement() );
+    if( !gamepad_processor_create( &desc, gp ) ) {
+        fprintf( stderr, "failed to create gamepad processor!\n" );
+        return -1;
+    }
+
+    // NOTE(alicia): circles and flicks with jitter, different per gamepad.
+    GamepadState* frames = calloc( FRAME_COUNT * GAMEPAD_MAX_COUNT, sizeof(GamepadState) );
+    uint32_t rng = 0x12345678;
+    for( uint32_t f = 0; f < FRAME_COUNT; ++f ) {
+        for( uint32_t pad = 0; pad < GAMEPAD_MAX_COUNT; ++pad ) {
+            GamepadState* state = frames + f * GAMEPAD_MAX_COUNT + pad;
+            float t = (float)f / 60.0f + (float)pad;
+            rng = rng * 1664525u + 1013904223u;
+            int32_t jitter = (int32_t)(rng >> 23) - 256;
+
+            state->stick_left_x  = (int16_t)(cosf( t * 2.0f ) * 30000.0f) + (int16_t)jitter;
+            state->stick_left_y  = (int16_t)(sinf( t * 2.0f ) * 30000.0f) - (int16_t)jitter;
+            state->stick_right_x = (int16_t)(sinf( t * 7.0f ) > 0.5f ? 32767 : jitter);
+            state->stick_right_y = (int16_t)(cosf( t * 0.5f ) * 12000.0f);
+            state->trigger_left  = (uint8_t)(f * 3 + pad);
+            state->trigger_right = (uint8_t)(255 - f);
+        }
+    }
+
+    GamepadProcessedState state;
+    uint32_t at = 0;
+    for( uint32_t i = 0; i < bench_sample_count; ++i ) {
+        double start = bench_now_ns();
+        for( uint32_t j = 0; j < UPDATES_PER_SAMPLE; ++j, ++at ) {
+            const GamepadState* states = frames + (at % FRAME_COUNT) * GAMEPAD_MAX_COUNT;
+            gamepad_processor_update( gp, 0xF, states, 1.0f / 60.0f );
+            gamepad_processor_query_state( gp, at % GAMEPAD_MAX_COUNT, &state );
+            sink += state.stick_left_x;
+        }
+        bench_samples[i] = (bench_now_ns() - start) / (double)UPDATES_PER_SAMPLE;
+    }
+    bench_record( name, "update", sizeof(GamepadState) * GAMEPAD_MAX_COUNT,
+        bench_sample_count );
+
+    free( frames );
+    free( gp );
+    return bench_finish();
+}
@@ -0,0 +1,177 @@
+/**
+ * @file   spatial.c
+ * @brief  HRTF spatializer throughput benchmark.
+ * @details
+ * Renders moving voices through a synthetic HRTF set at 48 kHz
+ * and reports how many voices a single core can keep up with.
+ * Each sample is one render block.
+ *
+ * Arguments:
+ *   -voices <n> Number of voices. (default = 64)
+ *   -taps <n>   Length of impulse responses. (default = 256)
+ *   Arguments shared by every benchmark, see bench.h.
+ *
+ * Build and run:
+ *   ./cbuild bench
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 20, 2024
+*/
+// IWYU pragma: begin_keep
+#define _POSIX_C_SOURCE 200809L
+#include <math.h>
+#include "bench/bench.h"
+#include "media/audio.h"
+#include "media/spatial.h"
+// IWYU pragma: end_keep
+
+#define HZ              (48000)
+#define DIRECTION_COUNT (512)
+#define CLIP_LENGTH     (HZ)
+
+static volatile float sink = 0.0f;
+
+int main( int argc, char** argv ) {
+    uint32_t voices = 64;
+    uint32_t length = 256;
+    for( int i = 1; i < argc; ++i ) {
+        if( bench_parse_arg( argc, argv, &i ) ) {
+            continue;
+        }
+        if( strcmp( argv[i], "-voices" ) == 0 && i + 1 < argc ) {
+            voices = (uint32_t)strtoul( argv[++i], 0, 10 );
+        } else if( strcmp( argv[i], "-taps" ) == 0 && i + 1 < argc ) {
+            length = (uint32_t)strtoul( argv[++i], 0, 10 );
+        } else {
+            fprintf( stderr, "unrecognized argument '%s'\n", argv[i] );
+            return -1;
+        }
+    }
+    if( !voices ) {
+        voices = 1;
+    }
+    if( !length ) {
+        length = 1;
+    }
+    _Bool run_create = bench_enabled( "spatial.create" );
+    _Bool run_render = bench_enabled( "spatial.render" );
+    if( !run_create && !run_render ) {
+        return bench_finish();
+    }
+
+    // NOTE(alicia): directions on a Fibonacci sphere with decaying noise
+    // responses delayed by interaural time difference. Content does not
+    // matter for throughput, only length and direction count do.
+    float* directions = malloc( sizeof(float) * 3 * DIRECTION_COUNT );
+    float* responses  = malloc( sizeof(float) * 2 * length * DIRECTION_COUNT );
+    uint32_t rng = 0x12345678;
+    for( uint32_t d = 0; d < DIRECTION_COUNT; ++d ) {
+        float y = 1.0f - 2.0f * ((float)d + 0.5f) / (float)DIRECTION_COUNT;
+        float r = sqrtf( 1.0f - y * y );
+        float a = (float)d * 2.39996323f;
+        float* dir = directions + d * 3;
+        dir[0] = cosf( a ) * r;
+        dir[1] = y;
+        dir[2] = sinf( a ) * r;
+
+        for( uint32_t ear = 0; ear < 2; ++ear ) {
+            float* ir = responses + ((uintptr_t)d * 2 + ear) * length;
+            float side = ear ? dir[0] : -dir[0];
+            uint32_t delay = side < 0.0f ? (uint32_t)(-side * 30.0f) : 0;
+            for( uint32_t i = 0; i < length; ++i ) {
+                rng = rng * 1664525u + 1013904223u;
+                float noise = (float)(rng >> 8) / (float)(1 << 24) - 0.5f;
+                ir[i] = i < delay ? 0.0f : noise * expf( -(float)(i - delay) / 40.0f );
+            }
+        }
+    }
+
+    struct AudioSpatializerDesc desc;
+    memset( &desc, 0, sizeof(desc) );
+    desc.samples_per_second     = HZ;
+    desc.voice_cap              = voices;
+    desc.hrtf.length            = length;
+    desc.hrtf.direction_count   = DIRECTION_COUNT;
+    desc.hrtf.directions        = directions;
+    desc.hrtf.impulse_responses = responses;
+
+    uintptr_t size = audio_spatializer_query_memory_requirement( &desc );
+    AudioSpatializer* sp = malloc( size );
+
+    double start = bench_now_ns();
+    if( !audio_spatializer_create( &desc, sp ) ) {
+        fprintf( stderr, "failed to create spatializer!\n" );
+        return -1;
+    }
+    bench_samples[0] = bench_now_ns() - start;
+    if( run_create ) {
+        bench_record( "spatial.create", "call", size, 1 );
+    }
+
+    float* clip = malloc( sizeof(float) * CLIP_LENGTH );
+    for( uint32_t i = 0; i < CLIP_LENGTH; ++i ) {
+        clip[i] = sinf( (float)i * 0.0575f ) * 0.1f;
+    }
+    struct AudioSpatializerSource source;
+    memset( &source, 0, sizeof(source) );
+    source.samples            = clip;
+    source.sample_count       = CLIP_LENGTH;
+    source.samples_per_second = HZ;
+    source.loop               = true;
+    source.gain               = 1.0f;
+    source.min_distance       = 1.0f;
+    source.rolloff            = 1.0f;
+
+    uint32_t* handles = malloc( sizeof(uint32_t) * voices );
+    for( uint32_t v = 0; v < voices; ++v ) {
+        handles[v] = audio_spatializer_voice_play( sp, &source );
+    }
+
+    uint32_t block = AUDIO_SPATIALIZER_BLOCK_SIZE;
+    float* out = calloc( block * 2, sizeof(float) );
+
+    struct AudioBufferFormat format;
+    memset( &format, 0, sizeof(format) );
+    format.channel_count      = 2;
+    format.bits_per_sample    = 32;
+    format.samples_per_second = HZ;
+
+    uint32_t count = run_render ? bench_sample_count : 0;
+    for( uint32_t i = 0; i < count; ++i ) {
+        // NOTE(alicia): voices circle listener so responses
+        // change and crossfades are part of the measurement.
+        float t = (float)(i * block) / (float)HZ;
+        for( uint32_t v = 0; v < voices; ++v ) {
+            float a = t * (0.5f + (float)v * 0.01f) + (float)v;
+            float position[3] = { cosf( a ) * 4.0f, sinf( a * 0.3f ), sinf( a ) * 4.0f };
+            float velocity[3] = { -sinf( a ) * 2.0f, 0.0f, cosf( a ) * 2.0f };
+            audio_spatializer_voice_set_position( sp, handles[v], position, velocity );
+        }
+
+        struct AudioBuffer buffer;
+        buffer.sample_count = block;
+        buffer.size         = block * 2 * sizeof(float);
+        buffer.start        = out;
+
+        start = bench_now_ns();
+        audio_spatializer_render( sp, &format, &buffer );
+        bench_samples[i] = (bench_now_ns() - start) / (double)voices;
+        sink += out[0];
+    }
+    if( count ) {
+        bench_record( "spatial.render", "voice block", block * 2 * sizeof(float), count );
+
+        // NOTE(alicia): voices one core renders in real time at median cost.
+        double block_ns = (double)block * (double)MEDIA_TIME_NS_PER_SECOND / (double)HZ;
+        fprintf( stderr, "%-40s %12.0f voices per core (%u voices, %u taps)\n",
+            "spatial.render", block_ns / bench_results[bench_result_count - 1].p50,
+            voices, length );
+    }
+
+    free( out );
+    free( handles );
+    free( clip );
+    free( sp );
+    free( responses );
+    free( directions );
+    return bench_finish();
+}
@@ -0,0 +1,176 @@
+/**
+ * @file   startup.c
+ * @brief  Media library startup time benchmark.
+ * @details
+ * Measures how long each phase of startup takes.
+ *
+ * Arguments:
+ *   -preload  Preload every subsystem right after initializing library.
+ *   -async    Preload every subsystem on a background thread.
+ *
+ * Build (after ./cbuild build):
+ *   clang -std=c11 bench/startup.c -I. -L./build -lmedia -o build/startup.exe
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 13, 2024
+*/
+// IWYU pragma: begin_keep
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "media/lib.h"
+#include "media/surface.h"
+#include "media/input.h"
+#include "media/opengl.h"
+#include "media/audio.h"
+// IWYU pragma: end_keep
+
+#define text( lit ) sizeof(lit) - 1, lit
+
+double get_ms(void);
+
+struct Phase {
+    const char* name;
+    double      ms;
+};
+#define PHASE_CAP (16)
+static struct Phase phases[PHASE_CAP];
+static int phase_count = 0;
+static double phase_start = 0.0;
+
+static void phase_begin(void) {
+    phase_start = get_ms();
+}
+static void phase_end( const char* name ) {
+    double end = get_ms();
+    if( phase_count < PHASE_CAP ) {
+        phases[phase_count].name = name;
+        phases[phase_count].ms   = end - phase_start;
+        phase_count++;
+    }
+}
+
+void logging_callback(
+    MediaLoggingLevel level, uint32_t len, const char* message, void* params
+) {
+    unused(level, params);
+    printf( "%.*s\n", len, message );
+}
+
+int main( int argc, char** argv ) {
+    bool preload = false;
+    bool async   = false;
+    for( int i = 1; i < argc; ++i ) {
+        if( strcmp( argv[i], "-preload" ) == 0 ) {
+            preload = true;
+        } else if( strcmp( argv[i], "-async" ) == 0 ) {
+            preload = true;
+            async   = true;
+        } else {
+            printf( "unrecognized argument '%s'\n", argv[i] );
+            return -1;
+        }
+    }
+
+    double total_start = get_ms();
+
+    uintptr_t lib_size     = media_lib_query_memory_requirement();
+    uintptr_t surface_size = surface_query_memory_requirement();
+    uintptr_t input_size   = input_subsystem_query_memory_requirement();
+    uintptr_t list_size    = audio_device_list_query_memory_requirement();
+
+    uintptr_t buf_size = lib_size + surface_size + input_size + list_size;
+    uint8_t*  buf      = malloc( buf_size );
+    memset( buf, 0, buf_size );
+
+    void*            lib_buf   = buf;
+    SurfaceHandle*   surface   = buf + lib_size;
+    void*            input_buf = buf + lib_size + surface_size;
+    AudioDeviceList* list      = buf + lib_size + surface_size + input_size;
+
+    phase_begin();
+    if( !media_lib_initialize(
+        MEDIA_LOGGING_LEVEL_WARN, logging_callback, 0, lib_buf
+    ) ) {
+        printf( "failed to initialize media lib!\n" );
+        return -1;
+    }
+    phase_end( "media_lib_initialize" );
+
+    if( preload ) {
+        phase_begin();
+        if( !media_lib_preload( MEDIA_LIB_PRELOAD_ALL, async ) ) {
+            printf( "failed to preload media lib!\n" );
+            return -1;
+        }
+        phase_end( async ? "media_lib_preload (async)" : "media_lib_preload" );
+    }
+
+    phase_begin();
+    if( !surface_create(
+        text("Startup Benchmark"), 0, 0, 0, 0,
+        SURFACE_CREATE_FLAG_HIDDEN | SURFACE_CREATE_FLAG_DARK_MODE,
+        NULL, NULL, NULL, surface
+    ) ) {
+        printf( "failed to create surface!\n" );
+        return -1;
+    }
+    phase_end( "surface_create (first)" );
+
+    phase_begin();
+    if( !input_subsystem_initialize( input_buf ) ) {
+        printf( "failed to initialize input subsystem!\n" );
+        return -1;
+    }
+    phase_end( "input_subsystem_initialize" );
+
+    phase_begin();
+    if( !opengl_initialize() ) {
+        printf( "failed to initialize opengl!\n" );
+        return -1;
+    }
+    phase_end( "opengl_initialize" );
+
+    phase_begin();
+    bool has_audio = audio_device_list_create( list );
+    phase_end( "audio_device_list_create" );
+
+    phase_begin();
+    surface_pump_events();
+    phase_end( "surface_pump_events (first)" );
+
+    double total = get_ms() - total_start;
+
+    if( has_audio ) {
+        audio_device_list_destroy( list );
+    }
+    input_subsystem_shutdown();
+    surface_destroy( surface );
+    media_lib_shutdown();
+    free( buf );
+
+    printf( "startup phases:\n" );
+    for( int i = 0; i < phase_count; ++i ) {
+        printf( "    %-32s %8.3fms\n", phases[i].name, phases[i].ms );
+    }
+    printf( "    %-32s %8.3fms\n", "total", total );
+    return 0;
+}
+
+#if defined(MEDIA_PLATFORM_WINDOWS)
+#include <windows.h>
+double get_ms(void) {
+    LARGE_INTEGER qpc, qpf;
+    QueryPerformanceCounter( &qpc );
+    QueryPerformanceFrequency( &qpf );
+
+    return ((double)qpc.QuadPart / (double)qpf.QuadPart) * 1000.0;
+}
+#else
+#include <time.h>
+double get_ms(void) {
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ((double)ts.tv_nsec / 1000000.0) + ((double)ts.tv_sec * 1000.0);
+}
+#endif
@@ -0,0 +1,120 @@
+/**
+ * @file   unicode.c
+ * @brief  Unicode transcoding throughput benchmark.
+ * @details
+ * Measures UTF-8 to UTF-16, UTF-16 to UTF-8 and UTF-8 validation
+ * throughput on ASCII, mixed Latin, CJK and emoji text.
+ * Each sample is one call over whole corpus.
+ *
+ * Arguments:
+ *   -size <n> Size of each corpus in KiB. (default = 64)
+ *   Arguments shared by every benchmark, see bench.h.
+ *
+ * Build and run:
+ *   ./cbuild bench
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 15, 2024
+*/
+// IWYU pragma: begin_keep
+#define _POSIX_C_SOURCE 200809L
+#include "bench/bench.h"
+#include "media/internal/unicode.h"
+// IWYU pragma: end_keep
+
+#define CORPUS_SIZE_CAP (16 * 1024)
+
+struct Corpus {
+    const char* to16;
+    const char* to8;
+    const char* validate;
+    const char* sample;
+};
+static struct Corpus corpora[] = {
+    { "unicode.ascii.utf8_to_utf16", "unicode.ascii.utf16_to_utf8", "unicode.ascii.validate",
+        "The quick brown fox jumps over the lazy dog. 0123456789\n" },
+    { "unicode.latin.utf8_to_utf16", "unicode.latin.utf16_to_utf8", "unicode.latin.validate",
+        "Caf\xC3\xA9 na\xC3\xAFve fa\xC3\xA7" "ade r\xC3\xA9sum\xC3\xA9 ok. " },
+    { "unicode.cjk.utf8_to_utf16", "unicode.cjk.utf16_to_utf8", "unicode.cjk.validate",
+        "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E\xE3\x81\xAE\xE6\x96\x87\xE7\xAB\xA0 " },
+    { "unicode.emoji.utf8_to_utf16", "unicode.emoji.utf16_to_utf8", "unicode.emoji.validate",
+        "\xF0\x9F\x98\x80\xF0\x9F\x8E\xAE\xF0\x9F\x9A\x80 ok " },
+};
+
+static volatile uintptr_t sink = 0;
+
+/// Print throughput of most recent result.
+static void report_throughput( const char* name, uintptr_t bytes ) {
+    double p50 = bench_results[bench_result_count - 1].p50;
+    fprintf( stderr, "%-40s %12.1f MB/s\n",
+        name, ((double)bytes / (1024.0 * 1024.0)) / (p50 / 1000000000.0) );
+}
+
+int main( int argc, char** argv ) {
+    uint32_t size_kib = 64;
+    for( int i = 1; i < argc; ++i ) {
+        if( bench_parse_arg( argc, argv, &i ) ) {
+            continue;
+        }
+        if( strcmp( argv[i], "-size" ) == 0 && i + 1 < argc ) {
+            size_kib = (uint32_t)strtoul( argv[++i], 0, 10 );
+        } else {
+            fprintf( stderr, "unrecognized argument '%s'\n", argv[i] );
+            return -1;
+        }
+    }
+    if( !size_kib || size_kib > CORPUS_SIZE_CAP ) {
+        size_kib = 64;
+    }
+    uintptr_t cap = (uintptr_t)size_kib * 1024;
+
+    char*     utf8  = malloc( cap );
+    char*     utf8b = malloc( cap * 2 );
+    uint16_t* utf16 = malloc( cap * sizeof(uint16_t) );
+
+    for( uint32_t c = 0; c < sizeof(corpora) / sizeof(corpora[0]); ++c ) {
+        struct Corpus* corpus = corpora + c;
+
+        uintptr_t sample_len = strlen( corpus->sample );
+        uintptr_t len = 0;
+        while( len + sample_len <= cap ) {
+            memcpy( utf8 + len, corpus->sample, sample_len );
+            len += sample_len;
+        }
+        uintptr_t len16 = media_utf8_to_utf16( len, utf8, cap, utf16, 0 );
+
+        if( bench_enabled( corpus->to16 ) ) {
+            for( uint32_t i = 0; i < bench_sample_count; ++i ) {
+                double start = bench_now_ns();
+                sink += media_utf8_to_utf16( len, utf8, cap, utf16, 0 );
+                bench_samples[i] = bench_now_ns() - start;
+            }
+            bench_record( corpus->to16, "call", len, bench_sample_count );
+            report_throughput( corpus->to16, len );
+        }
+
+        if( bench_enabled( corpus->to8 ) ) {
+            for( uint32_t i = 0; i < bench_sample_count; ++i ) {
+                double start = bench_now_ns();
+                sink += media_utf16_to_utf8( len16, utf16, cap * 2, utf8b, 0 );
+                bench_samples[i] = bench_now_ns() - start;
+            }
+            bench_record( corpus->to8, "call", len16 * sizeof(uint16_t), bench_sample_count );
+            report_throughput( corpus->to8, len16 * sizeof(uint16_t) );
+        }
+
+        if( bench_enabled( corpus->validate ) ) {
+            for( uint32_t i = 0; i < bench_sample_count; ++i ) {
+                double start = bench_now_ns();
+                sink += media_utf8_validate( len, utf8 );
+                bench_samples[i] = bench_now_ns() - start;
+            }
+            bench_record( corpus->validate, "call", len, bench_sample_count );
+            report_throughput( corpus->validate, len );
+        }
+    }
+
+    free( utf8 );
+    free( utf8b );
+    free( utf16 );
+    return bench_finish();
+}
@@ -14,6 +14,14 @@
 #define ARGS_OPT    "-O2"
 #define ARGS_NO_OPT "-O0"
 
+#define ARGS_LTO    "-flto"
+#define ARGS_NATIVE "-march=native"
+
+#define ARGS_PROFILE_USE_WARN\
+    "-Wno-profile-instr-out-of-date",\
+    "-Wno-profile-instr-unprofiled",\
+    "-Wno-profile-instr-missing"
+
 #define ARGS_WARN "-Wall", "-Wextra", "-Werror=vla", "-Werror"
 
 #if defined(PLATFORM_WINDOWS)
@@ -24,6 +32,7 @@
     #define ARGS_WITH_SYMBOLS        "-g", "-gcodeview", "-fuse-ld=lld", "-Wl,/debug"
 
     #define ARGS_LINK "-lkernel32", "-nostdlib"
+    #define ARGS_LINK_PROGRAM "-lkernel32"
 
     #define ARGS_LD "-shared"
 #else
@@ -33,7 +42,10 @@
     #define ARGS_WITH_SYMBOLS_STATIC "-ggdb"
     #define ARGS_WITH_SYMBOLS        "-ggdb"
     
-    #define ARGS_LINK "-lSDL3"
+    // NOTE(alicia): only headless subsystems and POSIX fallbacks
+    // build here, they need libm and pthreads.
+    #define ARGS_LINK "-lpthread"
+    #define ARGS_LINK_PROGRAM "-lm", "-lpthread"
 
     #define ARGS_LD   "-fPIC", "-shared"
 #endif
@@ -42,10 +54,31 @@
 
 #define TEST_PATH "./build/libmedia-test" EXE_EXT
 
+// NOTE(alicia): tests that include code they test instead of
+// linking library, ./tests/<name>.c
+#define TEST_STANDALONE\
+    "allocator", "unicode", "spatial", "action", "gamepad_processor"
+
+#define PGO_DIR          "./build/pgo"
+#define PGO_PROFRAW_PATH PGO_DIR "/media.profraw"
+#define PGO_PROFILE_PATH PGO_DIR "/media.profdata"
+#define REPORT_DIR       "./build/report"
+
+#define BENCH_SOURCE "./bench/bench.c"
+#define BENCH_PATH   "./build/media-bench" EXE_EXT
+
+// NOTE(alicia): benchmarks with their own program, ./bench/<name>.c
+#define BENCH_STANDALONE "unicode", "spatial", "action", "gamepad_processor"
+
+#define WORKLOAD_DEFAULT BENCH_SOURCE
+#define WORKLOAD_RUNS    (5)
+
 typedef enum Mode {
     M_HELP,
     M_BUILD,
     M_TEST,
+    M_PGO,
+    M_BENCH,
     M_DOCS,
     M_LSP,
 
@@ -88,6 +121,13 @@ typedef struct ParsedArgs {
             bool        strip_symbols;
             bool        is_static;
             bool        dry;
+            bool        lto;
+            bool        native;
+            bool        trace;
+            bool        instrument;
+            bool        report;
+            const char* profile;
+            const char* workload;
         } build;
         struct TestArgs {
             struct BuildArgs build;
@@ -95,6 +135,15 @@ typedef struct ParsedArgs {
             int          argc;
             const char** argv;
         } test;
+        struct PgoArgs {
+            struct BuildArgs build;
+        } pgo;
+        struct BenchArgs {
+            struct BuildArgs build;
+            int          start;
+            int          argc;
+            const char** argv;
+        } bench;
         struct DocsArgs {
             struct BuildArgs build;
             bool             launch_browser;
@@ -108,6 +157,8 @@ typedef struct ParsedArgs {
 int mode_help( ParsedArgs* args );
 int mode_build( struct BuildArgs* args, CommandBuilder* opt_out_builder );
 int mode_test( struct TestArgs* args );
+int mode_pgo( struct PgoArgs* args );
+int mode_bench( struct BenchArgs* args );
 int mode_docs( struct DocsArgs* args );
 int mode_lsp( struct LspArgs* args );
 
@@ -144,6 +195,8 @@ int main( int argc, const char** argv ) {
         switch( parsed_args.mode ) {
             case M_BUILD:
             case M_TEST:
+            case M_PGO:
+            case M_BENCH:
             case M_DOCS:
             case M_LSP: {
                 if( string_cmp( string_text("-t"), arg ) ) {
@@ -173,7 +226,9 @@ int main( int argc, const char** argv ) {
 
         switch( parsed_args.mode ) {
             case M_BUILD:
-            case M_TEST: {
+            case M_TEST:
+            case M_PGO:
+            case M_BENCH: {
                 if( string_cmp( string_text("-o"), arg ) ) {
                     i++;
                     if( i >= argc ) {
@@ -196,6 +251,18 @@ int main( int argc, const char** argv ) {
                     parsed_args.build.dry = true;
                     continue;
                 }
+                if( string_cmp( string_text("-lto"), arg ) ) {
+                    parsed_args.build.lto = true;
+                    continue;
+                }
+                if( string_cmp( string_text("-native"), arg ) ) {
+                    parsed_args.build.native = true;
+                    continue;
+                }
+                if( string_cmp( string_text("-trace"), arg ) ) {
+                    parsed_args.build.trace = true;
+                    continue;
+                }
             } break;
 
             case M_DOCS:
@@ -204,6 +271,29 @@ int main( int argc, const char** argv ) {
             case M_COUNT: break;
         }
 
+        switch( parsed_args.mode ) {
+            case M_BUILD:
+            case M_PGO: {
+                if( string_cmp( string_text("-workload"), arg ) ) {
+                    i++;
+                    if( i >= argc ) {
+                        cb_error( "argument '-workload' requires a path after it!" );
+                        mode_help( &parsed_args );
+                        return 1;
+                    }
+                    parsed_args.build.workload = argv[i];
+                    continue;
+                }
+            } break;
+
+            case M_TEST:
+            case M_BENCH:
+            case M_DOCS:
+            case M_LSP:
+            case M_HELP:
+            case M_COUNT: break;
+        }
+
         switch( parsed_args.mode ) {
             case M_DOCS: {
                 if( string_cmp( string_text("-browser"), arg ) ) {
@@ -222,6 +312,16 @@ int main( int argc, const char** argv ) {
                 }
             } break;
 
+            case M_BENCH: {
+                if( string_cmp( string_text( "--" ), arg ) ) {
+                    parsed_args.bench.start = i + 1;
+                    parsed_args.bench.argc  = argc;
+                    parsed_args.bench.argv  = argv;
+                    break_loop = true;
+                    continue;
+                }
+            } break;
+
             case M_BUILD: {
                 if( string_cmp( string_text("-n"), arg ) ) {
                     i++;
@@ -233,10 +333,25 @@ int main( int argc, const char** argv ) {
                     parsed_args.build.name = argv[i];
                     continue;
                 }
+                if( string_cmp( string_text("-profile"), arg ) ) {
+                    i++;
+                    if( i >= argc ) {
+                        cb_error( "argument '-profile' requires a path after it!" );
+                        mode_help( &parsed_args );
+                        return 1;
+                    }
+                    parsed_args.build.profile = argv[i];
+                    continue;
+                }
+                if( string_cmp( string_text("-report"), arg ) ) {
+                    parsed_args.build.report = true;
+                    continue;
+                }
             } break;
 
             case M_HELP:
             case M_LSP:
+            case M_PGO:
             case M_COUNT:break;
         }
 
@@ -248,6 +363,8 @@ int main( int argc, const char** argv ) {
     switch( parsed_args.mode ) {
         case M_BUILD : return mode_build( &parsed_args.build, NULL );
         case M_TEST  : return mode_test( &parsed_args.test );
+        case M_PGO   : return mode_pgo( &parsed_args.pgo );
+        case M_BENCH : return mode_bench( &parsed_args.bench );
         case M_DOCS  : return mode_docs( &parsed_args.docs );
         case M_LSP   : return mode_lsp( &parsed_args.lsp );
 
@@ -317,9 +434,286 @@ bool mode_build_generate_command_line( const char* cmd_line ) {
     #undef write
     return true;
 }
+usize file_size( const char* path ) {
+    FD fd;
+    if( !fd_open( path, FOPEN_READ, &fd ) ) {
+        return 0;
+    }
+    usize size = fd_query_size( &fd );
+    fd_close( &fd );
+    return size;
+}
+f64 percent_delta( f64 baseline, f64 value ) {
+    if( baseline == 0.0 ) {
+        return 0.0;
+    }
+    return ((value - baseline) / baseline) * 100.0;
+}
+void build_append_optimization( CommandBuilder* builder, struct BuildArgs* args ) {
+    if( args->lto ) {
+        command_builder_append( builder, ARGS_LTO );
+#if defined(PLATFORM_WINDOWS)
+        if( !args->is_static ) {
+            command_builder_append( builder, "-fuse-ld=lld" );
+        }
+#endif
+    }
+    if( args->native ) {
+        command_builder_append( builder, ARGS_NATIVE );
+    }
+    if( args->trace ) {
+        command_builder_append( builder, "-DMEDIA_ENABLE_TRACE" );
+    }
+    if( args->instrument ) {
+        command_builder_append(
+            builder, "-fprofile-instr-generate=" PGO_PROFRAW_PATH );
+    }
+    if( args->profile ) {
+        command_builder_append(
+            builder, local_fmt( "-fprofile-use=%s", args->profile ),
+            ARGS_PROFILE_USE_WARN );
+    }
+}
+bool ensure_dir( const char* path ) {
+    if( path_exists( path ) ) {
+        return true;
+    }
+    return dir_create( path );
+}
+/// Link workload program against static library built with args.
+int workload_build( struct BuildArgs* args, const char* exe_path ) {
+    const char* workload = args->workload ? args->workload : WORKLOAD_DEFAULT;
+
+    CommandBuilder builder;
+    expect(
+        command_builder_new( "clang", &builder ),
+        "failed to create command builder!" );
+
+    command_builder_append(
+        &builder, "-std=c11", workload, "-I.", args->output,
+        "-DMEDIA_ENABLE_STATIC_BUILD", ARGS_OPT, "-o", exe_path );
+    build_append_optimization( &builder, args );
+#if defined(PLATFORM_WINDOWS)
+    if( args->lto ) {
+        command_builder_append( &builder, "-fuse-ld=lld" );
+    }
+#endif
+    command_builder_append( &builder, ARGS_LINK_PROGRAM );
+
+    Command cmd  = command_builder_cmd( &builder );
+    DString* flat = command_flatten_dstring( &cmd );
+    cb_info( "workload: %s", flat );
+    dstring_free( flat );
+
+    int res = 0;
+    if( !args->dry ) {
+        PID pid = process_exec( cmd, false, NULL, NULL, NULL, NULL );
+        res = process_wait( pid );
+        if( res ) {
+            cb_error( "workload: failed to compile %s!", workload );
+        }
+    }
+
+    command_builder_free( &builder );
+    return res;
+}
+/// Run workload program, write median runtime.
+bool workload_run( const char* exe_path, u32 runs, f64* out_median_ms ) {
+    f64 times[WORKLOAD_RUNS];
+    if( runs > WORKLOAD_RUNS ) {
+        runs = WORKLOAD_RUNS;
+    }
+
+    Command cmd = command_new( exe_path );
+    for( u32 i = 0; i < runs; ++i ) {
+        f64 start = timer_milliseconds();
+        PID pid = process_exec( cmd, true, NULL, NULL, NULL, NULL );
+        int res = process_wait( pid );
+        f64 end = timer_milliseconds();
+        if( res ) {
+            cb_error( "workload: %s exited with code %i!", exe_path, res );
+            return false;
+        }
+
+        // NOTE(alicia): insertion sort, runs is tiny.
+        u32 at = i;
+        while( at && times[at - 1] > end - start ) {
+            times[at] = times[at - 1];
+            at--;
+        }
+        times[at] = end - start;
+    }
+
+    *out_median_ms = times[runs / 2];
+    return true;
+}
+/// Build and run tests that include code they test.
+/// @return Number of tests that failed to build or run.
+int test_run_standalone( struct TestArgs* args ) {
+    const char* names[] = { TEST_STANDALONE };
+
+    int failed = 0;
+    for( usize i = 0; i < static_array_len( names ); ++i ) {
+        DString* source = dstring_fmt( "./tests/%s.c", names[i] );
+        DString* exe    = dstring_fmt( "./build/test-%s" EXE_EXT, names[i] );
+
+        CommandBuilder builder;
+        expect(
+            command_builder_new( "clang", &builder ),
+            "failed to create command builder!" );
+        command_builder_append(
+            &builder, "-std=c11", source, "-I.", ARGS_WARN, ARGS_OPT, "-o", exe );
+#if !defined(PLATFORM_WINDOWS)
+        command_builder_append( &builder, "-lm" );
+#endif
+
+        Command cmd   = command_builder_cmd( &builder );
+        DString* flat = command_flatten_dstring( &cmd );
+        cb_info( "test: %s", flat );
+        dstring_free( flat );
+
+        int res = 0;
+        if( !args->build.dry ) {
+            PID pid = process_exec( cmd, false, NULL, NULL, NULL, NULL );
+            res = process_wait( pid );
+            if( res ) {
+                cb_error( "test: failed to compile %s!", source );
+            } else {
+                pid = process_exec(
+                    command_new( exe ), false, NULL, NULL, NULL, NULL );
+                res = process_wait( pid );
+                if( res ) {
+                    cb_error( "test: %s exited with code %i", exe, res );
+                }
+            }
+        }
+        failed += res != 0;
+
+        command_builder_free( &builder );
+        dstring_free( exe );
+        dstring_free( source );
+    }
+    return failed;
+}
+/// Build and run benchmarks that have their own program.
+/// Each writes results to ./build/bench-<name>.json.
+int bench_run_standalone( struct BenchArgs* args ) {
+    const char* names[] = { BENCH_STANDALONE };
+
+    int res = 0;
+    for( usize i = 0; !res && i < static_array_len( names ); ++i ) {
+        DString* source = dstring_fmt( "./bench/%s.c", names[i] );
+        DString* exe    = dstring_fmt( "./build/media-bench-%s" EXE_EXT, names[i] );
+        DString* json   = dstring_fmt( "./build/bench-%s.json", names[i] );
+
+        struct BuildArgs build = args->build;
+        build.workload = source;
+        res = workload_build( &build, exe );
+
+        CommandBuilder builder;
+        expect(
+            command_builder_new( exe, &builder ),
+            "failed to create command builder!" );
+        if( args->argv ) {
+            command_builder_append_list(
+                &builder, (usize)(args->argc - args->start), args->argv + args->start );
+        }
+        // NOTE(alicia): last -o wins, keeps results of main program intact.
+        command_builder_append( &builder, "-o", json );
+
+        Command cmd   = command_builder_cmd( &builder );
+        DString* flat = command_flatten_dstring( &cmd );
+        cb_info( "bench: %s", flat );
+        dstring_free( flat );
+
+        if( !res && !args->build.dry ) {
+            PID pid = process_exec( cmd, false, NULL, NULL, NULL, NULL );
+            res = process_wait( pid );
+            if( res ) {
+                cb_error( "bench: %s exited with code %i", exe, res );
+            }
+        }
+
+        command_builder_free( &builder );
+        dstring_free( json );
+        dstring_free( exe );
+        dstring_free( source );
+    }
+    return res;
+}
+/// Build baseline and optimized static libraries,
+/// link workload against both and report size and runtime delta.
+int optimize_report( struct BuildArgs* args ) {
+    if( !ensure_dir( "./build" ) || !ensure_dir( REPORT_DIR ) ) {
+        cb_error( "report: failed to create " REPORT_DIR "!" );
+        return 1;
+    }
+
+    struct BuildArgs baseline;
+    memory_zero( &baseline, sizeof(baseline) );
+    baseline.name          = "libmedia-baseline";
+    baseline.output        = REPORT_DIR;
+    baseline.target        = args->target;
+    baseline.release       = true;
+    baseline.strip_symbols = true;
+    baseline.is_static     = true;
+    baseline.dry           = args->dry;
+    baseline.workload      = args->workload;
+
+    struct BuildArgs optimized = baseline;
+    optimized.name    = "libmedia-optimized";
+    optimized.lto     = args->lto;
+    optimized.native  = args->native;
+    optimized.profile = args->profile;
+
+    const char* baseline_exe  = REPORT_DIR "/workload-baseline" EXE_EXT;
+    const char* optimized_exe = REPORT_DIR "/workload-optimized" EXE_EXT;
+
+    int res = mode_build( &baseline, NULL );
+    if( res ) {
+        return res;
+    }
+    res = mode_build( &optimized, NULL );
+    if( res ) {
+        return res;
+    }
+    res = workload_build( &baseline, baseline_exe );
+    if( res ) {
+        return res;
+    }
+    res = workload_build( &optimized, optimized_exe );
+    if( res ) {
+        return res;
+    }
+    if( args->dry ) {
+        return 0;
+    }
+
+    f64 baseline_ms = 0.0, optimized_ms = 0.0;
+    if(
+        !workload_run( baseline_exe, WORKLOAD_RUNS, &baseline_ms ) ||
+        !workload_run( optimized_exe, WORKLOAD_RUNS, &optimized_ms )
+    ) {
+        return 1;
+    }
+
+    usize baseline_size  = file_size( baseline_exe );
+    usize optimized_size = file_size( optimized_exe );
+
+    cb_info( "report: workload %s (median of %i runs)",
+        args->workload ? args->workload : WORKLOAD_DEFAULT, WORKLOAD_RUNS );
+    cb_info( "report: size    baseline %zu bytes, optimized %zu bytes (%+.2f%%)",
+        baseline_size, optimized_size,
+        percent_delta( (f64)baseline_size, (f64)optimized_size ) );
+    cb_info( "report: runtime baseline %.2fms, optimized %.2fms (%+.2f%%)",
+        baseline_ms, optimized_ms, percent_delta( baseline_ms, optimized_ms ) );
+    return 0;
+}
 int mode_build( struct BuildArgs* args, CommandBuilder* opt_out_builder ) {
     f64 start = timer_milliseconds();
 
+    struct BuildArgs original = *args;
+
     // NOTE(alicia): finalized output path is generated here.
     args->output = path_join(
         args->output ? args->output : "./build",
@@ -352,6 +746,8 @@ int mode_build( struct BuildArgs* args, CommandBuilder* opt_out_builder ) {
         command_builder_append( &builder, ARGS_NO_OPT, "-DMEDIA_ENABLE_LOGGING" );
     }
 
+    build_append_optimization( &builder, args );
+
     if( args->strip_symbols ) {
     } else {
         if( args->is_static ) {
@@ -389,6 +785,10 @@ int mode_build( struct BuildArgs* args, CommandBuilder* opt_out_builder ) {
         } else {
             command_builder_free( &builder );
         }
+        if( args->report ) {
+            original.report = false;
+            return optimize_report( &original );
+        }
         return 0;
     }
 
@@ -411,6 +811,9 @@ int mode_build( struct BuildArgs* args, CommandBuilder* opt_out_builder ) {
 
     f64 end = timer_milliseconds();
     cb_info( "build: compilation took %.2fms", end - start );
+    if( !res ) {
+        cb_info( "build: %s is %zu bytes", args->output, file_size( args->output ) );
+    }
 
     if( opt_out_builder ) {
         *opt_out_builder = builder;
@@ -418,6 +821,11 @@ int mode_build( struct BuildArgs* args, CommandBuilder* opt_out_builder ) {
         command_builder_free( &builder );
     }
 
+    if( !res && args->report ) {
+        original.report = false;
+        res = optimize_report( &original );
+    }
+
     return res;
 }
 int mode_test( struct TestArgs* args ) {
@@ -499,7 +907,7 @@ int mode_test( struct TestArgs* args ) {
         flat = command_flatten_dstring( &cmd );
         cb_info( "test: %s", flat );
         dstring_free( flat );
-        return 0;
+        return test_run_standalone( args ) ? 1 : 0;
     }
 
     PID pid = process_exec( cmd, false, NULL, NULL, NULL, NULL );
@@ -507,7 +915,120 @@ int mode_test( struct TestArgs* args ) {
 
     cb_info( "test: exited with code %i", res );
 
-    return 0;
+    return test_run_standalone( args ) ? 1 : 0;
+}
+int mode_pgo( struct PgoArgs* args ) {
+    if( !args->build.dry && !process_in_path( "llvm-profdata" ) ) {
+        cb_error( "pgo: could not find llvm-profdata in path!" );
+        return 1;
+    }
+    if( !ensure_dir( "./build" ) || !ensure_dir( PGO_DIR ) ) {
+        cb_error( "pgo: failed to create " PGO_DIR "!" );
+        return 1;
+    }
+
+    struct BuildArgs instrumented;
+    memory_zero( &instrumented, sizeof(instrumented) );
+    instrumented.name       = "libmedia-instrumented";
+    instrumented.output     = PGO_DIR;
+    instrumented.target     = args->build.target;
+    instrumented.release    = true;
+    instrumented.is_static  = true;
+    instrumented.dry        = args->build.dry;
+    instrumented.native     = args->build.native;
+    instrumented.instrument = true;
+    instrumented.workload   = args->build.workload;
+
+    const char* instrumented_exe = PGO_DIR "/workload-instrumented" EXE_EXT;
+
+    cb_info( "pgo: building instrumented library . . ." );
+    int res = mode_build( &instrumented, NULL );
+    if( res ) {
+        return res;
+    }
+    res = workload_build( &instrumented, instrumented_exe );
+    if( res ) {
+        return res;
+    }
+
+    if( !args->build.dry ) {
+        if( path_exists( PGO_PROFRAW_PATH ) ) {
+            file_remove( PGO_PROFRAW_PATH );
+        }
+
+        cb_info( "pgo: collecting profile . . ." );
+        f64 ms = 0.0;
+        if( !workload_run( instrumented_exe, 1, &ms ) ) {
+            return 1;
+        }
+
+        Command merge = command_new(
+            "llvm-profdata", "merge",
+            "-output=" PGO_PROFILE_PATH, PGO_PROFRAW_PATH );
+        PID pid = process_exec( merge, false, NULL, NULL, NULL, NULL );
+        res = process_wait( pid );
+        if( res ) {
+            cb_error( "pgo: llvm-profdata failed to merge profile!" );
+            return res;
+        }
+        cb_info( "pgo: profile written to " PGO_PROFILE_PATH );
+    }
+
+    cb_info( "pgo: building profile optimized library . . ." );
+    args->build.release = true;
+    args->build.profile = PGO_PROFILE_PATH;
+    args->build.report  = true;
+    return mode_build( &args->build, NULL );
+}
+int mode_bench( struct BenchArgs* args ) {
+    if( !ensure_dir( "./build" ) ) {
+        cb_error( "bench: failed to create ./build!" );
+        return 1;
+    }
+
+    args->build.name          = "libmedia-bench";
+    args->build.release       = true;
+    args->build.is_static     = true;
+    args->build.strip_symbols = true;
+    args->build.report        = false;
+    args->build.workload      = BENCH_SOURCE;
+
+    int res = mode_build( &args->build, NULL );
+    if( res ) {
+        return res;
+    }
+    res = workload_build( &args->build, BENCH_PATH );
+    if( res ) {
+        return res;
+    }
+
+    CommandBuilder builder;
+    expect(
+        command_builder_new( BENCH_PATH, &builder ),
+        "failed to create command builder!" );
+    if( args->argv ) {
+        command_builder_append_list(
+            &builder, (usize)(args->argc - args->start), args->argv + args->start );
+    }
+
+    Command cmd = command_builder_cmd( &builder );
+    if( args->build.dry ) {
+        DString* flat = command_flatten_dstring( &cmd );
+        cb_info( "bench: %s", flat );
+        dstring_free( flat );
+        command_builder_free( &builder );
+        return bench_run_standalone( args );
+    }
+
+    PID pid = process_exec( cmd, false, NULL, NULL, NULL, NULL );
+    res = process_wait( pid );
+    command_builder_free( &builder );
+
+    if( res ) {
+        cb_error( "bench: exited with code %i", res );
+        return res;
+    }
+    return bench_run_standalone( args );
 }
 int mode_docs( struct DocsArgs* args ) {
     if( !process_in_path( "doxygen" ) ) {
@@ -818,6 +1339,53 @@ int mode_help( ParsedArgs* args ) {
             printf( "  -static      Build static library instead of dynamic. (default = false)\n");
             printf( "                 Prints required link flags for current target after compilation completes.\n");
             printf( "  -dry         Don't actually build, just print configuration.\n" );
+            printf( "  -lto         Enable link time optimization. (default = false)\n");
+            printf( "  -native      Tune for the CPU of this machine (-march=native). (default = false)\n");
+            printf( "  -trace       Record trace scopes, see media/trace.h. (default = false)\n");
+            printf( "  -profile <path>  Optimize with profile from llvm-profdata. (default = none)\n");
+            printf( "                 See pgo mode for generating profile.\n" );
+            printf( "  -report      Build baseline and optimized static libraries, link workload against\n");
+            printf( "                 both and report binary size and runtime delta. (default = false)\n");
+            printf( "  -workload <path>  Workload program for -report. (default = " WORKLOAD_DEFAULT ")\n");
+        } break;
+        case M_PGO: {
+            printf( "  -o <path>    Set output directory. (default = ./build)\n");
+            printf( "  -t <target>  Set target. (default = native)\n");
+            printf( "                 valid: " );
+            for( Target target_i = 0; target_i < T_COUNT; ++target_i ) {
+                printf( "%s", target_to_str(target_i).cc );
+                if( target_i + 1 < T_COUNT ) {
+                    printf( ", " );
+                } else {
+                    printf( "\n" );
+                }
+            }
+            printf( "  -no-symbols  Strips debug symbols from build. (default = false)\n" );
+            printf( "  -static      Build static library instead of dynamic. (default = false)\n");
+            printf( "  -lto         Enable link time optimization. (default = false)\n");
+            printf( "  -native      Tune for the CPU of this machine (-march=native). (default = false)\n");
+            printf( "  -workload <path>  Program run to collect profile. (default = " WORKLOAD_DEFAULT ")\n");
+            printf( "                 Must build against static library, e.g. ./tests/test.c\n");
+            printf( "  -dry         Don't actually build, just print configuration.\n" );
+        } break;
+        case M_BENCH: {
+            printf( "  -o <path>    Set output directory. (default = ./build)\n");
+            printf( "  -t <target>  Set target. (default = native)\n");
+            printf( "                 valid: " );
+            for( Target target_i = 0; target_i < T_COUNT; ++target_i ) {
+                printf( "%s", target_to_str(target_i).cc );
+                if( target_i + 1 < T_COUNT ) {
+                    printf( ", " );
+                } else {
+                    printf( "\n" );
+                }
+            }
+            printf( "  -lto         Enable link time optimization. (default = false)\n");
+            printf( "  -native      Tune for the CPU of this machine (-march=native). (default = false)\n");
+            printf( "  -trace       Record trace scopes, see media/trace.h. (default = false)\n");
+            printf( "  -dry         Don't actually build, just print configuration.\n" );
+            printf( "  --           Stop parsing cbuild arguments and pass remaining arguments to benchmark program.\n" );
+            printf( "                 e.g. ./cbuild bench -- -o build/bench.json -filter surface\n" );
         } break;
         case M_TEST: {
             printf( "  -o <path>    Set output directory. (default = ./build)\n");
@@ -837,6 +1405,7 @@ int mode_help( ParsedArgs* args ) {
             printf( "  -no-symbols  Strips debug symbols from build. (default = false)\n" );
             printf( "  -static      Build static library instead of dynamic. (default = false)\n");
             printf( "                 Prints required link flags for current target after compilation completes.\n");
+            printf( "  -trace       Record trace scopes, see media/trace.h. (default = false)\n");
             printf( "  -dry         Don't actually build, just print configuration.\n" );
             printf( "  --           Stop parsing cbuild arguments and pass remaining arguments to test program.\n" );
         } break;
@@ -877,6 +1446,8 @@ String mode_to_str( Mode mode ) {
         case M_HELP:  return string_text("help");
         case M_BUILD: return string_text("build");
         case M_TEST:  return string_text("test");
+        case M_PGO:   return string_text("pgo");
+        case M_BENCH: return string_text("bench");
         case M_DOCS:  return string_text("docs");
         case M_LSP:   return string_text("lsp");
         case M_COUNT: break;
@@ -897,6 +1468,12 @@ String mode_description( Mode mode ) {
         case M_HELP:  return string_text("Print this message and quit.");
         case M_BUILD: return string_text("Build library.");
         case M_TEST:  return string_text("Build library, tests and then run tests.");
+        case M_PGO:   return string_text(
+            "Build instrumented library, run workload to collect profile "
+            "then build profile optimized library and report size and runtime delta.");
+        case M_BENCH: return string_text(
+            "Build release static library and benchmark suite, "
+            "then run benchmarks and print results as JSON.");
         case M_DOCS:  return string_text("Generate documentation.");
         case M_LSP:   return string_text("Generate LSP files (clangd).");
         case M_COUNT: break;
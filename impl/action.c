@@ -0,0 +1,457 @@
+/**
+ * @file   action.c
+ * @brief  Compiled input action mapping.
+ * @details
+ * Digital input is packed into six 64-bit words: 128 key bits,
+ * 128 scancode bits, 16 gamepad button bits per gamepad and mouse bits.
+ * Bindings are transposed at compile time: every input bit that has
+ * a binding gets a row holding two action bitsets (positive and negative).
+ *
+ * Evaluation ORs rows of inputs that are down into action bitsets,
+ * so cost grows with number of held inputs and action count / 64,
+ * not with binding count. Held, pressed and released states are then
+ * derived 64 actions at a time. Axis bindings are kept in a separate
+ * flat table since they need deadzone math.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 22, 2024
+*/
+#include "media/defines.h"
+#include "media/types.h"
+#include "media/input/action.h"
+
+#if defined(MEDIA_ARCH_X86)
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define MEDIA_ACTION_SSE
+        #include <emmintrin.h>
+    #endif
+#endif
+
+/// Words of packed digital input.
+#define MEDIA_ACTION_INPUT_WORDS (6)
+/// Bits of packed digital input.
+#define MEDIA_ACTION_INPUT_BITS  (MEDIA_ACTION_INPUT_WORDS * 64)
+
+#define MEDIA_ACTION_WORD_KEYS      (0)
+#define MEDIA_ACTION_WORD_SCANCODES (2)
+#define MEDIA_ACTION_WORD_GAMEPAD   (4)
+#define MEDIA_ACTION_WORD_MOUSE     (5)
+
+struct MediaActionAxis {
+    uint16_t action;
+    uint8_t  gamepad;
+    uint8_t  axis;
+    /// 1 or -1.
+    float    sign;
+    float    deadzone;
+    /// Rescales value past deadzone to 0..1.
+    float    scale;
+};
+struct MediaActionMap {
+    uint32_t action_count;
+    uint32_t axis_count;
+    /// Words in an action bitset, always even so that SSE can process pairs.
+    uint32_t word_count;
+    uint32_t row_count;
+
+    /// Input bits that have at least one binding.
+    uint64_t bound[MEDIA_ACTION_INPUT_WORDS];
+    /// Row of every bound input bit.
+    uint16_t row_index[MEDIA_ACTION_INPUT_BITS];
+
+    /// row_count rows, positive bitset followed by negative bitset.
+    uint64_t* rows;
+    struct MediaActionAxis* axes;
+    /// Sum of axis values of every action, zero for actions without axes.
+    float*    axis_values;
+
+    /// Action bitsets, word_count words each.
+    uint64_t* positive;
+    uint64_t* negative;
+    uint64_t* axis_held;
+    uint64_t* held;
+    uint64_t* pressed;
+    uint64_t* released;
+};
+
+struct MediaActionLayout {
+    uint32_t  word_count;
+    uint32_t  row_count;
+    uint32_t  axis_count;
+    uintptr_t rows;
+    uintptr_t axes;
+    uintptr_t axis_values;
+    uintptr_t bitsets;
+    uintptr_t bitset_stride;
+    uintptr_t size;
+};
+attr_internal uintptr_t media_action_align( uintptr_t size ) {
+    return (size + 63) & ~(uintptr_t)63;
+}
+attr_internal uint32_t media_action_lowest_bit( uint64_t bits ) {
+    return (uint32_t)__builtin_ctzll( bits );
+}
+attr_internal uint32_t media_action_bit_count( uint64_t bits ) {
+    return (uint32_t)__builtin_popcountll( bits );
+}
+attr_internal _Bool media_action_binding_is_valid(
+    uint32_t action_count, const InputBinding* binding
+) {
+    if( binding->action >= action_count ) {
+        return false;
+    }
+    switch( binding->type ) {
+        case INPUT_BINDING_TYPE_KEY:
+        case INPUT_BINDING_TYPE_SCANCODE:
+            return binding->key != KB_UNKNOWN && (uint32_t)binding->key < KB_COUNT;
+        case INPUT_BINDING_TYPE_MOUSE_BUTTON:
+            return true;
+        case INPUT_BINDING_TYPE_GAMEPAD_BUTTON:
+            return
+                binding->gamepad < GAMEPAD_MAX_COUNT ||
+                binding->gamepad == INPUT_BINDING_ANY_GAMEPAD;
+        case INPUT_BINDING_TYPE_GAMEPAD_AXIS:
+            if(
+                binding->gamepad >= GAMEPAD_MAX_COUNT &&
+                binding->gamepad != INPUT_BINDING_ANY_GAMEPAD
+            ) {
+                return false;
+            }
+            // NOTE(alicia): negated comparison also rejects NaN.
+            return
+                (uint32_t)binding->gamepad_axis.axis < INPUT_GAMEPAD_AXIS_COUNT &&
+                (binding->gamepad_axis.deadzone >= 0.0f) &&
+                (binding->gamepad_axis.deadzone < 1.0f);
+    }
+    return false;
+}
+/// Input bits that activate digital binding.
+attr_internal void media_action_binding_bits(
+    const InputBinding* binding, uint64_t out_bits[MEDIA_ACTION_INPUT_WORDS]
+) {
+    for( uint32_t i = 0; i < MEDIA_ACTION_INPUT_WORDS; ++i ) {
+        out_bits[i] = 0;
+    }
+    switch( binding->type ) {
+        case INPUT_BINDING_TYPE_KEY:
+        case INPUT_BINDING_TYPE_SCANCODE: {
+            uint32_t word = binding->type == INPUT_BINDING_TYPE_KEY ?
+                MEDIA_ACTION_WORD_KEYS : MEDIA_ACTION_WORD_SCANCODES;
+            uint32_t bit  = (uint32_t)binding->key;
+            out_bits[word + (bit / 64)] = (uint64_t)1 << (bit % 64);
+        } break;
+        case INPUT_BINDING_TYPE_MOUSE_BUTTON: {
+            out_bits[MEDIA_ACTION_WORD_MOUSE] = (uint64_t)binding->mouse;
+        } break;
+        case INPUT_BINDING_TYPE_GAMEPAD_BUTTON: {
+            for( uint32_t gp = 0; gp < GAMEPAD_MAX_COUNT; ++gp ) {
+                if(
+                    binding->gamepad == INPUT_BINDING_ANY_GAMEPAD ||
+                    binding->gamepad == gp
+                ) {
+                    out_bits[MEDIA_ACTION_WORD_GAMEPAD] |=
+                        (uint64_t)binding->gamepad_button << (gp * 16);
+                }
+            }
+        } break;
+        case INPUT_BINDING_TYPE_GAMEPAD_AXIS:
+            break;
+    }
+}
+attr_internal _Bool media_action_layout(
+    uint32_t action_count, uint32_t binding_count,
+    const InputBinding* bindings, struct MediaActionLayout* out
+) {
+    if( !action_count || action_count > INPUT_ACTION_MAX_COUNT ) {
+        return false;
+    }
+    if( binding_count && !bindings ) {
+        return false;
+    }
+
+    uint64_t bound[MEDIA_ACTION_INPUT_WORDS] = {0};
+    out->axis_count = 0;
+    for( uint32_t i = 0; i < binding_count; ++i ) {
+        if( !media_action_binding_is_valid( action_count, bindings + i ) ) {
+            return false;
+        }
+        if( bindings[i].type == INPUT_BINDING_TYPE_GAMEPAD_AXIS ) {
+            out->axis_count++;
+            continue;
+        }
+        uint64_t bits[MEDIA_ACTION_INPUT_WORDS];
+        media_action_binding_bits( bindings + i, bits );
+        for( uint32_t w = 0; w < MEDIA_ACTION_INPUT_WORDS; ++w ) {
+            bound[w] |= bits[w];
+        }
+    }
+    out->row_count = 0;
+    for( uint32_t w = 0; w < MEDIA_ACTION_INPUT_WORDS; ++w ) {
+        out->row_count += media_action_bit_count( bound[w] );
+    }
+    out->word_count = (((action_count + 63) / 64) + 1) & ~(uint32_t)1;
+
+    uintptr_t bitset = sizeof(uint64_t) * out->word_count;
+
+    uintptr_t at = media_action_align( sizeof(struct MediaActionMap) );
+    out->rows        = at;
+    at += media_action_align( bitset * 2 * out->row_count );
+    out->axes        = at;
+    at += media_action_align( sizeof(struct MediaActionAxis) * out->axis_count );
+    out->axis_values = at;
+    at += media_action_align( sizeof(float) * action_count );
+    out->bitset_stride = media_action_align( bitset );
+    out->bitsets     = at;
+    at += out->bitset_stride * 6;
+    out->size = at;
+    return true;
+}
+attr_internal void media_action_pack_keys(
+    const KeyboardState* state, uint64_t* out_words
+) {
+    out_words[0] = 0;
+    out_words[1] = 0;
+    for( uint32_t i = 0; i < sizeof(state->keys); ++i ) {
+        out_words[i / 8] |= (uint64_t)state->keys[i] << ((i % 8) * 8);
+    }
+}
+attr_internal void media_action_pack_snapshot(
+    const InputSnapshot* snapshot, uint64_t out_input[MEDIA_ACTION_INPUT_WORDS]
+) {
+    media_action_pack_keys( &snapshot->keys, out_input + MEDIA_ACTION_WORD_KEYS );
+    media_action_pack_keys( &snapshot->scancodes, out_input + MEDIA_ACTION_WORD_SCANCODES );
+
+    // NOTE(alicia): disconnected gamepads read as released.
+    uint64_t gamepad = 0;
+    for( uint32_t i = 0; i < GAMEPAD_MAX_COUNT; ++i ) {
+        if( snapshot->gamepad_connected & (1 << i) ) {
+            gamepad |= (uint64_t)snapshot->gamepads[i].buttons << (i * 16);
+        }
+    }
+    out_input[MEDIA_ACTION_WORD_GAMEPAD] = gamepad;
+    out_input[MEDIA_ACTION_WORD_MOUSE]   = snapshot->mouse;
+}
+/// Normalized axes of every gamepad, disconnected gamepads read as centered.
+attr_internal void media_action_read_axes(
+    const InputSnapshot* snapshot,
+    float out_axes[GAMEPAD_MAX_COUNT][INPUT_GAMEPAD_AXIS_COUNT]
+) {
+    for( uint32_t i = 0; i < GAMEPAD_MAX_COUNT; ++i ) {
+        float* axes = out_axes[i];
+        if( !(snapshot->gamepad_connected & (1 << i)) ) {
+            for( uint32_t axis = 0; axis < INPUT_GAMEPAD_AXIS_COUNT; ++axis ) {
+                axes[axis] = 0.0f;
+            }
+            continue;
+        }
+        const GamepadState* gp = snapshot->gamepads + i;
+        axes[INPUT_GAMEPAD_AXIS_STICK_LEFT_X]  = (float)gp->stick_left_x  / 32767.0f;
+        axes[INPUT_GAMEPAD_AXIS_STICK_LEFT_Y]  = (float)gp->stick_left_y  / 32767.0f;
+        axes[INPUT_GAMEPAD_AXIS_STICK_RIGHT_X] = (float)gp->stick_right_x / 32767.0f;
+        axes[INPUT_GAMEPAD_AXIS_STICK_RIGHT_Y] = (float)gp->stick_right_y / 32767.0f;
+        axes[INPUT_GAMEPAD_AXIS_TRIGGER_LEFT]  = (float)gp->trigger_left  / 255.0f;
+        axes[INPUT_GAMEPAD_AXIS_TRIGGER_RIGHT] = (float)gp->trigger_right / 255.0f;
+        // NOTE(alicia): stick minimum is -32768.
+        for( uint32_t axis = 0; axis < INPUT_GAMEPAD_AXIS_TRIGGER_LEFT; ++axis ) {
+            axes[axis] = axes[axis] < -1.0f ? -1.0f : axes[axis];
+        }
+    }
+}
+attr_internal float media_action_axis_evaluate(
+    const struct MediaActionAxis* axis,
+    float axes[GAMEPAD_MAX_COUNT][INPUT_GAMEPAD_AXIS_COUNT]
+) {
+    float value = 0.0f;
+    if( axis->gamepad == INPUT_BINDING_ANY_GAMEPAD ) {
+        // NOTE(alicia): any gamepad binding takes furthest pushed gamepad.
+        for( uint32_t i = 0; i < GAMEPAD_MAX_COUNT; ++i ) {
+            float candidate = axes[i][axis->axis] * axis->sign;
+            value = candidate > value ? candidate : value;
+        }
+    } else {
+        value = axes[axis->gamepad][axis->axis] * axis->sign;
+    }
+    // NOTE(alicia): branchless, sticks hover around deadzone edge
+    // and mispredicts would dominate axis evaluation.
+    value = (value - axis->deadzone) * axis->scale;
+    value = value > 0.0f ? value : 0.0f;
+    return value > 1.0f ? 1.0f : value;
+}
+/// OR bitset of word_count words into destination.
+attr_internal void media_action_bitset_or(
+    uint32_t word_count, uint64_t* attr_restrict dst, const uint64_t* attr_restrict src
+) {
+#if defined(MEDIA_ACTION_SSE)
+    for( uint32_t i = 0; i < word_count; i += 2 ) {
+        __m128i a = _mm_load_si128( (const __m128i*)(dst + i) );
+        __m128i b = _mm_load_si128( (const __m128i*)(src + i) );
+        _mm_store_si128( (__m128i*)(dst + i), _mm_or_si128( a, b ) );
+    }
+#else
+    for( uint32_t i = 0; i < word_count; ++i ) {
+        dst[i] |= src[i];
+    }
+#endif
+}
+attr_internal _Bool media_action_bitset_get( const uint64_t* bitset, uint32_t bit ) {
+    return (bitset[bit / 64] >> (bit % 64)) & 1;
+}
+
+attr_media_api uintptr_t input_action_map_query_memory_requirement(
+    uint32_t action_count, uint32_t binding_count, const InputBinding* bindings
+) {
+    struct MediaActionLayout layout;
+    if( !media_action_layout( action_count, binding_count, bindings, &layout ) ) {
+        return 0;
+    }
+    return layout.size;
+}
+attr_media_api _Bool input_action_map_compile(
+    uint32_t action_count, uint32_t binding_count,
+    const InputBinding* bindings, InputActionMap* in_out_map
+) {
+    struct MediaActionLayout layout;
+    if( !media_action_layout( action_count, binding_count, bindings, &layout ) ) {
+        return false;
+    }
+
+    uint8_t* base = in_out_map;
+    memset( base, 0, layout.size );
+
+    struct MediaActionMap* map = in_out_map;
+    map->action_count = action_count;
+    map->word_count   = layout.word_count;
+    map->rows         = (uint64_t*)(base + layout.rows);
+    map->axes         = (struct MediaActionAxis*)(base + layout.axes);
+    map->axis_values  = (float*)(base + layout.axis_values);
+
+    uint64_t** bitsets[] = {
+        &map->positive, &map->negative, &map->axis_held,
+        &map->held, &map->pressed, &map->released,
+    };
+    for( uint32_t i = 0; i < sizeof(bitsets) / sizeof(bitsets[0]); ++i ) {
+        *bitsets[i] = (uint64_t*)(base + layout.bitsets + layout.bitset_stride * i);
+    }
+
+    for( uint32_t i = 0; i < binding_count; ++i ) {
+        const InputBinding* binding = bindings + i;
+
+        if( binding->type == INPUT_BINDING_TYPE_GAMEPAD_AXIS ) {
+            struct MediaActionAxis* axis = map->axes + map->axis_count++;
+            axis->action   = binding->action;
+            axis->gamepad  = binding->gamepad;
+            axis->axis     = binding->gamepad_axis.axis;
+            axis->sign     = binding->is_negative ? -1.0f : 1.0f;
+            axis->deadzone = binding->gamepad_axis.deadzone;
+            axis->scale    = 1.0f / (1.0f - axis->deadzone);
+            continue;
+        }
+
+        uint64_t bits[MEDIA_ACTION_INPUT_WORDS];
+        media_action_binding_bits( binding, bits );
+        for( uint32_t w = 0; w < MEDIA_ACTION_INPUT_WORDS; ++w ) {
+            while( bits[w] ) {
+                uint32_t bit = w * 64 + media_action_lowest_bit( bits[w] );
+                bits[w] &= bits[w] - 1;
+
+                if( !(map->bound[w] & ((uint64_t)1 << (bit % 64))) ) {
+                    map->bound[w] |= (uint64_t)1 << (bit % 64);
+                    map->row_index[bit] = (uint16_t)map->row_count++;
+                }
+                uint64_t* row =
+                    map->rows + (uintptr_t)map->row_index[bit] * map->word_count * 2;
+                if( binding->is_negative ) {
+                    row += map->word_count;
+                }
+                row[binding->action / 64] |= (uint64_t)1 << (binding->action % 64);
+            }
+        }
+    }
+    return true;
+}
+attr_media_api void input_action_map_evaluate(
+    InputActionMap* in_map, const InputSnapshot* snapshot
+) {
+    struct MediaActionMap* map = in_map;
+    uint32_t  word_count = map->word_count;
+    uintptr_t bitset     = sizeof(uint64_t) * word_count;
+
+    uint64_t input[MEDIA_ACTION_INPUT_WORDS];
+    media_action_pack_snapshot( snapshot, input );
+
+    memset( map->positive, 0, bitset );
+    memset( map->negative, 0, bitset );
+    memset( map->axis_held, 0, bitset );
+
+    // NOTE(alicia): only inputs that are down and bound are visited.
+    for( uint32_t w = 0; w < MEDIA_ACTION_INPUT_WORDS; ++w ) {
+        uint64_t bits = input[w] & map->bound[w];
+        while( bits ) {
+            uint32_t bit = w * 64 + media_action_lowest_bit( bits );
+            bits &= bits - 1;
+
+            const uint64_t* row =
+                map->rows + (uintptr_t)map->row_index[bit] * word_count * 2;
+            media_action_bitset_or( word_count, map->positive, row );
+            media_action_bitset_or( word_count, map->negative, row + word_count );
+        }
+    }
+
+    if( map->axis_count ) {
+        float axes[GAMEPAD_MAX_COUNT][INPUT_GAMEPAD_AXIS_COUNT];
+        media_action_read_axes( snapshot, axes );
+
+        for( uint32_t i = 0; i < map->axis_count; ++i ) {
+            map->axis_values[map->axes[i].action] = 0.0f;
+        }
+        for( uint32_t i = 0; i < map->axis_count; ++i ) {
+            const struct MediaActionAxis* axis = map->axes + i;
+
+            float value = media_action_axis_evaluate( axis, axes );
+            map->axis_values[axis->action]    += value * axis->sign;
+            map->axis_held[axis->action / 64] |=
+                (uint64_t)(value > 0.0f) << (axis->action % 64);
+        }
+    }
+
+    for( uint32_t i = 0; i < word_count; ++i ) {
+        uint64_t was_held = map->held[i];
+        uint64_t is_held  = map->positive[i] | map->negative[i] | map->axis_held[i];
+
+        map->held[i]     = is_held;
+        map->pressed[i]  = is_held & ~was_held;
+        map->released[i] = was_held & ~is_held;
+    }
+}
+attr_media_api InputActionState input_action_query_state(
+    const InputActionMap* in_map, uint32_t action
+) {
+    const struct MediaActionMap* map = in_map;
+    if( action >= map->action_count ) {
+        return 0;
+    }
+    InputActionState result = 0;
+    if( media_action_bitset_get( map->held, action ) ) {
+        result |= INPUT_ACTION_STATE_HELD;
+    }
+    if( media_action_bitset_get( map->pressed, action ) ) {
+        result |= INPUT_ACTION_STATE_PRESSED;
+    }
+    if( media_action_bitset_get( map->released, action ) ) {
+        result |= INPUT_ACTION_STATE_RELEASED;
+    }
+    return result;
+}
+attr_media_api float input_action_query_value(
+    const InputActionMap* in_map, uint32_t action
+) {
+    const struct MediaActionMap* map = in_map;
+    if( action >= map->action_count ) {
+        return 0.0f;
+    }
+    float value =
+        (float)media_action_bitset_get( map->positive, action ) -
+        (float)media_action_bitset_get( map->negative, action ) +
+        map->axis_values[action];
+    value = value > 1.0f ? 1.0f : value;
+    return value < -1.0f ? -1.0f : value;
+}
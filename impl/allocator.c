@@ -0,0 +1,202 @@
+/**
+ * @file   allocator.c
+ * @brief  Allocator interface implementation.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 14, 2024
+*/
+#include "media/defines.h"
+#include "media/types.h"
+#include "media/allocator.h"
+#include "media/internal/alloc.h"
+#include "media/internal/trace.h"
+
+attr_global MediaAllocator   global_media_allocator;
+attr_global MediaArena       global_media_scratch;
+// NOTE(alicia): thread that set scratch arena, only it allocates from scratch.
+// library allocates from any thread, everything else goes to heap.
+attr_global uint32_t         global_media_scratch_thread = 0;
+// NOTE(alicia): only accessed atomically.
+attr_global MediaMemoryStats global_media_memory_stats;
+
+#define stat_load( field )\
+    __atomic_load_n( &global_media_memory_stats.field, __ATOMIC_RELAXED )
+#define stat_store( field, value )\
+    __atomic_store_n( &global_media_memory_stats.field, value, __ATOMIC_RELAXED )
+#define stat_add( field, value )\
+    __atomic_add_fetch( &global_media_memory_stats.field, value, __ATOMIC_RELAXED )
+
+#define align_up( value, alignment )\
+    (((value) + ((alignment) - 1)) & ~((alignment) - 1))
+
+// NOTE(alicia): offset before push is stored in front of each allocation
+// so that pop also rewinds alignment padding.
+#define MEDIA_ARENA_HEADER_SIZE (sizeof(uintptr_t))
+
+attr_media_api void* media_arena_push(
+    MediaArena* arena, uintptr_t size, uintptr_t alignment
+) {
+    uintptr_t base   = (uintptr_t)arena->buffer;
+    uintptr_t start  = align_up(
+        base + arena->offset + MEDIA_ARENA_HEADER_SIZE, alignment ) - base;
+    uintptr_t end    = start + size;
+    if( end > arena->cap || end < start ) {
+        return NULL;
+    }
+
+    memcpy(
+        arena->buffer + start - MEDIA_ARENA_HEADER_SIZE,
+        &arena->offset, MEDIA_ARENA_HEADER_SIZE );
+    arena->offset = end;
+    if( arena->offset > arena->peak ) {
+        arena->peak = arena->offset;
+    }
+
+    void* result = arena->buffer + start;
+    memset( result, 0, size );
+    return result;
+}
+attr_media_api void media_arena_pop( MediaArena* arena, void* memory, uintptr_t size ) {
+    uint8_t* ptr = memory;
+    if( !ptr || ptr < arena->buffer + MEDIA_ARENA_HEADER_SIZE ) {
+        return;
+    }
+    uintptr_t start = (uintptr_t)(ptr - arena->buffer);
+    if( start + size != arena->offset ) {
+        return;
+    }
+
+    uintptr_t previous = 0;
+    memcpy( &previous, ptr - MEDIA_ARENA_HEADER_SIZE, MEDIA_ARENA_HEADER_SIZE );
+    if( previous > start - MEDIA_ARENA_HEADER_SIZE ) {
+        return;
+    }
+    arena->offset = previous;
+}
+
+attr_internal void* media_arena_allocator_alloc(
+    uintptr_t size, uintptr_t alignment, void* params
+) {
+    return media_arena_push( params, size, alignment );
+}
+attr_internal void media_arena_allocator_free(
+    void* memory, uintptr_t size, void* params
+) {
+    media_arena_pop( params, memory, size );
+}
+attr_media_api MediaAllocator media_arena_allocator( MediaArena* arena ) {
+    MediaAllocator result;
+    result.alloc  = media_arena_allocator_alloc;
+    result.free   = media_arena_allocator_free;
+    result.params = arena;
+    return result;
+}
+
+attr_media_api void media_lib_set_allocator( const MediaAllocator* opt_allocator ) {
+    if( opt_allocator ) {
+        global_media_allocator = *opt_allocator;
+    } else {
+        memset( &global_media_allocator, 0, sizeof(global_media_allocator) );
+    }
+}
+attr_media_api void media_lib_set_scratch( void* opt_buffer, uintptr_t size ) {
+    if( opt_buffer ) {
+        global_media_scratch = media_arena_from_buffer( opt_buffer, size );
+        global_media_scratch_thread = media_trace_platform_thread_id();
+    } else {
+        memset( &global_media_scratch, 0, sizeof(global_media_scratch) );
+        global_media_scratch_thread = 0;
+    }
+}
+attr_media_api void media_lib_query_memory_stats( MediaMemoryStats* out_stats ) {
+    out_stats->heap_alloc_count    = stat_load( heap_alloc_count );
+    out_stats->scratch_alloc_count = stat_load( scratch_alloc_count );
+    out_stats->heap_bytes          = stat_load( heap_bytes );
+    out_stats->heap_bytes_peak     = stat_load( heap_bytes_peak );
+    out_stats->scratch_bytes_peak  = global_media_scratch.peak;
+}
+attr_media_api void media_lib_reset_memory_stats(void) {
+    stat_store( heap_alloc_count, 0 );
+    stat_store( scratch_alloc_count, 0 );
+    stat_store( heap_bytes_peak, stat_load( heap_bytes ) );
+
+    global_media_scratch.peak = global_media_scratch.offset;
+}
+
+attr_internal _Bool media_scratch_is_owned( void* opt_memory ) {
+    if( !global_media_scratch.buffer ) {
+        return false;
+    }
+    if( opt_memory ) {
+        uint8_t* ptr = opt_memory;
+        if(
+            ptr <  global_media_scratch.buffer ||
+            ptr >= global_media_scratch.buffer + global_media_scratch.cap
+        ) {
+            return false;
+        }
+    }
+    return global_media_scratch_thread == media_trace_platform_thread_id();
+}
+attr_media_api void media_lib_reset_scratch(void) {
+    if( media_scratch_is_owned( NULL ) ) {
+        media_arena_reset( &global_media_scratch );
+    }
+}
+
+void* media_alloc( uintptr_t size ) {
+    void* result = NULL;
+    if( media_scratch_is_owned( NULL ) ) {
+        result = media_arena_push(
+            &global_media_scratch, size, MEDIA_ALLOCATOR_DEFAULT_ALIGNMENT );
+        if( result ) {
+            stat_add( scratch_alloc_count, 1 );
+            return result;
+        }
+    }
+
+    if( global_media_allocator.alloc ) {
+        result = global_media_allocator.alloc(
+            size, MEDIA_ALLOCATOR_DEFAULT_ALIGNMENT, global_media_allocator.params );
+    } else {
+        result = media_heap_alloc( size );
+    }
+    if( !result ) {
+        return NULL;
+    }
+
+    stat_add( heap_alloc_count, 1 );
+    uintptr_t heap_bytes = stat_add( heap_bytes, size );
+    uintptr_t peak       = stat_load( heap_bytes_peak );
+    while( heap_bytes > peak ) {
+        if( __atomic_compare_exchange_n(
+            &global_media_memory_stats.heap_bytes_peak, &peak, heap_bytes,
+            true, __ATOMIC_RELAXED, __ATOMIC_RELAXED
+        ) ) {
+            break;
+        }
+    }
+    return result;
+}
+void media_free( void* memory, uintptr_t size ) {
+    if( !memory ) {
+        return;
+    }
+
+    if( media_scratch_is_owned( memory ) ) {
+        media_arena_pop( &global_media_scratch, memory, size );
+        return;
+    }
+
+    stat_add( heap_bytes, -size );
+    if( global_media_allocator.free ) {
+        global_media_allocator.free( memory, size, global_media_allocator.params );
+    } else {
+        media_heap_free( memory, size );
+    }
+}
+
+#undef MEDIA_ARENA_HEADER_SIZE
+#undef align_up
+#undef stat_load
+#undef stat_store
+#undef stat_add
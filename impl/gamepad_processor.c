@@ -0,0 +1,509 @@
+/**
+ * @file   gamepad_processor.c
+ * @brief  Gamepad deadzones, response curves and smoothing.
+ * @details
+ * State is kept as structure of arrays, one lane per gamepad,
+ * so every stage runs once for all gamepads.
+ * Response curves are resampled into a fixed size table of
+ * base value and slope pairs at creation.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 22, 2024
+*/
+#include "media/defines.h"
+#include "media/types.h"
+#include "media/input/gamepad_processor.h"
+
+#if defined(MEDIA_ARCH_X86)
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define MEDIA_GAMEPAD_SSE
+        #include <emmintrin.h>
+    #endif
+#endif
+
+#if GAMEPAD_MAX_COUNT != 4
+    #error "gamepad processor expects one gamepad per lane of 4 wide vectors"
+#endif
+
+/// Segments in resampled response curve.
+#define MEDIA_GAMEPAD_CURVE_SEGMENTS (64)
+/// Derivative cutoff of one-euro filter in Hz.
+#define MEDIA_GAMEPAD_DERIVATIVE_CUTOFF (1.0f)
+
+#define MEDIA_GAMEPAD_PI (3.14159265358979323846f)
+
+enum MediaGamepadAxis {
+    MEDIA_GAMEPAD_AXIS_STICK_LEFT_X,
+    MEDIA_GAMEPAD_AXIS_STICK_LEFT_Y,
+    MEDIA_GAMEPAD_AXIS_STICK_RIGHT_X,
+    MEDIA_GAMEPAD_AXIS_STICK_RIGHT_Y,
+    MEDIA_GAMEPAD_AXIS_TRIGGER_LEFT,
+    MEDIA_GAMEPAD_AXIS_TRIGGER_RIGHT,
+
+    MEDIA_GAMEPAD_AXIS_COUNT
+};
+
+struct MediaGamepadCurve {
+    _Bool is_linear;
+    /// Last entry is value at 1 with zero slope so that t = 1 needs no clamp.
+    float base[MEDIA_GAMEPAD_CURVE_SEGMENTS + 4];
+    float slope[MEDIA_GAMEPAD_CURVE_SEGMENTS + 4];
+};
+struct MediaGamepadProcessor {
+    /// Axes of every gamepad, one lane per gamepad.
+    float output[MEDIA_GAMEPAD_AXIS_COUNT][GAMEPAD_MAX_COUNT];
+    /// One-euro filter state.
+    float filtered[MEDIA_GAMEPAD_AXIS_COUNT][GAMEPAD_MAX_COUNT];
+    float derivative[MEDIA_GAMEPAD_AXIS_COUNT][GAMEPAD_MAX_COUNT];
+    /// Non-zero for gamepads with filter history.
+    uint32_t has_history[GAMEPAD_MAX_COUNT];
+
+    GamepadButton buttons[GAMEPAD_MAX_COUNT];
+    uint8_t       connected;
+
+    GamepadDeadzoneType deadzone_type;
+    float stick_inner;
+    float stick_scale;
+    float trigger_inner;
+    float trigger_scale;
+    float min_cutoff;
+    float beta;
+
+    struct MediaGamepadCurve stick_curve;
+    struct MediaGamepadCurve trigger_curve;
+};
+
+#if defined(MEDIA_GAMEPAD_SSE)
+typedef __m128 MediaGamepadLanes;
+
+attr_internal MediaGamepadLanes media_gamepad_set1( float x ) {
+    return _mm_set1_ps( x );
+}
+attr_internal MediaGamepadLanes media_gamepad_load( const float* p ) {
+    return _mm_loadu_ps( p );
+}
+attr_internal void media_gamepad_store( float* p, MediaGamepadLanes a ) {
+    _mm_storeu_ps( p, a );
+}
+attr_internal MediaGamepadLanes media_gamepad_add( MediaGamepadLanes a, MediaGamepadLanes b ) {
+    return _mm_add_ps( a, b );
+}
+attr_internal MediaGamepadLanes media_gamepad_sub( MediaGamepadLanes a, MediaGamepadLanes b ) {
+    return _mm_sub_ps( a, b );
+}
+attr_internal MediaGamepadLanes media_gamepad_mul( MediaGamepadLanes a, MediaGamepadLanes b ) {
+    return _mm_mul_ps( a, b );
+}
+attr_internal MediaGamepadLanes media_gamepad_div( MediaGamepadLanes a, MediaGamepadLanes b ) {
+    return _mm_div_ps( a, b );
+}
+attr_internal MediaGamepadLanes media_gamepad_min( MediaGamepadLanes a, MediaGamepadLanes b ) {
+    return _mm_min_ps( a, b );
+}
+attr_internal MediaGamepadLanes media_gamepad_max( MediaGamepadLanes a, MediaGamepadLanes b ) {
+    return _mm_max_ps( a, b );
+}
+attr_internal MediaGamepadLanes media_gamepad_sqrt( MediaGamepadLanes a ) {
+    return _mm_sqrt_ps( a );
+}
+attr_internal MediaGamepadLanes media_gamepad_abs( MediaGamepadLanes a ) {
+    return _mm_andnot_ps( _mm_set1_ps( -0.0f ), a );
+}
+/// Lanes with non-zero mask have all bits set.
+attr_internal MediaGamepadLanes media_gamepad_load_mask( const uint32_t* p ) {
+    __m128i mask = _mm_loadu_si128( (const __m128i*)p );
+    return _mm_castsi128_ps( _mm_cmpeq_epi32(
+        _mm_cmpeq_epi32( mask, _mm_setzero_si128() ), _mm_setzero_si128() ) );
+}
+/// Copy sign of b to a.
+attr_internal MediaGamepadLanes media_gamepad_copysign( MediaGamepadLanes a, MediaGamepadLanes b ) {
+    __m128 sign = _mm_set1_ps( -0.0f );
+    return _mm_or_ps( _mm_andnot_ps( sign, a ), _mm_and_ps( sign, b ) );
+}
+/// Lanes where a > b have all bits set.
+attr_internal MediaGamepadLanes media_gamepad_greater( MediaGamepadLanes a, MediaGamepadLanes b ) {
+    return _mm_cmpgt_ps( a, b );
+}
+/// Select a where mask is set, otherwise b.
+attr_internal MediaGamepadLanes media_gamepad_select(
+    MediaGamepadLanes mask, MediaGamepadLanes a, MediaGamepadLanes b
+) {
+    return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+}
+/// Look up resampled curve, t must be in range 0..1.
+attr_internal MediaGamepadLanes media_gamepad_curve(
+    const struct MediaGamepadCurve* curve, MediaGamepadLanes t
+) {
+    __m128  f     = _mm_mul_ps( t, _mm_set1_ps( (float)MEDIA_GAMEPAD_CURVE_SEGMENTS ) );
+    __m128i index = _mm_cvttps_epi32( f );
+    __m128  frac  = _mm_sub_ps( f, _mm_cvtepi32_ps( index ) );
+
+    // NOTE(alicia): no gather in SSE2, table is small enough to stay in L1.
+    int32_t i[4];
+    _mm_storeu_si128( (__m128i*)i, index );
+    __m128 base  = _mm_setr_ps(
+        curve->base[i[0]], curve->base[i[1]], curve->base[i[2]], curve->base[i[3]] );
+    __m128 slope = _mm_setr_ps(
+        curve->slope[i[0]], curve->slope[i[1]], curve->slope[i[2]], curve->slope[i[3]] );
+    return _mm_add_ps( base, _mm_mul_ps( slope, frac ) );
+}
+#else
+typedef struct MediaGamepadLanes {
+    float v[GAMEPAD_MAX_COUNT];
+} MediaGamepadLanes;
+
+#define media_gamepad_lanes_op( expression ) \
+    MediaGamepadLanes r;\
+    for( uint32_t i = 0; i < GAMEPAD_MAX_COUNT; ++i ) {\
+        r.v[i] = expression;\
+    }\
+    return r
+
+attr_internal MediaGamepadLanes media_gamepad_set1( float x ) {
+    media_gamepad_lanes_op( x );
+}
+attr_internal MediaGamepadLanes media_gamepad_load( const float* p ) {
+    media_gamepad_lanes_op( p[i] );
+}
+attr_internal void media_gamepad_store( float* p, MediaGamepadLanes a ) {
+    for( uint32_t i = 0; i < GAMEPAD_MAX_COUNT; ++i ) {
+        p[i] = a.v[i];
+    }
+}
+attr_internal MediaGamepadLanes media_gamepad_add( MediaGamepadLanes a, MediaGamepadLanes b ) {
+    media_gamepad_lanes_op( a.v[i] + b.v[i] );
+}
+attr_internal MediaGamepadLanes media_gamepad_sub( MediaGamepadLanes a, MediaGamepadLanes b ) {
+    media_gamepad_lanes_op( a.v[i] - b.v[i] );
+}
+attr_internal MediaGamepadLanes media_gamepad_mul( MediaGamepadLanes a, MediaGamepadLanes b ) {
+    media_gamepad_lanes_op( a.v[i] * b.v[i] );
+}
+attr_internal MediaGamepadLanes media_gamepad_div( MediaGamepadLanes a, MediaGamepadLanes b ) {
+    media_gamepad_lanes_op( a.v[i] / b.v[i] );
+}
+attr_internal MediaGamepadLanes media_gamepad_min( MediaGamepadLanes a, MediaGamepadLanes b ) {
+    media_gamepad_lanes_op( a.v[i] < b.v[i] ? a.v[i] : b.v[i] );
+}
+attr_internal MediaGamepadLanes media_gamepad_max( MediaGamepadLanes a, MediaGamepadLanes b ) {
+    media_gamepad_lanes_op( a.v[i] > b.v[i] ? a.v[i] : b.v[i] );
+}
+attr_internal float media_gamepad_sqrt_scalar( float x ) {
+    if( x <= 0.0f ) {
+        return 0.0f;
+    }
+    union { float f; uint32_t u; } bits = { .f = x };
+    bits.u = 0x1FBD1DF5 + (bits.u >> 1);
+    float y = bits.f;
+    y = 0.5f * (y + x / y);
+    y = 0.5f * (y + x / y);
+    y = 0.5f * (y + x / y);
+    return y;
+}
+attr_internal MediaGamepadLanes media_gamepad_sqrt( MediaGamepadLanes a ) {
+    media_gamepad_lanes_op( media_gamepad_sqrt_scalar( a.v[i] ) );
+}
+attr_internal MediaGamepadLanes media_gamepad_abs( MediaGamepadLanes a ) {
+    media_gamepad_lanes_op( a.v[i] < 0.0f ? -a.v[i] : a.v[i] );
+}
+attr_internal MediaGamepadLanes media_gamepad_load_mask( const uint32_t* p ) {
+    media_gamepad_lanes_op( p[i] ? 1.0f : 0.0f );
+}
+attr_internal MediaGamepadLanes media_gamepad_copysign( MediaGamepadLanes a, MediaGamepadLanes b ) {
+    media_gamepad_lanes_op(
+        (b.v[i] < 0.0f) != (a.v[i] < 0.0f) ? -a.v[i] : a.v[i] );
+}
+attr_internal MediaGamepadLanes media_gamepad_greater( MediaGamepadLanes a, MediaGamepadLanes b ) {
+    media_gamepad_lanes_op( a.v[i] > b.v[i] ? 1.0f : 0.0f );
+}
+attr_internal MediaGamepadLanes media_gamepad_select(
+    MediaGamepadLanes mask, MediaGamepadLanes a, MediaGamepadLanes b
+) {
+    media_gamepad_lanes_op( mask.v[i] != 0.0f ? a.v[i] : b.v[i] );
+}
+attr_internal MediaGamepadLanes media_gamepad_curve(
+    const struct MediaGamepadCurve* curve, MediaGamepadLanes t
+) {
+    MediaGamepadLanes r;
+    for( uint32_t i = 0; i < GAMEPAD_MAX_COUNT; ++i ) {
+        float    f     = t.v[i] * (float)MEDIA_GAMEPAD_CURVE_SEGMENTS;
+        uint32_t index = (uint32_t)f;
+        r.v[i] = curve->base[index] + curve->slope[index] * (f - (float)index);
+    }
+    return r;
+}
+
+#undef media_gamepad_lanes_op
+#endif
+
+attr_internal _Bool media_gamepad_is_unit( float x ) {
+    // NOTE(alicia): negated comparison also rejects NaN.
+    return x >= 0.0f && x <= 1.0f;
+}
+attr_internal _Bool media_gamepad_curve_is_valid( const GamepadCurve* curve ) {
+    if( !curve->point_count ) {
+        return true;
+    }
+    if(
+        curve->point_count < 2 ||
+        curve->point_count > GAMEPAD_CURVE_MAX_POINTS ||
+        !curve->points
+    ) {
+        return false;
+    }
+    for( uint32_t i = 0; i < curve->point_count; ++i ) {
+        if( !media_gamepad_is_unit( curve->points[i] ) ) {
+            return false;
+        }
+    }
+    return true;
+}
+attr_internal void media_gamepad_curve_resample(
+    const GamepadCurve* curve, struct MediaGamepadCurve* out
+) {
+    float values[MEDIA_GAMEPAD_CURVE_SEGMENTS + 1];
+    out->is_linear = curve->point_count == 0;
+    for( uint32_t i = 0; i <= MEDIA_GAMEPAD_CURVE_SEGMENTS; ++i ) {
+        float t = (float)i / (float)MEDIA_GAMEPAD_CURVE_SEGMENTS;
+        if( out->is_linear ) {
+            values[i] = t;
+            continue;
+        }
+        float    f     = t * (float)(curve->point_count - 1);
+        uint32_t index = (uint32_t)f;
+        if( index >= curve->point_count - 1 ) {
+            values[i] = curve->points[curve->point_count - 1];
+            continue;
+        }
+        float frac = f - (float)index;
+        values[i]  = curve->points[index] +
+            (curve->points[index + 1] - curve->points[index]) * frac;
+    }
+    memset( out->base, 0, sizeof(out->base) );
+    memset( out->slope, 0, sizeof(out->slope) );
+    for( uint32_t i = 0; i < MEDIA_GAMEPAD_CURVE_SEGMENTS; ++i ) {
+        out->base[i]  = values[i];
+        out->slope[i] = values[i + 1] - values[i];
+    }
+    out->base[MEDIA_GAMEPAD_CURVE_SEGMENTS] = values[MEDIA_GAMEPAD_CURVE_SEGMENTS];
+}
+/// Deadzone scale, maps inner..outer to 0..1.
+attr_internal float media_gamepad_deadzone_scale( float inner, float outer ) {
+    if( outer == 0.0f ) {
+        outer = 1.0f;
+    }
+    return 1.0f / (outer - inner);
+}
+/// Remap magnitude past deadzone to 0..1 and apply response curve.
+attr_internal MediaGamepadLanes media_gamepad_response(
+    const struct MediaGamepadCurve* curve, float inner, float scale,
+    MediaGamepadLanes magnitude
+) {
+    MediaGamepadLanes t = media_gamepad_mul(
+        media_gamepad_sub( magnitude, media_gamepad_set1( inner ) ),
+        media_gamepad_set1( scale ) );
+    t = media_gamepad_min(
+        media_gamepad_max( t, media_gamepad_set1( 0.0f ) ), media_gamepad_set1( 1.0f ) );
+    if( curve->is_linear ) {
+        return t;
+    }
+    return media_gamepad_curve( curve, t );
+}
+attr_internal void media_gamepad_stick(
+    struct MediaGamepadProcessor* gp, float* x_lanes, float* y_lanes,
+    const float* raw_x, const float* raw_y
+) {
+    MediaGamepadLanes x = media_gamepad_load( raw_x );
+    MediaGamepadLanes y = media_gamepad_load( raw_y );
+
+    if( gp->deadzone_type == GAMEPAD_DEADZONE_TYPE_AXIAL ) {
+        x = media_gamepad_copysign( media_gamepad_response(
+            &gp->stick_curve, gp->stick_inner, gp->stick_scale,
+            media_gamepad_abs( x ) ), x );
+        y = media_gamepad_copysign( media_gamepad_response(
+            &gp->stick_curve, gp->stick_inner, gp->stick_scale,
+            media_gamepad_abs( y ) ), y );
+    } else {
+        MediaGamepadLanes magnitude = media_gamepad_sqrt(
+            media_gamepad_add( media_gamepad_mul( x, x ), media_gamepad_mul( y, y ) ) );
+        MediaGamepadLanes response = media_gamepad_response(
+            &gp->stick_curve, gp->stick_inner, gp->stick_scale, magnitude );
+
+        // NOTE(alicia): keep direction, replace magnitude.
+        MediaGamepadLanes is_moved =
+            media_gamepad_greater( magnitude, media_gamepad_set1( 1e-6f ) );
+        MediaGamepadLanes scale = media_gamepad_select(
+            is_moved,
+            media_gamepad_div( response,
+                media_gamepad_max( magnitude, media_gamepad_set1( 1e-6f ) ) ),
+            media_gamepad_set1( 0.0f ) );
+        x = media_gamepad_mul( x, scale );
+        y = media_gamepad_mul( y, scale );
+    }
+    media_gamepad_store( x_lanes, x );
+    media_gamepad_store( y_lanes, y );
+}
+/// One-euro filter, https://gery.casiez.net/1euro/
+attr_internal void media_gamepad_smooth(
+    struct MediaGamepadProcessor* gp, float (*in_out_axes)[GAMEPAD_MAX_COUNT],
+    float delta_seconds
+) {
+    MediaGamepadLanes has_history = media_gamepad_load_mask( gp->has_history );
+    MediaGamepadLanes one  = media_gamepad_set1( 1.0f );
+    MediaGamepadLanes rate = media_gamepad_set1( 1.0f / delta_seconds );
+    MediaGamepadLanes tau  = media_gamepad_set1( 2.0f * MEDIA_GAMEPAD_PI * delta_seconds );
+
+    // NOTE(alicia): alpha = r / (r + 1) where r = 2 pi cutoff dt.
+    float derivative_r = 2.0f * MEDIA_GAMEPAD_PI *
+        MEDIA_GAMEPAD_DERIVATIVE_CUTOFF * delta_seconds;
+    MediaGamepadLanes derivative_alpha =
+        media_gamepad_set1( derivative_r / (derivative_r + 1.0f) );
+
+    for( uint32_t axis = 0; axis < MEDIA_GAMEPAD_AXIS_COUNT; ++axis ) {
+        MediaGamepadLanes x          = media_gamepad_load( in_out_axes[axis] );
+        MediaGamepadLanes previous   = media_gamepad_load( gp->filtered[axis] );
+        MediaGamepadLanes derivative = media_gamepad_load( gp->derivative[axis] );
+
+        MediaGamepadLanes dx = media_gamepad_mul( media_gamepad_sub( x, previous ), rate );
+        derivative = media_gamepad_add( derivative,
+            media_gamepad_mul( derivative_alpha, media_gamepad_sub( dx, derivative ) ) );
+
+        MediaGamepadLanes cutoff = media_gamepad_add(
+            media_gamepad_set1( gp->min_cutoff ),
+            media_gamepad_mul( media_gamepad_set1( gp->beta ), media_gamepad_abs( derivative ) ) );
+        MediaGamepadLanes r     = media_gamepad_mul( tau, cutoff );
+        MediaGamepadLanes alpha = media_gamepad_div( r, media_gamepad_add( r, one ) );
+
+        MediaGamepadLanes filtered = media_gamepad_add( previous,
+            media_gamepad_mul( alpha, media_gamepad_sub( x, previous ) ) );
+
+        // NOTE(alicia): first sample after connecting starts filter.
+        filtered   = media_gamepad_select( has_history, filtered, x );
+        derivative = media_gamepad_select( has_history, derivative, media_gamepad_set1( 0.0f ) );
+
+        media_gamepad_store( gp->filtered[axis], filtered );
+        media_gamepad_store( gp->derivative[axis], derivative );
+        media_gamepad_store( in_out_axes[axis], filtered );
+    }
+}
+
+attr_media_api uintptr_t gamepad_processor_query_memory_requirement(void) {
+    return sizeof(struct MediaGamepadProcessor);
+}
+attr_media_api _Bool gamepad_processor_create(
+    const GamepadProcessorDesc* desc, GamepadProcessor* in_out_processor
+) {
+    float stick_outer   = desc->stick_deadzone_outer == 0.0f ? 1.0f : desc->stick_deadzone_outer;
+    float trigger_outer = desc->trigger_deadzone_outer == 0.0f ? 1.0f : desc->trigger_deadzone_outer;
+    if(
+        (uint32_t)desc->stick_deadzone_type > GAMEPAD_DEADZONE_TYPE_AXIAL ||
+        !media_gamepad_is_unit( desc->stick_deadzone_inner ) ||
+        !media_gamepad_is_unit( stick_outer ) ||
+        !(desc->stick_deadzone_inner < stick_outer) ||
+        !media_gamepad_is_unit( desc->trigger_deadzone_inner ) ||
+        !media_gamepad_is_unit( trigger_outer ) ||
+        !(desc->trigger_deadzone_inner < trigger_outer) ||
+        !media_gamepad_curve_is_valid( &desc->stick_curve ) ||
+        !media_gamepad_curve_is_valid( &desc->trigger_curve ) ||
+        !(desc->smoothing_min_cutoff >= 0.0f) ||
+        !(desc->smoothing_beta >= 0.0f)
+    ) {
+        return false;
+    }
+
+    struct MediaGamepadProcessor* gp = in_out_processor;
+    memset( gp, 0, sizeof(*gp) );
+
+    gp->deadzone_type = desc->stick_deadzone_type;
+    gp->stick_inner   = desc->stick_deadzone_inner;
+    gp->stick_scale   = media_gamepad_deadzone_scale(
+        desc->stick_deadzone_inner, desc->stick_deadzone_outer );
+    gp->trigger_inner = desc->trigger_deadzone_inner;
+    gp->trigger_scale = media_gamepad_deadzone_scale(
+        desc->trigger_deadzone_inner, desc->trigger_deadzone_outer );
+    gp->min_cutoff    = desc->smoothing_min_cutoff;
+    gp->beta          = desc->smoothing_beta;
+
+    media_gamepad_curve_resample( &desc->stick_curve, &gp->stick_curve );
+    media_gamepad_curve_resample( &desc->trigger_curve, &gp->trigger_curve );
+    return true;
+}
+attr_media_api void gamepad_processor_update(
+    GamepadProcessor* processor, uint8_t connected,
+    const GamepadState* states, float delta_seconds
+) {
+    struct MediaGamepadProcessor* gp = processor;
+    gp->connected = connected;
+
+    float axes[MEDIA_GAMEPAD_AXIS_COUNT][GAMEPAD_MAX_COUNT];
+    for( uint32_t i = 0; i < GAMEPAD_MAX_COUNT; ++i ) {
+        if( !(connected & (1 << i)) ) {
+            for( uint32_t axis = 0; axis < MEDIA_GAMEPAD_AXIS_COUNT; ++axis ) {
+                axes[axis][i] = 0.0f;
+            }
+            gp->buttons[i]     = 0;
+            gp->has_history[i] = 0;
+            continue;
+        }
+        const GamepadState* state = states + i;
+        gp->buttons[i] = state->buttons;
+        axes[MEDIA_GAMEPAD_AXIS_STICK_LEFT_X][i]   = (float)state->stick_left_x;
+        axes[MEDIA_GAMEPAD_AXIS_STICK_LEFT_Y][i]   = (float)state->stick_left_y;
+        axes[MEDIA_GAMEPAD_AXIS_STICK_RIGHT_X][i]  = (float)state->stick_right_x;
+        axes[MEDIA_GAMEPAD_AXIS_STICK_RIGHT_Y][i]  = (float)state->stick_right_y;
+        axes[MEDIA_GAMEPAD_AXIS_TRIGGER_LEFT][i]   = (float)state->trigger_left;
+        axes[MEDIA_GAMEPAD_AXIS_TRIGGER_RIGHT][i]  = (float)state->trigger_right;
+    }
+
+    // NOTE(alicia): normalize, stick minimum is -32768.
+    MediaGamepadLanes stick_scale   = media_gamepad_set1( 1.0f / 32767.0f );
+    MediaGamepadLanes trigger_scale = media_gamepad_set1( 1.0f / 255.0f );
+    for( uint32_t axis = 0; axis < MEDIA_GAMEPAD_AXIS_TRIGGER_LEFT; ++axis ) {
+        media_gamepad_store( axes[axis], media_gamepad_max(
+            media_gamepad_mul( media_gamepad_load( axes[axis] ), stick_scale ),
+            media_gamepad_set1( -1.0f ) ) );
+    }
+    for( uint32_t axis = MEDIA_GAMEPAD_AXIS_TRIGGER_LEFT; axis < MEDIA_GAMEPAD_AXIS_COUNT; ++axis ) {
+        media_gamepad_store( axes[axis],
+            media_gamepad_mul( media_gamepad_load( axes[axis] ), trigger_scale ) );
+    }
+
+    if( gp->min_cutoff > 0.0f && delta_seconds > 0.0f ) {
+        media_gamepad_smooth( gp, axes, delta_seconds );
+        for( uint32_t i = 0; i < GAMEPAD_MAX_COUNT; ++i ) {
+            gp->has_history[i] = (connected & (1 << i)) != 0;
+        }
+    }
+
+    media_gamepad_stick( gp,
+        gp->output[MEDIA_GAMEPAD_AXIS_STICK_LEFT_X],
+        gp->output[MEDIA_GAMEPAD_AXIS_STICK_LEFT_Y],
+        axes[MEDIA_GAMEPAD_AXIS_STICK_LEFT_X],
+        axes[MEDIA_GAMEPAD_AXIS_STICK_LEFT_Y] );
+    media_gamepad_stick( gp,
+        gp->output[MEDIA_GAMEPAD_AXIS_STICK_RIGHT_X],
+        gp->output[MEDIA_GAMEPAD_AXIS_STICK_RIGHT_Y],
+        axes[MEDIA_GAMEPAD_AXIS_STICK_RIGHT_X],
+        axes[MEDIA_GAMEPAD_AXIS_STICK_RIGHT_Y] );
+    for( uint32_t axis = MEDIA_GAMEPAD_AXIS_TRIGGER_LEFT; axis < MEDIA_GAMEPAD_AXIS_COUNT; ++axis ) {
+        media_gamepad_store( gp->output[axis], media_gamepad_response(
+            &gp->trigger_curve, gp->trigger_inner, gp->trigger_scale,
+            media_gamepad_load( axes[axis] ) ) );
+    }
+}
+attr_media_api _Bool gamepad_processor_query_state(
+    const GamepadProcessor* processor, uint32_t index,
+    GamepadProcessedState* out_state
+) {
+    const struct MediaGamepadProcessor* gp = processor;
+    if( index >= GAMEPAD_MAX_COUNT || !(gp->connected & (1 << index)) ) {
+        return false;
+    }
+    out_state->buttons       = gp->buttons[index];
+    out_state->stick_left_x  = gp->output[MEDIA_GAMEPAD_AXIS_STICK_LEFT_X][index];
+    out_state->stick_left_y  = gp->output[MEDIA_GAMEPAD_AXIS_STICK_LEFT_Y][index];
+    out_state->stick_right_x = gp->output[MEDIA_GAMEPAD_AXIS_STICK_RIGHT_X][index];
+    out_state->stick_right_y = gp->output[MEDIA_GAMEPAD_AXIS_STICK_RIGHT_Y][index];
+    out_state->trigger_left  = gp->output[MEDIA_GAMEPAD_AXIS_TRIGGER_LEFT][index];
+    out_state->trigger_right = gp->output[MEDIA_GAMEPAD_AXIS_TRIGGER_RIGHT][index];
+    return true;
+}
@@ -7,6 +7,7 @@
 #include "media/defines.h"
 #include "media/types.h"
 #include "media/lib.h"
+#include "media/internal/logging.h"
 
 #if !defined(MEDIA_LIB_VERSION_MAJOR)
     #define MEDIA_LIB_VERSION_MAJOR 0
@@ -21,10 +22,37 @@
     #warning "MEDIA_LIB_VERSION_PATCH is undefined!"
 #endif
 
+#if !defined(MEDIA_LOG_RING_CAP)
+    /// @brief Number of deferred log messages. Must be a power of two.
+    #define MEDIA_LOG_RING_CAP (256)
+#endif
+
+#define MEDIA_LOG_FORMAT_BUFFER_CAP (512)
+
 #if defined(MEDIA_ENABLE_LOGGING)
+struct MediaLogRecord {
+    uint64_t    sequence;
+    const char* format;
+    uint32_t    format_len;
+    uint16_t    level;
+    uint16_t    argc;
+    uint64_t    args[MEDIA_LOG_ARG_CAP];
+};
+// NOTE(alicia): bounded multi-producer queue, each record's sequence
+// tells producers and consumer whose turn it is to touch it.
+struct MediaLogRing {
+    uint64_t tail;
+    uint64_t head;
+    uint32_t dropped;
+    uint32_t is_flushing;
+    struct MediaLogRecord records[MEDIA_LOG_RING_CAP];
+};
+
     attr_global MediaLoggingLevel global_media_logging_level = MEDIA_LOGGING_LEVEL_NONE;
     attr_global MediaLoggingCallbackFN* global_media_logging_callback = 0;
     attr_global void* global_media_logging_callback_params            = 0;
+    attr_global _Bool global_media_logging_is_deferred                = false;
+    attr_global struct MediaLogRing global_media_log_ring;
 #endif
 
 extern const char   external_media_library_command_line[];
@@ -64,17 +92,240 @@ attr_media_api void media_lib_set_logging_callback(
 #define validate( level )\
 ( global_media_logging_level ? ( global_media_logging_level >= (level) ) : false )
 
+#if defined(MEDIA_ENABLE_LOGGING)
+
+attr_internal uint32_t media_log_format_u64(
+    uint32_t cap, char* buffer, uint64_t value, uint64_t base
+) {
+    char digits[24];
+    uint32_t at = sizeof(digits);
+    do {
+        uint64_t digit = value % base;
+        digits[--at]   = digit < 10 ? '0' + digit : 'A' + (digit - 10);
+        value /= base;
+    } while( value );
+
+    uint32_t len = sizeof(digits) - at;
+    if( len > cap ) {
+        len = cap;
+    }
+    memcpy( buffer, digits + at, len );
+    return len;
+}
+attr_internal uint32_t media_log_format(
+    uint32_t cap, char* buffer, uint32_t format_len, const char* format,
+    uint32_t argc, const uint64_t* args
+) {
+    uint32_t len = 0;
+    uint32_t arg = 0;
+    for( uint32_t i = 0; i < format_len && len < cap; ++i ) {
+        char c = format[i];
+        if( c != '%' || i + 1 >= format_len ) {
+            buffer[len++] = c;
+            continue;
+        }
+        char spec = format[++i];
+        switch( spec ) {
+            case 'u':
+            case 'i':
+            case 'x':
+            case 's':
+            case 'e': break;
+            case '%': {
+                buffer[len++] = '%';
+            } continue;
+            default: {
+                buffer[len++] = '%';
+                if( len < cap ) {
+                    buffer[len++] = spec;
+                }
+            } continue;
+        }
+        if( arg >= argc ) {
+            buffer[len++] = '?';
+            continue;
+        }
+        uint64_t value = args[arg++];
+        switch( spec ) {
+            case 'u': {
+                len += media_log_format_u64( cap - len, buffer + len, value, 10 );
+            } break;
+            case 'i': {
+                int64_t signed_value = (int64_t)value;
+                if( signed_value < 0 ) {
+                    buffer[len++] = '-';
+                    value = (uint64_t)0 - value;
+                }
+                len += media_log_format_u64( cap - len, buffer + len, value, 10 );
+            } break;
+            case 'x': {
+                if( len + 2 <= cap ) {
+                    buffer[len++] = '0';
+                    buffer[len++] = 'x';
+                }
+                len += media_log_format_u64( cap - len, buffer + len, value, 16 );
+            } break;
+            case 's': {
+                const char* string = (const char*)(uintptr_t)value;
+                if( !string ) {
+                    string = "(null)";
+                }
+                while( *string && len < cap ) {
+                    buffer[len++] = *string++;
+                }
+            } break;
+            case 'e': {
+                len += media_log_platform_error_text( value, cap - len, buffer + len );
+            } break;
+        }
+    }
+    return len;
+}
+attr_internal void media_log_deliver(
+    MediaLoggingLevel level, uint32_t format_len, const char* format,
+    uint32_t argc, const uint64_t* args
+) {
+    if( !argc ) {
+        global_media_logging_callback(
+            level, format_len, format, global_media_logging_callback_params );
+        return;
+    }
+
+    char buffer[MEDIA_LOG_FORMAT_BUFFER_CAP];
+    uint32_t len = media_log_format(
+        sizeof(buffer), buffer, format_len, format, argc, args );
+    global_media_logging_callback(
+        level, len, buffer, global_media_logging_callback_params );
+}
+attr_internal void media_log_ring_reset(void) {
+    struct MediaLogRing* ring = &global_media_log_ring;
+    ring->tail = 0;
+    ring->head = 0;
+    for( uint64_t i = 0; i < MEDIA_LOG_RING_CAP; ++i ) {
+        ring->records[i].sequence = i;
+    }
+}
+attr_internal void media_log_ring_push(
+    MediaLoggingLevel level, uint32_t format_len, const char* format,
+    uint32_t argc, const uint64_t* args
+) {
+    struct MediaLogRing* ring = &global_media_log_ring;
+    struct MediaLogRecord* record = NULL;
+
+    uint64_t pos = __atomic_load_n( &ring->tail, __ATOMIC_RELAXED );
+    for( ;; ) {
+        record = ring->records + (pos & (MEDIA_LOG_RING_CAP - 1));
+        uint64_t sequence = __atomic_load_n( &record->sequence, __ATOMIC_ACQUIRE );
+        int64_t  diff     = (int64_t)sequence - (int64_t)pos;
+        if( !diff ) {
+            if( __atomic_compare_exchange_n(
+                &ring->tail, &pos, pos + 1, true,
+                __ATOMIC_RELAXED, __ATOMIC_RELAXED
+            ) ) {
+                break;
+            }
+        } else if( diff < 0 ) {
+            __atomic_fetch_add( &ring->dropped, 1, __ATOMIC_RELAXED );
+            return;
+        } else {
+            pos = __atomic_load_n( &ring->tail, __ATOMIC_RELAXED );
+        }
+    }
+
+    record->format     = format;
+    record->format_len = format_len;
+    record->level      = level;
+    record->argc       = argc;
+    for( uint32_t i = 0; i < argc; ++i ) {
+        record->args[i] = args[i];
+    }
+
+    __atomic_store_n( &record->sequence, pos + 1, __ATOMIC_RELEASE );
+}
+
+#endif /* MEDIA_ENABLE_LOGGING */
+
 void media_log( MediaLoggingLevel level, uint32_t len, const char* message ) {
-    unused(level, len, message);
+    media_log_args( level, len, message, 0, NULL );
+}
+void media_log_args(
+    MediaLoggingLevel level, uint32_t format_len, const char* format,
+    uint32_t argc, const uint64_t* args
+) {
+    unused(level, format_len, format, argc, args);
 #if defined(MEDIA_ENABLE_LOGGING)
     if( !(validate(level) && global_media_logging_callback) ) {
         return;
     }
+    if( argc > MEDIA_LOG_ARG_CAP ) {
+        argc = MEDIA_LOG_ARG_CAP;
+    }
 
-    global_media_logging_callback(
-        level, len, message, global_media_logging_callback_params );
+    if( global_media_logging_is_deferred ) {
+        media_log_ring_push( level, format_len, format, argc, args );
+    } else {
+        media_log_deliver( level, format_len, format, argc, args );
+    }
 #endif
 }
 
-#undef validate
+attr_media_api void media_lib_set_logging_deferred( _Bool is_deferred ) {
+    unused(is_deferred);
+#if defined(MEDIA_ENABLE_LOGGING)
+    if( is_deferred == global_media_logging_is_deferred ) {
+        return;
+    }
+    if( is_deferred ) {
+        media_log_ring_reset();
+        global_media_logging_is_deferred = true;
+    } else {
+        global_media_logging_is_deferred = false;
+        media_lib_flush_logging();
+    }
+#endif
+}
+attr_media_api uint32_t media_lib_flush_logging(void) {
+#if defined(MEDIA_ENABLE_LOGGING)
+    struct MediaLogRing* ring = &global_media_log_ring;
+    if( __atomic_exchange_n( &ring->is_flushing, 1, __ATOMIC_ACQUIRE ) ) {
+        return 0;
+    }
+
+    uint32_t count = 0;
+    for( ;; ) {
+        uint64_t pos = ring->head;
+        struct MediaLogRecord* record =
+            ring->records + (pos & (MEDIA_LOG_RING_CAP - 1));
+        uint64_t sequence = __atomic_load_n( &record->sequence, __ATOMIC_ACQUIRE );
+        if( sequence != pos + 1 ) {
+            break;
+        }
+
+        struct MediaLogRecord copy = *record;
+        __atomic_store_n(
+            &record->sequence, pos + MEDIA_LOG_RING_CAP, __ATOMIC_RELEASE );
+        ring->head = pos + 1;
+
+        if( global_media_logging_callback ) {
+            media_log_deliver(
+                copy.level, copy.format_len, copy.format, copy.argc, copy.args );
+            count++;
+        }
+    }
+
+    __atomic_store_n( &ring->is_flushing, 0, __ATOMIC_RELEASE );
+    return count;
+#else
+    return 0;
+#endif
+}
+attr_media_api uint32_t media_lib_query_logging_dropped(void) {
+#if defined(MEDIA_ENABLE_LOGGING)
+    return __atomic_load_n( &global_media_log_ring.dropped, __ATOMIC_RELAXED );
+#else
+    return 0;
+#endif
+}
 
+#undef validate
+#undef MEDIA_LOG_FORMAT_BUFFER_CAP
@@ -12,16 +12,23 @@
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 
+#include "impl/win32/common.h"
+
 BOOL WINAPI DllMainCRTStartup(
     HINSTANCE const instance,
     DWORD     const reason,
     LPVOID    const reserved
 ) {
-    unused( instance, reserved );
+    unused( instance );
     switch( reason ) {
         case DLL_PROCESS_ATTACH: {
         } break;
         case DLL_PROCESS_DETACH: {
+            // NOTE(alicia): library is unloaded while process keeps running,
+            // thread state callbacks must not outlive it.
+            if( !reserved ) {
+                win32_thread_state_shutdown();
+            }
         } break;
         case DLL_THREAD_ATTACH: break;
         case DLL_THREAD_DETACH: break;
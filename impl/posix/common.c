@@ -0,0 +1,98 @@
+/**
+ * @file   common.c
+ * @brief  Media POSIX fallbacks.
+ * @details
+ * Platform functions required by headless subsystems
+ * (allocator, time, trace and logging) on platforms
+ * that do not have a platform layer yet.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 23, 2024
+*/
+#include "media/defines.h"
+#if !defined(MEDIA_PLATFORM_WINDOWS)
+#include "media/types.h"
+#include "media/time.h"
+#include "media/internal/alloc.h"
+#include "media/internal/logging.h"
+#include "media/internal/trace.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+void* media_heap_alloc( uintptr_t size ) {
+    return calloc( 1, size );
+}
+void media_heap_free( void* memory, uintptr_t size ) {
+    unused( size );
+    free( memory );
+}
+
+attr_media_api uint64_t media_time_ns(void) {
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ((uint64_t)ts.tv_sec * MEDIA_TIME_NS_PER_SECOND) + (uint64_t)ts.tv_nsec;
+}
+attr_media_api uint64_t media_time_sleep_until_ns( uint64_t deadline_ns ) {
+    struct timespec ts;
+    ts.tv_sec  = deadline_ns / MEDIA_TIME_NS_PER_SECOND;
+    ts.tv_nsec = deadline_ns % MEDIA_TIME_NS_PER_SECOND;
+    while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL ) ) {}
+    return media_time_ns();
+}
+
+// NOTE(alicia): key destructor returns trace ring when thread exits.
+attr_global pthread_once_t global_posix_trace_once = PTHREAD_ONCE_INIT;
+attr_global pthread_key_t  global_posix_trace_key;
+attr_global _Bool          global_posix_trace_key_valid = false;
+
+attr_internal void posix_trace_ring_free( void* ring ) {
+#if defined(MEDIA_ENABLE_TRACE)
+    media_trace_ring_release( ring );
+#else
+    unused( ring );
+#endif
+}
+attr_internal void posix_trace_key_create(void) {
+    global_posix_trace_key_valid =
+        pthread_key_create( &global_posix_trace_key, posix_trace_ring_free ) == 0;
+}
+
+// NOTE(alicia): libc provides thread local storage on this platform.
+attr_global uint32_t global_posix_thread_id_next = 0;
+attr_global _Thread_local uint32_t global_posix_thread_id = 0;
+
+uint32_t media_trace_platform_thread_id(void) {
+    if( !global_posix_thread_id ) {
+        global_posix_thread_id = __atomic_add_fetch(
+            &global_posix_thread_id_next, 1, __ATOMIC_RELAXED );
+    }
+    return global_posix_thread_id;
+}
+void* media_trace_platform_ring(void) {
+    pthread_once( &global_posix_trace_once, posix_trace_key_create );
+    if( !global_posix_trace_key_valid ) {
+        return NULL;
+    }
+    return pthread_getspecific( global_posix_trace_key );
+}
+_Bool media_trace_platform_set_ring( void* ring ) {
+    pthread_once( &global_posix_trace_once, posix_trace_key_create );
+    if( !global_posix_trace_key_valid ) {
+        return false;
+    }
+    return pthread_setspecific( global_posix_trace_key, ring ) == 0;
+}
+
+uint32_t media_log_platform_error_text( uint64_t code, uint32_t cap, char* buffer ) {
+    const char* text = strerror( (int)code );
+    uint32_t len = (uint32_t)strlen( text );
+    if( len > cap ) {
+        len = cap;
+    }
+    memcpy( buffer, text, len );
+    return len;
+}
+
+#endif /* !Platform Windows */
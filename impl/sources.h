@@ -6,8 +6,20 @@
 */
 #include "media/defines.h"
 
+#if !defined(MEDIA_PLATFORM_WINDOWS) && !defined(_POSIX_C_SOURCE)
+    // NOTE(alicia): required for clock_gettime and friends in posix/common.c.
+    #define _POSIX_C_SOURCE 200809L
+#endif
+
 #include "impl/cstdlib.c"
 #include "impl/lib.c"
+#include "impl/allocator.c"
+#include "impl/unicode.c"
+#include "impl/time.c"
+#include "impl/trace.c"
+#include "impl/spatial.c"
+#include "impl/action.c"
+#include "impl/gamepad_processor.c"
 
 #if !defined(MEDIA_ENABLE_STATIC_BUILD)
     #include "impl/platform_sharedmain.c"
@@ -15,10 +27,16 @@
 
 #if defined(MEDIA_PLATFORM_WINDOWS)
     #include "impl/win32/common.c"
+    #include "impl/win32/time.c"
     #include "impl/win32/prompt.c"
     #include "impl/win32/surface.c"
+    #include "impl/win32/display.c"
     #include "impl/win32/input.c"
     #include "impl/win32/opengl.c"
+    #include "impl/win32/vulkan.c"
     #include "impl/win32/audio.c"
+#else
+    // NOTE(alicia): only headless subsystems until platform layer exists.
+    #include "impl/posix/common.c"
 #endif
 
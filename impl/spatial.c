@@ -0,0 +1,827 @@
+/**
+ * @file   spatial.c
+ * @brief  3D positional audio with HRTF convolution.
+ * @details
+ * Every voice runs uniformly partitioned overlap-save convolution:
+ * impulse responses are split into blocks of AUDIO_SPATIALIZER_BLOCK_SIZE
+ * taps and transformed once at creation. Each block, voice input is
+ * transformed once and multiplied with every partition against
+ * a frequency domain delay line, so cost grows with partition count
+ * instead of impulse response length.
+ *
+ * Spectra are stored as separate real and imaginary arrays with
+ * Nyquist bin packed into imaginary part of DC bin.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 20, 2024
+*/
+#include "media/defines.h"
+#include "media/types.h"
+#include "media/spatial.h"
+
+#if defined(MEDIA_ARCH_X86)
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define MEDIA_SPATIAL_SSE
+        #include <emmintrin.h>
+    #endif
+#endif
+
+/// Frames per block.
+#define MEDIA_SPATIAL_B (AUDIO_SPATIALIZER_BLOCK_SIZE)
+/// Real FFT size.
+#define MEDIA_SPATIAL_N (MEDIA_SPATIAL_B * 2)
+/// Complex FFT size and number of packed spectrum bins.
+#define MEDIA_SPATIAL_M (MEDIA_SPATIAL_B)
+/// Floats in one packed spectrum (real then imaginary).
+#define MEDIA_SPATIAL_SPECTRUM (MEDIA_SPATIAL_M * 2)
+
+#define MEDIA_SPATIAL_PI (3.14159265358979323846)
+
+struct MediaSpatialVoice {
+    const float* samples;
+    uint32_t     sample_count;
+    uint32_t     samples_per_second;
+    double       cursor;
+
+    float gain;
+    float min_distance;
+    float max_distance;
+    float rolloff;
+    float position[3];
+    float velocity[3];
+
+    /// Gain applied at end of last block, ramped towards new gain.
+    float    last_gain;
+    /// Impulse response used last block.
+    uint32_t direction;
+    uint32_t delay_line_head;
+    /// Blocks left to flush impulse response tail after source ended.
+    uint32_t tail;
+    uint16_t generation;
+    _Bool    loop;
+    _Bool    is_playing;
+    _Bool    is_first_block;
+
+    /// Previous input block, first half of overlap-save window.
+    float* history;
+    /// Frequency domain delay line, partition_count spectra.
+    float* delay_line;
+};
+struct MediaSpatializer {
+    uint32_t samples_per_second;
+    uint32_t voice_cap;
+    uint32_t partition_count;
+    uint32_t direction_count;
+    float    speed_of_sound;
+
+    struct AudioSpatializerListener listener;
+    float    listener_right[3];
+
+    /// direction_count * 3 floats.
+    float* directions;
+    /// direction_count * 2 ears * partition_count spectra.
+    float* responses;
+    struct MediaSpatialVoice* voices;
+
+    /// Offset of each stage's twiddles in stage_twiddle arrays,
+    /// stage with half size h starts at h - 1.
+    float stage_twiddle_re[MEDIA_SPATIAL_M];
+    float stage_twiddle_im[MEDIA_SPATIAL_M];
+    /// e^(-2 pi i k / N)
+    float real_twiddle_re[MEDIA_SPATIAL_M];
+    float real_twiddle_im[MEDIA_SPATIAL_M];
+    uint8_t bit_reverse[MEDIA_SPATIAL_M];
+
+    float window[MEDIA_SPATIAL_N];
+    float input[MEDIA_SPATIAL_SPECTRUM];
+    float left[MEDIA_SPATIAL_SPECTRUM];
+    float right[MEDIA_SPATIAL_SPECTRUM];
+    float left_time[MEDIA_SPATIAL_N];
+    float right_time[MEDIA_SPATIAL_N];
+    float fade_left[MEDIA_SPATIAL_N];
+    float fade_right[MEDIA_SPATIAL_N];
+
+    /// Rendered block that has not been written to a buffer yet.
+    float    mix_left[MEDIA_SPATIAL_B];
+    float    mix_right[MEDIA_SPATIAL_B];
+    uint32_t mix_offset;
+};
+
+attr_internal float media_spatial_sqrt( float x ) {
+#if defined(MEDIA_SPATIAL_SSE)
+    return _mm_cvtss_f32( _mm_sqrt_ss( _mm_set_ss( x ) ) );
+#else
+    if( x <= 0.0f ) {
+        return 0.0f;
+    }
+    union { float f; uint32_t u; } bits = { .f = x };
+    bits.u = 0x1FBD1DF5 + (bits.u >> 1);
+    float y = bits.f;
+    y = 0.5f * (y + x / y);
+    y = 0.5f * (y + x / y);
+    y = 0.5f * (y + x / y);
+    return y;
+#endif
+}
+/// Sine and cosine of 2 pi * turns, for building twiddle tables.
+attr_internal void media_spatial_sincos( double turns, double* out_sin, double* out_cos ) {
+    turns -= (double)(int64_t)turns;
+    if( turns < 0.0 ) {
+        turns += 1.0;
+    }
+    // NOTE(alicia): reduce to [-1/8, 1/8] turn where Taylor series converges quickly.
+    uint32_t quadrant = (uint32_t)(turns * 4.0 + 0.5);
+    double   x        = (turns - (double)quadrant * 0.25) * 2.0 * MEDIA_SPATIAL_PI;
+    double   x2       = x * x;
+
+    double s = x, c = 1.0, term_s = x, term_c = 1.0;
+    for( uint32_t i = 1; i < 12; ++i ) {
+        term_s *= -x2 / (double)((2 * i) * (2 * i + 1));
+        term_c *= -x2 / (double)((2 * i - 1) * (2 * i));
+        s += term_s;
+        c += term_c;
+    }
+
+    switch( quadrant & 3 ) {
+        case 0: *out_sin =  s; *out_cos =  c; break;
+        case 1: *out_sin =  c; *out_cos = -s; break;
+        case 2: *out_sin = -s; *out_cos = -c; break;
+        case 3: *out_sin = -c; *out_cos =  s; break;
+    }
+}
+
+attr_internal void media_spatial_tables_init( struct MediaSpatializer* sp ) {
+    uint32_t bits = 0;
+    while( (1u << bits) < MEDIA_SPATIAL_M ) {
+        bits++;
+    }
+    for( uint32_t i = 0; i < MEDIA_SPATIAL_M; ++i ) {
+        uint32_t r = 0;
+        for( uint32_t b = 0; b < bits; ++b ) {
+            r |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        sp->bit_reverse[i] = (uint8_t)r;
+    }
+
+    for( uint32_t k = 0; k < MEDIA_SPATIAL_M; ++k ) {
+        double s, c;
+        media_spatial_sincos( (double)k / (double)MEDIA_SPATIAL_N, &s, &c );
+        sp->real_twiddle_re[k] = (float)c;
+        sp->real_twiddle_im[k] = (float)-s;
+    }
+
+    for( uint32_t half = 1; half < MEDIA_SPATIAL_M; half *= 2 ) {
+        for( uint32_t j = 0; j < half; ++j ) {
+            double s, c;
+            media_spatial_sincos( (double)j / (double)(half * 2), &s, &c );
+            sp->stage_twiddle_re[half - 1 + j] = (float)c;
+            sp->stage_twiddle_im[half - 1 + j] = (float)-s;
+        }
+    }
+}
+/// Forward complex FFT of size M on bit reversed input.
+attr_internal void media_spatial_fft_butterflies(
+    const struct MediaSpatializer* sp, float* re, float* im
+) {
+    for( uint32_t half = 1; half < MEDIA_SPATIAL_M; half *= 2 ) {
+        const float* wr = sp->stage_twiddle_re + (half - 1);
+        const float* wi = sp->stage_twiddle_im + (half - 1);
+        for( uint32_t k = 0; k < MEDIA_SPATIAL_M; k += half * 2 ) {
+            float* ar = re + k;
+            float* ai = im + k;
+            float* br = re + k + half;
+            float* bi = im + k + half;
+            uint32_t j = 0;
+#if defined(MEDIA_SPATIAL_SSE)
+            for( ; j + 4 <= half; j += 4 ) {
+                __m128 twr = _mm_loadu_ps( wr + j );
+                __m128 twi = _mm_loadu_ps( wi + j );
+                __m128 xr  = _mm_loadu_ps( br + j );
+                __m128 xi  = _mm_loadu_ps( bi + j );
+                __m128 tr  = _mm_sub_ps( _mm_mul_ps( xr, twr ), _mm_mul_ps( xi, twi ) );
+                __m128 ti  = _mm_add_ps( _mm_mul_ps( xr, twi ), _mm_mul_ps( xi, twr ) );
+                __m128 yr  = _mm_loadu_ps( ar + j );
+                __m128 yi  = _mm_loadu_ps( ai + j );
+                _mm_storeu_ps( ar + j, _mm_add_ps( yr, tr ) );
+                _mm_storeu_ps( ai + j, _mm_add_ps( yi, ti ) );
+                _mm_storeu_ps( br + j, _mm_sub_ps( yr, tr ) );
+                _mm_storeu_ps( bi + j, _mm_sub_ps( yi, ti ) );
+            }
+#endif
+            for( ; j < half; ++j ) {
+                float tr = br[j] * wr[j] - bi[j] * wi[j];
+                float ti = br[j] * wi[j] + bi[j] * wr[j];
+                br[j] = ar[j] - tr;
+                bi[j] = ai[j] - ti;
+                ar[j] = ar[j] + tr;
+                ai[j] = ai[j] + ti;
+            }
+        }
+    }
+}
+/// Real FFT of N samples into packed spectrum.
+attr_internal void media_spatial_rfft(
+    const struct MediaSpatializer* sp, const float* x, float* out
+) {
+    float* re = out;
+    float* im = out + MEDIA_SPATIAL_M;
+    for( uint32_t n = 0; n < MEDIA_SPATIAL_M; ++n ) {
+        uint32_t r = sp->bit_reverse[n];
+        re[r] = x[2 * n];
+        im[r] = x[2 * n + 1];
+    }
+    media_spatial_fft_butterflies( sp, re, im );
+
+    // NOTE(alicia): split spectrum of even/odd samples packed
+    // as complex signal into spectrum of real signal.
+    float z0r = re[0], z0i = im[0];
+    re[0] = z0r + z0i;
+    im[0] = z0r - z0i;
+    for( uint32_t k = 1; k <= MEDIA_SPATIAL_M / 2; ++k ) {
+        uint32_t kc = MEDIA_SPATIAL_M - k;
+        float ar = re[k],  ai = im[k];
+        float br = re[kc], bi = -im[kc];
+
+        float er = 0.5f * (ar + br);
+        float ei = 0.5f * (ai + bi);
+        // -i * (a - b) / 2
+        float dr = 0.5f * (ai - bi);
+        float di = -0.5f * (ar - br);
+
+        float wr = sp->real_twiddle_re[k], wi = sp->real_twiddle_im[k];
+        float orr = dr * wr - di * wi;
+        float oi  = dr * wi + di * wr;
+
+        re[k]  = er + orr;
+        im[k]  = ei + oi;
+        re[kc] = er - orr;
+        im[kc] = -(ei - oi);
+    }
+}
+/// Inverse real FFT of packed spectrum, result is scaled by N.
+attr_internal void media_spatial_irfft(
+    const struct MediaSpatializer* sp, const float* in, float* out_x, float* scratch
+) {
+    const float* xr = in;
+    const float* xi = in + MEDIA_SPATIAL_M;
+    float* re = scratch;
+    float* im = scratch + MEDIA_SPATIAL_M;
+
+    // NOTE(alicia): imaginary parts are negated on the way in and out
+    // so forward butterflies compute inverse transform.
+    re[sp->bit_reverse[0]] = xr[0] + xi[0];
+    im[sp->bit_reverse[0]] = -(xr[0] - xi[0]);
+    for( uint32_t k = 1; k <= MEDIA_SPATIAL_M / 2; ++k ) {
+        uint32_t kc = MEDIA_SPATIAL_M - k;
+        float ar = xr[k],  ai = xi[k];
+        float br = xr[kc], bi = -xi[kc];
+
+        float sr = ar + br, si = ai + bi;
+        float tr = ar - br, ti = ai - bi;
+        // i * conj(w) * t
+        float wr = sp->real_twiddle_re[k], wi = -sp->real_twiddle_im[k];
+        float ur = tr * wr - ti * wi;
+        float ui = tr * wi + ti * wr;
+        float dr = -ui, di = ur;
+
+        re[sp->bit_reverse[k]]  = sr + dr;
+        im[sp->bit_reverse[k]]  = -(si + di);
+        re[sp->bit_reverse[kc]] = sr - dr;
+        im[sp->bit_reverse[kc]] = si - di;
+    }
+    media_spatial_fft_butterflies( sp, re, im );
+
+    for( uint32_t n = 0; n < MEDIA_SPATIAL_M; ++n ) {
+        out_x[2 * n]     = re[n];
+        out_x[2 * n + 1] = -im[n];
+    }
+}
+/// Multiply input spectrum with both ears of one partition and accumulate.
+attr_internal void media_spatial_multiply_accumulate(
+    const float* x, const float* hl, const float* hr, float* yl, float* yr
+) {
+    const float* x_re  = x;
+    const float* x_im  = x + MEDIA_SPATIAL_M;
+    const float* hl_re = hl;
+    const float* hl_im = hl + MEDIA_SPATIAL_M;
+    const float* hr_re = hr;
+    const float* hr_im = hr + MEDIA_SPATIAL_M;
+    float* yl_re = yl;
+    float* yl_im = yl + MEDIA_SPATIAL_M;
+    float* yr_re = yr;
+    float* yr_im = yr + MEDIA_SPATIAL_M;
+
+    // NOTE(alicia): DC and Nyquist are both real and packed in bin 0.
+    float dc_l = yl_re[0] + x_re[0] * hl_re[0];
+    float ny_l = yl_im[0] + x_im[0] * hl_im[0];
+    float dc_r = yr_re[0] + x_re[0] * hr_re[0];
+    float ny_r = yr_im[0] + x_im[0] * hr_im[0];
+
+    uint32_t k = 0;
+#if defined(MEDIA_SPATIAL_SSE)
+    for( ; k + 4 <= MEDIA_SPATIAL_M; k += 4 ) {
+        __m128 ar = _mm_loadu_ps( x_re + k );
+        __m128 ai = _mm_loadu_ps( x_im + k );
+
+        __m128 br = _mm_loadu_ps( hl_re + k );
+        __m128 bi = _mm_loadu_ps( hl_im + k );
+        __m128 cr = _mm_sub_ps( _mm_mul_ps( ar, br ), _mm_mul_ps( ai, bi ) );
+        __m128 ci = _mm_add_ps( _mm_mul_ps( ar, bi ), _mm_mul_ps( ai, br ) );
+        _mm_storeu_ps( yl_re + k, _mm_add_ps( _mm_loadu_ps( yl_re + k ), cr ) );
+        _mm_storeu_ps( yl_im + k, _mm_add_ps( _mm_loadu_ps( yl_im + k ), ci ) );
+
+        br = _mm_loadu_ps( hr_re + k );
+        bi = _mm_loadu_ps( hr_im + k );
+        cr = _mm_sub_ps( _mm_mul_ps( ar, br ), _mm_mul_ps( ai, bi ) );
+        ci = _mm_add_ps( _mm_mul_ps( ar, bi ), _mm_mul_ps( ai, br ) );
+        _mm_storeu_ps( yr_re + k, _mm_add_ps( _mm_loadu_ps( yr_re + k ), cr ) );
+        _mm_storeu_ps( yr_im + k, _mm_add_ps( _mm_loadu_ps( yr_im + k ), ci ) );
+    }
+#endif
+    for( ; k < MEDIA_SPATIAL_M; ++k ) {
+        float ar = x_re[k], ai = x_im[k];
+        yl_re[k] += ar * hl_re[k] - ai * hl_im[k];
+        yl_im[k] += ar * hl_im[k] + ai * hl_re[k];
+        yr_re[k] += ar * hr_re[k] - ai * hr_im[k];
+        yr_im[k] += ar * hr_im[k] + ai * hr_re[k];
+    }
+
+    yl_re[0] = dc_l;
+    yl_im[0] = ny_l;
+    yr_re[0] = dc_r;
+    yr_im[0] = ny_r;
+}
+
+/// Byte offsets of spatializer arrays, shared by memory query and create.
+struct MediaSpatialLayout {
+    uintptr_t directions;
+    uintptr_t responses;
+    uintptr_t voices;
+    uintptr_t voice_data;
+    uintptr_t voice_data_stride;
+    uintptr_t size;
+};
+attr_internal uintptr_t media_spatial_align( uintptr_t size ) {
+    return (size + 63) & ~(uintptr_t)63;
+}
+attr_internal uint32_t media_spatial_partition_count( uint32_t length ) {
+    return (length + MEDIA_SPATIAL_B - 1) / MEDIA_SPATIAL_B;
+}
+attr_internal _Bool media_spatial_layout(
+    const struct AudioSpatializerDesc* desc, struct MediaSpatialLayout* out
+) {
+    if(
+        !desc->voice_cap || desc->voice_cap > 0xFFFF ||
+        !desc->hrtf.length || !desc->hrtf.direction_count ||
+        !desc->hrtf.directions || !desc->hrtf.impulse_responses ||
+        !desc->samples_per_second
+    ) {
+        return false;
+    }
+    uintptr_t partitions = media_spatial_partition_count( desc->hrtf.length );
+    uintptr_t spectrum   = sizeof(float) * MEDIA_SPATIAL_SPECTRUM;
+
+    uintptr_t at = media_spatial_align( sizeof(struct MediaSpatializer) );
+    out->directions = at;
+    at += media_spatial_align( sizeof(float) * 3 * desc->hrtf.direction_count );
+    out->responses  = at;
+    at += media_spatial_align( spectrum * 2 * partitions * desc->hrtf.direction_count );
+    out->voices     = at;
+    at += media_spatial_align( sizeof(struct MediaSpatialVoice) * desc->voice_cap );
+    out->voice_data_stride =
+        media_spatial_align( sizeof(float) * MEDIA_SPATIAL_B + spectrum * partitions );
+    out->voice_data = at;
+    at += out->voice_data_stride * desc->voice_cap;
+    out->size = at;
+    return true;
+}
+
+attr_media_api uintptr_t audio_spatializer_query_memory_requirement(
+    const struct AudioSpatializerDesc* desc
+) {
+    struct MediaSpatialLayout layout;
+    if( !media_spatial_layout( desc, &layout ) ) {
+        return 0;
+    }
+    return layout.size;
+}
+attr_media_api _Bool audio_spatializer_create(
+    const struct AudioSpatializerDesc* desc, AudioSpatializer* in_out_spatializer
+) {
+    struct MediaSpatialLayout layout;
+    if( !media_spatial_layout( desc, &layout ) ) {
+        return false;
+    }
+    uint8_t* base = in_out_spatializer;
+    memset( base, 0, layout.size );
+
+    struct MediaSpatializer* sp = in_out_spatializer;
+    sp->samples_per_second = desc->samples_per_second;
+    sp->voice_cap          = desc->voice_cap;
+    sp->partition_count    = media_spatial_partition_count( desc->hrtf.length );
+    sp->direction_count    = desc->hrtf.direction_count;
+    sp->speed_of_sound     = desc->speed_of_sound > 0.0f ?
+        desc->speed_of_sound : AUDIO_SPATIALIZER_DEFAULT_SPEED_OF_SOUND;
+    sp->directions = (float*)(base + layout.directions);
+    sp->responses  = (float*)(base + layout.responses);
+    sp->voices     = (struct MediaSpatialVoice*)(base + layout.voices);
+    sp->mix_offset = MEDIA_SPATIAL_B;
+
+    sp->listener.forward[2] = 1.0f;
+    sp->listener.up[1]      = 1.0f;
+    sp->listener_right[0]   = 1.0f;
+
+    media_spatial_tables_init( sp );
+
+    memcpy( sp->directions, desc->hrtf.directions,
+        sizeof(float) * 3 * desc->hrtf.direction_count );
+
+    // NOTE(alicia): inverse transform is scaled by N,
+    // fold normalization into impulse response spectra.
+    float scale = 1.0f / (float)MEDIA_SPATIAL_N;
+    uint32_t length = desc->hrtf.length;
+    float* spectrum = sp->responses;
+    for( uint32_t d = 0; d < sp->direction_count; ++d ) {
+        for( uint32_t ear = 0; ear < 2; ++ear ) {
+            const float* ir =
+                desc->hrtf.impulse_responses + ((uintptr_t)d * 2 + ear) * length;
+            for( uint32_t p = 0; p < sp->partition_count; ++p ) {
+                memset( sp->window, 0, sizeof(sp->window) );
+                for( uint32_t i = 0; i < MEDIA_SPATIAL_B; ++i ) {
+                    uint32_t tap = p * MEDIA_SPATIAL_B + i;
+                    if( tap >= length ) {
+                        break;
+                    }
+                    sp->window[i] = ir[tap] * scale;
+                }
+                media_spatial_rfft( sp, sp->window, spectrum );
+                spectrum += MEDIA_SPATIAL_SPECTRUM;
+            }
+        }
+    }
+
+    for( uint32_t v = 0; v < sp->voice_cap; ++v ) {
+        struct MediaSpatialVoice* voice = sp->voices + v;
+        float* data = (float*)(base + layout.voice_data + layout.voice_data_stride * v);
+        voice->history    = data;
+        voice->delay_line = data + MEDIA_SPATIAL_B;
+    }
+    memset( sp->window, 0, sizeof(sp->window) );
+
+    return true;
+}
+attr_media_api void audio_spatializer_set_listener(
+    AudioSpatializer* in_spatializer, const struct AudioSpatializerListener* listener
+) {
+    struct MediaSpatializer* sp = in_spatializer;
+    sp->listener = *listener;
+
+    const float* f = listener->forward;
+    const float* u = listener->up;
+    sp->listener_right[0] = f[1] * u[2] - f[2] * u[1];
+    sp->listener_right[1] = f[2] * u[0] - f[0] * u[2];
+    sp->listener_right[2] = f[0] * u[1] - f[1] * u[0];
+}
+
+attr_internal struct MediaSpatialVoice* media_spatial_voice_from_handle(
+    struct MediaSpatializer* sp, uint32_t handle
+) {
+    uint32_t index = handle & 0xFFFF;
+    if( handle == AUDIO_SPATIALIZER_VOICE_INVALID || index >= sp->voice_cap ) {
+        return NULL;
+    }
+    struct MediaSpatialVoice* voice = sp->voices + index;
+    if( !voice->is_playing || voice->generation != (handle >> 16) ) {
+        return NULL;
+    }
+    return voice;
+}
+attr_media_api uint32_t audio_spatializer_voice_play(
+    AudioSpatializer* in_spatializer, const struct AudioSpatializerSource* source
+) {
+    struct MediaSpatializer* sp = in_spatializer;
+    if( !source->samples || !source->sample_count || !source->samples_per_second ) {
+        return AUDIO_SPATIALIZER_VOICE_INVALID;
+    }
+    for( uint32_t v = 0; v < sp->voice_cap; ++v ) {
+        struct MediaSpatialVoice* voice = sp->voices + v;
+        if( voice->is_playing ) {
+            continue;
+        }
+
+        voice->samples            = source->samples;
+        voice->sample_count       = source->sample_count;
+        voice->samples_per_second = source->samples_per_second;
+        voice->cursor             = 0.0;
+        voice->loop               = source->loop;
+        voice->gain               = source->gain;
+        voice->min_distance       = source->min_distance > 0.0f ? source->min_distance : 1.0f;
+        voice->max_distance       = source->max_distance;
+        voice->rolloff            = source->rolloff;
+        memcpy( voice->position, source->position, sizeof(voice->position) );
+        memcpy( voice->velocity, source->velocity, sizeof(voice->velocity) );
+
+        voice->last_gain       = 0.0f;
+        voice->delay_line_head = 0;
+        voice->tail            = 0;
+        voice->is_first_block  = true;
+        voice->is_playing      = true;
+        voice->generation++;
+
+        memset( voice->history, 0, sizeof(float) * MEDIA_SPATIAL_B );
+        memset( voice->delay_line, 0,
+            sizeof(float) * MEDIA_SPATIAL_SPECTRUM * sp->partition_count );
+
+        return ((uint32_t)voice->generation << 16) | v;
+    }
+    return AUDIO_SPATIALIZER_VOICE_INVALID;
+}
+attr_media_api void audio_spatializer_voice_set_position(
+    AudioSpatializer* in_spatializer, uint32_t handle,
+    const float position[3], const float velocity[3]
+) {
+    struct MediaSpatialVoice* voice = media_spatial_voice_from_handle( in_spatializer, handle );
+    if( !voice ) {
+        return;
+    }
+    memcpy( voice->position, position, sizeof(voice->position) );
+    memcpy( voice->velocity, velocity, sizeof(voice->velocity) );
+}
+attr_media_api void audio_spatializer_voice_stop(
+    AudioSpatializer* in_spatializer, uint32_t handle
+) {
+    struct MediaSpatialVoice* voice = media_spatial_voice_from_handle( in_spatializer, handle );
+    if( voice ) {
+        voice->is_playing = false;
+    }
+}
+attr_media_api _Bool audio_spatializer_voice_is_playing(
+    AudioSpatializer* in_spatializer, uint32_t handle
+) {
+    return media_spatial_voice_from_handle( in_spatializer, handle ) != NULL;
+}
+
+/// Read next source sample with linear interpolation.
+attr_internal float media_spatial_voice_read( struct MediaSpatialVoice* voice, double step ) {
+    if( voice->tail ) {
+        return 0.0f;
+    }
+    uint32_t i0   = (uint32_t)voice->cursor;
+    float    frac = (float)(voice->cursor - (double)i0);
+    uint32_t i1   = i0 + 1;
+    float    s0   = voice->samples[i0];
+    float    s1   = 0.0f;
+    if( i1 < voice->sample_count ) {
+        s1 = voice->samples[i1];
+    } else if( voice->loop ) {
+        s1 = voice->samples[0];
+    }
+
+    voice->cursor += step;
+    if( voice->cursor >= (double)voice->sample_count ) {
+        if( voice->loop ) {
+            while( voice->cursor >= (double)voice->sample_count ) {
+                voice->cursor -= (double)voice->sample_count;
+            }
+        } else {
+            // NOTE(alicia): keep rendering silence until every
+            // partition has convolved last input block.
+            voice->tail = 1;
+        }
+    }
+    return s0 + (s1 - s0) * frac;
+}
+attr_internal uint32_t media_spatial_nearest_direction(
+    const struct MediaSpatializer* sp, const float dir[3]
+) {
+    uint32_t best     = 0;
+    float    best_dot = -2.0f;
+    const float* d = sp->directions;
+    for( uint32_t i = 0; i < sp->direction_count; ++i, d += 3 ) {
+        float dot = d[0] * dir[0] + d[1] * dir[1] + d[2] * dir[2];
+        if( dot > best_dot ) {
+            best_dot = dot;
+            best     = i;
+        }
+    }
+    return best;
+}
+/// Accumulate delay line against one direction's responses
+/// and transform back to time domain.
+attr_internal void media_spatial_convolve(
+    struct MediaSpatializer* sp, struct MediaSpatialVoice* voice, uint32_t direction
+) {
+    memset( sp->left, 0, sizeof(sp->left) );
+    memset( sp->right, 0, sizeof(sp->right) );
+
+    uint32_t partitions = sp->partition_count;
+    const float* left_responses = sp->responses +
+        (uintptr_t)direction * 2 * partitions * MEDIA_SPATIAL_SPECTRUM;
+    const float* right_responses = left_responses +
+        (uintptr_t)partitions * MEDIA_SPATIAL_SPECTRUM;
+
+    uint32_t slot = voice->delay_line_head;
+    for( uint32_t p = 0; p < partitions; ++p ) {
+        media_spatial_multiply_accumulate(
+            voice->delay_line + (uintptr_t)slot * MEDIA_SPATIAL_SPECTRUM,
+            left_responses  + (uintptr_t)p * MEDIA_SPATIAL_SPECTRUM,
+            right_responses + (uintptr_t)p * MEDIA_SPATIAL_SPECTRUM,
+            sp->left, sp->right );
+        slot = slot ? slot - 1 : partitions - 1;
+    }
+
+    media_spatial_irfft( sp, sp->left, sp->left_time, sp->input );
+    media_spatial_irfft( sp, sp->right, sp->right_time, sp->input );
+}
+attr_internal void media_spatial_voice_render(
+    struct MediaSpatializer* sp, struct MediaSpatialVoice* voice
+) {
+    const struct AudioSpatializerListener* listener = &sp->listener;
+
+    float rel[3];
+    for( uint32_t i = 0; i < 3; ++i ) {
+        rel[i] = voice->position[i] - listener->position[i];
+    }
+    float distance = media_spatial_sqrt(
+        rel[0] * rel[0] + rel[1] * rel[1] + rel[2] * rel[2] );
+
+    float local[3] = { 0.0f, 0.0f, 1.0f };
+    float pitch    = 1.0f;
+    if( distance > 1e-6f ) {
+        local[0] =
+            rel[0] * sp->listener_right[0] + rel[1] * sp->listener_right[1] +
+            rel[2] * sp->listener_right[2];
+        local[1] =
+            rel[0] * listener->up[0] + rel[1] * listener->up[1] + rel[2] * listener->up[2];
+        local[2] =
+            rel[0] * listener->forward[0] + rel[1] * listener->forward[1] +
+            rel[2] * listener->forward[2];
+
+        // NOTE(alicia): velocities projected on source to listener axis,
+        // positive when moving towards listener side.
+        float c   = sp->speed_of_sound;
+        float vls = -(
+            listener->velocity[0] * rel[0] + listener->velocity[1] * rel[1] +
+            listener->velocity[2] * rel[2] ) / distance;
+        float vss = -(
+            voice->velocity[0] * rel[0] + voice->velocity[1] * rel[1] +
+            voice->velocity[2] * rel[2] ) / distance;
+        if( vls > c * 0.95f ) {
+            vls = c * 0.95f;
+        }
+        if( vss > c * 0.95f ) {
+            vss = c * 0.95f;
+        }
+        pitch = (c - vls) / (c - vss);
+        if( pitch < 0.25f ) {
+            pitch = 0.25f;
+        } else if( pitch > 4.0f ) {
+            pitch = 4.0f;
+        }
+    }
+
+    float clamped = distance;
+    if( clamped < voice->min_distance ) {
+        clamped = voice->min_distance;
+    }
+    if( voice->max_distance > 0.0f && clamped > voice->max_distance ) {
+        clamped = voice->max_distance;
+    }
+    float gain = voice->gain * voice->min_distance /
+        (voice->min_distance + voice->rolloff * (clamped - voice->min_distance));
+
+    uint32_t direction = media_spatial_nearest_direction( sp, local );
+    if( voice->is_first_block ) {
+        voice->direction      = direction;
+        voice->last_gain      = gain;
+        voice->is_first_block = false;
+    }
+
+    double step = (double)pitch *
+        (double)voice->samples_per_second / (double)sp->samples_per_second;
+
+    // NOTE(alicia): overlap-save window is previous block followed by new block.
+    float* window = sp->window;
+    memcpy( window, voice->history, sizeof(float) * MEDIA_SPATIAL_B );
+    float gain_step = (gain - voice->last_gain) / (float)MEDIA_SPATIAL_B;
+    float g = voice->last_gain;
+    for( uint32_t i = 0; i < MEDIA_SPATIAL_B; ++i ) {
+        g += gain_step;
+        window[MEDIA_SPATIAL_B + i] = media_spatial_voice_read( voice, step ) * g;
+    }
+    voice->last_gain = gain;
+    memcpy( voice->history, window + MEDIA_SPATIAL_B, sizeof(float) * MEDIA_SPATIAL_B );
+
+    voice->delay_line_head = (voice->delay_line_head + 1) % sp->partition_count;
+    media_spatial_rfft( sp, window,
+        voice->delay_line + (uintptr_t)voice->delay_line_head * MEDIA_SPATIAL_SPECTRUM );
+
+    if( direction != voice->direction ) {
+        // NOTE(alicia): crossfade from previous response so direction
+        // changes do not click.
+        media_spatial_convolve( sp, voice, voice->direction );
+        memcpy( sp->fade_left, sp->left_time, sizeof(sp->fade_left) );
+        memcpy( sp->fade_right, sp->right_time, sizeof(sp->fade_right) );
+        media_spatial_convolve( sp, voice, direction );
+
+        float t_step = 1.0f / (float)MEDIA_SPATIAL_B;
+        float t = 0.0f;
+        for( uint32_t i = 0; i < MEDIA_SPATIAL_B; ++i ) {
+            t += t_step;
+            uint32_t at = MEDIA_SPATIAL_B + i;
+            sp->mix_left[i] +=
+                sp->fade_left[at] + (sp->left_time[at] - sp->fade_left[at]) * t;
+            sp->mix_right[i] +=
+                sp->fade_right[at] + (sp->right_time[at] - sp->fade_right[at]) * t;
+        }
+        voice->direction = direction;
+    } else {
+        media_spatial_convolve( sp, voice, direction );
+        for( uint32_t i = 0; i < MEDIA_SPATIAL_B; ++i ) {
+            sp->mix_left[i]  += sp->left_time[MEDIA_SPATIAL_B + i];
+            sp->mix_right[i] += sp->right_time[MEDIA_SPATIAL_B + i];
+        }
+    }
+
+    if( voice->tail ) {
+        if( voice->tail > sp->partition_count ) {
+            voice->is_playing = false;
+        }
+        voice->tail++;
+    }
+}
+attr_internal void media_spatial_render_block( struct MediaSpatializer* sp ) {
+    memset( sp->mix_left, 0, sizeof(sp->mix_left) );
+    memset( sp->mix_right, 0, sizeof(sp->mix_right) );
+    for( uint32_t v = 0; v < sp->voice_cap; ++v ) {
+        struct MediaSpatialVoice* voice = sp->voices + v;
+        if( voice->is_playing ) {
+            media_spatial_voice_render( sp, voice );
+        }
+    }
+    sp->mix_offset = 0;
+}
+attr_media_api void audio_spatializer_render(
+    AudioSpatializer* in_spatializer,
+    const struct AudioBufferFormat* format, struct AudioBuffer* buffer
+) {
+    struct MediaSpatializer* sp = in_spatializer;
+    uint32_t channels = format->channel_count;
+    if( !channels || (format->bits_per_sample != 16 && format->bits_per_sample != 32) ) {
+        return;
+    }
+
+    uint32_t frames = buffer->sample_count;
+    uint32_t done   = 0;
+    while( done < frames ) {
+        if( sp->mix_offset == MEDIA_SPATIAL_B ) {
+            media_spatial_render_block( sp );
+        }
+        uint32_t count = MEDIA_SPATIAL_B - sp->mix_offset;
+        if( count > frames - done ) {
+            count = frames - done;
+        }
+
+        const float* left  = sp->mix_left + sp->mix_offset;
+        const float* right = sp->mix_right + sp->mix_offset;
+        switch( format->bits_per_sample ) {
+            case 16: {
+                int16_t* out = (int16_t*)buffer->start + (uintptr_t)done * channels;
+                for( uint32_t i = 0; i < count; ++i, out += channels ) {
+                    float l = left[i], r = right[i];
+                    if( channels == 1 ) {
+                        l = (l + r) * 0.5f;
+                    }
+                    for( uint32_t c = 0; c < (channels < 2 ? channels : 2); ++c ) {
+                        float value = (float)out[c] + (c ? r : l) * 32767.0f;
+                        if( value > 32767.0f ) {
+                            value = 32767.0f;
+                        } else if( value < -32768.0f ) {
+                            value = -32768.0f;
+                        }
+                        out[c] = (int16_t)value;
+                    }
+                }
+            } break;
+            case 32: {
+                float* out = (float*)buffer->start + (uintptr_t)done * channels;
+                for( uint32_t i = 0; i < count; ++i, out += channels ) {
+                    if( channels == 1 ) {
+                        out[0] += (left[i] + right[i]) * 0.5f;
+                    } else {
+                        out[0] += left[i];
+                        out[1] += right[i];
+                    }
+                }
+            } break;
+        }
+
+        sp->mix_offset += count;
+        done           += count;
+    }
+}
+
+#undef MEDIA_SPATIAL_B
+#undef MEDIA_SPATIAL_N
+#undef MEDIA_SPATIAL_M
+#undef MEDIA_SPATIAL_SPECTRUM
+#undef MEDIA_SPATIAL_PI
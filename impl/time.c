@@ -0,0 +1,43 @@
+/**
+ * @file   time.c
+ * @brief  Timestamp counter calibration.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 19, 2024
+*/
+#include "media/defines.h"
+#include "media/types.h"
+#include "media/time.h"
+
+#define MEDIA_TIME_CALIBRATION_NS (10 * MEDIA_TIME_NS_PER_MS)
+
+// NOTE(alicia): bits of double so it can be loaded/stored atomically,
+// zero until calibrated.
+attr_global uint64_t global_media_time_ns_per_tick = 0;
+
+attr_media_api double media_time_ns_per_tick(void) {
+    union { uint64_t bits; double f; } result;
+#if defined(MEDIA_ARCH_X86)
+    result.bits = __atomic_load_n( &global_media_time_ns_per_tick, __ATOMIC_RELAXED );
+    if( result.bits ) {
+        return result.f;
+    }
+
+    // NOTE(alicia): two threads calibrating at once is harmless,
+    // both store nearly identical results.
+    uint64_t start_ns    = media_time_ns();
+    uint64_t start_ticks = media_time_ticks();
+    uint64_t end_ns, end_ticks;
+    do {
+        end_ns    = media_time_ns();
+        end_ticks = media_time_ticks();
+    } while( end_ns - start_ns < MEDIA_TIME_CALIBRATION_NS );
+
+    result.f = (double)(end_ns - start_ns) / (double)(end_ticks - start_ticks);
+    __atomic_store_n( &global_media_time_ns_per_tick, result.bits, __ATOMIC_RELAXED );
+#else
+    result.f = 1.0;
+#endif
+    return result.f;
+}
+
+#undef MEDIA_TIME_CALIBRATION_NS
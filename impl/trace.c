@@ -0,0 +1,282 @@
+/**
+ * @file   trace.c
+ * @brief  Trace scope recording and export.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 17, 2024
+*/
+#include "media/defines.h"
+#include "media/types.h"
+#include "media/trace.h"
+#include "media/internal/trace.h"
+
+#if defined(MEDIA_ENABLE_TRACE)
+
+struct MediaTraceEvent {
+    const char* name;
+    uint64_t    start;
+    uint64_t    end;
+};
+// NOTE(alicia): single producer (owning thread), exporter only reads.
+struct MediaTraceRing {
+    uint64_t head;
+    uint32_t thread_id;
+    struct MediaTraceEvent events[MEDIA_TRACE_EVENT_CAP];
+};
+
+attr_global struct MediaTraceRing global_media_trace_rings[MEDIA_TRACE_THREAD_CAP];
+attr_global uint32_t global_media_trace_ring_count = 0;
+// NOTE(alicia): bitfield of rings released by exited threads.
+attr_global uint64_t global_media_trace_ring_free  = 0;
+
+// NOTE(alicia): written once by first thread to record a scope.
+attr_global uint64_t global_media_trace_base_tsc = 0;
+attr_global uint64_t global_media_trace_base_ns  = 0;
+
+// NOTE(alicia): stored for threads that found every ring taken
+// so they don't try to acquire one again.
+#define MEDIA_TRACE_RING_NONE ((struct MediaTraceRing*)(uintptr_t)1)
+
+attr_internal attr_no_inline
+struct MediaTraceRing* media_trace_ring_acquire( uint64_t start ) {
+    struct MediaTraceRing* ring = NULL;
+
+    uint64_t free = __atomic_load_n( &global_media_trace_ring_free, __ATOMIC_ACQUIRE );
+    while( free ) {
+        uint64_t bit = free & (~free + 1);
+        if( __atomic_compare_exchange_n(
+            &global_media_trace_ring_free, &free, free & ~bit,
+            true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE
+        ) ) {
+            // NOTE(alicia): scopes of previous owner are dropped.
+            ring = global_media_trace_rings + __builtin_ctzll( bit );
+            __atomic_store_n( &ring->head, 0, __ATOMIC_RELEASE );
+            break;
+        }
+    }
+
+    if( !ring ) {
+        uint32_t index = __atomic_fetch_add(
+            &global_media_trace_ring_count, 1, __ATOMIC_ACQ_REL );
+        if( index >= MEDIA_TRACE_THREAD_CAP ) {
+            media_trace_platform_set_ring( MEDIA_TRACE_RING_NONE );
+            return NULL;
+        }
+        if( !index ) {
+            // NOTE(alicia): first recorded scope is time zero.
+            __atomic_store_n(
+                &global_media_trace_base_ns, media_time_ns(), __ATOMIC_RELAXED );
+            __atomic_store_n(
+                &global_media_trace_base_tsc, start, __ATOMIC_RELEASE );
+        }
+        ring = global_media_trace_rings + index;
+    }
+
+    __atomic_store_n(
+        &ring->thread_id, media_trace_platform_thread_id(), __ATOMIC_RELAXED );
+    if( !media_trace_platform_set_ring( ring ) ) {
+        media_trace_ring_release( ring );
+        return NULL;
+    }
+    return ring;
+}
+void media_trace_ring_release( void* ring ) {
+    if( !ring || ring == MEDIA_TRACE_RING_NONE ) {
+        return;
+    }
+    uint64_t index = (struct MediaTraceRing*)ring - global_media_trace_rings;
+    __atomic_fetch_or(
+        &global_media_trace_ring_free, 1ULL << index, __ATOMIC_RELEASE );
+}
+void media_trace_record( const char* name, uint64_t start, uint64_t end ) {
+    struct MediaTraceRing* ring = media_trace_platform_ring();
+    if( !ring ) {
+        ring = media_trace_ring_acquire( start );
+        if( !ring ) {
+            return;
+        }
+    } else if( ring == MEDIA_TRACE_RING_NONE ) {
+        return;
+    }
+
+    uint64_t head = ring->head;
+    struct MediaTraceEvent* event =
+        ring->events + (head & (MEDIA_TRACE_EVENT_CAP - 1));
+    event->name  = name;
+    event->start = start;
+    event->end   = end;
+
+    __atomic_store_n( &ring->head, head + 1, __ATOMIC_RELEASE );
+}
+
+#define MEDIA_TRACE_WRITE_BUFFER_CAP (512)
+
+struct MediaTraceWriter {
+    MediaTraceWriteFN* write;
+    void*    params;
+    uint32_t len;
+    char     buffer[MEDIA_TRACE_WRITE_BUFFER_CAP];
+};
+attr_internal void media_trace_writer_flush( struct MediaTraceWriter* writer ) {
+    if( writer->len ) {
+        writer->write( writer->len, writer->buffer, writer->params );
+        writer->len = 0;
+    }
+}
+attr_internal void media_trace_writer_push(
+    struct MediaTraceWriter* writer, uint32_t len, const char* text
+) {
+    if( writer->len + len > MEDIA_TRACE_WRITE_BUFFER_CAP ) {
+        media_trace_writer_flush( writer );
+    }
+    if( len > MEDIA_TRACE_WRITE_BUFFER_CAP ) {
+        writer->write( len, text, writer->params );
+        return;
+    }
+    memcpy( writer->buffer + writer->len, text, len );
+    writer->len += len;
+}
+attr_internal void media_trace_writer_cstr(
+    struct MediaTraceWriter* writer, const char* text
+) {
+    uint32_t len = 0;
+    while( text[len] ) {
+        len++;
+    }
+    media_trace_writer_push( writer, len, text );
+}
+attr_internal void media_trace_writer_u64(
+    struct MediaTraceWriter* writer, uint64_t value
+) {
+    char buf[24];
+    uint32_t at = sizeof(buf);
+    do {
+        buf[--at] = '0' + (value % 10);
+        value /= 10;
+    } while( value );
+    media_trace_writer_push( writer, sizeof(buf) - at, buf + at );
+}
+/// Write nanoseconds as microseconds with three decimals.
+attr_internal void media_trace_writer_us(
+    struct MediaTraceWriter* writer, uint64_t ns
+) {
+    media_trace_writer_u64( writer, ns / 1000 );
+    char frac[4];
+    uint64_t rem = ns % 1000;
+    frac[0] = '.';
+    frac[1] = '0' + (rem / 100);
+    frac[2] = '0' + ((rem / 10) % 10);
+    frac[3] = '0' + (rem % 10);
+    media_trace_writer_push( writer, sizeof(frac), frac );
+}
+
+attr_media_api _Bool media_trace_is_enabled(void) {
+    return true;
+}
+attr_media_api uint64_t media_trace_export_chrome_json(
+    MediaTraceWriteFN* write, void* params
+) {
+    struct MediaTraceWriter writer;
+    writer.write  = write;
+    writer.params = params;
+    writer.len    = 0;
+
+    #define push( literal ) media_trace_writer_push( &writer, sizeof(literal) - 1, literal )
+
+    push( "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" );
+
+    uint64_t base_tsc = __atomic_load_n( &global_media_trace_base_tsc, __ATOMIC_ACQUIRE );
+    uint64_t base_ns  = __atomic_load_n( &global_media_trace_base_ns, __ATOMIC_RELAXED );
+
+    uint32_t ring_count = __atomic_load_n(
+        &global_media_trace_ring_count, __ATOMIC_ACQUIRE );
+    if( ring_count > MEDIA_TRACE_THREAD_CAP ) {
+        ring_count = MEDIA_TRACE_THREAD_CAP;
+    }
+    // NOTE(alicia): first ring is taken but its scopes are not recorded yet.
+    if( !base_tsc ) {
+        ring_count = 0;
+    }
+
+    // NOTE(alicia): calibrate timestamp frequency against platform clock
+    // over the lifetime of the trace.
+    double ns_per_tick = 1.0;
+    uint64_t now_tsc = media_trace_timestamp();
+    uint64_t now_ns  = media_time_ns();
+    if( now_tsc > base_tsc && now_ns > base_ns ) {
+        ns_per_tick = (double)(now_ns - base_ns) / (double)(now_tsc - base_tsc);
+    }
+
+    uint64_t count = 0;
+    for( uint32_t r = 0; r < ring_count; ++r ) {
+        struct MediaTraceRing* ring = global_media_trace_rings + r;
+        uint64_t head = __atomic_load_n( &ring->head, __ATOMIC_ACQUIRE );
+        uint64_t tail = head > MEDIA_TRACE_EVENT_CAP ? head - MEDIA_TRACE_EVENT_CAP : 0;
+
+        for( uint64_t i = tail; i < head; ++i ) {
+            struct MediaTraceEvent* event =
+                ring->events + (i & (MEDIA_TRACE_EVENT_CAP - 1));
+            if( event->end < event->start ) {
+                continue;
+            }
+
+            uint64_t ts = 0;
+            if( event->start > base_tsc ) {
+                ts = (uint64_t)((double)(event->start - base_tsc) * ns_per_tick);
+            }
+            uint64_t dur = (uint64_t)((double)(event->end - event->start) * ns_per_tick);
+
+            if( count ) {
+                push( "," );
+            }
+            push( "\n{\"name\":\"" );
+            media_trace_writer_cstr( &writer, event->name );
+            push( "\",\"ph\":\"X\",\"pid\":1,\"tid\":" );
+            media_trace_writer_u64(
+                &writer, __atomic_load_n( &ring->thread_id, __ATOMIC_RELAXED ) );
+            push( ",\"ts\":" );
+            media_trace_writer_us( &writer, ts );
+            push( ",\"dur\":" );
+            media_trace_writer_us( &writer, dur );
+            push( "}" );
+
+            count++;
+        }
+    }
+
+    push( "\n]}\n" );
+    media_trace_writer_flush( &writer );
+
+    #undef push
+    return count;
+}
+attr_media_api void media_trace_clear(void) {
+    uint32_t ring_count = __atomic_load_n(
+        &global_media_trace_ring_count, __ATOMIC_ACQUIRE );
+    if( ring_count > MEDIA_TRACE_THREAD_CAP ) {
+        ring_count = MEDIA_TRACE_THREAD_CAP;
+    }
+    for( uint32_t r = 0; r < ring_count; ++r ) {
+        __atomic_store_n( &global_media_trace_rings[r].head, 0, __ATOMIC_RELEASE );
+    }
+}
+
+#undef MEDIA_TRACE_WRITE_BUFFER_CAP
+#undef MEDIA_TRACE_RING_NONE
+
+#else /* MEDIA_ENABLE_TRACE */
+
+attr_media_api _Bool media_trace_is_enabled(void) {
+    return false;
+}
+attr_media_api uint64_t media_trace_export_chrome_json(
+    MediaTraceWriteFN* write, void* params
+) {
+    const char empty[] = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[]}\n";
+    write( sizeof(empty) - 1, empty, params );
+    return 0;
+}
+attr_media_api void media_trace_clear(void) {
+    return;
+}
+
+#endif /* MEDIA_ENABLE_TRACE */
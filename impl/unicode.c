@@ -0,0 +1,435 @@
+/**
+ * @file   unicode.c
+ * @brief  UTF-8, UTF-16 and UTF-32 transcoding.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 15, 2024
+*/
+#include "media/defines.h"
+#include "media/types.h"
+#include "media/internal/unicode.h"
+
+#if defined(MEDIA_ARCH_X86)
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define MEDIA_UNICODE_SSE2
+        #include <emmintrin.h>
+    #endif
+    #if defined(__AVX2__)
+        #define MEDIA_UNICODE_AVX2
+        #include <immintrin.h>
+    #endif
+#endif
+
+// NOTE(alicia): ASCII run helpers.
+// Each returns how many leading code units are ASCII and,
+// when dst is provided, copies them widened/narrowed into dst.
+
+attr_internal uintptr_t media_unicode_ascii_run_utf8(
+    uintptr_t len, const uint8_t* src
+) {
+    uintptr_t i = 0;
+#if defined(MEDIA_UNICODE_AVX2)
+    for( ; i + 32 <= len; i += 32 ) {
+        __m256i v = _mm256_loadu_si256( (const __m256i*)(src + i) );
+        if( _mm256_movemask_epi8( v ) ) {
+            break;
+        }
+    }
+#endif
+#if defined(MEDIA_UNICODE_SSE2)
+    for( ; i + 16 <= len; i += 16 ) {
+        __m128i v = _mm_loadu_si128( (const __m128i*)(src + i) );
+        if( _mm_movemask_epi8( v ) ) {
+            break;
+        }
+    }
+#endif
+    while( i < len && src[i] < 0x80 ) {
+        i++;
+    }
+    return i;
+}
+attr_internal uintptr_t media_unicode_ascii_utf8_to_utf16(
+    uintptr_t len, const uint8_t* src, uint16_t* dst
+) {
+    uintptr_t i = 0;
+#if defined(MEDIA_UNICODE_AVX2)
+    for( ; i + 32 <= len; i += 32 ) {
+        __m256i v = _mm256_loadu_si256( (const __m256i*)(src + i) );
+        if( _mm256_movemask_epi8( v ) ) {
+            break;
+        }
+        __m256i lo = _mm256_cvtepu8_epi16( _mm256_castsi256_si128( v ) );
+        __m256i hi = _mm256_cvtepu8_epi16( _mm256_extracti128_si256( v, 1 ) );
+        _mm256_storeu_si256( (__m256i*)(dst + i), lo );
+        _mm256_storeu_si256( (__m256i*)(dst + i + 16), hi );
+    }
+#endif
+#if defined(MEDIA_UNICODE_SSE2)
+    __m128i zero = _mm_setzero_si128();
+    for( ; i + 16 <= len; i += 16 ) {
+        __m128i v = _mm_loadu_si128( (const __m128i*)(src + i) );
+        if( _mm_movemask_epi8( v ) ) {
+            break;
+        }
+        _mm_storeu_si128( (__m128i*)(dst + i), _mm_unpacklo_epi8( v, zero ) );
+        _mm_storeu_si128( (__m128i*)(dst + i + 8), _mm_unpackhi_epi8( v, zero ) );
+    }
+#endif
+    while( i < len && src[i] < 0x80 ) {
+        dst[i] = src[i];
+        i++;
+    }
+    return i;
+}
+attr_internal uintptr_t media_unicode_ascii_run_utf16(
+    uintptr_t len, const uint16_t* src
+) {
+    uintptr_t i = 0;
+#if defined(MEDIA_UNICODE_AVX2)
+    __m256i mask256 = _mm256_set1_epi16( (short)0xFF80 );
+    for( ; i + 32 <= len; i += 32 ) {
+        __m256i a = _mm256_loadu_si256( (const __m256i*)(src + i) );
+        __m256i b = _mm256_loadu_si256( (const __m256i*)(src + i + 16) );
+        if( !_mm256_testz_si256( _mm256_or_si256( a, b ), mask256 ) ) {
+            break;
+        }
+    }
+#endif
+#if defined(MEDIA_UNICODE_SSE2)
+    __m128i mask = _mm_set1_epi16( (short)0xFF80 );
+    __m128i zero = _mm_setzero_si128();
+    for( ; i + 16 <= len; i += 16 ) {
+        __m128i a = _mm_loadu_si128( (const __m128i*)(src + i) );
+        __m128i b = _mm_loadu_si128( (const __m128i*)(src + i + 8) );
+        __m128i t = _mm_and_si128( _mm_or_si128( a, b ), mask );
+        if( _mm_movemask_epi8( _mm_cmpeq_epi16( t, zero ) ) != 0xFFFF ) {
+            break;
+        }
+    }
+#endif
+    while( i < len && src[i] < 0x80 ) {
+        i++;
+    }
+    return i;
+}
+attr_internal uintptr_t media_unicode_ascii_utf16_to_utf8(
+    uintptr_t len, const uint16_t* src, uint8_t* dst
+) {
+    uintptr_t i = 0;
+#if defined(MEDIA_UNICODE_AVX2)
+    __m256i mask256 = _mm256_set1_epi16( (short)0xFF80 );
+    for( ; i + 32 <= len; i += 32 ) {
+        __m256i a = _mm256_loadu_si256( (const __m256i*)(src + i) );
+        __m256i b = _mm256_loadu_si256( (const __m256i*)(src + i + 16) );
+        if( !_mm256_testz_si256( _mm256_or_si256( a, b ), mask256 ) ) {
+            break;
+        }
+        // NOTE(alicia): packus works per 128-bit lane, permute restores order.
+        __m256i packed = _mm256_permute4x64_epi64(
+            _mm256_packus_epi16( a, b ), 0xD8 );
+        _mm256_storeu_si256( (__m256i*)(dst + i), packed );
+    }
+#endif
+#if defined(MEDIA_UNICODE_SSE2)
+    __m128i mask = _mm_set1_epi16( (short)0xFF80 );
+    __m128i zero = _mm_setzero_si128();
+    for( ; i + 16 <= len; i += 16 ) {
+        __m128i a = _mm_loadu_si128( (const __m128i*)(src + i) );
+        __m128i b = _mm_loadu_si128( (const __m128i*)(src + i + 8) );
+        __m128i t = _mm_and_si128( _mm_or_si128( a, b ), mask );
+        if( _mm_movemask_epi8( _mm_cmpeq_epi16( t, zero ) ) != 0xFFFF ) {
+            break;
+        }
+        _mm_storeu_si128( (__m128i*)(dst + i), _mm_packus_epi16( a, b ) );
+    }
+#endif
+    while( i < len && src[i] < 0x80 ) {
+        dst[i] = (uint8_t)src[i];
+        i++;
+    }
+    return i;
+}
+
+uint32_t media_utf8_decode( uintptr_t len, const char* utf8, uint32_t* out_cp ) {
+    const uint8_t* s = (const uint8_t*)utf8;
+    uint8_t b0 = s[0];
+    if( b0 < 0x80 ) {
+        *out_cp = b0;
+        return 1;
+    }
+
+    uint32_t count = 0;
+    uint32_t cp    = 0;
+    uint8_t  lo    = 0x80;
+    uint8_t  hi    = 0xBF;
+    if( b0 >= 0xC2 && b0 <= 0xDF ) {
+        count = 2;
+        cp    = b0 & 0x1F;
+    } else if( b0 >= 0xE0 && b0 <= 0xEF ) {
+        count = 3;
+        cp    = b0 & 0x0F;
+        if( b0 == 0xE0 ) {
+            lo = 0xA0;
+        } else if( b0 == 0xED ) {
+            hi = 0x9F;
+        }
+    } else if( b0 >= 0xF0 && b0 <= 0xF4 ) {
+        count = 4;
+        cp    = b0 & 0x07;
+        if( b0 == 0xF0 ) {
+            lo = 0x90;
+        } else if( b0 == 0xF4 ) {
+            hi = 0x8F;
+        }
+    } else {
+        *out_cp = MEDIA_UNICODE_INVALID;
+        return 1;
+    }
+
+    // NOTE(alicia): on invalid sequence, consume maximal valid subpart.
+    for( uint32_t i = 1; i < count; ++i ) {
+        if( i >= len ) {
+            *out_cp = MEDIA_UNICODE_INVALID;
+            return i;
+        }
+        uint8_t b = s[i];
+        if( b < lo || b > hi ) {
+            *out_cp = MEDIA_UNICODE_INVALID;
+            return i;
+        }
+        lo = 0x80;
+        hi = 0xBF;
+        cp = (cp << 6) | (b & 0x3F);
+    }
+
+    *out_cp = cp;
+    return count;
+}
+uint32_t media_utf8_encode( uint32_t cp, char* out ) {
+    uint8_t* s = (uint8_t*)out;
+    if( cp < 0x80 ) {
+        s[0] = (uint8_t)cp;
+        return 1;
+    }
+    if( cp < 0x800 ) {
+        s[0] = (uint8_t)(0xC0 | (cp >> 6));
+        s[1] = (uint8_t)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if( (cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF ) {
+        cp = MEDIA_UNICODE_REPLACEMENT;
+    }
+    if( cp < 0x10000 ) {
+        s[0] = (uint8_t)(0xE0 | (cp >> 12));
+        s[1] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+        s[2] = (uint8_t)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    s[0] = (uint8_t)(0xF0 | (cp >> 18));
+    s[1] = (uint8_t)(0x80 | ((cp >> 12) & 0x3F));
+    s[2] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+    s[3] = (uint8_t)(0x80 | (cp & 0x3F));
+    return 4;
+}
+uint32_t media_utf16_decode( uintptr_t len, const uint16_t* utf16, uint32_t* out_cp ) {
+    uint16_t u = utf16[0];
+    if( u < 0xD800 || u > 0xDFFF ) {
+        *out_cp = u;
+        return 1;
+    }
+    if( u <= 0xDBFF && len > 1 ) {
+        uint16_t n = utf16[1];
+        if( n >= 0xDC00 && n <= 0xDFFF ) {
+            *out_cp = 0x10000 + (((uint32_t)u - 0xD800) << 10) + (n - 0xDC00);
+            return 2;
+        }
+    }
+    *out_cp = MEDIA_UNICODE_INVALID;
+    return 1;
+}
+uint32_t media_utf16_encode( uint32_t cp, uint16_t* out ) {
+    if( (cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF ) {
+        cp = MEDIA_UNICODE_REPLACEMENT;
+    }
+    if( cp < 0x10000 ) {
+        out[0] = (uint16_t)cp;
+        return 1;
+    }
+    cp -= 0x10000;
+    out[0] = (uint16_t)(0xD800 + (cp >> 10));
+    out[1] = (uint16_t)(0xDC00 + (cp & 0x3FF));
+    return 2;
+}
+
+_Bool media_utf8_validate( uintptr_t len, const char* utf8 ) {
+    const uint8_t* s = (const uint8_t*)utf8;
+    uintptr_t at = 0;
+    while( at < len ) {
+        at += media_unicode_ascii_run_utf8( len - at, s + at );
+        if( at >= len ) {
+            break;
+        }
+        uint32_t cp;
+        at += media_utf8_decode( len - at, utf8 + at, &cp );
+        if( cp == MEDIA_UNICODE_INVALID ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uintptr_t media_utf8_to_utf16(
+    uintptr_t len, const char* utf8,
+    uintptr_t cap, uint16_t* opt_out, uintptr_t* opt_out_read
+) {
+    const uint8_t* s = (const uint8_t*)utf8;
+    uintptr_t read    = 0;
+    uintptr_t written = 0;
+    while( read < len ) {
+        uintptr_t run;
+        if( opt_out ) {
+            uintptr_t max = len - read;
+            if( max > cap - written ) {
+                max = cap - written;
+            }
+            run = media_unicode_ascii_utf8_to_utf16( max, s + read, opt_out + written );
+        } else {
+            run = media_unicode_ascii_run_utf8( len - read, s + read );
+        }
+        read    += run;
+        written += run;
+        if( read >= len ) {
+            break;
+        }
+
+        uint32_t cp;
+        uint32_t consumed = media_utf8_decode( len - read, utf8 + read, &cp );
+        if( cp == MEDIA_UNICODE_INVALID ) {
+            cp = MEDIA_UNICODE_REPLACEMENT;
+        }
+        uint32_t units = cp >= 0x10000 ? 2 : 1;
+        if( opt_out ) {
+            if( written + units > cap ) {
+                break;
+            }
+            media_utf16_encode( cp, opt_out + written );
+        }
+        written += units;
+        read    += consumed;
+    }
+
+    if( opt_out_read ) {
+        *opt_out_read = read;
+    }
+    return written;
+}
+uintptr_t media_utf16_to_utf8(
+    uintptr_t len, const uint16_t* utf16,
+    uintptr_t cap, char* opt_out, uintptr_t* opt_out_read
+) {
+    uintptr_t read    = 0;
+    uintptr_t written = 0;
+    while( read < len ) {
+        uintptr_t run;
+        if( opt_out ) {
+            uintptr_t max = len - read;
+            if( max > cap - written ) {
+                max = cap - written;
+            }
+            run = media_unicode_ascii_utf16_to_utf8(
+                max, utf16 + read, (uint8_t*)opt_out + written );
+        } else {
+            run = media_unicode_ascii_run_utf16( len - read, utf16 + read );
+        }
+        read    += run;
+        written += run;
+        if( read >= len ) {
+            break;
+        }
+
+        uint32_t cp;
+        uint32_t consumed = media_utf16_decode( len - read, utf16 + read, &cp );
+        if( cp == MEDIA_UNICODE_INVALID ) {
+            cp = MEDIA_UNICODE_REPLACEMENT;
+        }
+        if( opt_out ) {
+            char buf[4];
+            uint32_t bytes = media_utf8_encode( cp, buf );
+            if( written + bytes > cap ) {
+                break;
+            }
+            for( uint32_t i = 0; i < bytes; ++i ) {
+                opt_out[written + i] = buf[i];
+            }
+            written += bytes;
+        } else {
+            written += cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+        }
+        read += consumed;
+    }
+
+    if( opt_out_read ) {
+        *opt_out_read = read;
+    }
+    return written;
+}
+uintptr_t media_utf8_to_utf32(
+    uintptr_t len, const char* utf8,
+    uintptr_t cap, uint32_t* opt_out, uintptr_t* opt_out_read
+) {
+    uintptr_t read    = 0;
+    uintptr_t written = 0;
+    while( read < len ) {
+        if( opt_out && written >= cap ) {
+            break;
+        }
+        uint32_t cp;
+        read += media_utf8_decode( len - read, utf8 + read, &cp );
+        if( cp == MEDIA_UNICODE_INVALID ) {
+            cp = MEDIA_UNICODE_REPLACEMENT;
+        }
+        if( opt_out ) {
+            opt_out[written] = cp;
+        }
+        written++;
+    }
+
+    if( opt_out_read ) {
+        *opt_out_read = read;
+    }
+    return written;
+}
+uintptr_t media_utf32_to_utf8(
+    uintptr_t len, const uint32_t* utf32,
+    uintptr_t cap, char* opt_out, uintptr_t* opt_out_read
+) {
+    uintptr_t read    = 0;
+    uintptr_t written = 0;
+    for( ; read < len; ++read ) {
+        char buf[4];
+        uint32_t bytes = media_utf8_encode( utf32[read], buf );
+        if( opt_out ) {
+            if( written + bytes > cap ) {
+                break;
+            }
+            for( uint32_t i = 0; i < bytes; ++i ) {
+                opt_out[written + i] = buf[i];
+            }
+        }
+        written += bytes;
+    }
+
+    if( opt_out_read ) {
+        *opt_out_read = read;
+    }
+    return written;
+}
+
+uintptr_t media_utf16_len( const uint16_t* utf16 ) {
+    uintptr_t result = 0;
+    while( utf16[result] ) {
+        result++;
+    }
+    return result;
+}
+
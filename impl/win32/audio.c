@@ -8,6 +8,7 @@
 
 #if defined(MEDIA_PLATFORM_WINDOWS)
 #include "media/audio.h"
+#include "media/time.h"
 #include "impl/win32/common.h"
 
 #include <dshow.h>
@@ -17,6 +18,18 @@
 
 #define REFTIMES_PER_MS (10000)
 
+enum Win32AudioNotificationOwner {
+    WIN32_AUDIO_NOTIFICATION_LIST,
+    WIN32_AUDIO_NOTIFICATION_DEVICE,
+};
+/// IMMNotificationClient implementation embedded in its owner.
+/// Owner controls lifetime so reference counting is a no-op.
+struct Win32AudioNotificationClient {
+    IMMNotificationClient            client;
+    enum Win32AudioNotificationOwner owner_type;
+    void*                            owner;
+};
+
 struct Win32AudioDevice {
     IMMDevice*           device;
     IAudioClient*        client;
@@ -25,43 +38,258 @@ struct Win32AudioDevice {
         IAudioRenderClient*  render;
         IAudioCaptureClient* capture;
     };
+    IAudioClock*         clock;
+    uint64_t             clock_frequency;
+    HANDLE               event;
+    _Bool                is_exclusive;
     WAVEFORMATEXTENSIBLE fmt;
     uint32_t frame_count;
     uint32_t buffer_size;
+
+    uint32_t padding_high_water;
+    uint32_t underrun_count;
+    uint32_t overrun_count;
+    uint32_t migration_count;
+    _Bool    is_running;
+
+    AudioDeviceOpenFlags open_flags;
+    uint32_t             buffer_length_ms;
+
+    IMMDeviceEnumerator*                enumerator;
+    struct Win32AudioNotificationClient notification;
+    _Bool                               is_notification_registered;
+    _Bool                               is_migration_pending;
 };
 struct Win32AudioDeviceList {
     IMMDeviceEnumerator* enumerator;
     IMMDeviceCollection* input_devices;
     IMMDeviceCollection* output_devices;
+
+    struct Win32AudioNotificationClient notification;
+    _Bool                               is_notification_registered;
+    AudioDeviceListCallbackFN*          callback;
+    void*                               callback_params;
 };
 
+attr_internal HRESULT STDMETHODCALLTYPE win32_audio_notification_query_interface(
+    IMMNotificationClient* client, REFIID riid, void** out_object
+) {
+    if(
+        IsEqualIID( riid, &IID_IUnknown ) ||
+        IsEqualIID( riid, &IID_IMMNotificationClient )
+    ) {
+        *out_object = client;
+        return S_OK;
+    }
+    *out_object = NULL;
+    return E_NOINTERFACE;
+}
+attr_internal ULONG STDMETHODCALLTYPE win32_audio_notification_add_ref(
+    IMMNotificationClient* client
+) {
+    unused( client );
+    return 1;
+}
+attr_internal ULONG STDMETHODCALLTYPE win32_audio_notification_release(
+    IMMNotificationClient* client
+) {
+    unused( client );
+    return 1;
+}
+/// Figure out if endpoint is input or output.
+attr_internal _Bool win32_audio_endpoint_type(
+    IMMDeviceEnumerator* enumerator, LPCWSTR id, enum AudioDeviceType* out_type
+) {
+    IMMDevice* device = NULL;
+    HRESULT hr = enumerator->lpVtbl->GetDevice( enumerator, id, &device );
+    if( !CoCheck( hr ) ) {
+        return false;
+    }
+    IMMEndpoint* endpoint = NULL;
+    hr = device->lpVtbl->QueryInterface( device, &IID_IMMEndpoint, (void**)&endpoint );
+    CoRelease( device );
+    if( !CoCheck( hr ) ) {
+        return false;
+    }
+    EDataFlow flow = eRender;
+    hr = endpoint->lpVtbl->GetDataFlow( endpoint, &flow );
+    CoRelease( endpoint );
+    if( !CoCheck( hr ) ) {
+        return false;
+    }
+    *out_type = flow == eCapture ? AUDIO_DEVICE_TYPE_INPUT : AUDIO_DEVICE_TYPE_OUTPUT;
+    return true;
+}
+attr_internal HRESULT STDMETHODCALLTYPE win32_audio_notification_on_device_state_changed(
+    IMMNotificationClient* in_client, LPCWSTR id, DWORD new_state
+) {
+    struct Win32AudioNotificationClient* client = (void*)in_client;
+    if( client->owner_type != WIN32_AUDIO_NOTIFICATION_LIST ) {
+        // NOTE(alicia): devices find out their endpoint is gone
+        // through AUDCLNT_E_DEVICE_INVALIDATED.
+        return S_OK;
+    }
+    struct Win32AudioDeviceList* list = client->owner;
+
+    enum AudioDeviceType type;
+    if( !win32_audio_endpoint_type( list->enumerator, id, &type ) ) {
+        return S_OK;
+    }
+    enum AudioDeviceListEvent event = new_state == DEVICE_STATE_ACTIVE ?
+        AUDIO_DEVICE_LIST_EVENT_ADDED : AUDIO_DEVICE_LIST_EVENT_REMOVED;
+    list->callback( event, type, list->callback_params );
+    return S_OK;
+}
+attr_internal HRESULT STDMETHODCALLTYPE win32_audio_notification_on_device_added(
+    IMMNotificationClient* client, LPCWSTR id
+) {
+    // NOTE(alicia): newly installed endpoints are reported
+    // once they become active through state changes.
+    unused( client, id );
+    return S_OK;
+}
+attr_internal HRESULT STDMETHODCALLTYPE win32_audio_notification_on_device_removed(
+    IMMNotificationClient* client, LPCWSTR id
+) {
+    unused( client, id );
+    return S_OK;
+}
+attr_internal HRESULT STDMETHODCALLTYPE win32_audio_notification_on_default_device_changed(
+    IMMNotificationClient* in_client, EDataFlow flow, ERole role, LPCWSTR id
+) {
+    unused( id );
+    // NOTE(alicia): each role gets its own notification,
+    // devices are always opened with console role.
+    if( role != eConsole ) {
+        return S_OK;
+    }
+    struct Win32AudioNotificationClient* client = (void*)in_client;
+    enum AudioDeviceType type =
+        flow == eCapture ? AUDIO_DEVICE_TYPE_INPUT : AUDIO_DEVICE_TYPE_OUTPUT;
+
+    switch( client->owner_type ) {
+        case WIN32_AUDIO_NOTIFICATION_LIST: {
+            struct Win32AudioDeviceList* list = client->owner;
+            list->callback(
+                AUDIO_DEVICE_LIST_EVENT_DEFAULT_CHANGED, type, list->callback_params );
+        } break;
+        case WIN32_AUDIO_NOTIFICATION_DEVICE: {
+            struct Win32AudioDevice* device = client->owner;
+            if( device->type != type ) {
+                break;
+            }
+            __atomic_store_n( &device->is_migration_pending, true, __ATOMIC_RELEASE );
+            if( device->event ) {
+                SetEvent( device->event );
+            }
+        } break;
+    }
+    return S_OK;
+}
+attr_internal HRESULT STDMETHODCALLTYPE win32_audio_notification_on_property_value_changed(
+    IMMNotificationClient* client, LPCWSTR id, const PROPERTYKEY key
+) {
+    unused( client, id, key );
+    return S_OK;
+}
+attr_global IMMNotificationClientVtbl global_win32_audio_notification_vtbl = {
+    .QueryInterface         = win32_audio_notification_query_interface,
+    .AddRef                 = win32_audio_notification_add_ref,
+    .Release                = win32_audio_notification_release,
+    .OnDeviceStateChanged   = win32_audio_notification_on_device_state_changed,
+    .OnDeviceAdded          = win32_audio_notification_on_device_added,
+    .OnDeviceRemoved        = win32_audio_notification_on_device_removed,
+    .OnDefaultDeviceChanged = win32_audio_notification_on_default_device_changed,
+    .OnPropertyValueChanged = win32_audio_notification_on_property_value_changed,
+};
+attr_internal void win32_audio_notification_init(
+    struct Win32AudioNotificationClient* client,
+    enum Win32AudioNotificationOwner owner_type, void* owner
+) {
+    client->client.lpVtbl = &global_win32_audio_notification_vtbl;
+    client->owner_type    = owner_type;
+    client->owner         = owner;
+}
+
 attr_media_api uintptr_t audio_device_list_query_memory_requirement(void) {
     return sizeof(struct Win32AudioDeviceList);
 }
+attr_internal _Bool win32_audio_device_list_enumerate( struct Win32AudioDeviceList* list ) {
+    HRESULT hr = list->enumerator->lpVtbl->EnumAudioEndpoints(
+        list->enumerator, eCapture, DEVICE_STATE_ACTIVE, &list->input_devices );
+    if( !CoCheck( hr ) ) {
+        return false;
+    }
+
+    hr = list->enumerator->lpVtbl->EnumAudioEndpoints(
+        list->enumerator, eRender, DEVICE_STATE_ACTIVE, &list->output_devices );
+    if( !CoCheck( hr ) ) {
+        CoRelease( list->input_devices );
+        return false;
+    }
+    return true;
+}
 attr_media_api _Bool audio_device_list_create( AudioDeviceList* out_list ) {
     struct Win32AudioDeviceList* list = out_list;
+    memset( list, 0, sizeof(*list) );
+    if( !win32_load_com() ) {
+        win32_error( "audio_device_list_create: failed to initialize COM!" );
+        return false;
+    }
+
     HRESULT hr = CoCreateInstance(
         &CLSID_MMDeviceEnumerator, NULL, CLSCTX_ALL,
         &IID_IMMDeviceEnumerator, (void**)&list->enumerator );
     if( !CoCheck( hr ) ) {
+        win32_error_fmt(
+            "audio_device_list_create: failed to create device enumerator! hr: %x",
+            (uint32_t)hr );
         return false;
     }
 
-    hr = list->enumerator->lpVtbl->EnumAudioEndpoints(
-        list->enumerator, eCapture, DEVICE_STATE_ACTIVE, &list->input_devices );
-    if( !CoCheck( hr ) ) {
+    if( !win32_audio_device_list_enumerate( list ) ) {
         CoRelease( list->enumerator );
         return false;
     }
 
-    hr = list->enumerator->lpVtbl->EnumAudioEndpoints(
-        list->enumerator, eRender, DEVICE_STATE_ACTIVE, &list->output_devices );
+    return true;
+}
+attr_media_api _Bool audio_device_list_refresh( AudioDeviceList* in_list ) {
+    struct Win32AudioDeviceList* list = in_list;
+    CoRelease( list->input_devices );
+    CoRelease( list->output_devices );
+    return win32_audio_device_list_enumerate( list );
+}
+attr_media_api _Bool audio_device_list_set_callback(
+    AudioDeviceList* in_list,
+    AudioDeviceListCallbackFN* callback, void* opt_callback_params
+) {
+    struct Win32AudioDeviceList* list = in_list;
+    if( list->is_notification_registered ) {
+        list->enumerator->lpVtbl->UnregisterEndpointNotificationCallback(
+            list->enumerator, &list->notification.client );
+        list->is_notification_registered = false;
+    }
+
+    list->callback        = callback;
+    list->callback_params = opt_callback_params;
+    if( !callback ) {
+        return true;
+    }
+
+    win32_audio_notification_init(
+        &list->notification, WIN32_AUDIO_NOTIFICATION_LIST, list );
+    HRESULT hr = list->enumerator->lpVtbl->RegisterEndpointNotificationCallback(
+        list->enumerator, &list->notification.client );
     if( !CoCheck( hr ) ) {
-        CoRelease( list->input_devices );
-        CoRelease( list->enumerator );
+        win32_error_fmt(
+            "audio_device_list_set_callback: failed to register notification client! hr: %x",
+            (uint32_t)hr );
+        list->callback        = NULL;
+        list->callback_params = NULL;
         return false;
     }
-
+    list->is_notification_registered = true;
     return true;
 }
 attr_media_api uint32_t audio_device_list_query_count(
@@ -134,8 +362,10 @@ attr_media_api _Bool audio_device_list_query_name(
     if( name.vt == VT_EMPTY ) {
         *out_name_len = 0;
     } else {
-        int len = WideCharToMultiByte(
-            CP_UTF8, 0, name.pwszVal, -1, out_name, 260, 0, 0 );
+        uintptr_t len = media_utf16_to_utf8(
+            media_utf16_len( (uint16_t*)name.pwszVal ),
+            (uint16_t*)name.pwszVal, AUDIO_DEVICE_NAME_CAP - 1, out_name, 0 );
+        out_name[len] = 0;
         *out_name_len = len;
     }
 
@@ -148,6 +378,10 @@ attr_media_api _Bool audio_device_list_query_name(
 }
 attr_media_api void audio_device_list_destroy( AudioDeviceList* in_list ) {
     struct Win32AudioDeviceList* list = in_list;
+    if( list->is_notification_registered ) {
+        list->enumerator->lpVtbl->UnregisterEndpointNotificationCallback(
+            list->enumerator, &list->notification.client );
+    }
     CoRelease( list->enumerator );
     CoRelease( list->input_devices );
     CoRelease( list->output_devices );
@@ -155,58 +389,103 @@ attr_media_api void audio_device_list_destroy( AudioDeviceList* in_list ) {
     memset( list, 0, sizeof(*list) );
 }
 
-attr_media_api uintptr_t audio_device_query_memory_requirement(void) {
-    return sizeof(struct Win32AudioDevice);
+attr_internal HRESULT win32_audio_device_reactivate( struct Win32AudioDevice* device ) {
+    CoRelease( device->client );
+    return device->device->lpVtbl->Activate(
+        device->device, &IID_IAudioClient, CLSCTX_ALL, NULL, (void**)&device->client );
 }
-attr_media_api _Bool audio_device_open(
-    AudioDeviceList*          in_list,
-    struct AudioBufferFormat* opt_format,
-    uint32_t                  buffer_length_ms,
-    enum AudioDeviceType      type,
-    uint32_t                  device_index,
-    AudioDevice*              out_device
+attr_internal HRESULT win32_audio_device_initialize_low_latency(
+    struct Win32AudioDevice* device, DWORD flags
 ) {
-    struct Win32AudioDeviceList* list   = in_list;
-    struct Win32AudioDevice*     device = out_device;
+    IAudioClient3* client3 = NULL;
+    HRESULT hr = device->client->lpVtbl->QueryInterface(
+        device->client, &IID_IAudioClient3, (void**)&client3 );
+    if( !CoCheck( hr ) ) {
+        return hr;
+    }
 
-    HRESULT hr;
-    device->type = type;
+    UINT32 default_period = 0, fundamental_period = 0, min_period = 0, max_period = 0;
+    hr = client3->lpVtbl->GetSharedModeEnginePeriod(
+        client3, (WAVEFORMATEX*)&device->fmt,
+        &default_period, &fundamental_period, &min_period, &max_period );
+    if( CoCheck( hr ) ) {
+        hr = client3->lpVtbl->InitializeSharedAudioStream(
+            client3, flags, min_period, (WAVEFORMATEX*)&device->fmt, NULL );
+    }
 
-    switch( type ) {
+    CoRelease( client3 );
+    return hr;
+}
+attr_internal HRESULT win32_audio_device_initialize_exclusive(
+    struct Win32AudioDevice* device, DWORD flags
+) {
+    REFERENCE_TIME default_period = 0, period = 0;
+    HRESULT hr = device->client->lpVtbl->GetDevicePeriod(
+        device->client, &default_period, &period );
+    if( !CoCheck( hr ) ) {
+        return hr;
+    }
+
+    hr = device->client->lpVtbl->Initialize(
+        device->client, AUDCLNT_SHAREMODE_EXCLUSIVE,
+        flags, period, period, (WAVEFORMATEX*)&device->fmt, NULL );
+    if( hr != AUDCLNT_E_BUFFER_SIZE_NOT_ALIGNED ) {
+        return hr;
+    }
+
+    // NOTE(alicia): device rejected minimum period, retry with
+    // period that matches aligned buffer size it suggests.
+    UINT32 aligned_frames = 0;
+    hr = device->client->lpVtbl->GetBufferSize( device->client, &aligned_frames );
+    if( !CoCheck( hr ) ) {
+        return hr;
+    }
+    period = (REFERENCE_TIME)(
+        ((double)REFTIMES_PER_MS * 1000.0 * (double)aligned_frames /
+        (double)device->fmt.Format.nSamplesPerSec) + 0.5 );
+
+    hr = win32_audio_device_reactivate( device );
+    if( !CoCheck( hr ) ) {
+        return hr;
+    }
+
+    return device->client->lpVtbl->Initialize(
+        device->client, AUDCLNT_SHAREMODE_EXCLUSIVE,
+        flags, period, period, (WAVEFORMATEX*)&device->fmt, NULL );
+}
+
+attr_media_api uintptr_t audio_device_query_memory_requirement(void) {
+    return sizeof(struct Win32AudioDevice);
+}
+attr_internal void win32_audio_device_release( struct Win32AudioDevice* device ) {
+    CoRelease( device->clock );
+    switch( device->type ) {
         case AUDIO_DEVICE_TYPE_INPUT: {
-            if( device_index == AUDIO_DEVICE_DEFAULT ) {
-                hr = list->enumerator->lpVtbl->GetDefaultAudioEndpoint(
-                    list->enumerator, eCapture, eConsole, &device->device );
-            } else {
-                hr = list->input_devices->lpVtbl->Item( 
-                    list->input_devices, device_index, &device->device );
-            }
-            if( !CoCheck( hr ) ) {
-                return false;
-            }
+            CoRelease( device->capture );
         } break;
         case AUDIO_DEVICE_TYPE_OUTPUT: {
-            if( device_index == AUDIO_DEVICE_DEFAULT ) {
-                hr = list->enumerator->lpVtbl->GetDefaultAudioEndpoint(
-                    list->enumerator, eRender, eConsole, &device->device );
-            } else {
-                hr = list->output_devices->lpVtbl->Item(
-                    list->output_devices, device_index, &device->device );
-            }
-            if( !CoCheck( hr ) ) {
-                return false;
-            }
+            CoRelease( device->render );
         } break;
     }
-
-    hr = device->device->lpVtbl->Activate(
+    CoRelease( device->client );
+    CoRelease( device->device );
+}
+/// Activate and initialize client for device->device.
+/// Format is taken from @c opt_format, kept from previous stream
+/// when @c keep_format is true or queried from device mix format otherwise.
+/// Releases everything on failure.
+attr_internal _Bool win32_audio_device_open_endpoint(
+    struct Win32AudioDevice* device,
+    struct AudioBufferFormat* opt_format, _Bool keep_format
+) {
+    HRESULT hr = device->device->lpVtbl->Activate(
         device->device, &IID_IAudioClient, CLSCTX_ALL, NULL, (void**)&device->client );
     if( !CoCheck( hr ) ) {
-        CoRelease( device->device );
+        win32_audio_device_release( device );
         return false;
     }
 
-    REFTIME buffer_length_reftime = buffer_length_ms * REFTIMES_PER_MS;
+    REFTIME buffer_length_reftime = device->buffer_length_ms * REFTIMES_PER_MS;
 
     if( opt_format ) {
         WAVEFORMATEX* fmt = &device->fmt.Format;
@@ -217,12 +496,11 @@ attr_media_api _Bool audio_device_open(
         fmt->nChannels       = opt_format->channel_count;
         fmt->nBlockAlign     = (fmt->nChannels * fmt->wBitsPerSample) / 8;
         fmt->nAvgBytesPerSec = fmt->nSamplesPerSec * fmt->nBlockAlign;
-    } else {
+    } else if( !keep_format ) {
         WAVEFORMATEX* fmt;
         hr = device->client->lpVtbl->GetMixFormat( device->client, &fmt );
         if( !CoCheck( hr ) ) {
-            CoRelease( device->client );
-            CoRelease( device->device );
+            win32_audio_device_release( device );
             return false;
         }
 
@@ -231,25 +509,66 @@ attr_media_api _Bool audio_device_open(
     }
 
     DWORD flags = 0;
-
-    if( opt_format ) {
-        flags |= AUDCLNT_STREAMFLAGS_SRC_DEFAULT_QUALITY |
-            AUDCLNT_STREAMFLAGS_AUTOCONVERTPCM;
+    if( device->open_flags & AUDIO_DEVICE_OPEN_FLAG_EVENT_DRIVEN ) {
+        flags |= AUDCLNT_STREAMFLAGS_EVENTCALLBACK;
     }
 
-    hr = device->client->lpVtbl->Initialize(
-        device->client, AUDCLNT_SHAREMODE_SHARED,
-        flags, buffer_length_reftime, 0, (WAVEFORMATEX*)&device->fmt, NULL );
+    if( device->open_flags & AUDIO_DEVICE_OPEN_FLAG_EXCLUSIVE ) {
+        device->is_exclusive = true;
+        hr = win32_audio_device_initialize_exclusive( device, flags );
+    } else {
+        hr = E_FAIL;
+        if( device->open_flags & AUDIO_DEVICE_OPEN_FLAG_LOW_LATENCY ) {
+            hr = win32_audio_device_initialize_low_latency( device, flags );
+            if( !CoCheck( hr ) ) {
+                win32_warn_fmt(
+                    "audio_device_open: low latency stream not available, "
+                    "falling back to %u ms buffer. hr: %x",
+                    device->buffer_length_ms, (uint32_t)hr );
+                hr = win32_audio_device_reactivate( device );
+                if( !CoCheck( hr ) ) {
+                    win32_audio_device_release( device );
+                    return false;
+                }
+                hr = E_FAIL;
+            }
+        }
+
+        if( !CoCheck( hr ) ) {
+            if( opt_format || keep_format ) {
+                flags |= AUDCLNT_STREAMFLAGS_SRC_DEFAULT_QUALITY |
+                    AUDCLNT_STREAMFLAGS_AUTOCONVERTPCM;
+            }
+
+            hr = device->client->lpVtbl->Initialize(
+                device->client, AUDCLNT_SHAREMODE_SHARED,
+                flags, buffer_length_reftime, 0, (WAVEFORMATEX*)&device->fmt, NULL );
+        }
+    }
     if( !CoCheck( hr ) ) {
-        CoRelease( device->client );
-        CoRelease( device->device );
+        win32_error_fmt(
+            "audio_device_open: IAudioClient::Initialize failed! "
+            "hz: %u channels: %u bits: %u hr: %x",
+            device->fmt.Format.nSamplesPerSec, device->fmt.Format.nChannels,
+            device->fmt.Format.wBitsPerSample, (uint32_t)hr );
+        win32_audio_device_release( device );
         return false;
     }
 
+    if( device->event ) {
+        hr = device->client->lpVtbl->SetEventHandle( device->client, device->event );
+        if( !CoCheck( hr ) ) {
+            win32_error_fmt(
+                "audio_device_open: IAudioClient::SetEventHandle failed! hr: %x",
+                (uint32_t)hr );
+            win32_audio_device_release( device );
+            return false;
+        }
+    }
+
     hr = device->client->lpVtbl->GetBufferSize( device->client, &device->frame_count );
     if( !CoCheck( hr ) ) {
-        CoRelease( device->client );
-        CoRelease( device->device );
+        win32_audio_device_release( device );
         return false;
     }
 
@@ -257,7 +576,7 @@ attr_media_api _Bool audio_device_open(
         device->frame_count * (device->fmt.Format.nChannels *
         (device->fmt.Format.wBitsPerSample / 8 ) );
 
-    switch( type ) {
+    switch( device->type ) {
         case AUDIO_DEVICE_TYPE_INPUT: {
 
         } break;
@@ -265,8 +584,7 @@ attr_media_api _Bool audio_device_open(
             hr = device->client->lpVtbl->GetService(
                 device->client, &IID_IAudioRenderClient, (void**)&device->render );
             if( !CoCheck( hr ) ) {
-                CoRelease( device->client );
-                CoRelease( device->device );
+                win32_audio_device_release( device );
                 return false;
             }
 
@@ -274,9 +592,7 @@ attr_media_api _Bool audio_device_open(
             hr = device->render->lpVtbl->GetBuffer(
                 device->render, device->frame_count, &buf );
             if( !CoCheck( hr ) ) {
-                CoRelease( device->render );
-                CoRelease( device->client );
-                CoRelease( device->device );
+                win32_audio_device_release( device );
                 return false;
             }
 
@@ -285,31 +601,198 @@ attr_media_api _Bool audio_device_open(
             hr = device->render->lpVtbl->ReleaseBuffer(
                 device->render, device->frame_count, 0 );
             if( !CoCheck( hr ) ) {
-                CoRelease( device->render );
-                CoRelease( device->client );
-                CoRelease( device->device );
+                win32_audio_device_release( device );
                 return false;
             }
         } break;
     }
 
+    // NOTE(alicia): device clock is only needed for statistics,
+    // device is still usable without it.
+    hr = device->client->lpVtbl->GetService(
+        device->client, &IID_IAudioClock, (void**)&device->clock );
+    if( CoCheck( hr ) ) {
+        UINT64 frequency = 0;
+        hr = device->clock->lpVtbl->GetFrequency( device->clock, &frequency );
+        if( CoCheck( hr ) && frequency ) {
+            device->clock_frequency = frequency;
+        } else {
+            CoRelease( device->clock );
+        }
+    } else {
+        win32_warn_fmt(
+            "audio_device_open: failed to get audio clock! hr: %x", (uint32_t)hr );
+        device->clock = NULL;
+    }
+
     return true;
 }
-attr_media_api void audio_device_close( AudioDevice* in_device ) {
-    struct Win32AudioDevice* device = in_device;
-    device->client->lpVtbl->Stop( device->client );
+/// Reopen stream on current default endpoint.
+/// Device is left without a stream if there is no default endpoint,
+/// next default device change notification retries.
+attr_internal _Bool win32_audio_device_migrate( struct Win32AudioDevice* device ) {
+    __atomic_store_n( &device->is_migration_pending, false, __ATOMIC_RELAXED );
+
+    if( device->client ) {
+        device->client->lpVtbl->Stop( device->client );
+    }
+    win32_audio_device_release( device );
 
-    CoRelease( device->device );
-    CoRelease( device->client );
-    switch( device->type ) {
+    EDataFlow flow = device->type == AUDIO_DEVICE_TYPE_INPUT ? eCapture : eRender;
+    HRESULT hr = device->enumerator->lpVtbl->GetDefaultAudioEndpoint(
+        device->enumerator, flow, eConsole, &device->device );
+    if( !CoCheck( hr ) ) {
+        device->device = NULL;
+        return false;
+    }
+
+    if( !win32_audio_device_open_endpoint( device, NULL, true ) ) {
+        return false;
+    }
+    device->migration_count++;
+
+    if( device->is_running ) {
+        hr = device->client->lpVtbl->Start( device->client );
+        if( !CoCheck( hr ) ) {
+            win32_error_fmt(
+                "audio: failed to restart migrated audio device! hr: %x", (uint32_t)hr );
+        }
+    }
+    return true;
+}
+/// Check if stream was lost because its endpoint went away.
+/// Schedules migration for devices that follow default endpoint.
+attr_internal _Bool win32_audio_device_check_invalidated(
+    struct Win32AudioDevice* device, HRESULT hr
+) {
+    if(
+        hr == AUDCLNT_E_DEVICE_INVALIDATED &&
+        (device->open_flags & AUDIO_DEVICE_OPEN_FLAG_FOLLOW_DEFAULT)
+    ) {
+        __atomic_store_n( &device->is_migration_pending, true, __ATOMIC_RELEASE );
+        return true;
+    }
+    return false;
+}
+attr_media_api _Bool audio_device_open(
+    AudioDeviceList*          in_list,
+    struct AudioBufferFormat* opt_format,
+    uint32_t                  buffer_length_ms,
+    enum AudioDeviceType      type,
+    uint32_t                  device_index,
+    AudioDeviceOpenFlags      open_flags,
+    AudioDevice*              out_device
+) {
+    struct Win32AudioDeviceList* list   = in_list;
+    struct Win32AudioDevice*     device = out_device;
+
+    // NOTE(alicia): device can be opened on a different thread than list.
+    if( !win32_load_com() ) {
+        win32_error( "audio_device_open: failed to initialize COM!" );
+        return false;
+    }
+
+    if(
+        (open_flags & AUDIO_DEVICE_OPEN_FLAG_FOLLOW_DEFAULT) &&
+        device_index != AUDIO_DEVICE_DEFAULT
+    ) {
+        win32_error(
+            "audio_device_open: AUDIO_DEVICE_OPEN_FLAG_FOLLOW_DEFAULT "
+            "requires AUDIO_DEVICE_DEFAULT!" );
+        return false;
+    }
+    if( open_flags & (
+        AUDIO_DEVICE_OPEN_FLAG_LOW_LATENCY | AUDIO_DEVICE_OPEN_FLAG_EXCLUSIVE
+    ) ) {
+        open_flags |= AUDIO_DEVICE_OPEN_FLAG_EVENT_DRIVEN;
+    }
+
+    memset( device, 0, sizeof(*device) );
+    device->type             = type;
+    device->open_flags       = open_flags;
+    device->buffer_length_ms = buffer_length_ms;
+
+    HRESULT hr;
+    switch( type ) {
         case AUDIO_DEVICE_TYPE_INPUT: {
-            CoRelease( device->capture );
+            if( device_index == AUDIO_DEVICE_DEFAULT ) {
+                hr = list->enumerator->lpVtbl->GetDefaultAudioEndpoint(
+                    list->enumerator, eCapture, eConsole, &device->device );
+            } else {
+                hr = list->input_devices->lpVtbl->Item( 
+                    list->input_devices, device_index, &device->device );
+            }
+            if( !CoCheck( hr ) ) {
+                return false;
+            }
         } break;
         case AUDIO_DEVICE_TYPE_OUTPUT: {
-            CoRelease( device->render );
+            if( device_index == AUDIO_DEVICE_DEFAULT ) {
+                hr = list->enumerator->lpVtbl->GetDefaultAudioEndpoint(
+                    list->enumerator, eRender, eConsole, &device->device );
+            } else {
+                hr = list->output_devices->lpVtbl->Item(
+                    list->output_devices, device_index, &device->device );
+            }
+            if( !CoCheck( hr ) ) {
+                return false;
+            }
         } break;
     }
 
+    if( open_flags & AUDIO_DEVICE_OPEN_FLAG_EVENT_DRIVEN ) {
+        device->event = CreateEventW( NULL, FALSE, FALSE, NULL );
+        if( !device->event ) {
+            win32_error_message( GetLastError(), "audio_device_open: failed to create event!" );
+            CoRelease( device->device );
+            return false;
+        }
+    }
+
+    if( !win32_audio_device_open_endpoint( device, opt_format, false ) ) {
+        if( device->event ) {
+            CloseHandle( device->event );
+        }
+        return false;
+    }
+
+    if( open_flags & AUDIO_DEVICE_OPEN_FLAG_FOLLOW_DEFAULT ) {
+        // NOTE(alicia): device keeps its own enumerator reference
+        // because list is allowed to be destroyed while device is open.
+        device->enumerator = list->enumerator;
+        device->enumerator->lpVtbl->AddRef( device->enumerator );
+
+        win32_audio_notification_init(
+            &device->notification, WIN32_AUDIO_NOTIFICATION_DEVICE, device );
+        hr = device->enumerator->lpVtbl->RegisterEndpointNotificationCallback(
+            device->enumerator, &device->notification.client );
+        if( !CoCheck( hr ) ) {
+            win32_warn_fmt(
+                "audio_device_open: failed to register for default device changes! hr: %x",
+                (uint32_t)hr );
+        } else {
+            device->is_notification_registered = true;
+        }
+    }
+
+    return true;
+}
+attr_media_api void audio_device_close( AudioDevice* in_device ) {
+    struct Win32AudioDevice* device = in_device;
+    if( device->is_notification_registered ) {
+        device->enumerator->lpVtbl->UnregisterEndpointNotificationCallback(
+            device->enumerator, &device->notification.client );
+    }
+    CoRelease( device->enumerator );
+
+    if( device->client ) {
+        device->client->lpVtbl->Stop( device->client );
+    }
+    win32_audio_device_release( device );
+    if( device->event ) {
+        CloseHandle( device->event );
+    }
+
     memset( device, 0, sizeof(*device) );
 }
 attr_media_api void audio_device_query_format(
@@ -324,31 +807,62 @@ attr_media_api void audio_device_query_format(
 attr_media_api _Bool audio_device_buffer_lock(
     AudioDevice* in_device, struct AudioBuffer* out_buffer
 ) {
+    media_trace_scope( "audio_device_buffer_lock" );
     struct Win32AudioDevice* device = in_device;
     if( device->type != AUDIO_DEVICE_TYPE_OUTPUT ) {
         win32_error( "audio: attempted to write lock an input audio device!" );
         return false;
     }
 
-    uint32_t frame_padding_count = 0;
-    HRESULT hr = device->client->lpVtbl->GetCurrentPadding(
-        device->client, &frame_padding_count );
-    if( !CoCheck( hr ) ) {
+    if( __atomic_load_n( &device->is_migration_pending, __ATOMIC_ACQUIRE ) ) {
+        win32_audio_device_migrate( device );
+    }
+    if( !device->client ) {
         return false;
     }
 
-    if( frame_padding_count > device->frame_count ) {
-        return false;
+    HRESULT hr;
+    uint32_t frame_padding_count = 0;
+    // NOTE(alicia): exclusive event driven streams
+    // refill whole buffer every period.
+    if( !device->is_exclusive ) {
+        hr = device->client->lpVtbl->GetCurrentPadding(
+            device->client, &frame_padding_count );
+        if( !CoCheck( hr ) ) {
+            if( !win32_audio_device_check_invalidated( device, hr ) ) {
+                win32_error_fmt(
+                    "audio_device_buffer_lock: GetCurrentPadding failed! hr: %x",
+                    (uint32_t)hr );
+            }
+            return false;
+        }
+
+        if( frame_padding_count > device->frame_count ) {
+            return false;
+        }
+
+        if( frame_padding_count > device->padding_high_water ) {
+            device->padding_high_water = frame_padding_count;
+        }
+        if( device->is_running && !frame_padding_count ) {
+            device->underrun_count++;
+        }
     }
 
     uint32_t frames_request = device->frame_count - frame_padding_count;
     if( !frames_request ) {
+        device->overrun_count++;
         return false;
     }
 
     BYTE* buf = NULL;
     hr = device->render->lpVtbl->GetBuffer( device->render, frames_request, &buf );
     if( !CoCheck( hr ) ) {
+        if( !win32_audio_device_check_invalidated( device, hr ) ) {
+            win32_error_fmt(
+                "audio_device_buffer_lock: GetBuffer failed for %u frames! hr: %x",
+                frames_request, (uint32_t)hr );
+        }
         return false;
     }
 
@@ -370,14 +884,36 @@ attr_media_api void audio_device_buffer_unlock(
     device->render->lpVtbl->ReleaseBuffer( device->render, buffer->sample_count, 0 );
     memset( buffer, 0, sizeof(*buffer) );
 }
+attr_media_api _Bool audio_device_wait( AudioDevice* in_device, uint32_t timeout_ms ) {
+    struct Win32AudioDevice* device = in_device;
+    if( !device->event ) {
+        win32_error( "audio_device_wait: device is not event driven!" );
+        return false;
+    }
+    DWORD timeout = timeout_ms == AUDIO_DEVICE_WAIT_INFINITE ? INFINITE : timeout_ms;
+    if( WaitForSingleObject( device->event, timeout ) != WAIT_OBJECT_0 ) {
+        return false;
+    }
+    // NOTE(alicia): notification thread signals event when default
+    // device changes so waiting thread can migrate in next lock.
+    return device->client ||
+        __atomic_load_n( &device->is_migration_pending, __ATOMIC_ACQUIRE );
+}
 attr_media_api _Bool audio_device_start( AudioDevice* in_device ) {
     struct Win32AudioDevice* device = in_device;
     if( device->type != AUDIO_DEVICE_TYPE_OUTPUT ) {
         win32_error( "audio: attempted to start an input audio device!" );
         return false;
     }
+    if( !device->client ) {
+        // NOTE(alicia): stream was lost while following default device,
+        // it starts when a new default device shows up.
+        device->is_running = true;
+        return true;
+    }
     HRESULT hr = device->client->lpVtbl->Start( device->client );
-    return CoCheck(hr);
+    device->is_running = CoCheck(hr);
+    return device->is_running;
 }
 attr_media_api void audio_device_stop( AudioDevice* in_device ) {
     struct Win32AudioDevice* device = in_device;
@@ -385,7 +921,72 @@ attr_media_api void audio_device_stop( AudioDevice* in_device ) {
         win32_error( "audio: attempted to stop an input audio device!" );
         return;
     }
-    device->client->lpVtbl->Stop( device->client );
+    if( device->client ) {
+        device->client->lpVtbl->Stop( device->client );
+    }
+    device->is_running = false;
+}
+attr_media_api _Bool audio_device_query_stats(
+    AudioDevice* in_device, struct AudioDeviceStats* out_stats
+) {
+    struct Win32AudioDevice* device = in_device;
+    memset( out_stats, 0, sizeof(*out_stats) );
+
+    out_stats->padding_high_water = device->padding_high_water;
+    out_stats->underrun_count     = device->underrun_count;
+    out_stats->overrun_count      = device->overrun_count;
+    out_stats->migration_count    = device->migration_count;
+
+    if( !device->client ) {
+        return false;
+    }
+
+    uint64_t samples_per_second = device->fmt.Format.nSamplesPerSec;
+
+    UINT32 padding = 0;
+    HRESULT hr = device->client->lpVtbl->GetCurrentPadding( device->client, &padding );
+    if( !CoCheck( hr ) ) {
+        return false;
+    }
+    out_stats->padding = padding;
+
+    REFERENCE_TIME latency = 0;
+    hr = device->client->lpVtbl->GetStreamLatency( device->client, &latency );
+    if( !CoCheck( hr ) ) {
+        return false;
+    }
+    // NOTE(alicia): REFERENCE_TIME is in 100ns units.
+    out_stats->stream_latency_ns = (uint64_t)latency * 100;
+    out_stats->latency_ns        = out_stats->stream_latency_ns;
+    if( samples_per_second ) {
+        out_stats->latency_ns +=
+            ((uint64_t)padding * MEDIA_TIME_NS_PER_SECOND) / samples_per_second;
+    }
+
+    if( !device->clock ) {
+        return false;
+    }
+
+    UINT64 position = 0, qpc_position = 0;
+    hr = device->clock->lpVtbl->GetPosition( device->clock, &position, &qpc_position );
+    if( !CoCheck( hr ) ) {
+        return false;
+    }
+    // NOTE(alicia): qpc_position is QueryPerformanceCounter time in 100ns units,
+    // same clock as media_time_ns().
+    out_stats->position_time_ns = qpc_position * 100;
+    out_stats->position =
+        (uint64_t)(((double)position / (double)device->clock_frequency) *
+        (double)samples_per_second);
+
+    return true;
+}
+attr_media_api void audio_device_reset_stats( AudioDevice* in_device ) {
+    struct Win32AudioDevice* device = in_device;
+    device->padding_high_water = 0;
+    device->underrun_count     = 0;
+    device->overrun_count      = 0;
+    device->migration_count    = 0;
 }
 
 #endif /* Platform Windows */
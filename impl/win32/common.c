@@ -40,6 +40,7 @@ def( GetDC );
 def( ReleaseDC );
 def( ShowWindow );
 def( PeekMessageW );
+def( MsgWaitForMultipleObjectsEx );
 def( TranslateMessage );
 def( DispatchMessageW );
 def( SetWindowTextW );
@@ -47,16 +48,23 @@ def( SetWindowPos );
 def( MonitorFromPoint );
 def( MonitorFromWindow );
 def( GetMonitorInfoW );
+def( RegisterPowerSettingNotification );
+def( UnregisterPowerSettingNotification );
+def( EnumDisplayMonitors );
+def( EnumDisplaySettingsExW );
+def( ChangeDisplaySettingsExW );
+def( GetDisplayConfigBufferSizes );
+def( QueryDisplayConfig );
+def( DisplayConfigGetDeviceInfo );
 def( GetWindowPlacement );
 def( SetWindowPlacement );
 def( SetCursor );
 def( LoadCursorA );
 def( ShowCursor );
 def( ClientToScreen );
+def( ClipCursor );
 def( SetCursorPos );
 def( MapVirtualKeyW );
-def( GetForegroundWindow );
-def( GetWindowThreadProcessId );
 def( PostMessageW );
 def( GetCursorPos );
 def( GetKeyState );
@@ -73,6 +81,17 @@ GetWindowLongWFN* in_GetWindowLongW = NULL;
 
 def( GetStockObject );
 
+def( GetDpiForMonitor );
+
+def( WTSRegisterSessionNotification );
+def( WTSUnRegisterSessionNotification );
+
+def( ImmGetContext );
+def( ImmReleaseContext );
+def( ImmGetCompositionStringW );
+def( ImmSetCompositionWindow );
+def( ImmSetCandidateWindow );
+
 def( CoInitialize );
 def( CoCreateInstance );
 def( CoTaskMemFree );
@@ -80,6 +99,7 @@ def( CoUninitialize );
 def( PropVariantClear );
 
 def( DwmSetWindowAttribute );
+def( DwmGetWindowAttribute );
 
 attr_internal void win32_unload_modules(void) {
     if( !global_win32_state ) {
@@ -95,48 +115,28 @@ attr_internal void win32_unload_modules(void) {
     }
 }
 
-attr_media_api uintptr_t media_lib_query_memory_requirement(void) {
-    return sizeof(struct Win32State);
-}
-attr_media_api _Bool media_lib_initialize(
-    MediaLoggingLevel       log_level,
-    MediaLoggingCallbackFN* opt_log_callback,
-    void*                   opt_log_callback_params,
-    void*                   buffer
-) {
-    media_lib_set_logging_level( log_level );
-    media_lib_set_logging_callback( opt_log_callback, opt_log_callback_params );
-
-    if( !buffer ) {
-        win32_error( "media_lib_initialize: buffer provided is null!" );
-        return false;
-    }
-
-    global_win32_state = buffer;
-
-    HMODULE module = GetModuleHandleW(0);
-
-    #define open( lib ) do {\
+#define open( lib ) do {\
+    if( !global_win32_state->modules.lib ) {\
         global_win32_state->modules.lib = LoadLibraryA( #lib ".DLL" );\
         if( !global_win32_state->modules.lib ) {\
-            win32_error( "media_lib_initialize: failed to open library " #lib "!");\
-            win32_unload_modules();\
-            return false;\
+            win32_error_message( GetLastError(), "failed to open library " #lib "!");\
+            return FALSE;\
         }\
-    } while(0)
-    #define load( lib, fn ) do {\
-        fn = (fn##FN*)GetProcAddress( global_win32_state->modules.lib, #fn );\
-        if( !fn ) {\
-            win32_error( "media_lib_initialize: failed to load " #fn " from " #lib "!");\
-            win32_unload_modules();\
-            return false;\
-        }\
-    } while(0)
-
+    }\
+} while(0)
+#define load( lib, fn ) do {\
+    fn = (fn##FN*)GetProcAddress( global_win32_state->modules.lib, #fn );\
+    if( !fn ) {\
+        win32_error( "failed to load " #fn " from " #lib "!");\
+        return FALSE;\
+    }\
+} while(0)
+
+attr_internal BOOL CALLBACK win32_init_user32(
+    PINIT_ONCE once, PVOID params, PVOID* ctx
+) {
+    unused( once, params, ctx );
     open( USER32 );
-    open( GDI32 );
-    open( OLE32 );
-    open( DWMAPI );
 
     load( USER32, MessageBoxW );
     load( USER32, RegisterClassExW );
@@ -150,6 +150,7 @@ attr_media_api _Bool media_lib_initialize(
     load( USER32, ReleaseDC );
     load( USER32, ShowWindow );
     load( USER32, PeekMessageW );
+    load( USER32, MsgWaitForMultipleObjectsEx );
     load( USER32, TranslateMessage );
     load( USER32, DispatchMessageW );
     load( USER32, SetWindowTextW );
@@ -163,15 +164,16 @@ attr_media_api _Bool media_lib_initialize(
     load( USER32, LoadCursorA );
     load( USER32, ShowCursor );
     load( USER32, ClientToScreen );
+    load( USER32, ClipCursor );
     load( USER32, SetCursorPos );
     load( USER32, MapVirtualKeyW );
-    load( USER32, GetForegroundWindow );
-    load( USER32, GetWindowThreadProcessId );
     load( USER32, PostMessageW );
     load( USER32, GetCursorPos );
     load( USER32, GetKeyState );
     load( USER32, ToUnicode );
     load( USER32, ScreenToClient );
+    load( USER32, RegisterPowerSettingNotification );
+    load( USER32, UnregisterPowerSettingNotification );
 
 #if defined(MEDIA_ARCH_64_BIT)
     load( USER32, SetWindowLongPtrW );
@@ -182,8 +184,7 @@ attr_media_api _Bool media_lib_initialize(
             global_win32_state->modules.USER32, "SetWindowLongW" );
     if( !in_SetWindowLongW ) {
         win32_error( "failed to load SetWindowLongW from USER32!");
-        win32_unload_modules();
-        return false;
+        return FALSE;
     }
 
     in_GetWindowLongW =
@@ -191,74 +192,414 @@ attr_media_api _Bool media_lib_initialize(
             global_win32_state->modules.USER32, "GetWindowLongW" );
     if( !in_GetWindowLongW ) {
         win32_error( "failed to load GetWindowLongW from USER32!");
-        win32_unload_modules();
-        return false;
+        return FALSE;
     }
 #endif
 
-    load( GDI32, GetStockObject );
+    _Bool caps   = GetKeyState( VK_CAPITAL ) & 0x0001;
+    _Bool scroll = GetKeyState( VK_SCROLL )  & 0x0001;
+    _Bool num    = GetKeyState( VK_NUMLOCK ) & 0x0001;
 
-    load( OLE32, CoInitialize );
-    load( OLE32, CoCreateInstance );
-    load( OLE32, CoTaskMemFree );
-    load( OLE32, CoUninitialize );
-    load( OLE32, PropVariantClear );
+    global_win32_state->mod |= caps   ? KBMOD_CAPSLK : 0;
+    global_win32_state->mod |= scroll ? KBMOD_SCRLK  : 0;
+    global_win32_state->mod |= num    ? KBMOD_NUMLK  : 0;
 
-    load( DWMAPI, DwmSetWindowAttribute );
+    return TRUE;
+}
+attr_internal BOOL CALLBACK win32_init_surface(
+    PINIT_ONCE once, PVOID params, PVOID* ctx
+) {
+    unused( once, params, ctx );
+    if( !win32_load_user32() ) {
+        return FALSE;
+    }
 
-    if( !CoCheck( CoInitialize( NULL ) ) ) {
-        win32_error( "media_lib_initialize: failed to initialize COM!" );
-        win32_unload_modules();
-        return false;
+    open( GDI32 );
+    load( GDI32, GetStockObject );
+
+    // NOTE(alicia): session lock notifications are optional,
+    // surfaces are just not reported occluded while locked without them.
+    global_win32_state->modules.WTSAPI32 = LoadLibraryA( "WTSAPI32.DLL" );
+    if( global_win32_state->modules.WTSAPI32 ) {
+        WTSRegisterSessionNotification = (WTSRegisterSessionNotificationFN*)GetProcAddress(
+            global_win32_state->modules.WTSAPI32, "WTSRegisterSessionNotification" );
+        WTSUnRegisterSessionNotification = (WTSUnRegisterSessionNotificationFN*)GetProcAddress(
+            global_win32_state->modules.WTSAPI32, "WTSUnRegisterSessionNotification" );
+        if( !WTSRegisterSessionNotification || !WTSUnRegisterSessionNotification ) {
+            WTSRegisterSessionNotification   = NULL;
+            WTSUnRegisterSessionNotification = NULL;
+        }
+    }
+
+    // NOTE(alicia): input method functions are optional,
+    // platform composition window is always used without them.
+    global_win32_state->modules.IMM32 = LoadLibraryA( "IMM32.DLL" );
+    if( global_win32_state->modules.IMM32 ) {
+        HMODULE imm32 = global_win32_state->modules.IMM32;
+        ImmGetContext = (ImmGetContextFN*)GetProcAddress( imm32, "ImmGetContext" );
+        ImmReleaseContext =
+            (ImmReleaseContextFN*)GetProcAddress( imm32, "ImmReleaseContext" );
+        ImmGetCompositionStringW = (ImmGetCompositionStringWFN*)GetProcAddress(
+            imm32, "ImmGetCompositionStringW" );
+        ImmSetCompositionWindow = (ImmSetCompositionWindowFN*)GetProcAddress(
+            imm32, "ImmSetCompositionWindow" );
+        ImmSetCandidateWindow = (ImmSetCandidateWindowFN*)GetProcAddress(
+            imm32, "ImmSetCandidateWindow" );
+        if(
+            !ImmGetContext || !ImmReleaseContext || !ImmGetCompositionStringW ||
+            !ImmSetCompositionWindow || !ImmSetCandidateWindow
+        ) {
+            ImmGetContext = NULL;
+        }
     }
 
     WNDCLASSEXW default_window_class;
     memset( &default_window_class, 0, sizeof(default_window_class) );
     default_window_class.cbSize        = sizeof(default_window_class);
     default_window_class.lpszClassName = WIN32_DEFAULT_WINDOW_CLASS;
-    default_window_class.hInstance     = module;
+    default_window_class.hInstance     = GetModuleHandleW(0);
     default_window_class.hbrBackground = GetStockBrush( BLACK_BRUSH );
     default_window_class.lpfnWndProc   = win32_winproc;
 
     if( !RegisterClassExW( &default_window_class ) ) {
-        win32_error( "media_lib_initialize: failed to register default window class!" );
-        win32_unload_modules();
+        win32_error_message( GetLastError(), "failed to register default window class!" );
+        return FALSE;
+    }
+    global_win32_state->is_window_class_registered = true;
+
+    return TRUE;
+}
+attr_internal BOOL CALLBACK win32_init_dwmapi(
+    PINIT_ONCE once, PVOID params, PVOID* ctx
+) {
+    unused( once, params, ctx );
+    open( DWMAPI );
+    load( DWMAPI, DwmSetWindowAttribute );
+    load( DWMAPI, DwmGetWindowAttribute );
+    return TRUE;
+}
+attr_internal BOOL CALLBACK win32_init_display(
+    PINIT_ONCE once, PVOID params, PVOID* ctx
+) {
+    unused( once, params, ctx );
+    if( !win32_load_user32() ) {
+        return FALSE;
+    }
+    load( USER32, EnumDisplayMonitors );
+    load( USER32, EnumDisplaySettingsExW );
+    load( USER32, ChangeDisplaySettingsExW );
+    load( USER32, GetDisplayConfigBufferSizes );
+    load( USER32, QueryDisplayConfig );
+    load( USER32, DisplayConfigGetDeviceInfo );
+
+    // NOTE(alicia): per-monitor DPI is optional, displays report
+    // default DPI without it.
+    global_win32_state->modules.SHCORE = LoadLibraryA( "SHCORE.DLL" );
+    if( global_win32_state->modules.SHCORE ) {
+        GetDpiForMonitor = (GetDpiForMonitorFN*)GetProcAddress(
+            global_win32_state->modules.SHCORE, "GetDpiForMonitor" );
+    }
+    return TRUE;
+}
+attr_internal BOOL CALLBACK win32_init_ole32(
+    PINIT_ONCE once, PVOID params, PVOID* ctx
+) {
+    unused( once, params, ctx );
+    open( OLE32 );
+    load( OLE32, CoInitialize );
+    load( OLE32, CoCreateInstance );
+    load( OLE32, CoTaskMemFree );
+    load( OLE32, CoUninitialize );
+    load( OLE32, PropVariantClear );
+    return TRUE;
+}
+#undef open
+#undef load
+
+_Bool win32_load_user32(void) {
+    return InitOnceExecuteOnce(
+        &global_win32_state->once.user32, win32_init_user32, NULL, NULL ) != FALSE;
+}
+_Bool win32_load_surface(void) {
+    return InitOnceExecuteOnce(
+        &global_win32_state->once.surface, win32_init_surface, NULL, NULL ) != FALSE;
+}
+_Bool win32_load_dwmapi(void) {
+    return InitOnceExecuteOnce(
+        &global_win32_state->once.dwmapi, win32_init_dwmapi, NULL, NULL ) != FALSE;
+}
+_Bool win32_load_ole32(void) {
+    return InitOnceExecuteOnce(
+        &global_win32_state->once.ole32, win32_init_ole32, NULL, NULL ) != FALSE;
+}
+_Bool win32_load_display(void) {
+    return InitOnceExecuteOnce(
+        &global_win32_state->once.display, win32_init_display, NULL, NULL ) != FALSE;
+}
+_Bool win32_load_com(void) {
+    if( !win32_load_ole32() ) {
+        return false;
+    }
+    struct Win32ThreadState* thread = win32_thread_state();
+    if( !thread ) {
+        return false;
+    }
+    if( thread->is_com_ready ) {
+        return true;
+    }
+
+    HRESULT hr = CoInitialize( NULL );
+    switch( hr ) {
+        // NOTE(alicia): S_FALSE means COM was already initialized
+        // on this thread, it still has to be balanced.
+        case S_OK:
+        case S_FALSE: {
+            thread->is_com_initialized = true;
+        } break;
+        // NOTE(alicia): host application initialized this thread
+        // as multithreaded apartment, COM is usable as is.
+        case RPC_E_CHANGED_MODE: break;
+        default: {
+            win32_error_fmt( "failed to initialize COM! hr: %x", (uint32_t)hr );
+            return false;
+        }
+    }
+    thread->is_com_ready = true;
+    return true;
+}
+
+// NOTE(alicia): fiber local storage is used instead of _Thread_local,
+// library is linked without CRT which provides TLS directory.
+attr_global INIT_ONCE global_win32_thread_once = INIT_ONCE_STATIC_INIT;
+attr_global DWORD     global_win32_thread_fls  = FLS_OUT_OF_INDEXES;
+
+attr_internal VOID WINAPI win32_thread_state_free( PVOID data ) {
+    struct Win32ThreadState* thread = data;
+    if( !thread ) {
+        return;
+    }
+#if defined(MEDIA_ENABLE_TRACE)
+    media_trace_ring_release( thread->trace_ring );
+#endif
+    if( thread->sleep_timer && thread->sleep_timer != INVALID_HANDLE_VALUE ) {
+        CloseHandle( thread->sleep_timer );
+    }
+    // NOTE(alicia): called on exiting thread or on thread that frees
+    // every state in media_lib_shutdown(). COM can only be uninitialized
+    // by the thread that initialized it, other threads release it when they exit.
+    if( thread->is_com_initialized && thread->thread_id == GetCurrentThreadId() ) {
         CoUninitialize();
+    }
+    media_heap_free( thread, sizeof(*thread) );
+}
+attr_internal BOOL CALLBACK win32_init_thread_state(
+    PINIT_ONCE once, PVOID params, PVOID* ctx
+) {
+    unused( once, params, ctx );
+    DWORD index = FlsAlloc( win32_thread_state_free );
+    if( index == FLS_OUT_OF_INDEXES ) {
+        win32_error_message( GetLastError(), "failed to allocate thread state slot!" );
+        return FALSE;
+    }
+    __atomic_store_n( &global_win32_thread_fls, index, __ATOMIC_RELEASE );
+    return TRUE;
+}
+struct Win32ThreadState* win32_thread_state(void) {
+    struct Win32ThreadState* thread = win32_thread_state_query();
+    if( thread ) {
+        return thread;
+    }
+    if( !InitOnceExecuteOnce(
+        &global_win32_thread_once, win32_init_thread_state, NULL, NULL
+    ) ) {
+        return NULL;
+    }
+
+    thread = media_heap_alloc( sizeof(*thread) );
+    if( !thread ) {
+        win32_error( "failed to allocate thread state!" );
+        return NULL;
+    }
+    thread->thread_id      = GetCurrentThreadId();
+    thread->sleep_slack_ns = MEDIA_TIME_NS_PER_MS;
+
+    if( !FlsSetValue( global_win32_thread_fls, thread ) ) {
+        win32_error_message( GetLastError(), "failed to store thread state!" );
+        media_heap_free( thread, sizeof(*thread) );
+        return NULL;
+    }
+    return thread;
+}
+struct Win32ThreadState* win32_thread_state_query(void) {
+    DWORD index = __atomic_load_n( &global_win32_thread_fls, __ATOMIC_ACQUIRE );
+    if( index == FLS_OUT_OF_INDEXES ) {
+        return NULL;
+    }
+    return FlsGetValue( index );
+}
+void win32_thread_state_shutdown(void) {
+    DWORD index = __atomic_exchange_n(
+        &global_win32_thread_fls, FLS_OUT_OF_INDEXES, __ATOMIC_ACQ_REL );
+    if( index == FLS_OUT_OF_INDEXES ) {
+        return;
+    }
+    // NOTE(alicia): calls win32_thread_state_free for every thread.
+    FlsFree( index );
+    InitOnceInitialize( &global_win32_thread_once );
+}
+HCURSOR win32_cursor( CursorType cursor ) {
+    // NOTE(alicia): system cursors are shared so loading
+    // the same cursor twice from different threads is harmless.
+    if( global_win32_cursors[cursor] ) {
+        return global_win32_cursors[cursor];
+    }
+
+    LPCSTR name = IDC_ARROW;
+    switch( cursor ) {
+        case CURSOR_TYPE_ARROW      : name = IDC_ARROW;       break;
+        case CURSOR_TYPE_HAND       : name = IDC_HAND;        break;
+        case CURSOR_TYPE_TEXT       : name = IDC_IBEAM;       break;
+        case CURSOR_TYPE_WAIT       : name = IDC_WAIT;        break;
+        case CURSOR_TYPE_ARROW_WAIT : name = IDC_APPSTARTING; break;
+        case CURSOR_TYPE_SIZE_ALL   : name = IDC_SIZEALL;     break;
+        case CURSOR_TYPE_SIZE_V     : name = IDC_SIZENS;      break;
+        case CURSOR_TYPE_SIZE_H     : name = IDC_SIZEWE;      break;
+        case CURSOR_TYPE_SIZE_L     : name = IDC_SIZENWSE;    break;
+        case CURSOR_TYPE_SIZE_R     : name = IDC_SIZENESW;    break;
+        case CURSOR_TYPE_COUNT      : break;
+    }
+
+    global_win32_cursors[cursor] = LoadCursorA( NULL, name );
+    return global_win32_cursors[cursor];
+}
+
+attr_internal _Bool win32_preload( MediaLibPreloadFlags flags ) {
+    if( flags & MEDIA_LIB_PRELOAD_SURFACE ) {
+        if( !(win32_load_surface() && win32_load_dwmapi()) ) {
+            return false;
+        }
+    }
+    if( flags & MEDIA_LIB_PRELOAD_CURSOR ) {
+        if( !win32_load_user32() ) {
+            return false;
+        }
+        for( CursorType cursor = 0; cursor < CURSOR_TYPE_COUNT; ++cursor ) {
+            win32_cursor( cursor );
+        }
+    }
+    if( flags & MEDIA_LIB_PRELOAD_PROMPT ) {
+        if( !win32_load_user32() ) {
+            return false;
+        }
+    }
+    // NOTE(alicia): COM has to be initialized on the thread that uses it
+    // so only OLE32 functions can be preloaded.
+    if( flags & (MEDIA_LIB_PRELOAD_PROMPT | MEDIA_LIB_PRELOAD_AUDIO) ) {
+        if( !win32_load_ole32() ) {
+            return false;
+        }
+    }
+    if( flags & MEDIA_LIB_PRELOAD_OPENGL ) {
+        if( !win32_load_opengl() ) {
+            return false;
+        }
+    }
+    return true;
+}
+attr_internal DWORD WINAPI win32_preload_thread( LPVOID lpParameter ) {
+    unused( lpParameter );
+    if( !win32_preload( global_win32_state->preload_flags ) ) {
+        win32_error( "media_lib_preload: background preload failed!" );
+        return 1;
+    }
+    return 0;
+}
+
+attr_media_api uintptr_t media_lib_query_memory_requirement(void) {
+    return sizeof(struct Win32State);
+}
+attr_media_api _Bool media_lib_initialize(
+    MediaLoggingLevel       log_level,
+    MediaLoggingCallbackFN* opt_log_callback,
+    void*                   opt_log_callback_params,
+    void*                   buffer
+) {
+    media_lib_set_logging_level( log_level );
+    media_lib_set_logging_callback( opt_log_callback, opt_log_callback_params );
+
+    if( !buffer ) {
+        win32_error( "media_lib_initialize: buffer provided is null!" );
         return false;
     }
 
-    global_win32_cursors[CURSOR_TYPE_ARROW]      = LoadCursorA( NULL, IDC_ARROW );
-    global_win32_cursors[CURSOR_TYPE_HAND]       = LoadCursorA( NULL, IDC_HAND );
-    global_win32_cursors[CURSOR_TYPE_TEXT]       = LoadCursorA( NULL, IDC_IBEAM );
-    global_win32_cursors[CURSOR_TYPE_WAIT]       = LoadCursorA( NULL, IDC_WAIT );
-    global_win32_cursors[CURSOR_TYPE_ARROW_WAIT] = LoadCursorA( NULL, IDC_APPSTARTING );
-    global_win32_cursors[CURSOR_TYPE_SIZE_ALL]   = LoadCursorA( NULL, IDC_SIZEALL );
-    global_win32_cursors[CURSOR_TYPE_SIZE_V]     = LoadCursorA( NULL, IDC_SIZENS );
-    global_win32_cursors[CURSOR_TYPE_SIZE_H]     = LoadCursorA( NULL, IDC_SIZEWE );
-    global_win32_cursors[CURSOR_TYPE_SIZE_L]     = LoadCursorA( NULL, IDC_SIZENWSE );
-    global_win32_cursors[CURSOR_TYPE_SIZE_R]     = LoadCursorA( NULL, IDC_SIZENESW );
+    global_win32_state = buffer;
+    memset( global_win32_state, 0, sizeof(*global_win32_state) );
 
-    _Bool caps   = GetKeyState( VK_CAPITAL ) & 0x0001;
-    _Bool scroll = GetKeyState( VK_SCROLL )  & 0x0001;
-    _Bool num    = GetKeyState( VK_NUMLOCK ) & 0x0001;
+    InitOnceInitialize( &global_win32_state->once.user32 );
+    InitOnceInitialize( &global_win32_state->once.surface );
+    InitOnceInitialize( &global_win32_state->once.dwmapi );
+    InitOnceInitialize( &global_win32_state->once.ole32 );
+    InitOnceInitialize( &global_win32_state->once.opengl );
+    InitOnceInitialize( &global_win32_state->once.display );
+
+    InitializeSRWLock( &global_win32_state->displays.lock );
+    InitializeSRWLock( &global_win32_state->surfaces.lock );
+    global_win32_state->displays.is_dirty = 1;
+
+    global_win32_state->wake_event = CreateEventW( NULL, FALSE, FALSE, NULL );
+    if( !global_win32_state->wake_event ) {
+        win32_error_message( GetLastError(),
+            "media_lib_initialize: failed to create wake event!" );
+        global_win32_state = NULL;
+        return false;
+    }
 
-    global_win32_state->mod |= caps   ? KBMOD_CAPSLK : 0;
-    global_win32_state->mod |= scroll ? KBMOD_SCRLK  : 0;
-    global_win32_state->mod |= num    ? KBMOD_NUMLK  : 0;
+    return true;
+}
+attr_media_api _Bool media_lib_preload( MediaLibPreloadFlags flags, _Bool is_async ) {
+    if( !is_async ) {
+        return win32_preload( flags );
+    }
+
+    if( global_win32_state->preload_thread ) {
+        WaitForSingleObject( global_win32_state->preload_thread, INFINITE );
+        CloseHandle( global_win32_state->preload_thread );
+        global_win32_state->preload_thread = NULL;
+    }
 
-    #undef open
-    #undef load
+    global_win32_state->preload_flags  = flags;
+    global_win32_state->preload_thread =
+        CreateThread( NULL, 0, win32_preload_thread, NULL, 0, NULL );
+    if( !global_win32_state->preload_thread ) {
+        win32_error_message( GetLastError(),
+            "media_lib_preload: failed to create preload thread!" );
+        return false;
+    }
     return true;
 }
 attr_media_api void media_lib_shutdown(void) {
-    CoUninitialize();
-    
-    HMODULE module = GetModuleHandleA(0);
+    if( global_win32_state->preload_thread ) {
+        WaitForSingleObject( global_win32_state->preload_thread, INFINITE );
+        CloseHandle( global_win32_state->preload_thread );
+    }
+    if( global_win32_state->wake_event ) {
+        CloseHandle( global_win32_state->wake_event );
+    }
+
+    // NOTE(alicia): has to run before modules are unloaded,
+    // uninitializes COM on calling thread.
+    win32_thread_state_shutdown();
 
-    UnregisterClassW( WIN32_DEFAULT_WINDOW_CLASS, module );
+    if( global_win32_state->is_window_class_registered ) {
+        HMODULE module = GetModuleHandleA(0);
+        UnregisterClassW( WIN32_DEFAULT_WINDOW_CLASS, module );
+    }
 
+    win32_surface_restore_display_modes();
+    win32_display_shutdown();
     win32_unload_modules();
 
+    memset( global_win32_cursors, 0, sizeof(global_win32_cursors) );
     memset( global_win32_state, 0, sizeof(*global_win32_state) );
     global_win32_state = NULL;
 }
@@ -267,17 +608,43 @@ attr_media_api void cursor_set_visible( _Bool is_visible ) {
     global_win32_cursor_hidden = !is_visible;
 }
 
+void* media_heap_alloc( uintptr_t size ) {
+    return HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, size );
+}
+void media_heap_free( void* memory, uintptr_t size ) {
+    unused( size );
+    HeapFree( GetProcessHeap(), 0, memory );
+}
+
+uint32_t media_trace_platform_thread_id(void) {
+    return (uint32_t)GetCurrentThreadId();
+}
+void* media_trace_platform_ring(void) {
+    struct Win32ThreadState* thread = win32_thread_state_query();
+    return thread ? thread->trace_ring : NULL;
+}
+_Bool media_trace_platform_set_ring( void* ring ) {
+    struct Win32ThreadState* thread = win32_thread_state();
+    if( !thread ) {
+        return false;
+    }
+    thread->trace_ring = ring;
+    return true;
+}
+
 wchar_t* win32_utf8_to_ucs2_alloc(
-    uint32_t utf8_len, const char* utf8, uint32_t* opt_out_len
+    uint32_t utf8_len, const char* utf8,
+    uint32_t* opt_out_len, uintptr_t* out_size
 ) {
-    int required_len = MultiByteToWideChar( CP_UTF8, 0, utf8, utf8_len, 0, 0 );
-    wchar_t* res = HeapAlloc( 
-        GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(wchar_t) * (required_len + 1));
+    uintptr_t required_len = media_utf8_to_utf16( utf8_len, utf8, 0, 0, 0 );
+    uintptr_t size         = sizeof(wchar_t) * (required_len + 1);
+    wchar_t* res     = media_alloc( size );
     if( !res ) {
         return NULL;
     }
+    *out_size = size;
 
-    MultiByteToWideChar( CP_UTF8, 0, utf8, utf8_len, res, required_len + 1 );
+    media_utf8_to_utf16( utf8_len, utf8, required_len, (uint16_t*)res, 0 );
     if( opt_out_len ) {
         *opt_out_len = required_len;
     }
@@ -301,52 +668,15 @@ MONITORINFO win32_monitor_info( HWND opt_hwnd ) {
     GetMonitorInfoW( monitor, &result );
     return result;
 }
-HWND win32_get_focused_window(void) {
-    HWND focused = GetForegroundWindow();
-    DWORD pid;
-    GetWindowThreadProcessId( focused, &pid );
-    if( pid != GetCurrentProcessId() ) {
-        return NULL;
-    }
-    return focused;
-}
-
-void win32_error_message_full(
-    DWORD error_code, uint32_t message_len, const char* message
-) {
-    unused( error_code, message_len, message );
-#if defined(MEDIA_ENABLE_LOGGING)
-    if( error_code == ERROR_SUCCESS ) {
-        return;
-    }
-
-    #define prefix "win32: "
-
-    uint32_t buffer_size = message_len + sizeof(prefix) + 256 + 8;
-    uint32_t buffer_len  = 0;
-
-    char* buffer = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, buffer_size );
-    memcpy( buffer, prefix, sizeof(prefix) );
-    buffer_len += sizeof(prefix) - 1;
-
-    memcpy( buffer + buffer_len, message, message_len );
-    buffer_len += message_len;
-
-    buffer[buffer_len++] = ' ';
-    buffer[buffer_len++] = '"';
-
-    int format_len = FormatMessageA(
+uint32_t media_log_platform_error_text( uint64_t code, uint32_t cap, char* buffer ) {
+    DWORD len = FormatMessageA(
         FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
-        0, error_code, 0, buffer + buffer_len, buffer_size - buffer_len, 0 );
-
-    buffer_len += format_len - 2;
-    buffer[buffer_len++] = '"';
-
-    media_log( MEDIA_LOGGING_LEVEL_ERROR, buffer_len, buffer );
-
-    HeapFree( GetProcessHeap(), 0, buffer );
-    #undef prefix
-#endif /* MEDIA_ENABLE_LOGGING */
+        0, (DWORD)code, 0, buffer, cap, 0 );
+    // NOTE(alicia): system messages end with "\r\n".
+    while( len && (buffer[len - 1] == '\n' || buffer[len - 1] == '\r') ) {
+        len--;
+    }
+    return len;
 }
 
 #undef def
@@ -10,13 +10,19 @@
 #if defined(MEDIA_PLATFORM_WINDOWS)
 #include "media/types.h"
 #include "media/internal/logging.h"
+#include "media/internal/alloc.h"
+#include "media/internal/unicode.h"
+#include "media/internal/trace.h"
 #include "media/cursor.h"
+#include "media/lib.h"
+#include "media/display.h"
 
 // IWYU pragma: begin_exports
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
 #include <windows.h>
 #include <combaseapi.h>
+#include <imm.h>
 
 // NOTE(alicia): defined in winuser.h, conflicts with MouseButton enum
 #undef MB_RIGHT
@@ -27,6 +33,73 @@
 #if !defined(DWMWA_USE_IMMERSIVE_DARK_MODE)
     #define DWMWA_USE_IMMERSIVE_DARK_MODE (20)
 #endif
+#if !defined(WM_DPICHANGED)
+    #define WM_DPICHANGED (0x02E0)
+#endif
+#if !defined(DWMWA_CLOAKED)
+    #define DWMWA_CLOAKED (14)
+#endif
+#if !defined(WM_WTSSESSION_CHANGE)
+    #define WM_WTSSESSION_CHANGE (0x02B1)
+#endif
+#if !defined(WTS_SESSION_LOCK)
+    #define WTS_SESSION_LOCK   (0x7)
+    #define WTS_SESSION_UNLOCK (0x8)
+#endif
+#if !defined(NOTIFY_FOR_THIS_SESSION)
+    #define NOTIFY_FOR_THIS_SESSION (0)
+#endif
+
+// NOTE(alicia): slot indices are stored as uint8_t.
+#define WIN32_SURFACE_REGISTRY_CAP (64)
+// NOTE(alicia): hash table must be larger than registry.
+#define WIN32_SURFACE_REGISTRY_HASH_BITS (7)
+#define WIN32_SURFACE_REGISTRY_HASH_CAP  (1 << WIN32_SURFACE_REGISTRY_HASH_BITS)
+
+struct Win32Surface;
+struct Win32SurfaceFlush;
+struct Win32SurfaceSlot {
+    struct Win32Surface* surface;
+    uint16_t generation;
+    uint16_t next_free;
+};
+// NOTE(alicia): dense table of live surfaces,
+// HWND lookup goes through an open addressed hash of slot indices.
+struct Win32SurfaceRegistry {
+    struct Win32SurfaceSlot slots[WIN32_SURFACE_REGISTRY_CAP];
+    HWND    hash_keys[WIN32_SURFACE_REGISTRY_HASH_CAP];
+    uint8_t hash_slots[WIN32_SURFACE_REGISTRY_HASH_CAP];
+    // NOTE(alicia): slots ever used, slots below this are live or free listed.
+    uint16_t used;
+    // NOTE(alicia): index + 1 of first free slot, 0 if none.
+    uint16_t free_head;
+    // NOTE(alicia): surfaces that did not fit, found with GWLP_USERDATA.
+    uint32_t overflow_count;
+    struct Win32Surface* focused;
+    // NOTE(alicia): surfaces can be created on any thread, registry and
+    // focused surface are only accessed with this held.
+    SRWLOCK lock;
+};
+
+struct Win32Display {
+    struct DisplayInfo info;
+    HMONITOR monitor;
+    wchar_t  device[CCHDEVICENAME];
+    // NOTE(alicia): index of first mode in Win32DisplayCache::modes.
+    uint32_t first_mode;
+};
+// NOTE(alicia): rebuilt lazily after WM_DISPLAYCHANGE and friends,
+// readers hold lock shared, rebuild holds it exclusive.
+struct Win32DisplayCache {
+    SRWLOCK lock;
+    volatile LONG is_dirty;
+    uint32_t generation;
+    uint32_t count;
+    uint32_t primary;
+    struct Win32Display displays[DISPLAY_MAX_COUNT];
+    struct DisplayMode* modes;
+    uintptr_t           modes_size;
+};
 
 struct Win32State {
     union {
@@ -37,18 +110,66 @@ struct Win32State {
             HMODULE XINPUT;
             HMODULE OPENGL32;
             HMODULE OLE32;
+            HMODULE VULKAN;
+            HMODULE SHCORE;
+            HMODULE WTSAPI32;
+            HMODULE IMM32;
         };
-        HMODULE array[7];
+        HMODULE array[10];
     } modules;
+    struct {
+        INIT_ONCE user32;
+        INIT_ONCE surface;
+        INIT_ONCE dwmapi;
+        INIT_ONCE ole32;
+        INIT_ONCE opengl;
+        INIT_ONCE display;
+    } once;
+    HANDLE preload_thread;
+    // NOTE(alicia): auto-reset event signaled by surface_wake().
+    HANDLE wake_event;
+    enum MediaLibPreloadFlags preload_flags;
+    _Bool is_window_class_registered;
     enum KeyboardMod mod;
     enum MouseButton mb;
+    struct Win32SurfaceRegistry surfaces;
+    struct Win32DisplayCache    displays;
+    // NOTE(alicia): global reasons for surfaces to be occluded.
+    _Bool is_session_locked;
+    _Bool is_display_off;
 };
 extern struct Win32State* global_win32_state;
 extern HCURSOR global_win32_cursors[CURSOR_TYPE_COUNT];
 extern _Bool global_win32_cursor_hidden;
 
+// NOTE(alicia): state of each thread that uses the library,
+// freed when thread exits or library is shutdown.
+struct Win32ThreadState {
+    DWORD thread_id;
+    // NOTE(alicia): COM can be used on this thread.
+    _Bool is_com_ready;
+    // NOTE(alicia): CoInitialize succeeded on this thread and has to be balanced.
+    _Bool is_com_initialized;
+    // NOTE(alicia): trace ring owned by this thread.
+    void* trace_ring;
+    // NOTE(alicia): created on first sleep, INVALID_HANDLE_VALUE if that failed.
+    HANDLE sleep_timer;
+    // NOTE(alicia): estimate of how late sleep timer wakes up.
+    uint64_t sleep_slack_ns;
+    // NOTE(alicia): surfaces of this thread with coalesced move/resize
+    // waiting for end of pump.
+    struct Win32Surface* pending_surfaces;
+    // NOTE(alicia): surfaces whose pending callbacks are being sent,
+    // innermost flush first. surface_destroy() clears its entries.
+    struct Win32SurfaceFlush* flushing;
+    // NOTE(alicia): last time surfaces of this thread were checked for DWM cloaking.
+    uint64_t cloak_poll_ns;
+};
+
 #define win32_error(...) media_error( "win32: " __VA_ARGS__)
 #define win32_warn(...) media_warn( "win32: " __VA_ARGS__)
+#define win32_error_fmt( format, ... ) media_error_fmt( "win32: " format, __VA_ARGS__ )
+#define win32_warn_fmt( format, ... ) media_warn_fmt( "win32: " format, __VA_ARGS__ )
 
 #define CoCheck( hres ) ((hres) == (S_OK))
 #define CoRelease( punk ) do {\
@@ -58,20 +179,58 @@ extern _Bool global_win32_cursor_hidden;
     }\
 } while(0)
 
+// NOTE(alicia): lazy loaders, safe to call from any thread.
+// each one only does work until it succeeds once.
+_Bool win32_load_user32(void);
+_Bool win32_load_surface(void);
+_Bool win32_load_dwmapi(void);
+_Bool win32_load_ole32(void);
+// NOTE(alicia): initializes COM for calling thread,
+// balanced when thread exits or calls media_lib_shutdown().
+_Bool win32_load_com(void);
+_Bool win32_load_display(void);
+// NOTE(alicia): defined in opengl.c
+_Bool win32_load_opengl(void);
+// NOTE(alicia): defined in time.c
+// high resolution waitable timer owned by calling thread, NULL if unavailable.
+HANDLE win32_sleep_timer(void);
+// convert performance counter value to nanoseconds on media_time_ns() timeline.
+uint64_t win32_qpc_to_ns( uint64_t qpc );
+// NOTE(alicia): defined in display.c
+void win32_display_shutdown(void);
+// NOTE(alicia): defined in surface.c
+// restores display modes changed by exclusive fullscreen surfaces.
+void win32_surface_restore_display_modes(void);
+
+// NOTE(alicia): state of calling thread, created on first call.
+// NULL if it could not be allocated.
+struct Win32ThreadState* win32_thread_state(void);
+// NOTE(alicia): state of calling thread, NULL if it was never created.
+struct Win32ThreadState* win32_thread_state_query(void);
+// NOTE(alicia): frees state of every thread.
+void win32_thread_state_shutdown(void);
+
+HCURSOR win32_cursor( CursorType cursor );
+
+// NOTE(alicia): result must be freed with media_free( result, *out_size ).
 wchar_t* win32_utf8_to_ucs2_alloc(
-    uint32_t utf8_len, const char* utf8, uint32_t* opt_out_len );
+    uint32_t utf8_len, const char* utf8,
+    uint32_t* opt_out_len, uintptr_t* out_size );
 
 MONITORINFO win32_monitor_info( HWND opt_hwnd );
 
-void win32_error_message_full(
-    DWORD error_code, uint32_t message_len, const char* message );
-
-#define win32_error_message( error_code, message )\
-    win32_error_message_full( error_code, sizeof(message) - 1, message )
+#define win32_error_message( error_code, message ) do {\
+    DWORD win32_error_code = (error_code);\
+    if( win32_error_code != ERROR_SUCCESS ) {\
+        win32_error_fmt( message " \"%e\"", (uint64_t)win32_error_code );\
+    }\
+} while(0)
 
 LRESULT win32_winproc( HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam );
 
-HWND win32_get_focused_window(void);
+// NOTE(alicia): defined in surface.c, returns surface focused
+// by most recent WM_ACTIVATE.
+HWND win32_get_focused_window( _Bool* opt_out_is_relative_mouse );
 
 // NOTE(alicia): windows library functions
 
@@ -125,6 +284,11 @@ decl( BOOL, PeekMessageW,
      UINT wMsgFilterMin, UINT wMsgFilterMax, UINT wRemoveMsg );
 #define PeekMessageW in_PeekMessageW
 
+decl( DWORD, MsgWaitForMultipleObjectsEx,
+     DWORD nCount, const HANDLE* pHandles,
+     DWORD dwMilliseconds, DWORD dwWakeMask, DWORD dwFlags );
+#define MsgWaitForMultipleObjectsEx in_MsgWaitForMultipleObjectsEx
+
 decl( BOOL, TranslateMessage, const MSG* lpMsg );
 #define TranslateMessage in_TranslateMessage
 
@@ -147,6 +311,40 @@ decl( HMONITOR, MonitorFromWindow, HWND hwnd, DWORD dwFlags );
 decl( BOOL, GetMonitorInfoW, HMONITOR hMonitor, LPMONITORINFO lpmi );
 #define GetMonitorInfoW in_GetMonitorInfoW
 
+decl( HPOWERNOTIFY, RegisterPowerSettingNotification,
+     HANDLE hRecipient, LPCGUID PowerSettingGuid, DWORD Flags );
+#define RegisterPowerSettingNotification in_RegisterPowerSettingNotification
+
+decl( BOOL, UnregisterPowerSettingNotification, HPOWERNOTIFY Handle );
+#define UnregisterPowerSettingNotification in_UnregisterPowerSettingNotification
+
+decl( BOOL, EnumDisplayMonitors,
+     HDC hdc, LPCRECT lprcClip, MONITORENUMPROC lpfnEnum, LPARAM dwData );
+#define EnumDisplayMonitors in_EnumDisplayMonitors
+
+decl( BOOL, EnumDisplaySettingsExW,
+     LPCWSTR lpszDeviceName, DWORD iModeNum, DEVMODEW* lpDevMode, DWORD dwFlags );
+#define EnumDisplaySettingsExW in_EnumDisplaySettingsExW
+
+decl( LONG, ChangeDisplaySettingsExW,
+     LPCWSTR lpszDeviceName, DEVMODEW* lpDevMode,
+     HWND hwnd, DWORD dwflags, LPVOID lParam );
+#define ChangeDisplaySettingsExW in_ChangeDisplaySettingsExW
+
+decl( LONG, GetDisplayConfigBufferSizes,
+     UINT32 flags, UINT32* numPathArrayElements, UINT32* numModeInfoArrayElements );
+#define GetDisplayConfigBufferSizes in_GetDisplayConfigBufferSizes
+
+decl( LONG, QueryDisplayConfig,
+     UINT32 flags,
+     UINT32* numPathArrayElements, DISPLAYCONFIG_PATH_INFO* pathArray,
+     UINT32* numModeInfoArrayElements, DISPLAYCONFIG_MODE_INFO* modeInfoArray,
+     DISPLAYCONFIG_TOPOLOGY_ID* currentTopologyId );
+#define QueryDisplayConfig in_QueryDisplayConfig
+
+decl( LONG, DisplayConfigGetDeviceInfo, DISPLAYCONFIG_DEVICE_INFO_HEADER* requestPacket );
+#define DisplayConfigGetDeviceInfo in_DisplayConfigGetDeviceInfo
+
 decl( BOOL, GetWindowPlacement, HWND hWnd, WINDOWPLACEMENT* lpwndpl );
 #define GetWindowPlacement in_GetWindowPlacement
 
@@ -165,18 +363,15 @@ decl( int, ShowCursor, BOOL bShow );
 decl( BOOL, ClientToScreen, HWND hWnd, LPPOINT lpPoint );
 #define ClientToScreen in_ClientToScreen
 
+decl( BOOL, ClipCursor, const RECT* lpRect );
+#define ClipCursor in_ClipCursor
+
 decl( BOOL, SetCursorPos, int X, int Y );
 #define SetCursorPos in_SetCursorPos
 
 decl( UINT, MapVirtualKeyW, UINT uCode, UINT uMapType );
 #define MapVirtualKeyW in_MapVirtualKeyW
 
-decl( HWND, GetForegroundWindow, void );
-#define GetForegroundWindow in_GetForegroundWindow
-
-decl( DWORD, GetWindowThreadProcessId, HWND hWnd, LPDWORD lpdwProcessId );
-#define GetWindowThreadProcessId in_GetWindowThreadProcessId
-
 decl( BOOL, PostMessageW, HWND hWnd, UINT Msg, WPARAM wParam, LPARAM lParam );
 #define PostMessageW in_PostMessageW
 
@@ -224,6 +419,38 @@ decl( BOOL, ScreenToClient, HWND hWnd, LPPOINT lpPoint );
 decl( HGDIOBJ, GetStockObject, int i );
 #define GetStockObject in_GetStockObject
 
+// NOTE(alicia): SHCORE, optional (Windows 8.1+)
+
+decl( HRESULT, GetDpiForMonitor,
+     HMONITOR hmonitor, int dpiType, UINT* dpiX, UINT* dpiY );
+#define GetDpiForMonitor in_GetDpiForMonitor
+
+// NOTE(alicia): WTSAPI32, optional
+
+decl( BOOL, WTSRegisterSessionNotification, HWND hWnd, DWORD dwFlags );
+#define WTSRegisterSessionNotification in_WTSRegisterSessionNotification
+
+decl( BOOL, WTSUnRegisterSessionNotification, HWND hWnd );
+#define WTSUnRegisterSessionNotification in_WTSUnRegisterSessionNotification
+
+// NOTE(alicia): IMM32, optional
+
+decl( HIMC, ImmGetContext, HWND hWnd );
+#define ImmGetContext in_ImmGetContext
+
+decl( BOOL, ImmReleaseContext, HWND hWnd, HIMC hIMC );
+#define ImmReleaseContext in_ImmReleaseContext
+
+decl( LONG, ImmGetCompositionStringW,
+    HIMC hIMC, DWORD dwIndex, LPVOID lpBuf, DWORD dwBufLen );
+#define ImmGetCompositionStringW in_ImmGetCompositionStringW
+
+decl( BOOL, ImmSetCompositionWindow, HIMC hIMC, LPCOMPOSITIONFORM lpCompForm );
+#define ImmSetCompositionWindow in_ImmSetCompositionWindow
+
+decl( BOOL, ImmSetCandidateWindow, HIMC hIMC, LPCANDIDATEFORM lpCandidate );
+#define ImmSetCandidateWindow in_ImmSetCandidateWindow
+
 // NOTE(alicia): OLE32
 
 decl( HRESULT, CoInitialize, LPVOID pvReserved );
@@ -249,5 +476,9 @@ decl( HRESULT, DwmSetWindowAttribute,
      HWND hwnd, DWORD dwAttribute, LPCVOID pvAttribute, DWORD cbAttribute );
 #define DwmSetWindowAttribute in_DwmSetWindowAttribute
 
+decl( HRESULT, DwmGetWindowAttribute,
+     HWND hwnd, DWORD dwAttribute, PVOID pvAttribute, DWORD cbAttribute );
+#define DwmGetWindowAttribute in_DwmGetWindowAttribute
+
 #endif /* Platform Windows */
 #endif /* header guard */
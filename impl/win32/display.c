@@ -0,0 +1,436 @@
+/**
+ * @file   display.c
+ * @brief  Media Windows Display.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 21, 2024
+*/
+#include "media/defines.h"
+#if defined(MEDIA_PLATFORM_WINDOWS)
+#include "media/display.h"
+#include "impl/win32/common.h"
+#include "impl/win32/surface.h"
+
+attr_internal _Bool win32_display_device_equal( const wchar_t* a, const wchar_t* b ) {
+    for( uint32_t i = 0; i < CCHDEVICENAME; ++i ) {
+        if( a[i] != b[i] ) {
+            return false;
+        }
+        if( !a[i] ) {
+            break;
+        }
+    }
+    return true;
+}
+attr_internal void win32_display_set_name(
+    struct DisplayInfo* info, uint32_t cap, const wchar_t* name
+) {
+    uint32_t len = 0;
+    while( len < cap && name[len] ) {
+        len++;
+    }
+    memset( info->name, 0, sizeof(info->name) );
+    info->name_len = (uint32_t)media_utf16_to_utf8(
+        len, (const uint16_t*)name, DISPLAY_NAME_CAP - 1, info->name, 0 );
+    if( info->name_len > DISPLAY_NAME_CAP - 1 ) {
+        info->name_len = DISPLAY_NAME_CAP - 1;
+    }
+}
+attr_internal struct DisplayRefreshRate win32_display_rate( uint32_t n, uint32_t d ) {
+    struct DisplayRefreshRate result;
+    if( !n || !d ) {
+        result.numerator   = 0;
+        result.denominator = 1;
+        return result;
+    }
+    uint32_t a = n, b = d;
+    while( b ) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    result.numerator   = n / a;
+    result.denominator = d / a;
+    return result;
+}
+attr_internal struct DisplayMode win32_display_mode_from_devmode( const DEVMODEW* dm ) {
+    struct DisplayMode result;
+    result.w              = (int32_t)dm->dmPelsWidth;
+    result.h              = (int32_t)dm->dmPelsHeight;
+    result.bits_per_pixel = dm->dmBitsPerPel;
+    // NOTE(alicia): 0 and 1 both mean hardware default rate.
+    result.refresh_rate   = win32_display_rate(
+        dm->dmDisplayFrequency > 1 ? dm->dmDisplayFrequency : 0, 1 );
+    return result;
+}
+/// @return Positive if a should be listed before b.
+attr_internal int win32_display_mode_compare(
+    const struct DisplayMode* a, const struct DisplayMode* b
+) {
+    if( a->w != b->w ) {
+        return a->w > b->w ? 1 : -1;
+    }
+    if( a->h != b->h ) {
+        return a->h > b->h ? 1 : -1;
+    }
+    uint64_t ra = (uint64_t)a->refresh_rate.numerator * b->refresh_rate.denominator;
+    uint64_t rb = (uint64_t)b->refresh_rate.numerator * a->refresh_rate.denominator;
+    if( ra != rb ) {
+        return ra > rb ? 1 : -1;
+    }
+    if( a->bits_per_pixel != b->bits_per_pixel ) {
+        return a->bits_per_pixel > b->bits_per_pixel ? 1 : -1;
+    }
+    return 0;
+}
+
+attr_internal BOOL CALLBACK win32_display_enum_proc(
+    HMONITOR monitor, HDC hdc, LPRECT rect, LPARAM lparam
+) {
+    unused( hdc, rect );
+    struct Win32DisplayCache* cache = (struct Win32DisplayCache*)lparam;
+    if( cache->count >= DISPLAY_MAX_COUNT ) {
+        return FALSE;
+    }
+
+    MONITORINFOEXW info;
+    memset( &info, 0, sizeof(info) );
+    info.cbSize = sizeof(info);
+    if( !GetMonitorInfoW( monitor, (MONITORINFO*)&info ) ) {
+        return TRUE;
+    }
+
+    struct Win32Display* display = cache->displays + cache->count;
+    memset( display, 0, sizeof(*display) );
+    display->monitor = monitor;
+    memcpy( display->device, info.szDevice, sizeof(display->device) );
+
+    display->info.x      = info.rcMonitor.left;
+    display->info.y      = info.rcMonitor.top;
+    display->info.w      = info.rcMonitor.right  - info.rcMonitor.left;
+    display->info.h      = info.rcMonitor.bottom - info.rcMonitor.top;
+    display->info.work_x = info.rcWork.left;
+    display->info.work_y = info.rcWork.top;
+    display->info.work_w = info.rcWork.right  - info.rcWork.left;
+    display->info.work_h = info.rcWork.bottom - info.rcWork.top;
+
+    display->info.is_primary = (info.dwFlags & MONITORINFOF_PRIMARY) != 0;
+    if( display->info.is_primary ) {
+        cache->primary = cache->count;
+    }
+
+    UINT dpi_x = DISPLAY_DEFAULT_DPI, dpi_y = DISPLAY_DEFAULT_DPI;
+    if( GetDpiForMonitor ) {
+        // NOTE(alicia): 0 is MDT_EFFECTIVE_DPI.
+        if( FAILED( GetDpiForMonitor( monitor, 0, &dpi_x, &dpi_y ) ) ) {
+            dpi_x = DISPLAY_DEFAULT_DPI;
+        }
+    }
+    display->info.dpi   = dpi_x;
+    display->info.scale = (float)dpi_x / (float)DISPLAY_DEFAULT_DPI;
+
+    DEVMODEW dm;
+    memset( &dm, 0, sizeof(dm) );
+    dm.dmSize = sizeof(dm);
+    if( EnumDisplaySettingsExW( info.szDevice, ENUM_CURRENT_SETTINGS, &dm, 0 ) ) {
+        display->info.mode = win32_display_mode_from_devmode( &dm );
+    } else {
+        display->info.mode.w = display->info.w;
+        display->info.mode.h = display->info.h;
+        display->info.mode.refresh_rate = win32_display_rate( 0, 0 );
+    }
+
+    // NOTE(alicia): fallback name, replaced by monitor's friendly name
+    // in win32_display_query_config() if available.
+    win32_display_set_name( &display->info, CCHDEVICENAME, info.szDevice );
+
+    cache->count++;
+    return TRUE;
+}
+/// @brief Fill exact refresh rates and friendly names from display configuration.
+attr_internal void win32_display_query_config( struct Win32DisplayCache* cache ) {
+    UINT32 path_count = 0, mode_count = 0;
+    if( GetDisplayConfigBufferSizes(
+        QDC_ONLY_ACTIVE_PATHS, &path_count, &mode_count ) != ERROR_SUCCESS
+    ) {
+        return;
+    }
+    if( !path_count ) {
+        return;
+    }
+
+    uintptr_t paths_size = sizeof(DISPLAYCONFIG_PATH_INFO) * path_count;
+    uintptr_t modes_size = sizeof(DISPLAYCONFIG_MODE_INFO) * mode_count;
+    DISPLAYCONFIG_PATH_INFO* paths = media_alloc( paths_size );
+    if( !paths ) {
+        return;
+    }
+    DISPLAYCONFIG_MODE_INFO* modes = media_alloc( modes_size );
+    if( !modes ) {
+        media_free( paths, paths_size );
+        return;
+    }
+
+    if( QueryDisplayConfig(
+        QDC_ONLY_ACTIVE_PATHS, &path_count, paths, &mode_count, modes, NULL
+    ) != ERROR_SUCCESS ) {
+        path_count = 0;
+    }
+
+    for( UINT32 i = 0; i < path_count; ++i ) {
+        DISPLAYCONFIG_PATH_INFO* path = paths + i;
+
+        DISPLAYCONFIG_SOURCE_DEVICE_NAME source;
+        memset( &source, 0, sizeof(source) );
+        source.header.type      = DISPLAYCONFIG_DEVICE_INFO_GET_SOURCE_NAME;
+        source.header.size      = sizeof(source);
+        source.header.adapterId = path->sourceInfo.adapterId;
+        source.header.id        = path->sourceInfo.id;
+        if( DisplayConfigGetDeviceInfo( &source.header ) != ERROR_SUCCESS ) {
+            continue;
+        }
+
+        struct Win32Display* display = NULL;
+        for( uint32_t d = 0; d < cache->count; ++d ) {
+            if( win32_display_device_equal(
+                cache->displays[d].device, source.viewGdiDeviceName
+            ) ) {
+                display = cache->displays + d;
+                break;
+            }
+        }
+        if( !display ) {
+            continue;
+        }
+
+        DISPLAYCONFIG_RATIONAL rate = path->targetInfo.refreshRate;
+        if( rate.Numerator && rate.Denominator ) {
+            display->info.mode.refresh_rate =
+                win32_display_rate( rate.Numerator, rate.Denominator );
+        }
+
+        DISPLAYCONFIG_TARGET_DEVICE_NAME target;
+        memset( &target, 0, sizeof(target) );
+        target.header.type      = DISPLAYCONFIG_DEVICE_INFO_GET_TARGET_NAME;
+        target.header.size      = sizeof(target);
+        target.header.adapterId = path->targetInfo.adapterId;
+        target.header.id        = path->targetInfo.id;
+        if(
+            DisplayConfigGetDeviceInfo( &target.header ) == ERROR_SUCCESS &&
+            target.monitorFriendlyDeviceName[0]
+        ) {
+            win32_display_set_name(
+                &display->info,
+                sizeof(target.monitorFriendlyDeviceName) / sizeof(wchar_t),
+                target.monitorFriendlyDeviceName );
+        }
+    }
+
+    media_free( modes, modes_size );
+    media_free( paths, paths_size );
+}
+attr_internal uint32_t win32_display_count_modes( const wchar_t* device ) {
+    DEVMODEW dm;
+    memset( &dm, 0, sizeof(dm) );
+    dm.dmSize = sizeof(dm);
+
+    uint32_t count = 0;
+    while( EnumDisplaySettingsExW( device, count, &dm, 0 ) ) {
+        count++;
+    }
+    return count;
+}
+/// @brief Write sorted, unique modes of display to cache.
+attr_internal void win32_display_fill_modes(
+    struct Win32DisplayCache* cache, struct Win32Display* display, uint32_t cap
+) {
+    struct DisplayMode* modes = cache->modes + display->first_mode;
+    struct DisplayRefreshRate current = display->info.mode.refresh_rate;
+
+    DEVMODEW dm;
+    memset( &dm, 0, sizeof(dm) );
+    dm.dmSize = sizeof(dm);
+
+    uint32_t count = 0;
+    for( DWORD i = 0; count < cap && EnumDisplaySettingsExW( display->device, i, &dm, 0 ); ++i ) {
+        struct DisplayMode mode = win32_display_mode_from_devmode( &dm );
+        // NOTE(alicia): modes only report whole hertz, current rate
+        // is exact so reuse it when it rounds down to the same value.
+        if(
+            current.denominator > 1 &&
+            mode.refresh_rate.numerator == current.numerator / current.denominator
+        ) {
+            mode.refresh_rate = current;
+        }
+
+        // NOTE(alicia): same mode is listed once for each
+        // scaling and orientation, insertion sort drops duplicates.
+        uint32_t at = count;
+        int order   = 1;
+        while( at && (order = win32_display_mode_compare( &mode, modes + at - 1 )) > 0 ) {
+            at--;
+        }
+        if( at && !order ) {
+            continue;
+        }
+        memmove( modes + at + 1, modes + at, sizeof(*modes) * (count - at) );
+        modes[at] = mode;
+        count++;
+    }
+    display->info.mode_count = count;
+}
+attr_internal void win32_display_rebuild( struct Win32DisplayCache* cache ) {
+    if( cache->modes ) {
+        media_heap_free( cache->modes, cache->modes_size );
+        cache->modes      = NULL;
+        cache->modes_size = 0;
+    }
+    cache->count   = 0;
+    cache->primary = 0;
+    cache->generation++;
+
+    if( !EnumDisplayMonitors( NULL, NULL, win32_display_enum_proc, (LPARAM)cache ) ) {
+        if( !cache->count ) {
+            win32_error_message( GetLastError(), "failed to enumerate displays!" );
+            return;
+        }
+    }
+    win32_display_query_config( cache );
+
+    uint32_t caps[DISPLAY_MAX_COUNT];
+    uint32_t total = 0;
+    for( uint32_t i = 0; i < cache->count; ++i ) {
+        caps[i] = win32_display_count_modes( cache->displays[i].device );
+        cache->displays[i].first_mode = total;
+        total += caps[i];
+    }
+    if( !total ) {
+        return;
+    }
+
+    uintptr_t size = sizeof(struct DisplayMode) * total;
+    cache->modes   = media_heap_alloc( size );
+    if( !cache->modes ) {
+        win32_error( "failed to allocate display modes!" );
+        for( uint32_t i = 0; i < cache->count; ++i ) {
+            cache->displays[i].first_mode = 0;
+        }
+        return;
+    }
+    cache->modes_size = size;
+
+    for( uint32_t i = 0; i < cache->count; ++i ) {
+        win32_display_fill_modes( cache, cache->displays + i, caps[i] );
+    }
+}
+/// @brief Rebuild cache if it is out of date and lock it for reading.
+/// @return NULL if displays could not be loaded, otherwise
+/// cache must be released with win32_display_release().
+attr_internal struct Win32DisplayCache* win32_display_acquire(void) {
+    if( !win32_load_display() ) {
+        return NULL;
+    }
+    struct Win32DisplayCache* cache = &global_win32_state->displays;
+    if( cache->is_dirty ) {
+        AcquireSRWLockExclusive( &cache->lock );
+        if( InterlockedExchange( &cache->is_dirty, 0 ) ) {
+            win32_display_rebuild( cache );
+        }
+        ReleaseSRWLockExclusive( &cache->lock );
+    }
+    AcquireSRWLockShared( &cache->lock );
+    return cache;
+}
+attr_internal void win32_display_release( struct Win32DisplayCache* cache ) {
+    ReleaseSRWLockShared( &cache->lock );
+}
+void win32_display_shutdown(void) {
+    struct Win32DisplayCache* cache = &global_win32_state->displays;
+    if( cache->modes ) {
+        media_heap_free( cache->modes, cache->modes_size );
+        cache->modes      = NULL;
+        cache->modes_size = 0;
+    }
+}
+
+attr_media_api uint32_t display_query_count(void) {
+    struct Win32DisplayCache* cache = win32_display_acquire();
+    if( !cache ) {
+        return 0;
+    }
+    uint32_t result = cache->count;
+    win32_display_release( cache );
+    return result;
+}
+attr_media_api uint32_t display_query_primary(void) {
+    struct Win32DisplayCache* cache = win32_display_acquire();
+    if( !cache ) {
+        return DISPLAY_INVALID;
+    }
+    uint32_t result = cache->count ? cache->primary : DISPLAY_INVALID;
+    win32_display_release( cache );
+    return result;
+}
+attr_media_api uint32_t display_from_surface( const SurfaceHandle* in_surface ) {
+    const struct Win32Surface* surface = in_surface;
+    struct Win32DisplayCache* cache = win32_display_acquire();
+    if( !cache ) {
+        return DISPLAY_INVALID;
+    }
+
+    HMONITOR monitor = MonitorFromWindow( surface->hwnd, MONITOR_DEFAULTTONEAREST );
+    uint32_t result  = cache->count ? cache->primary : DISPLAY_INVALID;
+    for( uint32_t i = 0; i < cache->count; ++i ) {
+        if( cache->displays[i].monitor == monitor ) {
+            result = i;
+            break;
+        }
+    }
+
+    win32_display_release( cache );
+    return result;
+}
+attr_media_api _Bool display_query_info( uint32_t display, struct DisplayInfo* out_info ) {
+    struct Win32DisplayCache* cache = win32_display_acquire();
+    if( !cache ) {
+        return false;
+    }
+    _Bool result = display < cache->count;
+    if( result ) {
+        *out_info = cache->displays[display].info;
+    }
+    win32_display_release( cache );
+    return result;
+}
+attr_media_api uint32_t display_query_modes(
+    uint32_t display, uint32_t cap, struct DisplayMode* opt_out_modes
+) {
+    struct Win32DisplayCache* cache = win32_display_acquire();
+    if( !cache ) {
+        return 0;
+    }
+    uint32_t result = 0;
+    if( display < cache->count && cache->modes ) {
+        struct Win32Display* d = cache->displays + display;
+        result = d->info.mode_count;
+        if( opt_out_modes ) {
+            uint32_t count = cap < result ? cap : result;
+            memcpy( opt_out_modes, cache->modes + d->first_mode, sizeof(*opt_out_modes) * count );
+        }
+    }
+    win32_display_release( cache );
+    return result;
+}
+attr_media_api uint32_t display_query_generation(void) {
+    struct Win32DisplayCache* cache = win32_display_acquire();
+    if( !cache ) {
+        return 0;
+    }
+    uint32_t result = cache->generation;
+    win32_display_release( cache );
+    return result;
+}
+attr_media_api void display_invalidate(void) {
+    InterlockedExchange( &global_win32_state->displays.is_dirty, 1 );
+}
+
+#endif /* Platform Windows */
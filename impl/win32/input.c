@@ -8,14 +8,18 @@
 #if defined(MEDIA_PLATFORM_WINDOWS)
 #include "media/surface.h"
 #include "media/input.h"
+#include "media/time.h"
 #include "impl/win32/common.h"
 #include "impl/win32/input.h"
+#include "impl/win32/surface.h"
 
 #include <xinput.h>
 #include <hidusage.h>
 
 #define WIN32_INPUT_WINDOW_CLASS L"MediaInputWindow"
 #define WIN32_INPUT_POLL_XINPUT_MS 2
+// NOTE(alicia): most coalesced samples read per pointer message.
+#define WIN32_INPUT_POINTER_HISTORY_READ 32
 
 struct Win32Input* global_win32_input = NULL;
 
@@ -32,12 +36,32 @@ def( UINT, GetRawInputData,
     LPVOID pData, PUINT pcbSize, UINT cbSizeHeader );
 #define GetRawInputData in_GetRawInputData
 
+def( UINT, MapVirtualKeyExW, UINT uCode, UINT uMapType, HKL dwhkl );
+#define MapVirtualKeyExW in_MapVirtualKeyExW
+
+def( HKL, GetKeyboardLayout, DWORD idThread );
+#define GetKeyboardLayout in_GetKeyboardLayout
+
 def( DWORD, XInputGetState, DWORD dwUserIndex, XINPUT_STATE* pState );
 #define XInputGetState in_XInputGetState
 
 def( DWORD, XInputSetState, DWORD dwUserIndex, XINPUT_VIBRATION* pVibration );
 #define XInputSetState in_XInputSetState
 
+def( BOOL, GetPointerType, UINT32 pointerId, POINTER_INPUT_TYPE* pointerType );
+#define GetPointerType in_GetPointerType
+
+def( BOOL, GetPointerInfo, UINT32 pointerId, POINTER_INFO* pointerInfo );
+#define GetPointerInfo in_GetPointerInfo
+
+def( BOOL, GetPointerTouchInfoHistory,
+    UINT32 pointerId, UINT32* entriesCount, POINTER_TOUCH_INFO* touchInfo );
+#define GetPointerTouchInfoHistory in_GetPointerTouchInfoHistory
+
+def( BOOL, GetPointerPenInfoHistory,
+    UINT32 pointerId, UINT32* entriesCount, POINTER_PEN_INFO* penInfo );
+#define GetPointerPenInfoHistory in_GetPointerPenInfoHistory
+
 DWORD XInputSetState_stub( DWORD dwUserIndex, XINPUT_VIBRATION* pVibration ) {
     unused( dwUserIndex, pVibration );
     return ERROR_SUCCESS;
@@ -45,6 +69,365 @@ DWORD XInputSetState_stub( DWORD dwUserIndex, XINPUT_VIBRATION* pVibration ) {
 
 LRESULT win32_winproc_input( HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam );
 
+// NOTE(alicia): set 1 scancode, extended (E0) scancodes have high bit set.
+#define E0( scan ) ((scan) | 0x80)
+attr_global const KeyboardScancode global_win32_scancode_table[256] = {
+    [0x01]     = KB_ESCAPE,
+    [0x02]     = KB_1,
+    [0x03]     = KB_2,
+    [0x04]     = KB_3,
+    [0x05]     = KB_4,
+    [0x06]     = KB_5,
+    [0x07]     = KB_6,
+    [0x08]     = KB_7,
+    [0x09]     = KB_8,
+    [0x0A]     = KB_9,
+    [0x0B]     = KB_0,
+    [0x0C]     = KB_MINUS,
+    [0x0D]     = KB_EQUALS,
+    [0x0E]     = KB_BACKSPACE,
+    [0x0F]     = KB_TAB,
+    [0x10]     = KB_Q,
+    [0x11]     = KB_W,
+    [0x12]     = KB_E,
+    [0x13]     = KB_R,
+    [0x14]     = KB_T,
+    [0x15]     = KB_Y,
+    [0x16]     = KB_U,
+    [0x17]     = KB_I,
+    [0x18]     = KB_O,
+    [0x19]     = KB_P,
+    [0x1A]     = KB_BRACKET_LEFT,
+    [0x1B]     = KB_BRACKET_RIGHT,
+    [0x1C]     = KB_ENTER,
+    [0x1D]     = KB_CONTROL_LEFT,
+    [0x1E]     = KB_A,
+    [0x1F]     = KB_S,
+    [0x20]     = KB_D,
+    [0x21]     = KB_F,
+    [0x22]     = KB_G,
+    [0x23]     = KB_H,
+    [0x24]     = KB_J,
+    [0x25]     = KB_K,
+    [0x26]     = KB_L,
+    [0x27]     = KB_SEMICOLON,
+    [0x28]     = KB_QUOTE,
+    [0x29]     = KB_BACKTICK,
+    [0x2A]     = KB_SHIFT_LEFT,
+    [0x2B]     = KB_BACKSLASH,
+    [0x2C]     = KB_Z,
+    [0x2D]     = KB_X,
+    [0x2E]     = KB_C,
+    [0x2F]     = KB_V,
+    [0x30]     = KB_B,
+    [0x31]     = KB_N,
+    [0x32]     = KB_M,
+    [0x33]     = KB_COMMA,
+    [0x34]     = KB_PERIOD,
+    [0x35]     = KB_SLASH,
+    [0x36]     = KB_SHIFT_RIGHT,
+    [0x37]     = KB_PAD_MULTIPLY,
+    [0x38]     = KB_ALT_LEFT,
+    [0x39]     = KB_SPACE,
+    [0x3A]     = KB_CAPSLOCK,
+    [0x3B]     = KB_F1,
+    [0x3C]     = KB_F2,
+    [0x3D]     = KB_F3,
+    [0x3E]     = KB_F4,
+    [0x3F]     = KB_F5,
+    [0x40]     = KB_F6,
+    [0x41]     = KB_F7,
+    [0x42]     = KB_F8,
+    [0x43]     = KB_F9,
+    [0x44]     = KB_F10,
+    [0x45]     = KB_NUM_LOCK,
+    [0x46]     = KB_SCROLL_LOCK,
+    [0x47]     = KB_PAD_7,
+    [0x48]     = KB_PAD_8,
+    [0x49]     = KB_PAD_9,
+    [0x4A]     = KB_PAD_SUBTRACT,
+    [0x4B]     = KB_PAD_4,
+    [0x4C]     = KB_PAD_5,
+    [0x4D]     = KB_PAD_6,
+    [0x4E]     = KB_PAD_ADD,
+    [0x4F]     = KB_PAD_1,
+    [0x50]     = KB_PAD_2,
+    [0x51]     = KB_PAD_3,
+    [0x52]     = KB_PAD_0,
+    [0x53]     = KB_PAD_DOT,
+    [0x57]     = KB_F11,
+    [0x58]     = KB_F12,
+    [0x64]     = KB_F13,
+    [0x65]     = KB_F14,
+    [0x66]     = KB_F15,
+    [0x67]     = KB_F16,
+    [0x68]     = KB_F17,
+    [0x69]     = KB_F18,
+    [0x6A]     = KB_F19,
+    [0x6B]     = KB_F20,
+    [0x6C]     = KB_F21,
+    [0x6D]     = KB_F22,
+    [0x6E]     = KB_F23,
+    [0x76]     = KB_F24,
+    [E0(0x1C)] = KB_ENTER,
+    [E0(0x1D)] = KB_CONTROL_RIGHT,
+    [E0(0x35)] = KB_PAD_DIVIDE,
+    [E0(0x37)] = KB_PRINT_SCREEN,
+    [E0(0x38)] = KB_ALT_RIGHT,
+    [E0(0x45)] = KB_NUM_LOCK,
+    [E0(0x47)] = KB_HOME,
+    [E0(0x48)] = KB_ARROW_UP,
+    [E0(0x49)] = KB_PAGE_UP,
+    [E0(0x4B)] = KB_ARROW_LEFT,
+    [E0(0x4D)] = KB_ARROW_RIGHT,
+    [E0(0x4F)] = KB_END,
+    [E0(0x50)] = KB_ARROW_DOWN,
+    [E0(0x51)] = KB_PAGE_DOWN,
+    [E0(0x52)] = KB_INSERT,
+    [E0(0x53)] = KB_DELETE,
+    [E0(0x5B)] = KB_SUPER_LEFT,
+    [E0(0x5C)] = KB_SUPER_RIGHT,
+    [E0(0x5D)] = KB_RIGHT_CLICK_MENU,
+};
+#undef E0
+attr_global const KeyboardCode global_win32_vk_table[256] = {
+    [VK_BACK]       = KB_BACKSPACE,
+    [VK_TAB]        = KB_TAB,
+    [VK_RETURN]     = KB_ENTER,
+    [VK_SHIFT]      = KB_SHIFT_LEFT,
+    [VK_CONTROL]    = KB_CONTROL_LEFT,
+    [VK_MENU]       = KB_ALT_LEFT,
+    [VK_PAUSE]      = KB_PAUSE,
+    [VK_CAPITAL]    = KB_CAPSLOCK,
+    [VK_ESCAPE]     = KB_ESCAPE,
+    [VK_SPACE]      = KB_SPACE,
+    [VK_PRIOR]      = KB_PAGE_UP,
+    [VK_NEXT]       = KB_PAGE_DOWN,
+    [VK_END]        = KB_END,
+    [VK_HOME]       = KB_HOME,
+    [VK_LEFT]       = KB_ARROW_LEFT,
+    [VK_UP]         = KB_ARROW_UP,
+    [VK_RIGHT]      = KB_ARROW_RIGHT,
+    [VK_DOWN]       = KB_ARROW_DOWN,
+    [VK_SNAPSHOT]   = KB_PRINT_SCREEN,
+    [VK_INSERT]     = KB_INSERT,
+    [VK_DELETE]     = KB_DELETE,
+    ['0']           = KB_0,
+    ['1']           = KB_1,
+    ['2']           = KB_2,
+    ['3']           = KB_3,
+    ['4']           = KB_4,
+    ['5']           = KB_5,
+    ['6']           = KB_6,
+    ['7']           = KB_7,
+    ['8']           = KB_8,
+    ['9']           = KB_9,
+    ['A']           = KB_A,
+    ['B']           = KB_B,
+    ['C']           = KB_C,
+    ['D']           = KB_D,
+    ['E']           = KB_E,
+    ['F']           = KB_F,
+    ['G']           = KB_G,
+    ['H']           = KB_H,
+    ['I']           = KB_I,
+    ['J']           = KB_J,
+    ['K']           = KB_K,
+    ['L']           = KB_L,
+    ['M']           = KB_M,
+    ['N']           = KB_N,
+    ['O']           = KB_O,
+    ['P']           = KB_P,
+    ['Q']           = KB_Q,
+    ['R']           = KB_R,
+    ['S']           = KB_S,
+    ['T']           = KB_T,
+    ['U']           = KB_U,
+    ['V']           = KB_V,
+    ['W']           = KB_W,
+    ['X']           = KB_X,
+    ['Y']           = KB_Y,
+    ['Z']           = KB_Z,
+    [VK_LWIN]       = KB_SUPER_LEFT,
+    [VK_RWIN]       = KB_SUPER_RIGHT,
+    [VK_APPS]       = KB_RIGHT_CLICK_MENU,
+    [VK_NUMPAD0]    = KB_PAD_0,
+    [VK_NUMPAD1]    = KB_PAD_1,
+    [VK_NUMPAD2]    = KB_PAD_2,
+    [VK_NUMPAD3]    = KB_PAD_3,
+    [VK_NUMPAD4]    = KB_PAD_4,
+    [VK_NUMPAD5]    = KB_PAD_5,
+    [VK_NUMPAD6]    = KB_PAD_6,
+    [VK_NUMPAD7]    = KB_PAD_7,
+    [VK_NUMPAD8]    = KB_PAD_8,
+    [VK_NUMPAD9]    = KB_PAD_9,
+    [VK_MULTIPLY]   = KB_PAD_MULTIPLY,
+    [VK_ADD]        = KB_PAD_ADD,
+    [VK_SUBTRACT]   = KB_PAD_SUBTRACT,
+    [VK_DECIMAL]    = KB_PAD_DOT,
+    [VK_DIVIDE]     = KB_PAD_DIVIDE,
+    [VK_F1]         = KB_F1,
+    [VK_F2]         = KB_F2,
+    [VK_F3]         = KB_F3,
+    [VK_F4]         = KB_F4,
+    [VK_F5]         = KB_F5,
+    [VK_F6]         = KB_F6,
+    [VK_F7]         = KB_F7,
+    [VK_F8]         = KB_F8,
+    [VK_F9]         = KB_F9,
+    [VK_F10]        = KB_F10,
+    [VK_F11]        = KB_F11,
+    [VK_F12]        = KB_F12,
+    [VK_F13]        = KB_F13,
+    [VK_F14]        = KB_F14,
+    [VK_F15]        = KB_F15,
+    [VK_F16]        = KB_F16,
+    [VK_F17]        = KB_F17,
+    [VK_F18]        = KB_F18,
+    [VK_F19]        = KB_F19,
+    [VK_F20]        = KB_F20,
+    [VK_F21]        = KB_F21,
+    [VK_F22]        = KB_F22,
+    [VK_F23]        = KB_F23,
+    [VK_F24]        = KB_F24,
+    [VK_NUMLOCK]    = KB_NUM_LOCK,
+    [VK_SCROLL]     = KB_SCROLL_LOCK,
+    [VK_LSHIFT]     = KB_SHIFT_LEFT,
+    [VK_RSHIFT]     = KB_SHIFT_RIGHT,
+    [VK_LCONTROL]   = KB_CONTROL_LEFT,
+    [VK_RCONTROL]   = KB_CONTROL_RIGHT,
+    [VK_LMENU]      = KB_ALT_LEFT,
+    [VK_RMENU]      = KB_ALT_RIGHT,
+    [VK_OEM_1]      = KB_SEMICOLON,
+    [VK_OEM_PLUS]   = KB_EQUALS,
+    [VK_OEM_COMMA]  = KB_COMMA,
+    [VK_OEM_MINUS]  = KB_MINUS,
+    [VK_OEM_PERIOD] = KB_PERIOD,
+    [VK_OEM_2]      = KB_SLASH,
+    [VK_OEM_3]      = KB_BACKTICK,
+    [VK_OEM_4]      = KB_BRACKET_LEFT,
+    [VK_OEM_5]      = KB_BACKSLASH,
+    [VK_OEM_6]      = KB_BRACKET_RIGHT,
+    [VK_OEM_7]      = KB_QUOTE,
+};
+attr_global const uint8_t global_win32_keyboard_code_table[KB_COUNT] = {
+    [KB_BACKSPACE]        = VK_BACK,
+    [KB_TAB]              = VK_TAB,
+    [KB_ENTER]            = VK_RETURN,
+    [KB_SHIFT_LEFT]       = VK_SHIFT,
+    [KB_SHIFT_RIGHT]      = VK_RSHIFT,
+    [KB_CONTROL_LEFT]     = VK_CONTROL,
+    [KB_CONTROL_RIGHT]    = VK_RCONTROL,
+    [KB_ALT_LEFT]         = VK_MENU,
+    [KB_ALT_RIGHT]        = VK_RMENU,
+    [KB_PAUSE]            = VK_PAUSE,
+    [KB_CAPSLOCK]         = VK_CAPITAL,
+    [KB_ESCAPE]           = VK_ESCAPE,
+    [KB_SPACE]            = VK_SPACE,
+    [KB_PAGE_UP]          = VK_PRIOR,
+    [KB_PAGE_DOWN]        = VK_NEXT,
+    [KB_END]              = VK_END,
+    [KB_HOME]             = VK_HOME,
+    [KB_ARROW_LEFT]       = VK_LEFT,
+    [KB_ARROW_UP]         = VK_UP,
+    [KB_ARROW_RIGHT]      = VK_RIGHT,
+    [KB_ARROW_DOWN]       = VK_DOWN,
+    [KB_PRINT_SCREEN]     = VK_SNAPSHOT,
+    [KB_INSERT]           = VK_INSERT,
+    [KB_DELETE]           = VK_DELETE,
+    [KB_0]                = '0',
+    [KB_1]                = '1',
+    [KB_2]                = '2',
+    [KB_3]                = '3',
+    [KB_4]                = '4',
+    [KB_5]                = '5',
+    [KB_6]                = '6',
+    [KB_7]                = '7',
+    [KB_8]                = '8',
+    [KB_9]                = '9',
+    [KB_A]                = 'A',
+    [KB_B]                = 'B',
+    [KB_C]                = 'C',
+    [KB_D]                = 'D',
+    [KB_E]                = 'E',
+    [KB_F]                = 'F',
+    [KB_G]                = 'G',
+    [KB_H]                = 'H',
+    [KB_I]                = 'I',
+    [KB_J]                = 'J',
+    [KB_K]                = 'K',
+    [KB_L]                = 'L',
+    [KB_M]                = 'M',
+    [KB_N]                = 'N',
+    [KB_O]                = 'O',
+    [KB_P]                = 'P',
+    [KB_Q]                = 'Q',
+    [KB_R]                = 'R',
+    [KB_S]                = 'S',
+    [KB_T]                = 'T',
+    [KB_U]                = 'U',
+    [KB_V]                = 'V',
+    [KB_W]                = 'W',
+    [KB_X]                = 'X',
+    [KB_Y]                = 'Y',
+    [KB_Z]                = 'Z',
+    [KB_SUPER_LEFT]       = VK_LWIN,
+    [KB_SUPER_RIGHT]      = VK_RWIN,
+    [KB_PAD_0]            = VK_NUMPAD0,
+    [KB_PAD_1]            = VK_NUMPAD1,
+    [KB_PAD_2]            = VK_NUMPAD2,
+    [KB_PAD_3]            = VK_NUMPAD3,
+    [KB_PAD_4]            = VK_NUMPAD4,
+    [KB_PAD_5]            = VK_NUMPAD5,
+    [KB_PAD_6]            = VK_NUMPAD6,
+    [KB_PAD_7]            = VK_NUMPAD7,
+    [KB_PAD_8]            = VK_NUMPAD8,
+    [KB_PAD_9]            = VK_NUMPAD9,
+    [KB_PAD_ADD]          = VK_ADD,
+    [KB_PAD_MULTIPLY]     = VK_MULTIPLY,
+    [KB_PAD_SUBTRACT]     = VK_SUBTRACT,
+    [KB_PAD_DIVIDE]       = VK_DIVIDE,
+    [KB_PAD_DOT]          = VK_DECIMAL,
+    [KB_F1]               = VK_F1,
+    [KB_F2]               = VK_F2,
+    [KB_F3]               = VK_F3,
+    [KB_F4]               = VK_F4,
+    [KB_F5]               = VK_F5,
+    [KB_F6]               = VK_F6,
+    [KB_F7]               = VK_F7,
+    [KB_F8]               = VK_F8,
+    [KB_F9]               = VK_F9,
+    [KB_F10]              = VK_F10,
+    [KB_F11]              = VK_F11,
+    [KB_F12]              = VK_F12,
+    [KB_F13]              = VK_F13,
+    [KB_F14]              = VK_F14,
+    [KB_F15]              = VK_F15,
+    [KB_F16]              = VK_F16,
+    [KB_F17]              = VK_F17,
+    [KB_F18]              = VK_F18,
+    [KB_F19]              = VK_F19,
+    [KB_F20]              = VK_F20,
+    [KB_F21]              = VK_F21,
+    [KB_F22]              = VK_F22,
+    [KB_F23]              = VK_F23,
+    [KB_F24]              = VK_F24,
+    [KB_NUM_LOCK]         = VK_NUMLOCK,
+    [KB_SCROLL_LOCK]      = VK_SCROLL,
+    [KB_SEMICOLON]        = VK_OEM_1,
+    [KB_EQUALS]           = VK_OEM_PLUS,
+    [KB_COMMA]            = VK_OEM_COMMA,
+    [KB_MINUS]            = VK_OEM_MINUS,
+    [KB_PERIOD]           = VK_OEM_PERIOD,
+    [KB_SLASH]            = VK_OEM_2,
+    [KB_BACKTICK]         = VK_OEM_3,
+    [KB_BRACKET_LEFT]     = VK_OEM_4,
+    [KB_BACKSLASH]        = VK_OEM_5,
+    [KB_BRACKET_RIGHT]    = VK_OEM_6,
+    [KB_QUOTE]            = VK_OEM_7,
+    [KB_RIGHT_CLICK_MENU] = VK_APPS,
+};
+
 DWORD win32_xinput_thread( LPVOID lpParameter ) {
     volatile long* atomic = (volatile long*)lpParameter;
     unused(atomic);
@@ -84,11 +467,38 @@ attr_media_api _Bool input_subsystem_initialize( void* buffer ) {
         }\
     } while(0)
 
+    if( !win32_load_user32() ) {
+        win32_error( "input_subsystem_initialize: failed to load USER32!" );
+        return false;
+    }
+
     HMODULE module     = GetModuleHandleW(0);
     global_win32_input = buffer;
 
     load( USER32, RegisterRawInputDevices );
     load( USER32, GetRawInputData );
+    load( USER32, MapVirtualKeyExW );
+    load( USER32, GetKeyboardLayout );
+
+    global_win32_input->layout.hkl = NULL;
+    win32_input_layout_rebuild( GetKeyboardLayout( 0 ) );
+
+    // NOTE(alicia): pointer input requires Windows 8,
+    // touch and pen are only reported as mouse without it.
+    HMODULE user32 = global_win32_state->modules.USER32;
+    GetPointerType = (GetPointerTypeFN*)GetProcAddress( user32, "GetPointerType" );
+    GetPointerInfo = (GetPointerInfoFN*)GetProcAddress( user32, "GetPointerInfo" );
+    GetPointerTouchInfoHistory = (GetPointerTouchInfoHistoryFN*)GetProcAddress(
+        user32, "GetPointerTouchInfoHistory" );
+    GetPointerPenInfoHistory   = (GetPointerPenInfoHistoryFN*)GetProcAddress(
+        user32, "GetPointerPenInfoHistory" );
+    if(
+        !GetPointerType || !GetPointerInfo ||
+        !GetPointerTouchInfoHistory || !GetPointerPenInfoHistory
+    ) {
+        GetPointerType = NULL;
+        win32_warn( "input_subsystem_initialize: touch and pen input is not available!" );
+    }
 
     _Bool xinput_1_3 = false;
     HMODULE xinput = LoadLibraryA( "XINPUT1_4.DLL" );
@@ -200,7 +610,18 @@ attr_media_api void input_subsystem_shutdown(void) {
     memset( global_win32_input, 0, sizeof(*global_win32_input) );
     global_win32_input = NULL;
 }
+attr_internal void win32_input_drain_raw(void) {
+    MSG message;
+    memset( &message, 0, sizeof(message) );
+    while( PeekMessageW(
+        &message, global_win32_input->hwnd,
+        WM_INPUT, WM_INPUT, PM_REMOVE
+    ) ) {
+        DispatchMessageW( &message );
+    }
+}
 attr_media_api void input_subsystem_update(void) {
+    media_trace_scope( "input_subsystem_update" );
     XINPUT_STATE xinput_state;
     memset( &xinput_state, 0, sizeof(xinput_state) );
     for( DWORD i = 0; i < XUSER_MAX_COUNT; ++i ) {
@@ -231,35 +652,85 @@ attr_media_api void input_subsystem_update(void) {
         memset( &xinput_state, 0, sizeof(xinput_state) );
     }
 
-    HWND focused = win32_get_focused_window();
-    POINT point;
-    GetCursorPos( &point );
-    if( focused ) {
-        if(
-            point.x != global_win32_input->mb_x ||
-            point.y != global_win32_input->mb_y
-        ) {
-            PostMessageW(
-                focused, WM_CUSTOM_MOUSE_POS,
-                win32_mouse_x_to_wparam( point.x ),
-                win32_mouse_y_to_lparam( point.y ) );
+    // NOTE(alicia): position is frozen in relative mouse mode,
+    // only raw deltas are reported.
+    _Bool is_relative_mouse = false;
+    HWND  focused = win32_get_focused_window( &is_relative_mouse );
+
+    if( !is_relative_mouse ) {
+        POINT point;
+        GetCursorPos( &point );
+        if( focused ) {
+            if(
+                point.x != global_win32_input->mb_x ||
+                point.y != global_win32_input->mb_y
+            ) {
+                PostMessageW(
+                    focused, WM_CUSTOM_MOUSE_POS,
+                    win32_mouse_x_to_wparam( point.x ),
+                    win32_mouse_y_to_lparam( point.y ) );
+            }
         }
-    }
 
-    global_win32_input->mb_x = point.x;
-    global_win32_input->mb_y = point.y;
+        global_win32_input->mb_x = point.x;
+        global_win32_input->mb_y = point.y;
+    }
 
     global_win32_input->mb_dx = 0;
     global_win32_input->mb_dy = 0;
 
-    MSG message;
-    memset( &message, 0, sizeof(message) );
-    while( PeekMessageW(
-        &message, global_win32_input->hwnd,
-        WM_INPUT, WM_INPUT, PM_REMOVE
-    ) ) {
-        DispatchMessageW( &message );
+    // NOTE(alicia): released contacts are reported for one update.
+    uint32_t contact_count = 0;
+    for( uint32_t i = 0; i < global_win32_input->pointer_contact_count; ++i ) {
+        PointerSample* contact = global_win32_input->pointer_contacts + i;
+        if( contact->state & POINTER_STATE_RELEASED ) {
+            continue;
+        }
+        global_win32_input->pointer_contacts[contact_count++] = *contact;
     }
+    global_win32_input->pointer_contact_count = contact_count;
+    global_win32_input->pointer_history_count = 0;
+
+    win32_input_drain_raw();
+
+    if( global_win32_input->gp_processor ) {
+        uint8_t connected = 0;
+        for( uint32_t i = 0; i < GAMEPAD_MAX_COUNT; ++i ) {
+            if( global_win32_input->gp_connected[i] ) {
+                connected |= (1 << i);
+            }
+        }
+        // NOTE(alicia): first update after setting processor skips smoothing.
+        uint64_t now   = media_time_ns();
+        float    delta = global_win32_input->gp_processor_time_ns ?
+            (float)(now - global_win32_input->gp_processor_time_ns) / 1000000000.0f : 0.0f;
+        global_win32_input->gp_processor_time_ns = now;
+
+        gamepad_processor_update(
+            global_win32_input->gp_processor, connected,
+            global_win32_input->gp, delta );
+    }
+    if( global_win32_input->action_map ) {
+        InputSnapshot snapshot;
+        memset( &snapshot, 0, sizeof(snapshot) );
+        snapshot.keys      = global_win32_input->kb;
+        snapshot.scancodes = global_win32_input->kb_scan;
+        snapshot.mouse     = global_win32_state->mb;
+        for( uint32_t i = 0; i < GAMEPAD_MAX_COUNT; ++i ) {
+            if( global_win32_input->gp_connected[i] ) {
+                snapshot.gamepad_connected |= (1 << i);
+                snapshot.gamepads[i]        = global_win32_input->gp[i];
+            }
+        }
+        input_action_map_evaluate( global_win32_input->action_map, &snapshot );
+    }
+}
+attr_media_api void input_subsystem_set_action_map( InputActionMap* opt_map ) {
+    global_win32_input->action_map = opt_map;
+}
+attr_media_api void input_subsystem_set_gamepad_processor( GamepadProcessor* opt_processor ) {
+    global_win32_input->gp_processor         = opt_processor;
+    global_win32_input->gp_processor_time_ns = 0;
 }
 attr_media_api KeyboardMod input_keyboard_query_mod(void) {
     return global_win32_state->mod;
@@ -270,6 +741,24 @@ attr_media_api _Bool input_keyboard_query_key( KeyboardCode keycode ) {
 attr_media_api void input_keyboard_copy_state( KeyboardState* out_state ) {
     memcpy( out_state, &global_win32_input->kb, sizeof(*out_state) );
 }
+attr_media_api _Bool input_keyboard_query_scancode( KeyboardScancode scancode ) {
+    return keyboard_state_get_key( &global_win32_input->kb_scan, scancode );
+}
+attr_media_api void input_keyboard_copy_scancode_state( KeyboardState* out_state ) {
+    memcpy( out_state, &global_win32_input->kb_scan, sizeof(*out_state) );
+}
+attr_media_api KeyboardCode input_keyboard_scancode_to_code( KeyboardScancode scancode ) {
+    if( (uint32_t)scancode >= KB_COUNT ) {
+        return KB_UNKNOWN;
+    }
+    return global_win32_input->layout.scancode_to_code[scancode];
+}
+attr_media_api KeyboardScancode input_keyboard_code_to_scancode( KeyboardCode code ) {
+    if( (uint32_t)code >= KB_COUNT ) {
+        return KB_UNKNOWN;
+    }
+    return global_win32_input->layout.code_to_scancode[code];
+}
 attr_media_api MouseButton input_mouse_query_buttons(void) {
     return global_win32_state->mb;
 }
@@ -309,6 +798,28 @@ attr_media_api void input_mouse_query_delta( int32_t* out_x, int32_t* out_y ) {
     *out_x = global_win32_input->mb_dx;
     *out_y = global_win32_input->mb_dy;
 }
+attr_media_api uint32_t input_pointer_query_contacts(
+    uint32_t cap, PointerSample* opt_out_samples
+) {
+    uint32_t count = global_win32_input->pointer_contact_count;
+    if( opt_out_samples ) {
+        memcpy(
+            opt_out_samples, global_win32_input->pointer_contacts,
+            sizeof(*opt_out_samples) * (cap < count ? cap : count) );
+    }
+    return count;
+}
+attr_media_api uint32_t input_pointer_query_history(
+    uint32_t cap, PointerSample* opt_out_samples
+) {
+    uint32_t count = global_win32_input->pointer_history_count;
+    if( opt_out_samples ) {
+        memcpy(
+            opt_out_samples, global_win32_input->pointer_history,
+            sizeof(*opt_out_samples) * (cap < count ? cap : count) );
+    }
+    return count;
+}
 attr_media_api _Bool input_gamepad_query_state(
     uint32_t index, GamepadState* out_state
 ) {
@@ -335,6 +846,158 @@ attr_media_api _Bool input_gamepad_rumble_set(
     return true;
 }
 
+attr_internal void win32_input_pointer_from_info(
+    const POINTER_INFO* info, PointerType type, PointerSample* out_sample
+) {
+    memset( out_sample, 0, sizeof(*out_sample) );
+    out_sample->id   = info->pointerId;
+    out_sample->type = type;
+    out_sample->x    = info->ptPixelLocation.x;
+    out_sample->y    = info->ptPixelLocation.y;
+
+    if( info->pointerFlags & POINTER_FLAG_INCONTACT ) {
+        out_sample->state |= POINTER_STATE_IN_CONTACT;
+        out_sample->pressure = 1.0f;
+    }
+    if( info->pointerFlags & POINTER_FLAG_PRIMARY ) {
+        out_sample->state |= POINTER_STATE_PRIMARY;
+    }
+    if( info->pointerFlags & POINTER_FLAG_CANCELED ) {
+        out_sample->state |= POINTER_STATE_CANCELED | POINTER_STATE_RELEASED;
+    }
+    if( !(info->pointerFlags & POINTER_FLAG_INRANGE) ) {
+        out_sample->state |= POINTER_STATE_RELEASED;
+    }
+
+    if( info->PerformanceCount ) {
+        out_sample->time_ns = win32_qpc_to_ns( info->PerformanceCount );
+    } else {
+        out_sample->time_ns = media_time_ns();
+    }
+}
+attr_internal void win32_input_pointer_push( const PointerSample* sample ) {
+    struct Win32Input* in = global_win32_input;
+
+    if( in->pointer_history_count < POINTER_HISTORY_CAP ) {
+        in->pointer_history[in->pointer_history_count++] = *sample;
+    }
+
+    for( uint32_t i = 0; i < in->pointer_contact_count; ++i ) {
+        if( in->pointer_contacts[i].id == sample->id ) {
+            in->pointer_contacts[i] = *sample;
+            return;
+        }
+    }
+    // NOTE(alicia): contacts that don't fit are only reported in history.
+    if( in->pointer_contact_count < POINTER_MAX_CONTACTS ) {
+        in->pointer_contacts[in->pointer_contact_count++] = *sample;
+    }
+}
+_Bool win32_input_pointer_message( UINT msg, WPARAM wparam ) {
+    if( !GetPointerType ) {
+        return false;
+    }
+    UINT32 id = GET_POINTERID_WPARAM( wparam );
+
+    POINTER_INPUT_TYPE type = PT_POINTER;
+    if( !GetPointerType( id, &type ) ) {
+        return false;
+    }
+    if( type != PT_TOUCH && type != PT_PEN ) {
+        return false;
+    }
+
+    if( msg == WM_POINTERCAPTURECHANGED ) {
+        // NOTE(alicia): pointer info is no longer available,
+        // cancel using last known sample.
+        struct Win32Input* in = global_win32_input;
+        for( uint32_t i = 0; i < in->pointer_contact_count; ++i ) {
+            PointerSample sample = in->pointer_contacts[i];
+            if( sample.id != id || (sample.state & POINTER_STATE_RELEASED) ) {
+                continue;
+            }
+            sample.state  &= ~POINTER_STATE_IN_CONTACT;
+            sample.state  |= POINTER_STATE_CANCELED | POINTER_STATE_RELEASED;
+            sample.time_ns = media_time_ns();
+            win32_input_pointer_push( &sample );
+            break;
+        }
+        return true;
+    }
+
+    POINTER_INFO info;
+    memset( &info, 0, sizeof(info) );
+    if( !GetPointerInfo( id, &info ) ) {
+        return false;
+    }
+
+    // NOTE(alicia): history contains samples coalesced into this message,
+    // newest first. current sample is always at index 0.
+    UINT32 count = info.historyCount;
+    if( !count ) {
+        count = 1;
+    }
+    if( count > WIN32_INPUT_POINTER_HISTORY_READ ) {
+        count = WIN32_INPUT_POINTER_HISTORY_READ;
+    }
+
+    PointerSample sample;
+    if( type == PT_PEN ) {
+        POINTER_PEN_INFO pen[WIN32_INPUT_POINTER_HISTORY_READ];
+        if( !GetPointerPenInfoHistory( id, &count, pen ) ) {
+            return false;
+        }
+        for( UINT32 i = count; i-- > 0; ) {
+            win32_input_pointer_from_info(
+                &pen[i].pointerInfo, POINTER_TYPE_PEN, &sample );
+
+            if( pen[i].penFlags & PEN_FLAG_BARREL ) {
+                sample.state |= POINTER_STATE_BARREL;
+            }
+            if( pen[i].penFlags & PEN_FLAG_INVERTED ) {
+                sample.state |= POINTER_STATE_INVERTED;
+            }
+            if( pen[i].penFlags & PEN_FLAG_ERASER ) {
+                sample.state |= POINTER_STATE_ERASER;
+            }
+            if( pen[i].penMask & PEN_MASK_PRESSURE ) {
+                sample.pressure = (float)pen[i].pressure / 1024.0f;
+            }
+            if( pen[i].penMask & PEN_MASK_ROTATION ) {
+                sample.rotation = (float)pen[i].rotation;
+            }
+            if( pen[i].penMask & PEN_MASK_TILT_X ) {
+                sample.tilt_x = (float)pen[i].tiltX;
+            }
+            if( pen[i].penMask & PEN_MASK_TILT_Y ) {
+                sample.tilt_y = (float)pen[i].tiltY;
+            }
+
+            win32_input_pointer_push( &sample );
+        }
+    } else {
+        POINTER_TOUCH_INFO touch[WIN32_INPUT_POINTER_HISTORY_READ];
+        if( !GetPointerTouchInfoHistory( id, &count, touch ) ) {
+            return false;
+        }
+        for( UINT32 i = count; i-- > 0; ) {
+            win32_input_pointer_from_info(
+                &touch[i].pointerInfo, POINTER_TYPE_TOUCH, &sample );
+
+            if( touch[i].touchMask & TOUCH_MASK_PRESSURE ) {
+                sample.pressure = (float)touch[i].pressure / 1024.0f;
+            }
+            if( touch[i].touchMask & TOUCH_MASK_ORIENTATION ) {
+                sample.rotation = (float)touch[i].orientation;
+            }
+
+            win32_input_pointer_push( &sample );
+        }
+    }
+
+    return true;
+}
+
 LRESULT win32_winproc_input( HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam ) {
     BYTE lpb[sizeof(RAWINPUT)];
     memset( lpb, 0, sizeof(lpb) );
@@ -351,52 +1014,44 @@ LRESULT win32_winproc_input( HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam )
         case RIM_TYPEKEYBOARD: {
             RAWKEYBOARD* kb = &raw->data.keyboard;
 
-            if( kb->MakeCode == KEYBOARD_OVERRUN_MAKE_CODE ) {
+            // NOTE(alicia): VKey 0xFF is the escaped half of pause
+            // (and similar sequences), its make code maps to numlock.
+            if( kb->MakeCode == KEYBOARD_OVERRUN_MAKE_CODE || kb->VKey == 0xFF ) {
                 break;
             }
-            /* uint16_t scan = kb->MakeCode; */
-            uint16_t vk   = kb->VKey;
+            uint16_t vk = kb->VKey;
 
             _Bool is_e0 = ((kb->Flags & RI_KEY_E0) != 0);
             _Bool is_e1 = ((kb->Flags & RI_KEY_E1) != 0);
-            unused(is_e1);
 
-            uint16_t vk_translate   = vk;
+            _Bool down = !(kb->Flags & RI_KEY_BREAK);
 
-            _Bool down           = !(kb->Flags & RI_KEY_BREAK);
-            uint32_t scan_translate = MapVirtualKeyW( vk, MAPVK_VK_TO_VSC );
+            // NOTE(alicia): pause is the only key sent with E1 prefix,
+            // its make code collides with left control.
+            KeyboardScancode scancode = is_e1 ?
+                KB_PAUSE : scan_to_keyboard_scancode( kb->MakeCode, is_e0 );
+            KeyboardCode code = vk_to_keyboard_code( vk );
 
-            switch( vk ) {
-                case VK_PAUSE: {
-                    scan_translate = 0x45;
-                } break;
-                case VK_CONTROL: {
-                    if( is_e0 ) {
-                        vk_translate = VK_RCONTROL;
-                    } else {
-                        vk_translate = VK_LCONTROL;
-                    }
+            _Bool is_modifier = vk == VK_SHIFT || vk == VK_CONTROL || vk == VK_MENU;
+            // NOTE(alicia): numpad keys send fake shifts
+            // with E0 prefix while numlock is on, skip them.
+            if( is_modifier && !scancode ) {
+                break;
+            }
 
-                    global_win32_state->mod = down ?
-                        (global_win32_state->mod | KBMOD_CTRL) :
-                        (global_win32_state->mod & ~KBMOD_CTRL);
-                } break;
-                case VK_MENU: {
-                    if( is_e0 ) {
-                        vk_translate = VK_RMENU;
-                    } else {
-                        vk_translate = VK_LMENU;
-                    }
-                    global_win32_state->mod = down ?
-                        (global_win32_state->mod | KBMOD_ALT) :
-                        (global_win32_state->mod & ~KBMOD_ALT);
-                } break;
+            switch( vk ) {
+                case VK_CONTROL:
+                case VK_MENU:
                 case VK_SHIFT: {
-                    vk_translate = MapVirtualKeyW( scan_translate, MAPVK_VSC_TO_VK_EX );
+                    // NOTE(alicia): left/right modifiers never move between
+                    // layouts so physical key is used to tell them apart.
+                    code = scancode;
 
+                    KeyboardMod mod = vk == VK_SHIFT ?
+                        KBMOD_SHIFT : (vk == VK_CONTROL ? KBMOD_CTRL : KBMOD_ALT);
                     global_win32_state->mod = down ?
-                        (global_win32_state->mod | KBMOD_SHIFT) :
-                        (global_win32_state->mod & ~KBMOD_SHIFT);
+                        (global_win32_state->mod | mod) :
+                        (global_win32_state->mod & ~mod);
                 } break;
                 case VK_CAPITAL: {
                     if( down ) {
@@ -415,7 +1070,6 @@ LRESULT win32_winproc_input( HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam )
                     }
                 } break;
                 case VK_NUMLOCK: {
-                    scan_translate = (MapVirtualKeyW( vk, MAPVK_VK_TO_VSC ) | 0x100);
                     if( down ) {
                         global_win32_state->mod =
                             (global_win32_state->mod & KBMOD_NUMLK) ?
@@ -425,13 +1079,12 @@ LRESULT win32_winproc_input( HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam )
                 } break;
             }
 
-            KeyboardCode code = vk_to_keyboard_code( vk_translate );
-
             keyboard_state_set_key( &global_win32_input->kb, code, down );
+            keyboard_state_set_key( &global_win32_input->kb_scan, scancode, down );
 
-            HWND focused = win32_get_focused_window();
+            HWND focused = win32_get_focused_window( NULL );
             if( focused ) {
-                WPARAM _wparam = win32_key_to_wparam( code, down );
+                WPARAM _wparam = win32_key_to_wparam( code, scancode, down );
                 PostMessageW(
                     focused, WM_CUSTOM_KEYBOARD, _wparam, 0 );
             }
@@ -488,12 +1141,19 @@ LRESULT win32_winproc_input( HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam )
             WPARAM buttons = win32_mouse_button_to_wparam(
                 btn, delta, scroll, scroll_hor );
 
-            global_win32_input->mb_dx = mb->lLastX;
-            global_win32_input->mb_dy = mb->lLastY;
+            // NOTE(alicia): absolute packets come from tablets and
+            // remote desktop, they carry position instead of motion.
+            _Bool is_relative = !(mb->usFlags & MOUSE_MOVE_ABSOLUTE);
+            if( is_relative ) {
+                global_win32_input->mb_dx += mb->lLastX;
+                global_win32_input->mb_dy += mb->lLastY;
+            }
 
-            HWND focused = win32_get_focused_window();
+            HWND focused = win32_get_focused_window( NULL );
             if( focused ) {
-                PostMessageW( focused, WM_CUSTOM_MOUSE_DEL, dx, dy );
+                if( is_relative && (mb->lLastX || mb->lLastY) ) {
+                    PostMessageW( focused, WM_CUSTOM_MOUSE_DEL, dx, dy );
+                }
                 PostMessageW( focused, WM_CUSTOM_MOUSE_BTN, buttons, 0 );
             }
         } break;
@@ -506,114 +1166,57 @@ LRESULT win32_winproc_input( HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam )
     return 0;
 }
 DWORD keyboard_code_to_vk( KeyboardCode code ) {
-    switch( code ) {
-        case KB_BACKSPACE                 : return VK_BACK;
-        case KB_TAB                       : return VK_TAB;
-        case KB_ENTER                     : return VK_RETURN;
-        case KB_SHIFT_LEFT                : return VK_SHIFT;
-        case KB_SHIFT_RIGHT               : return VK_RSHIFT;
-        case KB_CONTROL_LEFT              : return VK_CONTROL;
-        case KB_CONTROL_RIGHT             : return VK_RCONTROL;
-        case KB_ALT_LEFT                  : return VK_MENU;
-        case KB_ALT_RIGHT                 : return VK_RMENU;
-        case KB_PAUSE                     : return VK_PAUSE;
-        case KB_CAPSLOCK                  : return VK_CAPITAL;
-        case KB_ESCAPE                    : return VK_ESCAPE;
-        case KB_SPACE                     : return VK_SPACE;
-        case KB_PAGE_UP                   : return VK_PRIOR;
-        case KB_PAGE_DOWN                 : return VK_NEXT;
-        case KB_END                       : return VK_END;
-        case KB_HOME                      : return VK_HOME;
-        case KB_ARROW_LEFT                : return VK_LEFT;
-        case KB_ARROW_UP                  : return VK_UP;
-        case KB_ARROW_RIGHT               : return VK_RIGHT;
-        case KB_ARROW_DOWN                : return VK_DOWN;
-        case KB_0 ... KB_9                : return (code - KB_0) + 0x30;
-        case KB_A ... KB_Z                : return (code - KB_A) + 0x41;
-        case KB_SUPER_LEFT                : return VK_LWIN;
-        case KB_SUPER_RIGHT               : return VK_RWIN;
-        case KB_PAD_0 ... KB_PAD_9        : return (code - KB_PAD_0) + VK_NUMPAD0;
-        case KB_F1 ... KB_F24             : return (code - KB_F1) + VK_F1;
-        case KB_NUM_LOCK                  : return VK_NUMLOCK;
-        case KB_SCROLL_LOCK               : return VK_SCROLL;
-        case KB_SEMICOLON                 : return VK_OEM_1;
-        case KB_EQUALS                    : return VK_OEM_PLUS;
-        case KB_COMMA                     : return VK_OEM_COMMA;
-        case KB_MINUS                     : return VK_OEM_MINUS;
-        case KB_PERIOD                    : return VK_OEM_PERIOD;
-        case KB_SLASH                     : return VK_OEM_2;
-        case KB_BACKTICK                  : return VK_OEM_3;
-        case KB_BRACKET_LEFT              : return VK_OEM_4;
-        case KB_BACKSLASH                 : return VK_OEM_5;
-        case KB_BRACKET_RIGHT             : return VK_OEM_6;
-        case KB_QUOTE                     : return VK_OEM_7;
-        case KB_PRINT_SCREEN              : return VK_SNAPSHOT;
-        case KB_DELETE                    : return VK_DELETE;
-        case KB_PAD_ADD                   : return VK_ADD;
-        case KB_PAD_MULTIPLY              : return VK_MULTIPLY;
-        case KB_PAD_SUBTRACT              : return VK_SUBTRACT;
-        case KB_PAD_DIVIDE                : return VK_DIVIDE;
-        case KB_PAD_DOT                   : return VK_DECIMAL;
-        case KB_INSERT                    : return VK_INSERT;
-        case KB_RIGHT_CLICK_MENU          : return VK_APPS;
-        default: return 0;
+    if( (uint32_t)code >= KB_COUNT ) {
+        return 0;
     }
+    return global_win32_keyboard_code_table[code];
 }
 KeyboardCode vk_to_keyboard_code( DWORD vk ) {
-    switch( vk ) {
-        case VK_BACK                   : return KB_BACKSPACE;
-        case VK_TAB                    : return KB_TAB;
-        case VK_RETURN                 : return KB_ENTER;
-        case VK_LSHIFT:
-        case VK_SHIFT                  : return KB_SHIFT_LEFT;
-        case VK_RSHIFT                 : return KB_SHIFT_RIGHT;
-        case VK_LCONTROL:
-        case VK_CONTROL                : return KB_CONTROL_LEFT;
-        case VK_RCONTROL               : return KB_CONTROL_RIGHT;
-        case VK_LMENU:
-        case VK_MENU                   : return KB_ALT_LEFT;
-        case VK_RMENU                  : return KB_ALT_RIGHT;
-        case VK_PAUSE                  : return KB_PAUSE;
-        case VK_CAPITAL                : return KB_CAPSLOCK;
-        case VK_ESCAPE                 : return KB_ESCAPE;
-        case VK_SPACE                  : return KB_SPACE;
-        case VK_PRIOR                  : return KB_PAGE_UP;
-        case VK_NEXT                   : return KB_PAGE_DOWN;
-        case VK_END                    : return KB_END;
-        case VK_HOME                   : return KB_HOME;
-        case VK_LEFT                   : return KB_ARROW_LEFT;
-        case VK_UP                     : return KB_ARROW_UP;
-        case VK_RIGHT                  : return KB_ARROW_RIGHT;
-        case VK_DOWN                   : return KB_ARROW_DOWN;
-        case 0x30 ... 0x39             : return (vk - 0x30) + KB_0;
-        case 0x41 ... 0x5A             : return (vk - 0x41) + KB_A;
-        case VK_LWIN                   : return KB_SUPER_LEFT;
-        case VK_RWIN                   : return KB_SUPER_RIGHT;
-        case VK_NUMPAD0 ... VK_NUMPAD9 : return (vk - VK_NUMPAD0) + KB_PAD_0;
-        case VK_F1 ... VK_F24          : return (vk - VK_F1) + KB_F1;
-        case VK_NUMLOCK                : return KB_NUM_LOCK;
-        case VK_SCROLL                 : return KB_SCROLL_LOCK;
-        case VK_OEM_1                  : return KB_SEMICOLON;
-        case VK_OEM_PLUS               : return KB_EQUALS;
-        case VK_OEM_COMMA              : return KB_COMMA;
-        case VK_OEM_MINUS              : return KB_MINUS;
-        case VK_OEM_PERIOD             : return KB_PERIOD;
-        case VK_OEM_2                  : return KB_SLASH;
-        case VK_OEM_3                  : return KB_BACKTICK;
-        case VK_OEM_4                  : return KB_BRACKET_LEFT;
-        case VK_OEM_5                  : return KB_BACKSLASH;
-        case VK_OEM_6                  : return KB_BRACKET_RIGHT;
-        case VK_OEM_7                  : return KB_QUOTE;
-        case VK_SNAPSHOT               : return KB_PRINT_SCREEN;
-        case VK_DELETE                 : return KB_DELETE;
-        case VK_ADD                    : return KB_PAD_ADD;
-        case VK_MULTIPLY               : return KB_PAD_MULTIPLY;
-        case VK_SUBTRACT               : return KB_PAD_SUBTRACT;
-        case VK_DIVIDE                 : return KB_PAD_DIVIDE;
-        case VK_DECIMAL                : return KB_PAD_DOT;
-        case VK_INSERT                 : return KB_INSERT;
-        case VK_APPS                   : return KB_RIGHT_CLICK_MENU;
-        default                        : return KB_UNKNOWN;
+    if( vk > 0xFF ) {
+        return KB_UNKNOWN;
+    }
+    return global_win32_vk_table[vk];
+}
+KeyboardScancode scan_to_keyboard_scancode( uint32_t scan, _Bool is_extended ) {
+    return global_win32_scancode_table[(scan & 0x7F) | (is_extended ? 0x80 : 0)];
+}
+void win32_input_layout_rebuild( HKL hkl ) {
+    struct Win32KeyboardLayout* layout = &global_win32_input->layout;
+    if( layout->hkl == hkl ) {
+        return;
+    }
+    layout->hkl = hkl;
+
+    memset( layout->scancode_to_code, 0, sizeof(layout->scancode_to_code) );
+    memset( layout->code_to_scancode, 0, sizeof(layout->code_to_scancode) );
+
+    for( uint32_t i = 0; i < 256; ++i ) {
+        KeyboardScancode scancode = global_win32_scancode_table[i];
+        if( !scancode ) {
+            continue;
+        }
+
+        // NOTE(alicia): only typewriter keys move between layouts,
+        // numpad keys would otherwise map to navigation keys.
+        KeyboardCode code = scancode;
+        if(
+            (scancode >= KB_0 && scancode <= KB_Z) ||
+            (scancode >= KB_SEMICOLON && scancode <= KB_QUOTE)
+        ) {
+            UINT scan = (i & 0x7F) | ((i & 0x80) ? 0xE000 : 0);
+            KeyboardCode translated = vk_to_keyboard_code(
+                MapVirtualKeyExW( scan, MAPVK_VSC_TO_VK_EX, hkl ) );
+            if( translated ) {
+                code = translated;
+            }
+        }
+
+        if( !layout->scancode_to_code[scancode] ) {
+            layout->scancode_to_code[scancode] = code;
+        }
+        if( !layout->code_to_scancode[code] ) {
+            layout->code_to_scancode[code] = scancode;
+        }
     }
 }
 
@@ -11,8 +11,17 @@
 #include "media/input.h"
 #include "impl/win32/common.h"
 
+// NOTE(alicia): scancode/key code translation for current keyboard layout.
+struct Win32KeyboardLayout {
+    HKL              hkl;
+    KeyboardCode     scancode_to_code[KB_COUNT];
+    KeyboardScancode code_to_scancode[KB_COUNT];
+};
+
 struct Win32Input {
     KeyboardState kb;
+    KeyboardState kb_scan;
+    struct Win32KeyboardLayout layout;
     int32_t       mb_x, mb_y, mb_dx, mb_dy;
     uint16_t      rumble[GAMEPAD_MAX_COUNT][2];
     uint8_t       gp_connected[GAMEPAD_MAX_COUNT];
@@ -20,9 +29,19 @@ struct Win32Input {
     HWND          hwnd;
     HANDLE        thread;
     volatile long thread_exit;
+
+    uint32_t      pointer_contact_count;
+    uint32_t      pointer_history_count;
+    PointerSample pointer_contacts[POINTER_MAX_CONTACTS];
+    PointerSample pointer_history[POINTER_HISTORY_CAP];
+
+    InputActionMap*   action_map;
+    GamepadProcessor* gp_processor;
+    uint64_t          gp_processor_time_ns;
 };
 struct Win32KeyWParam {
-    uint16_t keycode;
+    uint8_t  keycode;
+    uint8_t  scancode;
     uint16_t is_down;
 #if defined(MEDIA_ARCH_64_BIT)
     uint32_t __padding;
@@ -49,8 +68,8 @@ struct Win32MouseButtonWParam {
 #define WM_CUSTOM_MOUSE_DEL (WM_USER + 3)
 #define WM_CUSTOM_MOUSE_BTN (WM_USER + 4)
 
-#define win32_key_to_wparam( kc, down )\
-    (*(WPARAM*)(&(struct Win32KeyWParam){.keycode=kc,.is_down=down}))
+#define win32_key_to_wparam( kc, sc, down )\
+    (*(WPARAM*)(&(struct Win32KeyWParam){.keycode=kc,.scancode=sc,.is_down=down}))
 #define win32_key_from_wparam( wparam )\
     (*(struct Win32KeyWParam*)(&(wparam)))
 
@@ -71,8 +90,15 @@ struct Win32MouseButtonWParam {
     (*(struct Win32MouseButtonWParam*)(&(wparam)))
 
 struct Win32Input* win32_input(void);
+// NOTE(alicia): called by surface winproc for WM_POINTER* messages.
+// returns false if pointer is not touch or pen.
+_Bool win32_input_pointer_message( UINT msg, WPARAM wparam );
 DWORD        keyboard_code_to_vk( KeyboardCode code );
 KeyboardCode vk_to_keyboard_code( DWORD vk );
+// NOTE(alicia): scan is set 1 make code without prefix.
+KeyboardScancode scan_to_keyboard_scancode( uint32_t scan, _Bool is_extended );
+// NOTE(alicia): called by surface winproc on WM_INPUTLANGCHANGE.
+void win32_input_layout_rebuild( HKL hkl );
 
 #endif /* Platform Windows */
 #endif /* header guard */
@@ -89,19 +89,29 @@ def( HGLRC, wglCreateContextAttribsARB, HDC, HGLRC, const int* );
 def( BOOL, wglSwapIntervalEXT, int );
 #define wglSwapIntervalEXT in_wglSwapIntervalEXT
 
-attr_media_api _Bool opengl_initialize(void) {
+attr_internal BOOL CALLBACK win32_init_opengl(
+    PINIT_ONCE once, PVOID params, PVOID* ctx
+) {
+    unused( once, params, ctx );
     #define load( lib, fn ) do {\
         fn = (fn##FN*)GetProcAddress( global_win32_state->modules.lib, #fn );\
         if( !fn ) {\
             win32_error( "opengl_initialize: failed to load " #fn " from " #lib "!");\
-            return false;\
+            return FALSE;\
         }\
     } while(0)
 
-    global_win32_state->modules.OPENGL32 = LoadLibraryA( "OPENGL32.DLL" );
+    // NOTE(alicia): GDI32 is opened by surface subsystem.
+    if( !win32_load_surface() ) {
+        return FALSE;
+    }
+
     if( !global_win32_state->modules.OPENGL32 ) {
-        win32_error( "opengl_initialize: failed to open library OPENGL32.DLL!" );
-        return false;
+        global_win32_state->modules.OPENGL32 = LoadLibraryA( "OPENGL32.DLL" );
+        if( !global_win32_state->modules.OPENGL32 ) {
+            win32_error( "opengl_initialize: failed to open library OPENGL32.DLL!" );
+            return FALSE;
+        }
     }
 
     load( GDI32, DescribePixelFormat );
@@ -117,7 +127,14 @@ attr_media_api _Bool opengl_initialize(void) {
     load( OPENGL32, wglCopyContext );
 
     #undef load
-    return true;
+    return TRUE;
+}
+_Bool win32_load_opengl(void) {
+    return InitOnceExecuteOnce(
+        &global_win32_state->once.opengl, win32_init_opengl, NULL, NULL ) != FALSE;
+}
+attr_media_api _Bool opengl_initialize(void) {
+    return win32_load_opengl();
 }
 
 struct Win32OpenGLAttributes win32_opengl_default_attrib(void) {
@@ -373,6 +390,7 @@ attr_media_api void* opengl_load_proc( const char* function_name ) {
     return res;
 }
 attr_media_api _Bool opengl_swap_buffers( SurfaceHandle* in_surface ) {
+    media_trace_scope( "opengl_swap_buffers" );
     struct Win32Surface* surface = in_surface;
     return SwapBuffers( surface->hdc ) != FALSE;
 }
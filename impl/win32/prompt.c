@@ -11,6 +11,8 @@
 
 #include <shobjidl.h>
 
+#define WIN32_PROMPT_STACK_CAP (256)
+
 attr_internal uint32_t win32_count_filters( uint32_t filter_len, const char* filter );
 attr_internal void win32_clip_filter(
     uint32_t filter_len, const char* filter,
@@ -19,8 +21,9 @@ attr_internal _Bool win32_clip_filter_name(
     uint32_t filter_len, const char* filter,
     uint32_t* out_filter_len );
 attr_internal COMDLG_FILTERSPEC* win32_make_filters(
-    uint32_t filter_len, const char* filter, uint32_t* out_count );
-attr_internal void win32_free_filters( COMDLG_FILTERSPEC* filters );
+    uint32_t filter_len, const char* filter,
+    uint32_t* out_count, uintptr_t* out_size );
+attr_internal void win32_free_filters( COMDLG_FILTERSPEC* filters, uintptr_t size );
 
 attr_media_api PromptMessageResult prompt_message(
     uint32_t opt_title_len, const char* opt_title,
@@ -31,40 +34,45 @@ attr_media_api PromptMessageResult prompt_message(
         win32_error( "prompt_message: did not provide a message!" );
         return PROMPT_MESSAGE_ERROR_UNKNOWN;
     }
+    if( !win32_load_user32() ) {
+        win32_error( "prompt_message: failed to load USER32!" );
+        return PROMPT_MESSAGE_ERROR_UNKNOWN;
+    }
 
-    uint32_t wide_buffer_cap = 2;
+    uintptr_t wide_buffer_cap = 2;
     if( opt_title && opt_title_len ) {
-        wide_buffer_cap +=
-            MultiByteToWideChar( CP_UTF8, 0, opt_title, opt_title_len, 0, 0 );
+        wide_buffer_cap += media_utf8_to_utf16( opt_title_len, opt_title, 0, 0, 0 );
     }
-    wide_buffer_cap +=
-        MultiByteToWideChar( CP_UTF8, 0, message, message_len, 0, 0 );
+    wide_buffer_cap += media_utf8_to_utf16( message_len, message, 0, 0, 0 );
 
-    uint32_t wide_buffer_size = sizeof(wchar_t) * wide_buffer_cap;
+    uintptr_t wide_buffer_size = sizeof(wchar_t) * wide_buffer_cap;
 
-    void* wide_buffer =
-        HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, wide_buffer_size );
-    if( !wide_buffer ) {
-        win32_error( "prompt_message: failed to allocate wide buffer!" );
-        return PROMPT_MESSAGE_ERROR_UNKNOWN;
+    // NOTE(alicia): short messages are converted on the stack.
+    wchar_t stack_buffer[WIN32_PROMPT_STACK_CAP];
+    void* wide_buffer = stack_buffer;
+    if( wide_buffer_cap > WIN32_PROMPT_STACK_CAP ) {
+        wide_buffer = media_alloc( wide_buffer_size );
+        if( !wide_buffer ) {
+            win32_error( "prompt_message: failed to allocate wide buffer!" );
+            return PROMPT_MESSAGE_ERROR_UNKNOWN;
+        }
     }
 
     wchar_t* wtitle   = 0;
     wchar_t* wmessage = wide_buffer;
     if( opt_title && opt_title_len ) {
-        wtitle  = wide_buffer;
-        int len = MultiByteToWideChar(
-            CP_UTF8, 0, opt_title, opt_title_len, wtitle, wide_buffer_cap );
-        len++;
-        
+        wtitle = wide_buffer;
+        uintptr_t len = media_utf8_to_utf16(
+            opt_title_len, opt_title, wide_buffer_cap - 1, (uint16_t*)wtitle, 0 );
+        wtitle[len++] = 0;
+
         wmessage         = (wchar_t*)wide_buffer + len;
         wide_buffer_cap -= len;
     }
 
-    MultiByteToWideChar(
-        CP_UTF8, 0,
-        message, message_len,
-        wmessage, wide_buffer_cap );
+    uintptr_t message_wide_len = media_utf8_to_utf16(
+        message_len, message, wide_buffer_cap - 1, (uint16_t*)wmessage, 0 );
+    wmessage[message_wide_len] = 0;
 
     UINT uType = 0;
 
@@ -103,7 +111,9 @@ attr_media_api PromptMessageResult prompt_message(
 
     int result = MessageBoxW( NULL, wmessage, wtitle, uType );
 
-    HeapFree( GetProcessHeap(), 0, wide_buffer );
+    if( wide_buffer != stack_buffer ) {
+        media_free( wide_buffer, wide_buffer_size );
+    }
 
     switch( result ) {
         case IDOK:     return PROMPT_MESSAGE_RESULT_OK_PRESSED;
@@ -126,10 +136,17 @@ attr_media_api PromptFileOpenResult prompt_file_open(
     uint32_t* out_result_len,
     char* out_result_buffer
 ) {
-    wchar_t* title = NULL;
+    if( !win32_load_com() ) {
+        win32_error( "prompt_file_open: failed to initialize COM!" );
+        return PROMPT_FILE_OPEN_ERROR_UNKNOWN;
+    }
+
+    wchar_t* title      = NULL;
+    uintptr_t title_size = 0;
     if( opt_title ) {
         if( opt_title_len ) {
-            title = win32_utf8_to_ucs2_alloc( opt_title_len, opt_title, 0 );
+            title = win32_utf8_to_ucs2_alloc(
+                opt_title_len, opt_title, 0, &title_size );
             if( !title ) {
                 win32_error(
                     "prompt_file_open: failed to allocate title wide buffer!" );
@@ -141,15 +158,18 @@ attr_media_api PromptFileOpenResult prompt_file_open(
     }
     #define free_title() do {\
         if(title) {\
-            HeapFree( GetProcessHeap(), 0, title );\
+            media_free( title, title_size );\
         }\
     } while(0)
 
+    // NOTE(alicia): filters are allocated after title
+    // so they must be freed before title.
     uint32_t filter_count = 0;
+    uintptr_t filter_size = 0;
     COMDLG_FILTERSPEC* filter = NULL;
     if( opt_ext_filters ) {
         filter = win32_make_filters(
-            opt_ext_filters_len, opt_ext_filters, &filter_count );
+            opt_ext_filters_len, opt_ext_filters, &filter_count, &filter_size );
         if( !filter && filter_count ) {
             // NOTE(alicia): logging occurs in win32_make_filters
             free_title();
@@ -164,6 +184,7 @@ attr_media_api PromptFileOpenResult prompt_file_open(
 
     if( !CoCheck(hr) ) {
         win32_error( "prompt_file_open: failed to create file open dialog" );
+        win32_free_filters( filter, filter_size );
         free_title();
         return PROMPT_FILE_OPEN_ERROR_UNKNOWN;
     }
@@ -173,7 +194,7 @@ attr_media_api PromptFileOpenResult prompt_file_open(
         if( !CoCheck( hr ) ) {
             win32_error( "prompt_file_open: failed to set extension filters!" );
             pFileOpen->lpVtbl->Release( pFileOpen );
-            win32_free_filters( filter );
+            win32_free_filters( filter, filter_size );
             free_title();
             return PROMPT_FILE_OPEN_ERROR_UNKNOWN;
         }
@@ -184,7 +205,7 @@ attr_media_api PromptFileOpenResult prompt_file_open(
         if( !CoCheck( hr ) ) {
             win32_error( "prompt_file_open: failed to set prompt title!" );
             pFileOpen->lpVtbl->Release( pFileOpen );
-            win32_free_filters( filter );
+            win32_free_filters( filter, filter_size );
             free_title();
             return PROMPT_FILE_OPEN_ERROR_UNKNOWN;
         }
@@ -196,7 +217,7 @@ attr_media_api PromptFileOpenResult prompt_file_open(
         default: {
             PromptFileOpenResult result = PROMPT_FILE_OPEN_ERROR_UNKNOWN;
             pFileOpen->lpVtbl->Release( pFileOpen );
-            win32_free_filters( filter );
+            win32_free_filters( filter, filter_size );
             free_title();
 
             if( HRESULT_FROM_WIN32(ERROR_CANCELLED) == hr ) {
@@ -214,7 +235,7 @@ attr_media_api PromptFileOpenResult prompt_file_open(
     if( !CoCheck(hr) ) {
         win32_error( "prompt_file_open: failed to get result from file open dialog!" );
         pFileOpen->lpVtbl->Release( pFileOpen );
-        win32_free_filters( filter );
+        win32_free_filters( filter, filter_size );
         free_title();
         return PROMPT_FILE_OPEN_ERROR_UNKNOWN;
     }
@@ -226,31 +247,35 @@ attr_media_api PromptFileOpenResult prompt_file_open(
         win32_error( "prompt_file_open: failed to get path!" );
         pItem->lpVtbl->Release( pItem );
         pFileOpen->lpVtbl->Release( pFileOpen );
-        win32_free_filters( filter );
+        win32_free_filters( filter, filter_size );
         free_title();
         return PROMPT_FILE_OPEN_ERROR_UNKNOWN;
     }
 
-    int len = WideCharToMultiByte(
-        CP_UTF8, 0,
-        pszFilePath, -1,
-        out_result_buffer, result_buffer_cap,
-        0, 0 ) - 1;
+    uintptr_t path_len  = media_utf16_len( (uint16_t*)pszFilePath );
+    uintptr_t path_read = 0;
+    uintptr_t len       = 0;
+    if( result_buffer_cap ) {
+        len = media_utf16_to_utf8(
+            path_len, (uint16_t*)pszFilePath,
+            result_buffer_cap - 1, out_result_buffer, &path_read );
+        out_result_buffer[len] = 0;
+    }
 
     PromptFileOpenResult result = PROMPT_FILE_OPEN_RESULT_SUCCESS;
-    if( len < 1 ) {
+    if( !len || path_read != path_len ) {
         win32_error( "prompt_file_open: failed to convert path from UCS-2 to UTF-8!" );
         result = PROMPT_FILE_OPEN_ERROR_UNKNOWN;
     } else {
         *out_result_len = len;
     }
 
-    free_title();
     CoTaskMemFree( pszFilePath );
     pItem->lpVtbl->Release( pItem );
     pFileOpen->lpVtbl->Release( pFileOpen );
 
-    win32_free_filters( filter );
+    win32_free_filters( filter, filter_size );
+    free_title();
 
     #undef free_title
     return result;
@@ -295,7 +320,8 @@ attr_internal _Bool win32_clip_filter_name(
 }
 
 attr_internal COMDLG_FILTERSPEC* win32_make_filters(
-    uint32_t filter_len, const char* filter, uint32_t* out_count
+    uint32_t filter_len, const char* filter,
+    uint32_t* out_count, uintptr_t* out_size
 ) {
     uint32_t filter_count = win32_count_filters( filter_len, filter );
     if( !filter_count ) {
@@ -304,13 +330,13 @@ attr_internal COMDLG_FILTERSPEC* win32_make_filters(
     }
 
     uint32_t wide_filter_len =
-        MultiByteToWideChar( CP_UTF8, 0, filter, filter_len, 0, 0 );
+        (uint32_t)media_utf8_to_utf16( filter_len, filter, 0, 0, 0 );
 
     uint32_t wide_buf_cap = wide_filter_len + 8;
     uint32_t buffer_size =
         (sizeof(wchar_t) * wide_buf_cap) +
         (sizeof(COMDLG_FILTERSPEC) * filter_count);
-    void* buffer = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, buffer_size );
+    void* buffer = media_alloc( buffer_size );
     if( !buffer ) {
         *out_count = filter_count;
         win32_error( "prompt_file_open: couldn't allocate file filter buffer!" );
@@ -356,35 +382,32 @@ attr_internal COMDLG_FILTERSPEC* win32_make_filters(
                 goto win32_make_filters_skip_filter;
             }
 
-            int name_len = MultiByteToWideChar(
-                CP_UTF8, 0,
-                filter_slice, current_filter_name_len,
-                filter_text_buffer, wide_buf_cap );
+            uintptr_t name_len = media_utf8_to_utf16(
+                current_filter_name_len, filter_slice,
+                wide_buf_cap - 1, (uint16_t*)filter_text_buffer, 0 );
 
             filter_text_buffer[name_len++] = 0;
             filters[i].pszName = filter_text_buffer;
 
             filter_text_buffer += name_len;
-            wide_buf_cap       += name_len;
+            wide_buf_cap       -= name_len;
 
             if( !wide_buf_cap ) {
                 break;
             }
 
-            int len = MultiByteToWideChar(
-                CP_UTF8, 0,
-                current_filter_start, current_filter_len,
-                filter_text_buffer, wide_buf_cap );
+            uintptr_t len = media_utf8_to_utf16(
+                current_filter_len, current_filter_start,
+                wide_buf_cap - 1, (uint16_t*)filter_text_buffer, 0 );
             filter_text_buffer[len++] = 0;
             filters[i].pszSpec = filter_text_buffer;
 
             filter_text_buffer += len;
-            wide_buf_cap       += len;
+            wide_buf_cap       -= len;
         } else {
-            int len = MultiByteToWideChar(
-                CP_UTF8, 0,
-                filter_slice, current_slice_len,
-                filter_text_buffer, wide_buf_cap );
+            uintptr_t len = media_utf8_to_utf16(
+                current_slice_len, filter_slice,
+                wide_buf_cap - 1, (uint16_t*)filter_text_buffer, 0 );
 
             filter_text_buffer[len++] = 0;
             filters[i].pszName = filter_text_buffer;
@@ -409,13 +432,16 @@ win32_make_filters_skip_filter:
     }
 
     *out_count = final_count;
+    *out_size  = buffer_size;
     return filters;
 }
-attr_internal void win32_free_filters( COMDLG_FILTERSPEC* filters ) {
+attr_internal void win32_free_filters( COMDLG_FILTERSPEC* filters, uintptr_t size ) {
     if( filters ) {
-        HeapFree( GetProcessHeap(), 0, filters );
+        media_free( filters, size );
     }
 }
 
+#undef WIN32_PROMPT_STACK_CAP
+
 #endif /* Platform Windows */
 
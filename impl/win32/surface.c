@@ -7,6 +7,7 @@
 #include "media/defines.h"
 #if defined(MEDIA_PLATFORM_WINDOWS)
 #include "media/surface.h"
+#include "media/time.h"
 #include "impl/win32/surface.h"
 #include "impl/win32/input.h"
 #include <windowsx.h>
@@ -14,10 +15,327 @@
 struct Win32Input;
 extern struct Win32Input* global_win32_input;
 
+// NOTE(alicia): DWM has no cloaking notification, surfaces are polled
+// at most this often from surface_pump_events().
+#define WIN32_SURFACE_CLOAK_POLL_NS (100ULL * MEDIA_TIME_NS_PER_MS)
+
+// NOTE(alicia): GUID_CONSOLE_DISPLAY_STATE, defined here to avoid initguid.
+attr_global const GUID global_win32_guid_console_display_state =
+    { 0x6FE69556, 0x704A, 0x47A0, { 0x8F, 0x24, 0xC2, 0x8D, 0x93, 0x6F, 0xDA, 0x47 } };
+
 attr_media_api uintptr_t surface_query_memory_requirement(void) {
     return sizeof( struct Win32Surface );
 }
 
+attr_internal uint32_t win32_surface_hash( HWND hwnd ) {
+    // NOTE(alicia): fibonacci hashing, top bits index hash table.
+    uint32_t key = (uint32_t)(uintptr_t)hwnd;
+    return (key * 2654435761u) >> (32 - WIN32_SURFACE_REGISTRY_HASH_BITS);
+}
+_Bool win32_surface_register( struct Win32Surface* surface ) {
+    struct Win32SurfaceRegistry* registry = &global_win32_state->surfaces;
+    AcquireSRWLockExclusive( &registry->lock );
+
+    uint32_t index;
+    if( registry->free_head ) {
+        index = registry->free_head - 1;
+        registry->free_head = registry->slots[index].next_free;
+    } else if( registry->used < WIN32_SURFACE_REGISTRY_CAP ) {
+        index = registry->used++;
+    } else {
+        registry->overflow_count++;
+        ReleaseSRWLockExclusive( &registry->lock );
+        surface->registry_handle = 0;
+        win32_warn_fmt(
+            "surface registry is full (%u surfaces), "
+            "falling back to slower window lookup!",
+            (uint64_t)WIN32_SURFACE_REGISTRY_CAP );
+        return false;
+    }
+
+    struct Win32SurfaceSlot* slot = registry->slots + index;
+    slot->generation++;
+    if( !slot->generation ) {
+        slot->generation = 1;
+    }
+    slot->surface   = surface;
+    slot->next_free = 0;
+
+    uint32_t at = win32_surface_hash( surface->hwnd );
+    while( registry->hash_keys[at] ) {
+        at = (at + 1) & (WIN32_SURFACE_REGISTRY_HASH_CAP - 1);
+    }
+    registry->hash_keys[at]  = surface->hwnd;
+    registry->hash_slots[at] = index;
+
+    surface->registry_handle = ((uint32_t)slot->generation << 16) | (index + 1);
+
+    ReleaseSRWLockExclusive( &registry->lock );
+    return true;
+}
+attr_internal void win32_surface_unregister_locked(
+    struct Win32SurfaceRegistry* registry, struct Win32Surface* surface
+) {
+    if( registry->focused == surface ) {
+        registry->focused = NULL;
+    }
+
+    if( !surface->registry_handle ) {
+        if( registry->overflow_count ) {
+            registry->overflow_count--;
+        }
+        return;
+    }
+
+    uint32_t index      = (surface->registry_handle & 0xFFFF) - 1;
+    uint16_t generation = surface->registry_handle >> 16;
+    surface->registry_handle = 0;
+
+    struct Win32SurfaceSlot* slot = registry->slots + index;
+    if( index >= registry->used || slot->generation != generation ) {
+        win32_warn( "attempted to unregister a stale surface!" );
+        return;
+    }
+
+    slot->surface       = NULL;
+    slot->next_free     = registry->free_head;
+    registry->free_head = index + 1;
+
+    uint32_t at = win32_surface_hash( surface->hwnd );
+    for( uint32_t i = 0; i < WIN32_SURFACE_REGISTRY_HASH_CAP; ++i ) {
+        if( registry->hash_keys[at] == surface->hwnd ) {
+            break;
+        }
+        at = (at + 1) & (WIN32_SURFACE_REGISTRY_HASH_CAP - 1);
+    }
+    if( registry->hash_keys[at] != surface->hwnd ) {
+        return;
+    }
+
+    // NOTE(alicia): backward shift deletion keeps probe chains intact
+    // without tombstones.
+    uint32_t hole = at;
+    uint32_t next = (hole + 1) & (WIN32_SURFACE_REGISTRY_HASH_CAP - 1);
+    while( registry->hash_keys[next] ) {
+        uint32_t home     = win32_surface_hash( registry->hash_keys[next] );
+        uint32_t distance =
+            (next - home) & (WIN32_SURFACE_REGISTRY_HASH_CAP - 1);
+        uint32_t hole_distance =
+            (next - hole) & (WIN32_SURFACE_REGISTRY_HASH_CAP - 1);
+        if( distance >= hole_distance ) {
+            registry->hash_keys[hole]  = registry->hash_keys[next];
+            registry->hash_slots[hole] = registry->hash_slots[next];
+            hole = next;
+        }
+        next = (next + 1) & (WIN32_SURFACE_REGISTRY_HASH_CAP - 1);
+    }
+    registry->hash_keys[hole]  = NULL;
+    registry->hash_slots[hole] = 0;
+}
+void win32_surface_unregister( struct Win32Surface* surface ) {
+    struct Win32SurfaceRegistry* registry = &global_win32_state->surfaces;
+    AcquireSRWLockExclusive( &registry->lock );
+    win32_surface_unregister_locked( registry, surface );
+    ReleaseSRWLockExclusive( &registry->lock );
+}
+struct Win32Surface* win32_surface_from_hwnd( HWND hwnd ) {
+    struct Win32SurfaceRegistry* registry = &global_win32_state->surfaces;
+    struct Win32Surface* result = NULL;
+    AcquireSRWLockShared( &registry->lock );
+
+    uint32_t at = win32_surface_hash( hwnd );
+    while( registry->hash_keys[at] ) {
+        if( registry->hash_keys[at] == hwnd ) {
+            result = registry->slots[registry->hash_slots[at]].surface;
+            break;
+        }
+        at = (at + 1) & (WIN32_SURFACE_REGISTRY_HASH_CAP - 1);
+    }
+    uint32_t overflow_count = registry->overflow_count;
+
+    ReleaseSRWLockShared( &registry->lock );
+    if( !result && overflow_count ) {
+        result = (struct Win32Surface*)GetWindowLongPtrW( hwnd, GWLP_USERDATA );
+    }
+    return result;
+}
+/// @brief Find next surface in registry, starting at slot index.
+/// @details
+/// Lock is not held when this returns so callbacks are free
+/// to create and destroy surfaces between calls.
+/// @param[in,out] at        Slot index to start at, set to slot after surface.
+/// @param         thread_id Only return surfaces created by this thread, 0 for any.
+/// @return NULL if there are no more surfaces.
+attr_internal struct Win32Surface* win32_surface_next(
+    uint32_t* at, DWORD thread_id
+) {
+    struct Win32SurfaceRegistry* registry = &global_win32_state->surfaces;
+    struct Win32Surface* result = NULL;
+    AcquireSRWLockShared( &registry->lock );
+
+    while( *at < registry->used ) {
+        struct Win32Surface* surface = registry->slots[(*at)++].surface;
+        if( surface && (!thread_id || surface->thread_id == thread_id) ) {
+            result = surface;
+            break;
+        }
+    }
+
+    ReleaseSRWLockShared( &registry->lock );
+    return result;
+}
+attr_internal void win32_surface_mark_pending(
+    struct Win32Surface* surface, uint8_t pending
+) {
+    // NOTE(alicia): only called from window procedure, which runs on
+    // thread that created surface. surface_create() made its state.
+    struct Win32ThreadState* thread = win32_thread_state_query();
+    if( !thread ) {
+        return;
+    }
+    if( !surface->pending ) {
+        surface->pending_next    = thread->pending_surfaces;
+        thread->pending_surfaces = surface;
+    }
+    surface->pending |= pending;
+}
+/// @brief Surface whose pending callbacks are being sent by flush.
+struct Win32SurfaceFlush {
+    /// @brief Set to NULL if a callback destroyed surface.
+    struct Win32Surface*      surface;
+    struct Win32SurfaceFlush* next;
+};
+attr_internal void win32_surface_remove_pending( struct Win32Surface* surface ) {
+    struct Win32ThreadState* thread = win32_thread_state_query();
+    if( !thread ) {
+        return;
+    }
+    // NOTE(alicia): flushes up the stack must not touch surface again.
+    for( struct Win32SurfaceFlush* flush = thread->flushing; flush; flush = flush->next ) {
+        if( flush->surface == surface ) {
+            flush->surface = NULL;
+        }
+    }
+
+    if( !surface->pending ) {
+        return;
+    }
+    struct Win32Surface** at = &thread->pending_surfaces;
+    while( *at ) {
+        if( *at == surface ) {
+            *at = surface->pending_next;
+            break;
+        }
+        at = &(*at)->pending_next;
+    }
+    surface->pending_next = NULL;
+    surface->pending      = 0;
+}
+void win32_surface_flush_pending(void) {
+    struct Win32ThreadState* thread = win32_thread_state_query();
+    if( !thread ) {
+        return;
+    }
+
+    struct Win32SurfaceFlush flush;
+    flush.next       = thread->flushing;
+    thread->flushing = &flush;
+
+    SurfaceCallbackData data;
+    // NOTE(alicia): surfaces are unlinked and everything callbacks report
+    // is copied before first callback. callbacks are free to destroy
+    // surfaces or move them again, destroyed surfaces get no more callbacks.
+    while( thread->pending_surfaces ) {
+        struct Win32Surface* surface = thread->pending_surfaces;
+        thread->pending_surfaces = surface->pending_next;
+        surface->pending_next    = NULL;
+
+        uint8_t pending  = surface->pending;
+        surface->pending = 0;
+
+        SurfaceCallbackFN* callback = surface->callback;
+        void* params = surface->callback_params;
+        if( !callback ) {
+            continue;
+        }
+
+        int32_t x     = surface->x;
+        int32_t y     = surface->y;
+        int32_t w     = surface->w;
+        int32_t h     = surface->h;
+        int32_t old_x = surface->pending_old_x;
+        int32_t old_y = surface->pending_old_y;
+        int32_t old_w = surface->pending_old_w;
+        int32_t old_h = surface->pending_old_h;
+
+        const char* text  = surface->text_buffer;
+        uint32_t text_len = surface->text_len;
+        _Bool is_text_truncated = surface->is_text_truncated;
+
+        flush.surface = surface;
+
+        if(
+            (pending & WIN32_SURFACE_PENDING_MOVE) &&
+            !( old_x == x && old_y == y )
+        ) {
+            memset( &data, 0, sizeof(data) );
+            data.type = SURFACE_CALLBACK_TYPE_POSITION;
+            data.position.x     = x;
+            data.position.y     = y;
+            data.position.old_x = old_x;
+            data.position.old_y = old_y;
+
+            callback( surface, &data, params );
+        }
+
+        if(
+            flush.surface &&
+            (pending & WIN32_SURFACE_PENDING_RESIZE) &&
+            !( old_w == w && old_h == h )
+        ) {
+            memset( &data, 0, sizeof(data) );
+            data.type = SURFACE_CALLBACK_TYPE_RESIZE;
+            data.resize.w     = w;
+            data.resize.h     = h;
+            data.resize.old_w = old_w;
+            data.resize.old_h = old_h;
+
+            callback( surface, &data, params );
+        }
+
+        if( flush.surface && (pending & WIN32_SURFACE_PENDING_TEXT) ) {
+            memset( &data, 0, sizeof(data) );
+            data.type = SURFACE_CALLBACK_TYPE_TEXT_BATCH;
+            data.text_batch.utf8         = text;
+            data.text_batch.len          = text_len;
+            data.text_batch.is_truncated = is_text_truncated;
+
+            callback( surface, &data, params );
+        }
+    }
+
+    thread->flushing = flush.next;
+}
+HWND win32_get_focused_window( _Bool* opt_out_is_relative_mouse ) {
+    struct Win32SurfaceRegistry* registry = &global_win32_state->surfaces;
+    HWND  result = NULL;
+    _Bool is_relative_mouse = false;
+    AcquireSRWLockShared( &registry->lock );
+
+    // NOTE(alicia): read under lock, owning thread may be destroying surface.
+    struct Win32Surface* focused = registry->focused;
+    if( focused ) {
+        result = focused->hwnd;
+        is_relative_mouse = (focused->state & SURFACE_STATE_RELATIVE_MOUSE) != 0;
+    }
+
+    ReleaseSRWLockShared( &registry->lock );
+    if( opt_out_is_relative_mouse ) {
+        *opt_out_is_relative_mouse = is_relative_mouse;
+    }
+    return result;
+}
+
 attr_internal void win32_surface_flags_to_style(
     SurfaceCreateFlags flags, DWORD* out_dwstyle, DWORD* out_dwexstyle 
 ) {
@@ -59,6 +377,11 @@ attr_media_api _Bool surface_create(
         return false;
     }
 
+    if( !win32_load_surface() ) {
+        win32_error( "surface_create: failed to load surface subsystem!" );
+        return false;
+    }
+
     struct Win32Surface* surface = out_surface;
     surface->callback        = opt_callback;
     surface->callback_params = opt_callback_params;
@@ -71,10 +394,9 @@ attr_media_api _Bool surface_create(
             max_title_len = SURFACE_MAX_TITLE_LEN;
         }
 
-        int wide_title_len = MultiByteToWideChar(
-            CP_UTF8, 0, title,
-            max_title_len, surface->title_ucs2,
-            WIN32_SURFACE_TITLE_UCS2_CAP - 1 );
+        uintptr_t wide_title_len = media_utf8_to_utf16(
+            max_title_len, title,
+            WIN32_SURFACE_TITLE_UCS2_CAP - 1, (uint16_t*)surface->title_ucs2, 0 );
 
         surface->title_ucs2[wide_title_len] = 0;
     } else {
@@ -116,6 +438,12 @@ attr_media_api _Bool surface_create(
         return false;
     }
 
+    // NOTE(alicia): pending surfaces are kept in state of creating thread.
+    if( !win32_thread_state() ) {
+        win32_error( "surface_create: failed to create thread state!" );
+        return false;
+    }
+
     HWND handle = CreateWindowExW(
         dwExStyle,
         WIN32_DEFAULT_WINDOW_CLASS, surface->title_ucs2,
@@ -139,12 +467,23 @@ attr_media_api _Bool surface_create(
         surface->title_len = sizeof("Surface") - 1;
     }
 
-    surface->hwnd = handle;
-    surface->hdc  = GetDC( surface->hwnd );
+    surface->hwnd      = handle;
+    surface->hdc       = GetDC( surface->hwnd );
+    // NOTE(alicia): window is owned by thread that created it.
+    surface->thread_id = GetCurrentThreadId();
 
-    SetWindowLongPtrW( surface->hwnd, GWLP_USERDATA, (WIN32_PTR)surface );
+    if( !win32_surface_register( surface ) ) {
+        SetWindowLongPtrW( surface->hwnd, GWLP_USERDATA, (WIN32_PTR)surface );
+    }
 
-    if( flags & SURFACE_CREATE_FLAG_DARK_MODE ) {
+    surface->power_notify = RegisterPowerSettingNotification(
+        surface->hwnd, &global_win32_guid_console_display_state,
+        DEVICE_NOTIFY_WINDOW_HANDLE );
+    if( WTSRegisterSessionNotification ) {
+        WTSRegisterSessionNotification( surface->hwnd, NOTIFY_FOR_THIS_SESSION );
+    }
+
+    if( (flags & SURFACE_CREATE_FLAG_DARK_MODE) && win32_load_dwmapi() ) {
         BOOL value = TRUE;
         DwmSetWindowAttribute(
             surface->hwnd, DWMWA_USE_IMMERSIVE_DARK_MODE,
@@ -166,18 +505,206 @@ attr_media_api _Bool surface_create(
 attr_media_api void surface_destroy( SurfaceHandle* in_surface ) {
     struct Win32Surface* surface = in_surface;
 
+    win32_surface_apply_exclusive( surface, false );
+    if(
+        (surface->state & SURFACE_STATE_RELATIVE_MOUSE) &&
+        (surface->state & SURFACE_STATE_IS_FOCUSED)
+    ) {
+        ClipCursor( NULL );
+    }
+    if( surface->power_notify ) {
+        UnregisterPowerSettingNotification( surface->power_notify );
+    }
+    if( WTSUnRegisterSessionNotification ) {
+        WTSUnRegisterSessionNotification( surface->hwnd );
+    }
     ReleaseDC( surface->hwnd, surface->hdc );
     DestroyWindow( surface->hwnd );
+    win32_surface_unregister( surface );
+    win32_surface_remove_pending( surface );
 
     memset( surface, 0, sizeof(*surface) );
 }
+attr_internal void win32_surface_update_occlusion( struct Win32Surface* surface ) {
+    _Bool is_occluded =
+        surface->is_cloaked                   ||
+        global_win32_state->is_session_locked ||
+        global_win32_state->is_display_off;
+    if( is_occluded == ((surface->state & SURFACE_STATE_IS_OCCLUDED) != 0) ) {
+        return;
+    }
+    if( is_occluded ) {
+        surface->state |= SURFACE_STATE_IS_OCCLUDED;
+    } else {
+        surface->state &= ~SURFACE_STATE_IS_OCCLUDED;
+    }
+
+    if( surface->callback ) {
+        SurfaceCallbackData data;
+        memset( &data, 0, sizeof(data) );
+        data.type = SURFACE_CALLBACK_TYPE_OCCLUSION;
+        data.occlusion.is_occluded = is_occluded;
+        surface->callback( surface, &data, surface->callback_params );
+    }
+}
+attr_internal void win32_surface_update_occlusion_all(void) {
+    // NOTE(alicia): callbacks may destroy surfaces, slots are rechecked.
+    // surfaces of other threads are updated when they receive same message.
+    DWORD thread_id = GetCurrentThreadId();
+    uint32_t at = 0;
+    struct Win32Surface* surface;
+    while( (surface = win32_surface_next( &at, thread_id )) ) {
+        win32_surface_update_occlusion( surface );
+    }
+}
+attr_internal void win32_surface_poll_cloaked(void) {
+    struct Win32ThreadState* thread = win32_thread_state_query();
+    if( !thread ) {
+        return;
+    }
+    uint64_t now = media_time_ns();
+    if( now - thread->cloak_poll_ns < WIN32_SURFACE_CLOAK_POLL_NS ) {
+        return;
+    }
+    thread->cloak_poll_ns = now;
+    if( !win32_load_dwmapi() ) {
+        return;
+    }
+
+    DWORD thread_id = GetCurrentThreadId();
+    uint32_t at = 0;
+    struct Win32Surface* surface;
+    while( (surface = win32_surface_next( &at, thread_id )) ) {
+        DWORD cloaked = 0;
+        // NOTE(alicia): fails before Windows 8, surfaces are never cloaked there.
+        if( FAILED( DwmGetWindowAttribute(
+            surface->hwnd, DWMWA_CLOAKED, &cloaked, sizeof(cloaked) ) )
+        ) {
+            cloaked = 0;
+        }
+        surface->is_cloaked = cloaked != 0;
+        win32_surface_update_occlusion( surface );
+    }
+}
 attr_media_api void surface_pump_events(void) {
+    if( !win32_load_user32() ) {
+        return;
+    }
+    media_trace_scope( "surface_pump_events" );
+
     MSG message;
     memset( &message, 0, sizeof(message) );
     while( PeekMessageW( &message, 0, 0, 0, PM_REMOVE ) ) {
         TranslateMessage( &message );
         DispatchMessageW( &message );
     }
+
+    win32_surface_poll_cloaked();
+    win32_surface_flush_pending();
+}
+attr_media_api void surface_pump_events_subset(
+    uint32_t count, SurfaceHandle** surfaces
+) {
+    if( !win32_load_user32() ) {
+        return;
+    }
+    media_trace_scope( "surface_pump_events_subset" );
+
+    MSG message;
+    memset( &message, 0, sizeof(message) );
+    for( uint32_t i = 0; i < count; ++i ) {
+        struct Win32Surface* surface = surfaces[i];
+        while( PeekMessageW( &message, surface->hwnd, 0, 0, PM_REMOVE ) ) {
+            TranslateMessage( &message );
+            DispatchMessageW( &message );
+        }
+    }
+
+    // NOTE(alicia): messages that are not bound to a window.
+    while( PeekMessageW( &message, (HWND)-1, 0, 0, PM_REMOVE ) ) {
+        TranslateMessage( &message );
+        DispatchMessageW( &message );
+    }
+
+    win32_surface_poll_cloaked();
+    win32_surface_flush_pending();
+}
+attr_media_api SurfaceWaitResult surface_wait_events(
+    uint64_t timeout_ns, uint32_t opt_handle_count,
+    void* const* opt_handles, uint32_t* opt_out_handle_index
+) {
+    if( !win32_load_user32() ) {
+        return SURFACE_WAIT_RESULT_ERROR;
+    }
+    if( opt_handle_count > SURFACE_WAIT_MAX_HANDLES ) {
+        win32_error_fmt(
+            "surface_wait_events: too many handles! max: %u",
+            SURFACE_WAIT_MAX_HANDLES );
+        return SURFACE_WAIT_RESULT_ERROR;
+    }
+    media_trace_scope( "surface_wait_events" );
+
+    // NOTE(alicia): layout is wake event, extra handles then timer.
+    HANDLE handles[SURFACE_WAIT_MAX_HANDLES + 2];
+    DWORD  count = 0;
+    handles[count++] = global_win32_state->wake_event;
+    for( uint32_t i = 0; i < opt_handle_count; ++i ) {
+        handles[count++] = (HANDLE)opt_handles[i];
+    }
+
+    // NOTE(alicia): wait timeout is in milliseconds and wakes up
+    // on scheduler ticks, high resolution timer keeps short timeouts precise.
+    DWORD timeout_ms  = INFINITE;
+    DWORD timer_index = count;
+    if( timeout_ns != SURFACE_WAIT_INFINITE ) {
+        HANDLE timer = timeout_ns ? win32_sleep_timer() : NULL;
+
+        LARGE_INTEGER due;
+        // NOTE(alicia): negative due time is relative, in 100ns units.
+        due.QuadPart = -(LONGLONG)((timeout_ns + 99) / 100);
+        if( timer && SetWaitableTimerEx( timer, &due, 0, NULL, NULL, NULL, 0 ) ) {
+            handles[count++] = timer;
+        } else {
+            uint64_t ms = (timeout_ns + (MEDIA_TIME_NS_PER_MS - 1)) / MEDIA_TIME_NS_PER_MS;
+            timeout_ms = ms >= INFINITE ? INFINITE - 1 : (DWORD)ms;
+        }
+    }
+
+    DWORD result = MsgWaitForMultipleObjectsEx(
+        count, handles, timeout_ms, QS_ALLINPUT, MWMO_INPUTAVAILABLE );
+
+    if( count > timer_index && result != WAIT_OBJECT_0 + timer_index ) {
+        CancelWaitableTimer( handles[timer_index] );
+    }
+
+    if( result == WAIT_OBJECT_0 + count ) {
+        return SURFACE_WAIT_RESULT_EVENTS;
+    }
+    if( result == WAIT_OBJECT_0 ) {
+        return SURFACE_WAIT_RESULT_WAKE;
+    }
+    if( result > WAIT_OBJECT_0 && result < WAIT_OBJECT_0 + timer_index ) {
+        if( opt_out_handle_index ) {
+            *opt_out_handle_index = result - (WAIT_OBJECT_0 + 1);
+        }
+        return SURFACE_WAIT_RESULT_HANDLE;
+    }
+    if( result == WAIT_TIMEOUT || result == WAIT_OBJECT_0 + timer_index ) {
+        return SURFACE_WAIT_RESULT_TIMEOUT;
+    }
+    if( result > WAIT_ABANDONED_0 && result < WAIT_ABANDONED_0 + timer_index ) {
+        // NOTE(alicia): abandoned mutex is still acquired by caller.
+        if( opt_out_handle_index ) {
+            *opt_out_handle_index = result - (WAIT_ABANDONED_0 + 1);
+        }
+        return SURFACE_WAIT_RESULT_HANDLE;
+    }
+
+    win32_error_message( GetLastError(), "surface_wait_events: wait failed!" );
+    return SURFACE_WAIT_RESULT_ERROR;
+}
+attr_media_api void surface_wake(void) {
+    SetEvent( global_win32_state->wake_event );
 }
 attr_media_api void surface_set_callback(
     SurfaceHandle* in_surface, SurfaceCallbackFN* callback, void* opt_callback_params
@@ -211,12 +738,12 @@ attr_media_api void surface_set_title(
     struct Win32Surface* surface = in_surface;
     memset( surface->title_ucs2, 0, WIN32_SURFACE_TITLE_SIZE );
 
-    MultiByteToWideChar(
-        CP_UTF8, 0, title, len,
-        surface->title_ucs2, WIN32_SURFACE_TITLE_UCS2_CAP - 1 );
+    media_utf8_to_utf16(
+        len, title,
+        WIN32_SURFACE_TITLE_UCS2_CAP - 1, (uint16_t*)surface->title_ucs2, 0 );
 
     SetWindowTextW( surface->hwnd, surface->title_ucs2 );
-    memset( surface->title_ucs2, 0, WIN32_SURFACE_TITLE_UCS2_CAP );
+    memset( surface->title_ucs2, 0, WIN32_SURFACE_TITLE_SIZE );
 
     uint32_t max_len = len;
     if( max_len > SURFACE_MAX_TITLE_LEN - 1 ) {
@@ -224,7 +751,7 @@ attr_media_api void surface_set_title(
     }
 
     memcpy( surface->title_utf8, title, max_len );
-    surface->title_len = max_len - 1;
+    surface->title_len = max_len;
 }
 attr_media_api void surface_query_position(
     const SurfaceHandle* in_surface, int32_t* out_x, int32_t* out_y
@@ -287,6 +814,72 @@ attr_media_api SurfaceStateFlags surface_query_state(
     const struct Win32Surface* surface = in_surface;
     return surface->state;
 }
+/// @brief Apply or restore exclusive fullscreen display mode.
+attr_internal _Bool win32_surface_apply_exclusive(
+    struct Win32Surface* surface, _Bool is_applied
+) {
+    if( surface->is_exclusive_applied == is_applied ) {
+        return true;
+    }
+    // NOTE(alicia): CDS_FULLSCREEN marks change as temporary so Windows
+    // also restores registry mode if process exits without cleaning up.
+    LONG result = ChangeDisplaySettingsExW(
+        surface->exclusive_device,
+        is_applied ? &surface->exclusive_mode : NULL,
+        NULL, is_applied ? CDS_FULLSCREEN : 0, NULL );
+    display_invalidate();
+    if( result != DISP_CHANGE_SUCCESSFUL ) {
+        if( is_applied ) {
+            win32_error_fmt(
+                "failed to apply exclusive display mode! result: %i", (int64_t)result );
+        } else {
+            win32_error_fmt(
+                "failed to restore display mode! result: %i", (int64_t)result );
+        }
+        return false;
+    }
+    surface->is_exclusive_applied = is_applied;
+    return true;
+}
+/// @brief Cover monitor surface is on.
+attr_internal void win32_surface_cover_monitor( struct Win32Surface* surface ) {
+    MONITORINFO monitor = win32_monitor_info( surface->hwnd );
+    SetWindowPos(
+        surface->hwnd, HWND_TOP,
+        monitor.rcMonitor.left, monitor.rcMonitor.top,
+        monitor.rcMonitor.right  - monitor.rcMonitor.left,
+        monitor.rcMonitor.bottom - monitor.rcMonitor.top,
+        SWP_NOOWNERZORDER | SWP_FRAMECHANGED | SWP_SHOWWINDOW );
+}
+/// @brief Restore or reapply exclusive mode when surface loses or gains focus.
+attr_internal void win32_surface_exclusive_focus(
+    struct Win32Surface* surface, _Bool is_focused
+) {
+    if( !(surface->state & SURFACE_STATE_FULLSCREEN_EXCLUSIVE) ) {
+        return;
+    }
+    if( is_focused ) {
+        if( win32_surface_apply_exclusive( surface, true ) ) {
+            ShowWindow( surface->hwnd, SW_RESTORE );
+            win32_surface_cover_monitor( surface );
+        }
+    } else {
+        win32_surface_apply_exclusive( surface, false );
+        // NOTE(alicia): surface would cover other windows at
+        // the wrong size otherwise.
+        ShowWindow( surface->hwnd, SW_MINIMIZE );
+    }
+}
+void win32_surface_restore_display_modes(void) {
+    // NOTE(alicia): display modes are process wide, restored for every thread.
+    uint32_t at = 0;
+    struct Win32Surface* surface;
+    while( (surface = win32_surface_next( &at, 0 )) ) {
+        if( surface->is_exclusive_applied ) {
+            win32_surface_apply_exclusive( surface, false );
+        }
+    }
+}
 attr_media_api void surface_set_fullscreen(
     SurfaceHandle* in_surface, _Bool is_fullscreen
 ) {
@@ -319,6 +912,10 @@ attr_media_api void surface_set_fullscreen(
             x, y, w, h,
             SWP_NOOWNERZORDER | SWP_FRAMECHANGED | SWP_SHOWWINDOW );
     } else {
+        if( surface->state & SURFACE_STATE_FULLSCREEN_EXCLUSIVE ) {
+            surface_set_fullscreen_exclusive( surface, NULL );
+            return;
+        }
         surface->state &= ~SURFACE_STATE_FULLSCREEN;
 
         DWORD dwStyle   = 0;
@@ -338,6 +935,299 @@ attr_media_api void surface_set_fullscreen(
             SWP_NOOWNERZORDER | SWP_FRAMECHANGED | SWP_SHOWWINDOW );
     }
 }
+attr_media_api _Bool surface_set_fullscreen_exclusive(
+    SurfaceHandle* in_surface, const struct DisplayMode* opt_mode
+) {
+    struct Win32Surface* surface = in_surface;
+    if( !win32_load_display() ) {
+        return false;
+    }
+
+    if( !opt_mode ) {
+        if( !(surface->state & SURFACE_STATE_FULLSCREEN_EXCLUSIVE) ) {
+            return true;
+        }
+        win32_surface_apply_exclusive( surface, false );
+        surface->state &= ~SURFACE_STATE_FULLSCREEN_EXCLUSIVE;
+        surface_set_fullscreen( surface, false );
+        return true;
+    }
+
+    HMONITOR monitor = MonitorFromWindow( surface->hwnd, MONITOR_DEFAULTTONEAREST );
+    MONITORINFOEXW info;
+    memset( &info, 0, sizeof(info) );
+    info.cbSize = sizeof(info);
+    if( !GetMonitorInfoW( monitor, (MONITORINFO*)&info ) ) {
+        win32_error_message( GetLastError(),
+            "surface_set_fullscreen_exclusive: failed to query monitor!" );
+        return false;
+    }
+
+    // NOTE(alicia): modes list whole hertz, 59.94 Hz is listed as 59.
+    DWORD frequency = 0;
+    if( opt_mode->refresh_rate.denominator ) {
+        frequency = opt_mode->refresh_rate.numerator / opt_mode->refresh_rate.denominator;
+    }
+
+    DEVMODEW dm;
+    memset( &dm, 0, sizeof(dm) );
+    dm.dmSize = sizeof(dm);
+    _Bool found = false;
+    for( DWORD i = 0; EnumDisplaySettingsExW( info.szDevice, i, &dm, 0 ); ++i ) {
+        if(
+            (int32_t)dm.dmPelsWidth  == opt_mode->w &&
+            (int32_t)dm.dmPelsHeight == opt_mode->h &&
+            (!opt_mode->bits_per_pixel || dm.dmBitsPerPel == opt_mode->bits_per_pixel) &&
+            (!frequency || dm.dmDisplayFrequency == frequency)
+        ) {
+            found = true;
+            break;
+        }
+    }
+    if( !found ) {
+        win32_error_fmt(
+            "surface_set_fullscreen_exclusive: display does not support %ix%i @ %u Hz!",
+            opt_mode->w, opt_mode->h, frequency );
+        return false;
+    }
+    dm.dmFields =
+        DM_PELSWIDTH | DM_PELSHEIGHT | DM_BITSPERPEL | DM_DISPLAYFREQUENCY;
+
+    // NOTE(alicia): restore current mode first in case
+    // surface is moving to another display.
+    win32_surface_apply_exclusive( surface, false );
+
+    memcpy( surface->exclusive_device, info.szDevice, sizeof(surface->exclusive_device) );
+    surface->exclusive_mode = dm;
+
+    // NOTE(alicia): windowed placement is saved before mode changes
+    // so it is restored at original resolution.
+    _Bool was_fullscreen = (surface->state & SURFACE_STATE_FULLSCREEN) != 0;
+    surface_set_fullscreen( surface, true );
+
+    if( !win32_surface_apply_exclusive( surface, true ) ) {
+        surface->state &= ~SURFACE_STATE_FULLSCREEN_EXCLUSIVE;
+        if( !was_fullscreen ) {
+            surface_set_fullscreen( surface, false );
+        }
+        return false;
+    }
+
+    surface->state |= SURFACE_STATE_FULLSCREEN_EXCLUSIVE;
+    win32_surface_cover_monitor( surface );
+    return true;
+}
+attr_internal void win32_surface_clip_cursor( struct Win32Surface* surface ) {
+    RECT rect;
+    memset( &rect, 0, sizeof(rect) );
+    if( !GetClientRect( surface->hwnd, &rect ) ) {
+        return;
+    }
+    POINT top_left     = { rect.left, rect.top };
+    POINT bottom_right = { rect.right, rect.bottom };
+    ClientToScreen( surface->hwnd, &top_left );
+    ClientToScreen( surface->hwnd, &bottom_right );
+
+    rect.left   = top_left.x;
+    rect.top    = top_left.y;
+    rect.right  = bottom_right.x;
+    rect.bottom = bottom_right.y;
+    ClipCursor( &rect );
+}
+/// @brief Confine or release cursor when surface gains or loses focus.
+attr_internal void win32_surface_relative_mouse_focus(
+    struct Win32Surface* surface, _Bool is_focused
+) {
+    if( !(surface->state & SURFACE_STATE_RELATIVE_MOUSE) ) {
+        return;
+    }
+    if( is_focused ) {
+        win32_surface_clip_cursor( surface );
+        SetCursor( NULL );
+    } else {
+        ClipCursor( NULL );
+    }
+}
+attr_media_api void surface_set_relative_mouse(
+    SurfaceHandle* in_surface, _Bool is_enabled
+) {
+    struct Win32Surface* surface = in_surface;
+    if( is_enabled == ((surface->state & SURFACE_STATE_RELATIVE_MOUSE) != 0) ) {
+        return;
+    }
+
+    if( is_enabled ) {
+        surface->state |= SURFACE_STATE_RELATIVE_MOUSE;
+        win32_surface_relative_mouse_focus(
+            surface, (surface->state & SURFACE_STATE_IS_FOCUSED) != 0 );
+    } else {
+        surface->state &= ~SURFACE_STATE_RELATIVE_MOUSE;
+        if( surface->state & SURFACE_STATE_IS_FOCUSED ) {
+            ClipCursor( NULL );
+            SetCursor( global_win32_cursor_hidden ? NULL : win32_cursor( surface->cursor ) );
+        }
+    }
+}
+attr_internal void win32_surface_apply_text_rect( struct Win32Surface* surface ) {
+    if( !surface->has_text_rect || !ImmGetContext ) {
+        return;
+    }
+    HIMC himc = ImmGetContext( surface->hwnd );
+    if( !himc ) {
+        return;
+    }
+
+    RECT area;
+    area.left   = surface->text_rect_x;
+    area.right  = surface->text_rect_x + surface->text_rect_w;
+    area.top    = surface->h - (surface->text_rect_y + surface->text_rect_h);
+    area.bottom = surface->h - surface->text_rect_y;
+
+    COMPOSITIONFORM composition;
+    memset( &composition, 0, sizeof(composition) );
+    composition.dwStyle        = CFS_POINT;
+    composition.ptCurrentPos.x = area.left;
+    composition.ptCurrentPos.y = area.top;
+    ImmSetCompositionWindow( himc, &composition );
+
+    CANDIDATEFORM candidate;
+    memset( &candidate, 0, sizeof(candidate) );
+    candidate.dwIndex        = 0;
+    candidate.dwStyle        = CFS_EXCLUDE;
+    candidate.ptCurrentPos.x = area.left;
+    candidate.ptCurrentPos.y = area.bottom;
+    candidate.rcArea         = area;
+    ImmSetCandidateWindow( himc, &candidate );
+
+    ImmReleaseContext( surface->hwnd, himc );
+}
+attr_internal void win32_surface_send_composition(
+    struct Win32Surface* surface, _Bool is_ended
+) {
+    uint16_t ucs2[WIN32_SURFACE_COMPOSITION_UCS2_CAP];
+    // NOTE(alicia): each UTF-16 code unit takes at most 3 bytes in UTF-8.
+    char     utf8[(WIN32_SURFACE_COMPOSITION_UCS2_CAP * 3) + 1];
+
+    uint32_t unit_count = 0;
+    uint32_t cursor     = 0;
+    if( !is_ended && ImmGetContext ) {
+        HIMC himc = ImmGetContext( surface->hwnd );
+        if( himc ) {
+            LONG size = ImmGetCompositionStringW( himc, GCS_COMPSTR, NULL, 0 );
+            if( size > (LONG)sizeof(ucs2) ) {
+                size = sizeof(ucs2);
+            }
+            if( size > 0 ) {
+                size = ImmGetCompositionStringW( himc, GCS_COMPSTR, ucs2, size );
+            }
+            LONG pos = ImmGetCompositionStringW( himc, GCS_CURSORPOS, NULL, 0 );
+
+            unit_count = size > 0 ? (uint32_t)size / sizeof(uint16_t) : 0;
+            cursor     = pos  > 0 ? (uint32_t)pos : 0;
+            ImmReleaseContext( surface->hwnd, himc );
+        }
+    }
+    if( cursor > unit_count ) {
+        cursor = unit_count;
+    }
+
+    uint32_t len = (uint32_t)media_utf16_to_utf8(
+        unit_count, ucs2, sizeof(utf8) - 1, utf8, 0 );
+    utf8[len] = 0;
+
+    SurfaceCallbackData data;
+    memset( &data, 0, sizeof(data) );
+    data.type = SURFACE_CALLBACK_TYPE_TEXT_COMPOSITION;
+    data.text_composition.utf8   = utf8;
+    data.text_composition.len    = len;
+    data.text_composition.cursor =
+        (uint32_t)media_utf16_to_utf8( cursor, ucs2, 0, NULL, 0 );
+
+    surface->callback( surface, &data, surface->callback_params );
+}
+attr_internal void win32_surface_commit_text(
+    struct Win32Surface* surface, uint32_t len, const uint16_t* utf16
+) {
+    if( surface->text_buffer ) {
+        if( !(surface->pending & WIN32_SURFACE_PENDING_TEXT) ) {
+            surface->text_len          = 0;
+            surface->is_text_truncated = false;
+        }
+        win32_surface_mark_pending( surface, WIN32_SURFACE_PENDING_TEXT );
+        if( surface->is_text_truncated ) {
+            return;
+        }
+
+        uintptr_t read    = 0;
+        char*     at      = surface->text_buffer + surface->text_len;
+        uint32_t  written = (uint32_t)media_utf16_to_utf8(
+            len, utf16, surface->text_cap - surface->text_len, at, &read );
+        for( uint32_t i = 0; i < written; ++i ) {
+            if( at[i] == '\r' ) {
+                at[i] = '\n';
+            }
+        }
+
+        surface->text_len += written;
+        if( read < len ) {
+            surface->is_text_truncated = true;
+        }
+        return;
+    }
+
+    SurfaceCallbackData data;
+    uint32_t read = 0;
+    while( read < len ) {
+        uint32_t cp;
+        uint32_t consumed = media_utf16_decode( len - read, utf16 + read, &cp );
+
+        memset( &data, 0, sizeof(data) );
+        data.type = SURFACE_CALLBACK_TYPE_TEXT;
+        media_utf16_to_utf8(
+            consumed, utf16 + read,
+            sizeof(data.text.utf8) - 1, data.text.utf8, 0 );
+        if( data.text.utf8[0] == '\r' ) {
+            data.text.utf8[0] = '\n';
+        }
+
+        surface->callback( surface, &data, surface->callback_params );
+        read += consumed;
+    }
+}
+attr_media_api void surface_set_text_buffer(
+    SurfaceHandle* in_surface, uint32_t cap, char* opt_buffer
+) {
+    struct Win32Surface* surface = in_surface;
+    surface->text_buffer       = opt_buffer;
+    surface->text_cap          = opt_buffer ? cap : 0;
+    surface->text_len          = 0;
+    surface->is_text_truncated = false;
+    if( !opt_buffer ) {
+        surface->pending &= ~WIN32_SURFACE_PENDING_TEXT;
+    }
+}
+attr_media_api void surface_set_text_composition_inline(
+    SurfaceHandle* in_surface, _Bool is_inline
+) {
+    struct Win32Surface* surface = in_surface;
+    if( is_inline ) {
+        surface->state |= SURFACE_STATE_INLINE_COMPOSITION;
+    } else {
+        surface->state &= ~SURFACE_STATE_INLINE_COMPOSITION;
+    }
+}
+attr_media_api void surface_set_text_composition_rect(
+    SurfaceHandle* in_surface, int32_t x, int32_t y, int32_t w, int32_t h
+) {
+    struct Win32Surface* surface = in_surface;
+    surface->has_text_rect = true;
+    surface->text_rect_x   = x;
+    surface->text_rect_y   = y;
+    surface->text_rect_w   = w;
+    surface->text_rect_h   = h;
+
+    win32_surface_apply_text_rect( surface );
+}
 attr_media_api void surface_set_hidden(
     SurfaceHandle* in_surface, _Bool is_hidden
 ) {
@@ -359,14 +1249,14 @@ attr_media_api void surface_set_hidden(
 }
 
 LRESULT win32_winproc( HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam ) {
-    struct Win32Surface* surface =
-        (struct Win32Surface*)GetWindowLongPtrW( hwnd, GWLP_USERDATA );
+    struct Win32Surface* surface = win32_surface_from_hwnd( hwnd );
 
     SurfaceCallbackData data;
     memset( &data, 0, sizeof(data) );
     #define cb() surface->callback( surface, &data, surface->callback_params )
 
     _Bool activated;
+    _Bool is_minimized_changed = false;
     switch( msg ) {
         case WM_SETCURSOR: {
             CursorType cursor = CURSOR_TYPE_ARROW;
@@ -394,18 +1284,35 @@ LRESULT win32_winproc( HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam ) {
                 } break;
                 default: break;
             }
-            if( global_win32_cursor_hidden ) {
+            if(
+                global_win32_cursor_hidden ||
+                ( LOWORD(lparam) == HTCLIENT && surface &&
+                  (surface->state & SURFACE_STATE_RELATIVE_MOUSE) )
+            ) {
                 SetCursor( NULL );
             } else {
-                SetCursor( global_win32_cursors[cursor] );
+                SetCursor( win32_cursor( cursor ) );
             }
         } return TRUE;
         case WM_ACTIVATE: {
+            if( !surface ) {
+                break;
+            }
             if( LOWORD( wparam ) ) {
                 activated = true;
             } else {
                 activated = false;
             }
+
+            struct Win32SurfaceRegistry* registry = &global_win32_state->surfaces;
+            AcquireSRWLockExclusive( &registry->lock );
+            if( activated ) {
+                registry->focused = surface;
+            } else if( registry->focused == surface ) {
+                registry->focused = NULL;
+            }
+            ReleaseSRWLockExclusive( &registry->lock );
+
             if( activated == ((surface->state & SURFACE_STATE_IS_FOCUSED) != 0)) {
                 return 0;
             }
@@ -415,6 +1322,96 @@ LRESULT win32_winproc( HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam ) {
             } else {
                 surface->state &= ~SURFACE_STATE_IS_FOCUSED;
             }
+            win32_surface_exclusive_focus( surface, activated );
+            win32_surface_relative_mouse_focus( surface, activated );
+        } break;
+        case WM_SIZE: {
+            if( !surface ) {
+                break;
+            }
+            _Bool is_minimized = wparam == SIZE_MINIMIZED;
+            if( is_minimized == ((surface->state & SURFACE_STATE_IS_MINIMIZED) != 0) ) {
+                break;
+            }
+            if( is_minimized ) {
+                surface->state |= SURFACE_STATE_IS_MINIMIZED;
+            } else {
+                surface->state &= ~SURFACE_STATE_IS_MINIMIZED;
+            }
+            is_minimized_changed = true;
+        } break;
+        case WM_WTSSESSION_CHANGE: {
+            if( wparam == WTS_SESSION_LOCK || wparam == WTS_SESSION_UNLOCK ) {
+                global_win32_state->is_session_locked = wparam == WTS_SESSION_LOCK;
+                win32_surface_update_occlusion_all();
+            }
+        } return 0;
+        case WM_POWERBROADCAST: {
+            if( wparam != PBT_POWERSETTINGCHANGE ) {
+                break;
+            }
+            POWERBROADCAST_SETTING* setting = (POWERBROADCAST_SETTING*)lparam;
+            if(
+                memcmp(
+                    &setting->PowerSetting, &global_win32_guid_console_display_state,
+                    sizeof(GUID) ) == 0 &&
+                setting->DataLength >= sizeof(DWORD)
+            ) {
+                // NOTE(alicia): 0 is off, 1 is on and 2 is dimmed.
+                DWORD display_state = 0;
+                memcpy( &display_state, setting->Data, sizeof(display_state) );
+                global_win32_state->is_display_off = display_state == 0;
+                win32_surface_update_occlusion_all();
+            }
+        } return TRUE;
+        case WM_DISPLAYCHANGE:
+        case WM_DPICHANGED: {
+            display_invalidate();
+        } break;
+        case WM_SETTINGCHANGE: {
+            if( wparam == SPI_SETWORKAREA ) {
+                display_invalidate();
+            }
+        } break;
+        case WM_WINDOWPOSCHANGED: {
+            if(
+                surface && (surface->state & SURFACE_STATE_RELATIVE_MOUSE) &&
+                (surface->state & SURFACE_STATE_IS_FOCUSED)
+            ) {
+                win32_surface_clip_cursor( surface );
+            }
+        } break;
+        case WM_INPUTLANGCHANGE: {
+            if( global_win32_input ) {
+                win32_input_layout_rebuild( (HKL)lparam );
+            }
+        } break;
+        // NOTE(alicia): contacts are recorded for polling
+        // even if surface has no callback. Always forward to DefWindowProc
+        // so that touch and pen still generate mouse messages.
+        case WM_POINTERDOWN:
+        case WM_POINTERUPDATE:
+        case WM_POINTERUP:
+        case WM_POINTERLEAVE:
+        case WM_POINTERCAPTURECHANGED: {
+            if( global_win32_input ) {
+                win32_input_pointer_message( msg, wparam );
+            }
+        } break;
+        case WM_IME_SETCONTEXT: {
+            if( surface && (surface->state & SURFACE_STATE_INLINE_COMPOSITION) ) {
+                lparam &= ~ISC_SHOWUICOMPOSITIONWINDOW;
+            }
+        } break;
+        case WM_ENTERSIZEMOVE: {
+            if( surface ) {
+                surface->is_in_size_move = true;
+            }
+        } break;
+        case WM_EXITSIZEMOVE: {
+            if( surface ) {
+                surface->is_in_size_move = false;
+            }
         } break;
         default: break;
     }
@@ -433,74 +1430,130 @@ LRESULT win32_winproc( HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam ) {
             data.focus.gained = activated;
             cb();
         } return 0;
+        case WM_SIZE: {
+            if( is_minimized_changed ) {
+                data.type = SURFACE_CALLBACK_TYPE_MINIMIZE;
+                data.minimize.is_minimized =
+                    (surface->state & SURFACE_STATE_IS_MINIMIZED) != 0;
+                cb();
+            }
+        } return 0;
         case WM_CHAR: {
             if( wparam == UNICODE_NOCHAR ) {
                 return TRUE;
             }
 
-            data.type = SURFACE_CALLBACK_TYPE_TEXT;
-            WideCharToMultiByte(
-                CP_UTF8, 0, (LPWSTR)&wparam, sizeof(wparam),
-                data.text.utf8, sizeof(data.text.utf8), 0, 0 );
-
-            if( data.text.utf8[0] == '\r' ) {
-                memset( data.text.utf8, 0, sizeof(data.text.utf8) );
-                data.text.utf8[0] = '\n';
+            // NOTE(alicia): characters outside of the BMP arrive as
+            // two WM_CHAR messages, one for each half of surrogate pair.
+            uint16_t units[2];
+            uint32_t unit_count = 0;
+            uint16_t unit       = (uint16_t)wparam;
+            if( unit >= 0xD800 && unit <= 0xDBFF ) {
+                surface->text_high_surrogate = unit;
+                return FALSE;
+            }
+            if( surface->text_high_surrogate ) {
+                if( unit >= 0xDC00 && unit <= 0xDFFF ) {
+                    units[unit_count++] = surface->text_high_surrogate;
+                }
+                surface->text_high_surrogate = 0;
             }
+            units[unit_count++] = unit;
 
-            cb();
+            win32_surface_commit_text( surface, unit_count, units );
         } return FALSE;
+        case WM_IME_STARTCOMPOSITION: {
+            win32_surface_apply_text_rect( surface );
+            // NOTE(alicia): platform composition window is not shown.
+            if( surface->state & SURFACE_STATE_INLINE_COMPOSITION ) {
+                return 0;
+            }
+        } break;
+        case WM_IME_COMPOSITION: {
+            if( lparam & GCS_COMPSTR ) {
+                win32_surface_send_composition( surface, false );
+            }
+            // NOTE(alicia): result is committed here when inline,
+            // otherwise DefWindowProc sends it as WM_CHAR messages.
+            if(
+                (surface->state & SURFACE_STATE_INLINE_COMPOSITION) &&
+                ImmGetContext
+            ) {
+                if( lparam & GCS_RESULTSTR ) {
+                    HIMC himc = ImmGetContext( hwnd );
+                    if( himc ) {
+                        uint16_t ucs2[WIN32_SURFACE_COMPOSITION_UCS2_CAP];
+                        LONG size = ImmGetCompositionStringW(
+                            himc, GCS_RESULTSTR, NULL, 0 );
+                        if( size > (LONG)sizeof(ucs2) ) {
+                            size = sizeof(ucs2);
+                        }
+                        if( size > 0 ) {
+                            size = ImmGetCompositionStringW(
+                                himc, GCS_RESULTSTR, ucs2, size );
+                        }
+                        ImmReleaseContext( hwnd, himc );
+                        if( size > 0 ) {
+                            win32_surface_commit_text(
+                                surface, (uint32_t)size / sizeof(uint16_t), ucs2 );
+                        }
+                    }
+                }
+                return 0;
+            }
+        } break;
+        case WM_IME_ENDCOMPOSITION: {
+            win32_surface_send_composition( surface, true );
+        } break;
         case WM_WINDOWPOSCHANGED: {
             WINDOWPOS* pos = (WINDOWPOS*)lparam;
             _Bool no_size = pos->flags & SWP_NOSIZE;
             _Bool no_move = pos->flags & SWP_NOMOVE;
-            
-            if( !no_move ) {
-                int32_t old_x = surface->x;
-                int32_t old_y = surface->y;
-                int32_t x     = pos->x;
-                int32_t y     = pos->y;
-
-                surface->x = x;
-                surface->y = y;
-
-                if( !(old_x == x && old_y == y) ) {
-                    data.type = SURFACE_CALLBACK_TYPE_POSITION;
-                    data.position.x = x;
-                    data.position.y = y;
-                    data.position.old_x = old_x;
-                    data.position.old_y = old_y;
 
-                    cb();
-
-                    memset( &data, 0, sizeof(data) );
+            // NOTE(alicia): dragging a surface sends this for every
+            // intermediate position, callbacks are coalesced and sent
+            // once at the end of surface_pump_events().
+            if( !no_move ) {
+                if( !(surface->pending & WIN32_SURFACE_PENDING_MOVE) ) {
+                    surface->pending_old_x = surface->x;
+                    surface->pending_old_y = surface->y;
                 }
+                surface->x = pos->x;
+                surface->y = pos->y;
+                win32_surface_mark_pending( surface, WIN32_SURFACE_PENDING_MOVE );
             }
 
             if( !no_size ) {
-                int32_t old_w = surface->w;
-                int32_t old_h = surface->h;
-
                 RECT client;
                 memset( &client, 0, sizeof(client) );
                 if( GetClientRect( surface->hwnd, &client ) ) {
-                    int32_t w = client.right  < 1 ? 1 : client.right;
-                    int32_t h = client.bottom < 1 ? 1 : client.bottom;
-
+                    int32_t old_w = surface->w;
+                    int32_t old_h = surface->h;
+                    int32_t w     = client.right  < 1 ? 1 : client.right;
+                    int32_t h     = client.bottom < 1 ? 1 : client.bottom;
+
+                    if( !(surface->pending & WIN32_SURFACE_PENDING_RESIZE) ) {
+                        surface->pending_old_w = old_w;
+                        surface->pending_old_h = old_h;
+                    }
                     surface->w = w;
                     surface->h = h;
-
-                    if( !(old_w == w && old_h == h ) ) {
-                        data.type = SURFACE_CALLBACK_TYPE_RESIZE;
+                    win32_surface_mark_pending( surface, WIN32_SURFACE_PENDING_RESIZE );
+
+                    if(
+                        surface->is_in_size_move &&
+                        (surface->create_flags & SURFACE_CREATE_FLAG_LIVE_RESIZE) &&
+                        !(old_w == w && old_h == h)
+                    ) {
+                        data.type = SURFACE_CALLBACK_TYPE_LIVE_RESIZE;
                         data.resize.old_w = old_w;
                         data.resize.old_h = old_h;
                         data.resize.w     = w;
                         data.resize.h     = h;
 
                         cb();
-
-                        // TODO(alicia): lock mouse cursor
                     }
+                    // TODO(alicia): lock mouse cursor
                 }
             }
         } return 0;
@@ -513,10 +1566,11 @@ LRESULT win32_winproc( HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam ) {
             case WM_CUSTOM_KEYBOARD: {
                 struct Win32KeyWParam w = win32_key_from_wparam( wparam );
 
-                data.type        = SURFACE_CALLBACK_TYPE_KEY;
-                data.key.code    = w.keycode;
-                data.key.is_down = w.is_down;
-                data.key.mod     = global_win32_state->mod;
+                data.type         = SURFACE_CALLBACK_TYPE_KEY;
+                data.key.code     = w.keycode;
+                data.key.scancode = w.scancode;
+                data.key.is_down  = w.is_down;
+                data.key.mod      = global_win32_state->mod;
 
                 cb();
             } return 0;
@@ -595,21 +1649,25 @@ LRESULT win32_winproc( HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam ) {
                 if( prev ) {
                     return DefWindowProcW( hwnd, msg, wparam, lparam );
                 }
-                WORD vk      = LOWORD(wparam);
-                WORD vk_orig = vk;
+                WORD vk_orig = LOWORD(wparam);
                 WORD flags   = HIWORD(lparam);
-                WORD scan    = LOBYTE(flags);
 
-                if( (flags & KF_EXTENDED) == KF_EXTENDED ) {
-                    scan = MAKEWORD(scan, 0xE0);
-                }
+                // NOTE(alicia): pause shares its scancode with numlock.
+                KeyboardScancode scancode = vk_orig == VK_PAUSE ?
+                    KB_PAUSE : scan_to_keyboard_scancode(
+                        LOBYTE(flags), (flags & KF_EXTENDED) == KF_EXTENDED );
+                KeyboardCode code = vk_to_keyboard_code( vk_orig );
 
-                switch( vk ) {
+                switch( vk_orig ) {
                     case VK_SHIFT:
                     case VK_CONTROL:
                     case VK_MENU: {
-                        vk = LOWORD( MapVirtualKeyW(
-                            scan, MAPVK_VSC_TO_VK_EX ));
+                        // NOTE(alicia): numpad keys send fake shifts
+                        // with E0 prefix while numlock is on, skip them.
+                        if( !scancode ) {
+                            return DefWindowProcW( hwnd, msg, wparam, lparam );
+                        }
+                        code = scancode;
                     } break;
                     default: break;
                 }
@@ -664,10 +1722,11 @@ LRESULT win32_winproc( HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam ) {
                     }
                 }
 
-                data.type        = SURFACE_CALLBACK_TYPE_KEY;
-                data.key.code    = vk_to_keyboard_code( vk );
-                data.key.is_down = is_down;
-                data.key.mod     = global_win32_state->mod;
+                data.type         = SURFACE_CALLBACK_TYPE_KEY;
+                data.key.code     = code;
+                data.key.scancode = scancode;
+                data.key.is_down  = is_down;
+                data.key.mod      = global_win32_state->mod;
 
                 cb();
             } return TRUE;
@@ -15,6 +15,13 @@
 #define WIN32_SURFACE_TITLE_UCS2_CAP (SURFACE_MAX_TITLE_LEN + 1)
 #define WIN32_SURFACE_TITLE_SIZE (sizeof(wchar_t) * WIN32_SURFACE_TITLE_UCS2_CAP)
 
+#define WIN32_SURFACE_PENDING_MOVE   (1 << 0)
+#define WIN32_SURFACE_PENDING_RESIZE (1 << 1)
+#define WIN32_SURFACE_PENDING_TEXT   (1 << 2)
+
+// NOTE(alicia): longer compositions are truncated.
+#define WIN32_SURFACE_COMPOSITION_UCS2_CAP (256)
+
 struct Win32Surface {
     HWND hwnd;
     HDC  hdc;
@@ -30,6 +37,41 @@ struct Win32Surface {
     SurfaceCallbackFN* callback;
     void* callback_params;
 
+    uint16_t text_high_surrogate;
+
+    // NOTE(alicia): committed text since last pump, see surface_set_text_buffer.
+    char*    text_buffer;
+    uint32_t text_cap;
+    uint32_t text_len;
+    _Bool    is_text_truncated;
+
+    // NOTE(alicia): text composition area, bottom to top like mouse position.
+    _Bool   has_text_rect;
+    int32_t text_rect_x, text_rect_y, text_rect_w, text_rect_h;
+
+    // NOTE(alicia): generation << 16 | slot index + 1, 0 if not in registry.
+    uint32_t registry_handle;
+    // NOTE(alicia): thread that created window, only it receives
+    // messages of this surface.
+    DWORD thread_id;
+
+    // NOTE(alicia): move/resize since last pump, see win32_surface_flush_pending.
+    struct Win32Surface* pending_next;
+    int32_t pending_old_x, pending_old_y;
+    int32_t pending_old_w, pending_old_h;
+    uint8_t pending;
+    _Bool   is_in_size_move;
+
+    // NOTE(alicia): display power notifications drive SURFACE_STATE_IS_OCCLUDED.
+    HPOWERNOTIFY power_notify;
+    _Bool        is_cloaked;
+
+    // NOTE(alicia): exclusive fullscreen mode and display it applies to,
+    // mode is only applied while surface is focused.
+    _Bool    is_exclusive_applied;
+    wchar_t  exclusive_device[CCHDEVICENAME];
+    DEVMODEW exclusive_mode;
+
     uint8_t title_len;
     union {
         wchar_t title_ucs2[WIN32_SURFACE_TITLE_UCS2_CAP];
@@ -37,5 +79,16 @@ struct Win32Surface {
     };
 };
 
+/// @brief Add surface to surface registry.
+/// @return False if registry is full, surface is then found with GWLP_USERDATA.
+_Bool win32_surface_register( struct Win32Surface* surface );
+/// @brief Remove surface from surface registry.
+void win32_surface_unregister( struct Win32Surface* surface );
+/// @brief Find surface that owns window.
+/// @return NULL if window is not a surface.
+struct Win32Surface* win32_surface_from_hwnd( HWND hwnd );
+/// @brief Send coalesced move/resize callbacks of surfaces of calling thread.
+void win32_surface_flush_pending(void);
+
 #endif /* Platform Windows */
 #endif /* header guard */
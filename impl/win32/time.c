@@ -0,0 +1,111 @@
+/**
+ * @file   time.c
+ * @brief  Media Windows Time.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 19, 2024
+*/
+#include "media/defines.h"
+#if defined(MEDIA_PLATFORM_WINDOWS)
+#include "media/time.h"
+#include "impl/win32/common.h"
+
+#if !defined(CREATE_WAITABLE_TIMER_HIGH_RESOLUTION)
+    #define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION (0x00000002)
+#endif
+
+// NOTE(alicia): smallest amount of time left to spin after timer wakes up.
+#define WIN32_SLEEP_MIN_SPIN_NS (200000ULL)
+
+attr_global LARGE_INTEGER global_win32_qpf = {0};
+
+uint64_t win32_qpc_to_ns( uint64_t qpc ) {
+    if( !global_win32_qpf.QuadPart ) {
+        QueryPerformanceFrequency( &global_win32_qpf );
+    }
+
+    uint64_t frequency = (uint64_t)global_win32_qpf.QuadPart;
+    uint64_t seconds   = qpc / frequency;
+    uint64_t remainder = qpc % frequency;
+    return (seconds * MEDIA_TIME_NS_PER_SECOND) +
+        ((remainder * MEDIA_TIME_NS_PER_SECOND) / frequency);
+}
+attr_media_api uint64_t media_time_ns(void) {
+    LARGE_INTEGER qpc;
+    QueryPerformanceCounter( &qpc );
+    return win32_qpc_to_ns( (uint64_t)qpc.QuadPart );
+}
+attr_internal HANDLE win32_thread_sleep_timer( struct Win32ThreadState* thread ) {
+    if( thread->sleep_timer == INVALID_HANDLE_VALUE ) {
+        return NULL;
+    }
+    if( thread->sleep_timer ) {
+        return thread->sleep_timer;
+    }
+
+    thread->sleep_timer = CreateWaitableTimerExW(
+        NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS );
+    if( !thread->sleep_timer ) {
+        // NOTE(alicia): high resolution timers require Windows 10 1803.
+        thread->sleep_timer = CreateWaitableTimerExW(
+            NULL, NULL, 0, TIMER_ALL_ACCESS );
+        thread->sleep_slack_ns = 2 * MEDIA_TIME_NS_PER_MS;
+    }
+    if( !thread->sleep_timer ) {
+        win32_error_message( GetLastError(), "failed to create sleep timer!" );
+        // NOTE(alicia): don't try again, sleeps only spin on this thread.
+        thread->sleep_timer = INVALID_HANDLE_VALUE;
+        return NULL;
+    }
+    return thread->sleep_timer;
+}
+HANDLE win32_sleep_timer(void) {
+    struct Win32ThreadState* thread = win32_thread_state();
+    if( !thread ) {
+        return NULL;
+    }
+    return win32_thread_sleep_timer( thread );
+}
+attr_media_api uint64_t media_time_sleep_until_ns( uint64_t deadline_ns ) {
+    uint64_t now = media_time_ns();
+    if( now >= deadline_ns ) {
+        return now;
+    }
+
+    // NOTE(alicia): without thread state, sleep only spins.
+    struct Win32ThreadState* thread = win32_thread_state();
+    HANDLE timer = thread ? win32_thread_sleep_timer( thread ) : NULL;
+
+    uint64_t slack = thread ? thread->sleep_slack_ns : 0;
+    if( slack < WIN32_SLEEP_MIN_SPIN_NS ) {
+        slack = WIN32_SLEEP_MIN_SPIN_NS;
+    }
+
+    if( timer && deadline_ns - now > slack ) {
+        uint64_t wake_ns = deadline_ns - slack;
+
+        LARGE_INTEGER due;
+        // NOTE(alicia): negative due time is relative, in 100ns units.
+        due.QuadPart = -(LONGLONG)((wake_ns - now) / 100);
+        if( SetWaitableTimerEx( timer, &due, 0, NULL, NULL, NULL, 0 ) ) {
+            WaitForSingleObject( timer, INFINITE );
+
+            // NOTE(alicia): adapt slack to how late timer actually wakes up,
+            // grows immediately and shrinks slowly.
+            now = media_time_ns();
+            uint64_t late = now > wake_ns ? now - wake_ns : 0;
+            if( late > thread->sleep_slack_ns ) {
+                thread->sleep_slack_ns = late;
+            } else {
+                thread->sleep_slack_ns -= (thread->sleep_slack_ns - late) / 8;
+            }
+        }
+    }
+
+    while( (now = media_time_ns()) < deadline_ns ) {
+        YieldProcessor();
+    }
+    return now;
+}
+
+#undef WIN32_SLEEP_MIN_SPIN_NS
+#endif /* Platform Windows */
@@ -0,0 +1,114 @@
+/**
+ * @file   vulkan.c
+ * @brief  Windows Vulkan.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 12, 2024
+*/
+#include "media/defines.h"
+
+#if defined(MEDIA_PLATFORM_WINDOWS)
+#include "media/vulkan.h"
+#include "impl/win32/common.h"
+#include "impl/win32/surface.h"
+
+#define VK_SUCCESS (0)
+#define VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR (1000009000)
+
+struct Win32VkWin32SurfaceCreateInfoKHR {
+    int32_t     sType;
+    const void* pNext;
+    uint32_t    flags;
+    HINSTANCE   hinstance;
+    HWND        hwnd;
+};
+
+typedef int32_t vkCreateWin32SurfaceKHRFN(
+    void* instance, const struct Win32VkWin32SurfaceCreateInfoKHR* pCreateInfo,
+    const void* pAllocator, void* pSurface );
+
+attr_global VulkanGetInstanceProcAddrFN* global_win32_vkGetInstanceProcAddr = NULL;
+
+attr_global const char* const global_win32_vulkan_extensions[] = {
+    "VK_KHR_surface",
+    "VK_KHR_win32_surface",
+};
+
+attr_media_api const char* const* vulkan_query_instance_extensions(
+    uint32_t* out_count
+) {
+    *out_count =
+        sizeof(global_win32_vulkan_extensions) /
+        sizeof(global_win32_vulkan_extensions[0]);
+    return global_win32_vulkan_extensions;
+}
+attr_media_api VulkanGetInstanceProcAddrFN* vulkan_query_instance_proc_addr(void) {
+    if( global_win32_vkGetInstanceProcAddr ) {
+        return global_win32_vkGetInstanceProcAddr;
+    }
+
+    if( !global_win32_state->modules.VULKAN ) {
+        global_win32_state->modules.VULKAN = LoadLibraryA( "VULKAN-1.DLL" );
+        if( !global_win32_state->modules.VULKAN ) {
+            win32_error_message( GetLastError(),
+                "vulkan_query_instance_proc_addr: failed to open library VULKAN-1.DLL!" );
+            return NULL;
+        }
+    }
+
+    global_win32_vkGetInstanceProcAddr =
+        (VulkanGetInstanceProcAddrFN*)GetProcAddress(
+            global_win32_state->modules.VULKAN, "vkGetInstanceProcAddr" );
+    if( !global_win32_vkGetInstanceProcAddr ) {
+        win32_error(
+            "vulkan_query_instance_proc_addr: "
+            "failed to load vkGetInstanceProcAddr from VULKAN-1!" );
+        return NULL;
+    }
+
+    return global_win32_vkGetInstanceProcAddr;
+}
+attr_media_api _Bool vulkan_surface_create(
+    SurfaceHandle* in_surface, void* instance,
+    const void* opt_allocator, void* out_vk_surface
+) {
+    struct Win32Surface* surface = in_surface;
+    if( !(surface->create_flags & SURFACE_CREATE_FLAG_VULKAN) ) {
+        win32_warn(
+            "vulkan_surface_create: "
+            "surface was not created with SURFACE_CREATE_FLAG_VULKAN!" );
+    }
+
+    VulkanGetInstanceProcAddrFN* get_proc = vulkan_query_instance_proc_addr();
+    if( !get_proc ) {
+        return false;
+    }
+
+    vkCreateWin32SurfaceKHRFN* vkCreateWin32SurfaceKHR =
+        (vkCreateWin32SurfaceKHRFN*)get_proc( instance, "vkCreateWin32SurfaceKHR" );
+    if( !vkCreateWin32SurfaceKHR ) {
+        win32_error(
+            "vulkan_surface_create: failed to load vkCreateWin32SurfaceKHR! "
+            "was instance created with VK_KHR_win32_surface?" );
+        return false;
+    }
+
+    struct Win32VkWin32SurfaceCreateInfoKHR info;
+    memset( &info, 0, sizeof(info) );
+    info.sType     = VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR;
+    info.hinstance = GetModuleHandleW(0);
+    info.hwnd      = surface->hwnd;
+
+    int32_t res = vkCreateWin32SurfaceKHR(
+        instance, &info, opt_allocator, out_vk_surface );
+    if( res != VK_SUCCESS ) {
+        win32_error( "vulkan_surface_create: failed to create Vulkan surface!" );
+        return false;
+    }
+
+    return true;
+}
+
+#undef VK_SUCCESS
+#undef VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR
+
+#endif /* Platform Windows */
@@ -0,0 +1,140 @@
+#if !defined(MEDIA_ALLOCATOR_H)
+#define MEDIA_ALLOCATOR_H
+/**
+ * @file   allocator.h
+ * @brief  Allocator interface used for library-owned memory.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 14, 2024
+*/
+#include "media/defines.h"
+#include "media/types.h"
+
+/// @brief Default alignment used by media library allocations.
+#define MEDIA_ALLOCATOR_DEFAULT_ALIGNMENT (16)
+
+/// @brief Function prototype for allocator allocate function.
+/// @param     size      Size of allocation in bytes.
+/// @param     alignment Alignment of allocation. Always a power of two.
+/// @param[in] params    Allocator parameters.
+/// @return Pointer to zeroed memory or NULL if allocation failed.
+typedef void* MediaAllocFN( uintptr_t size, uintptr_t alignment, void* params );
+/// @brief Function prototype for allocator free function.
+/// @param[in] memory Pointer to memory returned by allocate function.
+/// @param     size   Size of allocation in bytes.
+/// @param[in] params Allocator parameters.
+typedef void MediaFreeFN( void* memory, uintptr_t size, void* params );
+
+/// @brief Allocator interface.
+typedef struct MediaAllocator {
+    /// @brief Allocate function.
+    MediaAllocFN* alloc;
+    /// @brief Free function.
+    MediaFreeFN*  free;
+    /// @brief Allocator parameters.
+    void* params;
+} MediaAllocator;
+
+/// @brief Linear allocator.
+/// @details
+/// Memory is pushed onto the end of the arena and only the most recent
+/// allocation can be freed. Use media_arena_reset() to free everything at once.
+typedef struct MediaArena {
+    /// @brief Pointer to start of arena buffer.
+    uint8_t*  buffer;
+    /// @brief Size of arena buffer in bytes.
+    uintptr_t cap;
+    /// @brief Bytes currently in use.
+    uintptr_t offset;
+    /// @brief Highest value @c offset has reached.
+    uintptr_t peak;
+} MediaArena;
+
+/// @brief Media library memory usage statistics.
+typedef struct MediaMemoryStats {
+    /// @brief Number of allocations that went to the allocator set with
+    /// media_lib_set_allocator() or to the system heap.
+    uint64_t  heap_alloc_count;
+    /// @brief Number of allocations that were served by scratch arena.
+    uint64_t  scratch_alloc_count;
+    /// @brief Bytes currently allocated outside of scratch arena.
+    uintptr_t heap_bytes;
+    /// @brief Peak bytes allocated outside of scratch arena.
+    uintptr_t heap_bytes_peak;
+    /// @brief Peak bytes used in scratch arena.
+    uintptr_t scratch_bytes_peak;
+} MediaMemoryStats;
+
+/// @brief Create an arena from a buffer.
+/// @param[in] buffer Pointer to start of buffer.
+/// @param     size   Size of buffer in bytes.
+/// @return Arena.
+attr_header MediaArena media_arena_from_buffer( void* buffer, uintptr_t size ) {
+    MediaArena arena;
+    arena.buffer = (uint8_t*)buffer;
+    arena.cap    = size;
+    arena.offset = 0;
+    arena.peak   = 0;
+    return arena;
+}
+/// @brief Push memory onto arena.
+/// @param[in] arena     Arena to push onto.
+/// @param     size      Size of allocation in bytes.
+/// @param     alignment Alignment of allocation. Must be a power of two.
+/// @return Pointer to zeroed memory or NULL if arena does not have enough space.
+/// @note Each push uses @c sizeof(uintptr_t) bytes in front of allocation
+/// to remember previous offset, on top of alignment padding.
+attr_media_api void* media_arena_push(
+    MediaArena* arena, uintptr_t size, uintptr_t alignment );
+/// @brief Pop memory from arena.
+/// @details
+/// Does nothing if @c memory is not the most recent allocation.
+/// Alignment padding in front of allocation is freed with it.
+/// @param[in] arena  Arena to pop from.
+/// @param[in] memory Pointer returned by media_arena_push().
+/// @param     size   Size of allocation in bytes.
+attr_media_api void media_arena_pop( MediaArena* arena, void* memory, uintptr_t size );
+/// @brief Free everything in arena.
+/// @param[in] arena Arena to reset.
+attr_header void media_arena_reset( MediaArena* arena ) {
+    arena->offset = 0;
+}
+/// @brief Create an allocator interface for arena.
+/// @param[in] arena Arena to allocate from. Must outlive allocator.
+/// @return Allocator.
+attr_media_api MediaAllocator media_arena_allocator( MediaArena* arena );
+
+/// @brief Set allocator used for library-owned memory.
+/// @details
+/// Allocations that do not fit in scratch arena go through this allocator.
+/// By default, library uses the system heap.
+/// Allocator is called from any thread that uses the library so it must be thread safe.
+/// @note This function is not thread safe.
+/// @warning Do not change allocator while library memory is allocated!
+/// @param[in] opt_allocator (optional) Allocator. NULL resets to system heap.
+attr_media_api void media_lib_set_allocator( const MediaAllocator* opt_allocator );
+/// @brief Set scratch arena used for transient allocations.
+/// @details
+/// Transient allocations (text conversions, prompts, error messages)
+/// are served from scratch arena first. With a large enough scratch arena,
+/// media library makes no heap allocations on that thread.
+/// @note This function is not thread safe.
+/// Scratch arena belongs to the thread that calls this function,
+/// library functions called from other threads allocate from heap.
+/// @param[in] opt_buffer (optional) Pointer to scratch buffer. NULL disables scratch arena.
+/// @param     size       Size of scratch buffer in bytes.
+attr_media_api void media_lib_set_scratch( void* opt_buffer, uintptr_t size );
+/// @brief Free everything in scratch arena.
+/// @details
+/// Meant to be called once per frame by thread that owns scratch arena,
+/// while no library function is running on it.
+/// Does nothing when called from any other thread.
+attr_media_api void media_lib_reset_scratch(void);
+/// @brief Query library memory usage statistics.
+/// @param[out] out_stats Pointer to write statistics to.
+attr_media_api void media_lib_query_memory_stats( MediaMemoryStats* out_stats );
+/// @brief Reset library memory usage statistics.
+/// @details
+/// Counters and peaks are reset, current heap usage is kept.
+attr_media_api void media_lib_reset_memory_stats(void);
+
+#endif /* header guard */
@@ -13,6 +13,8 @@
 #define AUDIO_DEVICE_NAME_CAP (260)
 /// @brief Device index for picking system default audio device.
 #define AUDIO_DEVICE_DEFAULT  (0xFFFFFFFF)
+/// @brief Timeout for audio_device_wait() that never expires.
+#define AUDIO_DEVICE_WAIT_INFINITE (0xFFFFFFFF)
 
 /// @brief Structure defining an audio buffer's format.
 struct AudioBufferFormat {
@@ -40,6 +42,31 @@ struct AudioBuffer {
     /// @brief Pointer to start of locked audio buffer.
     void* start;
 };
+/// @brief Audio device timing and health statistics.
+/// @details Position and padding are in frames (one sample per channel).
+struct AudioDeviceStats {
+    /// @brief Number of frames device has played since it was started.
+    uint64_t position;
+    /// @brief Monotonic time in nanoseconds @c position was sampled at,
+    /// comparable with media_time_ns().
+    uint64_t position_time_ns;
+    /// @brief Latency of audio stream reported by device in nanoseconds.
+    uint64_t stream_latency_ns;
+    /// @brief Estimated latency from writing a frame to hearing it in nanoseconds.
+    /// @details Stream latency plus time it takes to play current padding.
+    uint64_t latency_ns;
+    /// @brief Frames written to buffer that have not been played yet.
+    uint32_t padding;
+    /// @brief Highest @c padding observed when locking buffer.
+    uint32_t padding_high_water;
+    /// @brief Number of times buffer ran empty while device was playing.
+    uint32_t underrun_count;
+    /// @brief Number of times buffer was full when trying to lock it.
+    uint32_t overrun_count;
+    /// @brief Number of times stream moved to a new default device.
+    /// @see #AUDIO_DEVICE_OPEN_FLAG_FOLLOW_DEFAULT
+    uint32_t migration_count;
+};
 /// @brief Opaque pointer to audio device list.
 typedef void AudioDeviceList;
 /// @brief Opaque pointer to an audio device handle.
@@ -53,6 +80,54 @@ enum AudioDeviceType {
 };
 /// @brief Opaque pointer to an audio input/output device.
 typedef void AudioDevice;
+/// @brief Audio device list change events.
+typedef enum AudioDeviceListEvent {
+    /// @brief Device became available.
+    AUDIO_DEVICE_LIST_EVENT_ADDED,
+    /// @brief Device was unplugged or disabled.
+    AUDIO_DEVICE_LIST_EVENT_REMOVED,
+    /// @brief System default device changed.
+    AUDIO_DEVICE_LIST_EVENT_DEFAULT_CHANGED,
+} AudioDeviceListEvent;
+/// @brief Function for receiving audio device list changes.
+/// @warning Called from a thread owned by the system, not from
+/// the thread that registered it. It should do as little as possible,
+/// such as setting a flag to call audio_device_list_refresh() later.
+/// @param     event   Type of change.
+/// @param     type    Type of device that changed.
+/// @param[in] params  (optional) User parameters.
+typedef void AudioDeviceListCallbackFN(
+    AudioDeviceListEvent event, enum AudioDeviceType type, void* params );
+/// @brief Flags for opening an audio device.
+typedef enum AudioDeviceOpenFlags {
+    /// @brief Request smallest buffer period audio engine supports
+    /// while still sharing device with other applications.
+    /// @details
+    /// @c buffer_length_ms is ignored when device supports it,
+    /// otherwise device is opened normally.
+    /// Implies #AUDIO_DEVICE_OPEN_FLAG_EVENT_DRIVEN.
+    /// @note Only output devices opened with mix format
+    /// (no @c opt_format) are guaranteed to support this.
+    AUDIO_DEVICE_OPEN_FLAG_LOW_LATENCY  = (1 << 0),
+    /// @brief Open device for exclusive use with smallest buffer period device supports.
+    /// @details
+    /// @c buffer_length_ms is ignored.
+    /// Device must natively support requested format, no conversion takes place.
+    /// Every lock returns whole buffer so it must be refilled
+    /// each time audio_device_wait() returns.
+    /// Implies #AUDIO_DEVICE_OPEN_FLAG_EVENT_DRIVEN.
+    AUDIO_DEVICE_OPEN_FLAG_EXCLUSIVE    = (1 << 1),
+    /// @brief Device signals audio_device_wait() when it needs more data.
+    AUDIO_DEVICE_OPEN_FLAG_EVENT_DRIVEN = (1 << 2),
+    /// @brief Move stream to new system default device when it changes
+    /// or when current device is unplugged.
+    /// @details
+    /// Requires #AUDIO_DEVICE_DEFAULT.
+    /// Migration happens inside audio_device_buffer_lock(),
+    /// format stays the same and playback resumes after a short gap.
+    /// Buffer sample count may change, see audio_device_query_format().
+    AUDIO_DEVICE_OPEN_FLAG_FOLLOW_DEFAULT = (1 << 3),
+} AudioDeviceOpenFlags;
 
 /// @brief Query memory requirement for retrieving a list of available devices.
 /// @return Bytes required to store device list.
@@ -83,6 +158,25 @@ attr_media_api _Bool audio_device_list_query_name(
     AudioDeviceList* list,
     enum AudioDeviceType type, uint32_t index,
     char out_name[AUDIO_DEVICE_NAME_CAP], uint32_t* out_name_len );
+/// @brief Enumerate devices again, updating counts and names.
+/// @details
+/// Device indices from before refresh are no longer valid.
+/// Devices already opened are not affected.
+/// @param[in] list Pointer to an audio device list.
+/// @return
+///     - true  : Refreshed device list.
+///     - false : Failed to enumerate devices, list is empty.
+attr_media_api _Bool audio_device_list_refresh( AudioDeviceList* list );
+/// @brief Set function that receives audio device changes.
+/// @param[in] list                Pointer to an audio device list.
+/// @param[in] callback            Callback function, NULL to stop receiving changes.
+/// @param[in] opt_callback_params (optional) Parameters for callback function.
+/// @return
+///     - true  : Callback was set.
+///     - false : Platform failed to register for notifications.
+attr_media_api _Bool audio_device_list_set_callback(
+    AudioDeviceList* list,
+    AudioDeviceListCallbackFN* callback, void* opt_callback_params );
 /// @brief Destroy audio device list object.
 /// @param[in] list Pointer to audio device list to destroy. 
 /// Its memory can be freed after calling this function.
@@ -97,6 +191,7 @@ attr_media_api uintptr_t audio_device_query_memory_requirement(void);
 /// @param         buffer_length_ms Length of audio device buffer in milliseconds.
 /// @param         type             Type of audio device to open.
 /// @param         device_index     Index of device to open or #AUDIO_DEVICE_DEFAULT.
+/// @param         flags            Flags for opening device.
 /// @param[in,out] in_out_device    Pointer to store audio device.
 /// Must be able to hold result of audio_device_query_memory_requirement().
 /// @return
@@ -105,7 +200,7 @@ attr_media_api uintptr_t audio_device_query_memory_requirement(void);
 attr_media_api _Bool audio_device_open(
     AudioDeviceList* list, struct AudioBufferFormat* opt_format,
     uint32_t buffer_length_ms, enum AudioDeviceType type,
-    uint32_t device_index, AudioDevice* out_device );
+    uint32_t device_index, AudioDeviceOpenFlags flags, AudioDevice* out_device );
 /// @brief Close audio device.
 /// @param[in] device Pointer to audio device to close.
 attr_media_api void audio_device_close( AudioDevice* device );
@@ -114,6 +209,21 @@ attr_media_api void audio_device_close( AudioDevice* device );
 /// @param[out] out_format Pointer to write out audio device format.
 attr_media_api void audio_device_query_format(
     AudioDevice* device, struct AudioBufferFormat* out_format );
+/// @brief Query audio device timing and health statistics.
+/// @details
+/// Padding high water mark and underrun/overrun counters are accumulated
+/// by audio_device_buffer_lock() since device was opened or
+/// audio_device_reset_stats() was last called.
+/// @param[in]  device    Pointer to audio device.
+/// @param[out] out_stats Pointer to write statistics to.
+/// @return
+///     - true  : Queried statistics successfully.
+///     - false : Failed to query device position or latency.
+attr_media_api _Bool audio_device_query_stats(
+    AudioDevice* device, struct AudioDeviceStats* out_stats );
+/// @brief Reset audio device padding high water mark and underrun/overrun counters.
+/// @param[in] device Pointer to audio device.
+attr_media_api void audio_device_reset_stats( AudioDevice* device );
 /// @brief Start playing audio device's buffer.
 /// @param[in] device Pointer to audio device to start playing.
 /// @return
@@ -123,6 +233,18 @@ attr_media_api _Bool audio_device_start( AudioDevice* device );
 /// @brief Stop playing audio device.
 /// @param[in] device Pointer to audio device to stop.
 attr_media_api void audio_device_stop( AudioDevice* device );
+/// @brief Wait for audio device to request more data.
+/// @details
+/// Device must be opened with #AUDIO_DEVICE_OPEN_FLAG_EVENT_DRIVEN,
+/// #AUDIO_DEVICE_OPEN_FLAG_LOW_LATENCY or #AUDIO_DEVICE_OPEN_FLAG_EXCLUSIVE.
+/// Intended to be called from a dedicated audio thread
+/// followed by audio_device_buffer_lock().
+/// @param[in] device     Pointer to audio device.
+/// @param     timeout_ms Milliseconds to wait for or #AUDIO_DEVICE_WAIT_INFINITE.
+/// @return
+///     - true  : Device requested more data.
+///     - false : Timed out or device is not event driven.
+attr_media_api _Bool audio_device_wait( AudioDevice* device, uint32_t timeout_ms );
 /// @brief Lock audio device's buffer.
 /// @param[in]  device     Device to lock.
 /// @param[out] out_buffer Pointer to write information about portion of buffer locked.
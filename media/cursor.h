@@ -52,6 +52,8 @@ typedef enum CursorType : uint32_t {
 /// @param cursor Shape to set cursor to.
 attr_media_api void cursor_type_set( SurfaceHandle* surface, CursorType cursor );
 /// @brief Center cursor within surface client area.
+/// @note For mouse look, use surface_set_relative_mouse() instead
+/// of centering cursor every frame.
 /// @param[in] surface Surface to center in.
 attr_media_api void cursor_center( SurfaceHandle* surface );
 /// @brief Show/hide cursor.
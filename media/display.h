@@ -0,0 +1,135 @@
+#if !defined(MEDIA_DISPLAY_H)
+#define MEDIA_DISPLAY_H
+/**
+ * @file   display.h
+ * @brief  Display enumeration and display modes.
+ * @details
+ * Display information is cached by library and rebuilt lazily
+ * the first time it is queried after display configuration changes.
+ * Changes are detected through messages sent to surfaces so cache is
+ * only invalidated automatically while at least one surface exists,
+ * call display_invalidate() to force a rebuild otherwise.
+ *
+ * All functions are safe to call from any thread.
+ *
+ * Display indices are only valid until display configuration changes,
+ * compare results of display_query_generation() to detect this.
+ *
+ * @note On Windows, positions, dimensions and DPI are only reported
+ * per-monitor if process is per-monitor DPI aware.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 21, 2024
+*/
+#include "media/defines.h" // IWYU pragma: keep
+#include "media/types.h"
+#include "media/surface.h"
+
+/// @brief Maximum number of displays reported.
+#define DISPLAY_MAX_COUNT (16)
+/// @brief Capacity of display name, including null terminator.
+#define DISPLAY_NAME_CAP  (64)
+/// @brief Invalid display index.
+#define DISPLAY_INVALID   (0xFFFFFFFF)
+/// @brief DPI at which display scale is 1.
+#define DISPLAY_DEFAULT_DPI (96)
+
+/// @brief Refresh rate in hertz as a fraction.
+/// @details
+/// For example, NTSC rate of 59.94 Hz is reported as 60000 / 1001.
+/// Zero numerator means rate is unknown (hardware default).
+struct DisplayRefreshRate {
+    /// @brief Numerator.
+    uint32_t numerator;
+    /// @brief Denominator, never zero.
+    uint32_t denominator;
+};
+/// @brief Display mode.
+struct DisplayMode {
+    /// @brief Width in pixels.
+    int32_t w;
+    /// @brief Height in pixels.
+    int32_t h;
+    /// @brief Color depth.
+    uint32_t bits_per_pixel;
+    /// @brief Refresh rate.
+    /// @note On Windows, only current mode reports exact fractional rate,
+    /// other modes report whole hertz unless they match current rate.
+    struct DisplayRefreshRate refresh_rate;
+};
+/// @brief Display information.
+struct DisplayInfo {
+    /// @brief Length of @c name.
+    uint32_t name_len;
+    /// @brief Human readable name of display (UTF-8, null terminated).
+    char     name[DISPLAY_NAME_CAP];
+    /// @brief Position of display on virtual desktop.
+    int32_t x, y;
+    /// @brief Dimensions of display on virtual desktop.
+    int32_t w, h;
+    /// @brief Position of work area (display minus taskbar and docked bars).
+    int32_t work_x, work_y;
+    /// @brief Dimensions of work area.
+    int32_t work_w, work_h;
+    /// @brief Effective dots per inch.
+    uint32_t dpi;
+    /// @brief Content scale, @c dpi / #DISPLAY_DEFAULT_DPI.
+    float    scale;
+    /// @brief True if this is primary display.
+    _Bool    is_primary;
+    /// @brief Number of available modes, see display_query_modes().
+    uint32_t mode_count;
+    /// @brief Current display mode.
+    struct DisplayMode mode;
+};
+
+/// @brief Convert refresh rate to hertz.
+/// @param[in] rate Refresh rate.
+/// @return Refresh rate in hertz or zero if unknown.
+attr_header double display_refresh_rate_hz( const struct DisplayRefreshRate* rate ) {
+    if( !rate->denominator ) {
+        return 0.0;
+    }
+    return (double)rate->numerator / (double)rate->denominator;
+}
+
+/// @brief Query number of connected displays.
+/// @return Number of displays, at most #DISPLAY_MAX_COUNT.
+attr_media_api uint32_t display_query_count(void);
+/// @brief Query index of primary display.
+/// @return Index of primary display or #DISPLAY_INVALID if there are no displays.
+attr_media_api uint32_t display_query_primary(void);
+/// @brief Query index of display that surface is on.
+/// @details
+/// If surface spans multiple displays, returns display that
+/// has the largest area of intersection with surface.
+/// @param[in] surface Surface.
+/// @return Index of display or #DISPLAY_INVALID if there are no displays.
+attr_media_api uint32_t display_from_surface( const SurfaceHandle* surface );
+/// @brief Query display information.
+/// @param      display  Index of display.
+/// @param[out] out_info Pointer to write information to.
+/// @return
+///     - true  : Display exists.
+///     - false : Index is out of bounds.
+attr_media_api _Bool display_query_info( uint32_t display, struct DisplayInfo* out_info );
+/// @brief Query available modes of a display.
+/// @details
+/// Modes are sorted by width, height, refresh rate and
+/// color depth, largest first.
+/// @param      display       Index of display.
+/// @param      cap           Capacity of @c opt_out_modes.
+/// @param[out] opt_out_modes (optional) Pointer to write up to @c cap modes to.
+/// @return Total number of modes available, zero if index is out of bounds.
+attr_media_api uint32_t display_query_modes(
+    uint32_t display, uint32_t cap, struct DisplayMode* opt_out_modes );
+/// @brief Query display configuration generation.
+/// @details
+/// Generation changes every time display information is rebuilt.
+/// Cheap enough to call every frame.
+/// @return Generation.
+attr_media_api uint32_t display_query_generation(void);
+/// @brief Invalidate cached display information.
+/// @details Information is rebuilt next time it is queried.
+attr_media_api void display_invalidate(void);
+
+#endif /* header guard */
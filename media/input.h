@@ -11,6 +11,9 @@
 #include "media/input/gamepad.h"
 #include "media/input/keyboard.h"
 #include "media/input/mouse.h"
+#include "media/input/pointer.h"
+#include "media/input/action.h"
+#include "media/input/gamepad_processor.h"
 // IWYU pragma: end_exports
 
 /// @brief Query how much memory is required for input subsystem.
@@ -32,6 +35,19 @@ attr_media_api void input_subsystem_update(void);
 /// @brief Shutdown input subsystem.
 /// @note Does not free input subsystem buffer.
 attr_media_api void input_subsystem_shutdown(void);
+/// @brief Set action map that is evaluated at end of every input_subsystem_update().
+/// @details
+/// Map is evaluated against keyboard, mouse and gamepad state
+/// so that actions can be queried with input_action_query_state()
+/// and input_action_query_value() without building a snapshot.
+/// @param[in] opt_map (optional) Compiled action map, NULL to stop evaluating.
+attr_media_api void input_subsystem_set_action_map( InputActionMap* opt_map );
+/// @brief Set gamepad processor that is updated in every input_subsystem_update().
+/// @details
+/// Processor runs before action map is evaluated, processed state
+/// can be queried with gamepad_processor_query_state().
+/// @param[in] opt_processor (optional) Gamepad processor, NULL to stop processing.
+attr_media_api void input_subsystem_set_gamepad_processor( GamepadProcessor* opt_processor );
 
 /// @brief Query key modifiers.
 /// @return Bitfield of key modifiers.
@@ -45,6 +61,25 @@ attr_media_api _Bool input_keyboard_query_key( KeyboardCode keycode );
 /// @brief Copy entire state of keyboard to buffer.
 /// @param[out] out_keyboard Array to copy state of keyboard to.
 attr_media_api void input_keyboard_copy_state( KeyboardState* out_state );
+/// @brief Query state of key at given physical location.
+/// @param scancode Scancode of key to query.
+/// @return
+///     - true  : Key is being pressed.
+///     - false : Key is not being pressed.
+attr_media_api _Bool input_keyboard_query_scancode( KeyboardScancode scancode );
+/// @brief Copy entire state of keyboard by physical location to buffer.
+/// @details Use keyboard_state_get_key() with scancodes to read result.
+/// @param[out] out_state Array to copy state of keyboard to.
+attr_media_api void input_keyboard_copy_scancode_state( KeyboardState* out_state );
+/// @brief Translate physical key location to key code in current keyboard layout.
+/// @details Translation is cached and only rebuilt when keyboard layout changes.
+/// @param scancode Scancode to translate.
+/// @return Key code of key at that location.
+attr_media_api KeyboardCode input_keyboard_scancode_to_code( KeyboardScancode scancode );
+/// @brief Translate key code in current keyboard layout to physical key location.
+/// @param code Key code to translate.
+/// @return Scancode of key or #KB_UNKNOWN if layout has no such key.
+attr_media_api KeyboardScancode input_keyboard_code_to_scancode( KeyboardCode code );
 
 /// @brief Query state of mouse buttons.
 /// @return Bitfield of mouse buttons.
@@ -63,10 +98,35 @@ attr_media_api void input_mouse_query_position( int32_t* out_x, int32_t* out_y )
 attr_media_api void input_mouse_position_to_client(
     SurfaceHandle* surface, int32_t* in_out_x, int32_t* in_out_y );
 /// @brief Query mouse delta.
+/// @details
+/// Sum of raw, unaccelerated mouse motion received during
+/// last input_subsystem_update(), in device units (mickeys).
+/// Includes every sample, so motion faster than frame rate is not lost.
 /// @param[out] out_x Pointer to write out x delta.
 /// @param[out] out_y Pointer to write out y delta.
 attr_media_api void input_mouse_query_delta( int32_t* out_x, int32_t* out_y );
 
+/// @brief Query touch and pen contacts.
+/// @details
+/// Latest sample of every contact as of last surface_pump_events().
+/// Contacts that were released since last input_subsystem_update()
+/// are included once with #POINTER_STATE_RELEASED.
+/// @param      cap          Capacity of @c opt_out_samples.
+/// @param[out] opt_out_samples (optional) Pointer to write up to @c cap contacts to.
+/// @return Number of contacts, at most #POINTER_MAX_CONTACTS.
+attr_media_api uint32_t input_pointer_query_contacts(
+    uint32_t cap, PointerSample* opt_out_samples );
+/// @brief Query every touch and pen sample received since last input_subsystem_update().
+/// @details
+/// Samples are in order they were generated by device, including samples
+/// that platform coalesced between messages, so pen strokes can be
+/// reconstructed at full device rate without a callback per sample.
+/// @param      cap          Capacity of @c opt_out_samples.
+/// @param[out] opt_out_samples (optional) Pointer to write up to @c cap samples to.
+/// @return Number of samples, at most #POINTER_HISTORY_CAP.
+attr_media_api uint32_t input_pointer_query_history(
+    uint32_t cap, PointerSample* opt_out_samples );
+
 /// @brief Query state of gamepad at given index.
 /// @param      index     Index of gamepad to query. Valid range is 0..#GAMEPAD_MAX_COUNT.
 /// @param[out] out_state Pointer to write state of gamepad to.
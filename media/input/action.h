@@ -0,0 +1,168 @@
+#if !defined(MEDIA_INPUT_ACTION_H)
+#define MEDIA_INPUT_ACTION_H
+/**
+ * @file   action.h
+ * @brief  Input action mapping.
+ * @details
+ * Actions are named by index (for example, ACTION_JUMP = 0) and
+ * are bound to any number of keys, mouse buttons, gamepad buttons
+ * and gamepad axes. Bindings are compiled into flat bitmask and
+ * axis tables once, evaluating an action map only visits inputs
+ * that are down and updates 64 actions at a time, so cost does not
+ * grow with number of bindings.
+ *
+ * Every action reports digital state (held, pressed, released) and
+ * an analog value in range -1..1. Digital bindings move value towards
+ * 1 or -1 (for example, D and A on the same horizontal action), axis
+ * bindings add axis value past their deadzone.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 22, 2024
+*/
+#include "media/defines.h" // IWYU pragma: keep
+#include "media/types.h"
+#include "media/input/keyboard.h"
+#include "media/input/mouse.h"
+#include "media/input/gamepad.h"
+
+/// @brief Maximum number of actions in an action map.
+#define INPUT_ACTION_MAX_COUNT (0xFFFF)
+/// @brief Bind to every gamepad instead of a specific one.
+#define INPUT_BINDING_ANY_GAMEPAD (0xFF)
+
+/// @brief Opaque pointer to compiled action map.
+typedef void InputActionMap;
+
+/// @brief Type of input an action is bound to.
+typedef enum InputBindingType : uint8_t {
+    /// @brief Key by key code, see #KeyboardCode.
+    INPUT_BINDING_TYPE_KEY,
+    /// @brief Key by physical location, see #KeyboardScancode.
+    INPUT_BINDING_TYPE_SCANCODE,
+    /// @brief Mouse buttons, see #MouseButton.
+    INPUT_BINDING_TYPE_MOUSE_BUTTON,
+    /// @brief Gamepad buttons, see #GamepadButton.
+    INPUT_BINDING_TYPE_GAMEPAD_BUTTON,
+    /// @brief Gamepad stick or trigger axis.
+    INPUT_BINDING_TYPE_GAMEPAD_AXIS,
+} InputBindingType;
+/// @brief Gamepad axes.
+typedef enum InputGamepadAxis : uint8_t {
+    /// @brief Left stick X-axis, positive is right.
+    INPUT_GAMEPAD_AXIS_STICK_LEFT_X,
+    /// @brief Left stick Y-axis, positive is up.
+    INPUT_GAMEPAD_AXIS_STICK_LEFT_Y,
+    /// @brief Right stick X-axis, positive is right.
+    INPUT_GAMEPAD_AXIS_STICK_RIGHT_X,
+    /// @brief Right stick Y-axis, positive is up.
+    INPUT_GAMEPAD_AXIS_STICK_RIGHT_Y,
+    /// @brief Left trigger, never negative.
+    INPUT_GAMEPAD_AXIS_TRIGGER_LEFT,
+    /// @brief Right trigger, never negative.
+    INPUT_GAMEPAD_AXIS_TRIGGER_RIGHT,
+
+    /// @brief Number of gamepad axes.
+    INPUT_GAMEPAD_AXIS_COUNT,
+} InputGamepadAxis;
+/// @brief Action state bitfield.
+typedef enum InputActionState : uint8_t {
+    /// @brief Any binding of action is active.
+    INPUT_ACTION_STATE_HELD     = (1 << 0),
+    /// @brief Action became held in last evaluation.
+    INPUT_ACTION_STATE_PRESSED  = (1 << 1),
+    /// @brief Action stopped being held in last evaluation.
+    INPUT_ACTION_STATE_RELEASED = (1 << 2),
+} InputActionState;
+
+/// @brief Binding of an input to an action.
+typedef struct InputBinding {
+    /// @brief Index of action.
+    uint16_t         action;
+    /// @brief Type of input.
+    InputBindingType type;
+    /// @brief Index of gamepad or #INPUT_BINDING_ANY_GAMEPAD.
+    /// @details Only used by gamepad bindings.
+    uint8_t          gamepad;
+    /// @brief Move action value towards -1 instead of 1.
+    /// @details
+    /// For axis bindings, binding is active when axis is past deadzone
+    /// in negative direction and contributes negated axis value.
+    _Bool            is_negative;
+    /// @brief Input, discriminated by @c type.
+    union {
+        /// @brief Key code or scancode.
+        KeyboardCode key;
+        /// @brief Bitfield of mouse buttons, any of them activates binding.
+        MouseButton  mouse;
+        /// @brief Bitfield of gamepad buttons, any of them activates binding.
+        GamepadButton gamepad_button;
+        /// @brief Gamepad axis.
+        struct {
+            /// @brief Axis.
+            InputGamepadAxis axis;
+            /// @brief Deadzone in range 0..1.
+            /// @details Value is rescaled so that it starts at 0 past deadzone.
+            float deadzone;
+        } gamepad_axis;
+    };
+} InputBinding;
+
+/// @brief Snapshot of input state that action map is evaluated against.
+typedef struct InputSnapshot {
+    /// @brief Keys by key code.
+    KeyboardState keys;
+    /// @brief Keys by physical location.
+    KeyboardState scancodes;
+    /// @brief Mouse buttons.
+    MouseButton   mouse;
+    /// @brief Bitfield of connected gamepads.
+    /// @details Disconnected gamepads are treated as released and centered.
+    uint8_t       gamepad_connected;
+    /// @brief Gamepad states.
+    GamepadState  gamepads[GAMEPAD_MAX_COUNT];
+} InputSnapshot;
+
+/// @brief Query memory requirement for action map.
+/// @details
+/// Memory grows with action count times number of distinct
+/// digital inputs that are bound.
+/// @param     action_count  Number of actions.
+/// @param     binding_count Number of bindings.
+/// @param[in] bindings      Bindings that will be compiled.
+/// @return Bytes required for action map or zero if a binding is invalid.
+attr_media_api uintptr_t input_action_map_query_memory_requirement(
+    uint32_t action_count, uint32_t binding_count, const InputBinding* bindings );
+/// @brief Compile bindings into action map.
+/// @param     action_count  Number of actions.
+/// Must be between 1 and #INPUT_ACTION_MAX_COUNT.
+/// @param     binding_count Number of bindings.
+/// @param[in] bindings      Bindings, not referenced after compiling.
+/// @param[in,out] in_out_map Pointer to buffer for action map, must be 16 byte aligned.
+/// Must be able to hold result of input_action_map_query_memory_requirement().
+/// @return
+///     - true  : Compiled action map, every action starts released.
+///     - false : A binding is invalid.
+attr_media_api _Bool input_action_map_compile(
+    uint32_t action_count, uint32_t binding_count,
+    const InputBinding* bindings, InputActionMap* in_out_map );
+/// @brief Evaluate every action in action map against input snapshot.
+/// @details
+/// Updates held, pressed and released states and values.
+/// Called automatically for map set with input_subsystem_set_action_map().
+/// @param[in] map      Action map.
+/// @param[in] snapshot Input state.
+attr_media_api void input_action_map_evaluate(
+    InputActionMap* map, const InputSnapshot* snapshot );
+/// @brief Query state of action.
+/// @param[in] map    Action map.
+/// @param     action Index of action.
+/// @return Bitfield of action state, zero if action is out of bounds.
+attr_media_api InputActionState input_action_query_state(
+    const InputActionMap* map, uint32_t action );
+/// @brief Query value of action.
+/// @param[in] map    Action map.
+/// @param     action Index of action.
+/// @return Value in range -1..1, zero if action is out of bounds.
+attr_media_api float input_action_query_value(
+    const InputActionMap* map, uint32_t action );
+
+#endif /* header guard */
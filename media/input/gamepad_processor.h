@@ -0,0 +1,122 @@
+#if !defined(MEDIA_INPUT_GAMEPAD_PROCESSOR_H)
+#define MEDIA_INPUT_GAMEPAD_PROCESSOR_H
+/**
+ * @file   gamepad_processor.h
+ * @brief  Gamepad deadzones, response curves and smoothing.
+ * @details
+ * Converts raw gamepad state into normalized floats.
+ * Every gamepad is processed at the same time,
+ * one gamepad per SIMD lane:
+ *   - optional one-euro smoothing of raw axes.
+ *   - radial or axial deadzone for sticks,
+ *     inner and outer deadzone for triggers.
+ *   - response curve lookup table for sticks and triggers.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 22, 2024
+*/
+#include "media/defines.h" // IWYU pragma: keep
+#include "media/types.h"
+#include "media/input/gamepad.h"
+
+/// @brief Maximum number of points in a response curve.
+#define GAMEPAD_CURVE_MAX_POINTS (256)
+
+/// @brief Opaque pointer to gamepad processor.
+typedef void GamepadProcessor;
+
+/// @brief Shape of stick deadzone.
+typedef enum GamepadDeadzoneType : uint8_t {
+    /// @brief Deadzone is applied to stick magnitude, keeps stick direction.
+    GAMEPAD_DEADZONE_TYPE_RADIAL,
+    /// @brief Deadzone is applied to each axis separately.
+    /// @details Snaps stick to axes, useful for menus and digital-like input.
+    GAMEPAD_DEADZONE_TYPE_AXIAL,
+} GamepadDeadzoneType;
+
+/// @brief Response curve.
+typedef struct GamepadCurve {
+    /// @brief Number of points, zero for linear response.
+    /// @details Must be between 2 and #GAMEPAD_CURVE_MAX_POINTS otherwise.
+    uint32_t     point_count;
+    /// @brief Output values in range 0..1, evenly spaced over input range 0..1.
+    /// @details Values in between points are linearly interpolated.
+    const float* points;
+} GamepadCurve;
+
+/// @brief Gamepad processor description.
+typedef struct GamepadProcessorDesc {
+    /// @brief Shape of stick deadzone.
+    GamepadDeadzoneType stick_deadzone_type;
+    /// @brief Stick values below this are zero, range 0..1.
+    float stick_deadzone_inner;
+    /// @brief Stick values above this are one, range 0..1.
+    /// @details Zero is treated as one.
+    float stick_deadzone_outer;
+    /// @brief Trigger values below this are zero, range 0..1.
+    float trigger_deadzone_inner;
+    /// @brief Trigger values above this are one, range 0..1.
+    /// @details Zero is treated as one.
+    float trigger_deadzone_outer;
+    /// @brief Response curve applied to stick past deadzone.
+    GamepadCurve stick_curve;
+    /// @brief Response curve applied to trigger past deadzone.
+    GamepadCurve trigger_curve;
+    /// @brief Minimum cutoff frequency of one-euro filter in Hz.
+    /// @details
+    /// Lower values remove more jitter at rest.
+    /// Zero disables smoothing.
+    float smoothing_min_cutoff;
+    /// @brief Speed coefficient of one-euro filter.
+    /// @details Higher values reduce lag when stick moves quickly.
+    float smoothing_beta;
+} GamepadProcessorDesc;
+
+/// @brief Processed gamepad state.
+typedef struct GamepadProcessedState {
+    /// @brief Bitfield of buttons.
+    GamepadButton buttons;
+    /// @brief Left stick, range -1..1, positive is right and up.
+    float stick_left_x, stick_left_y;
+    /// @brief Right stick, range -1..1, positive is right and up.
+    float stick_right_x, stick_right_y;
+    /// @brief Left trigger, range 0..1.
+    float trigger_left;
+    /// @brief Right trigger, range 0..1.
+    float trigger_right;
+} GamepadProcessedState;
+
+/// @brief Query memory requirement for gamepad processor.
+/// @return Bytes required for gamepad processor.
+attr_media_api uintptr_t gamepad_processor_query_memory_requirement(void);
+/// @brief Create gamepad processor.
+/// @param[in]     desc             Description of gamepad processor, not referenced after creation.
+/// @param[in,out] in_out_processor Pointer to buffer for gamepad processor.
+/// Must be able to hold result of gamepad_processor_query_memory_requirement().
+/// @return
+///     - true  : Created gamepad processor.
+///     - false : Description is invalid.
+attr_media_api _Bool gamepad_processor_create(
+    const GamepadProcessorDesc* desc, GamepadProcessor* in_out_processor );
+/// @brief Process state of every gamepad.
+/// @details
+/// Called automatically for processor set with input_subsystem_set_gamepad_processor().
+/// @param[in] processor     Gamepad processor.
+/// @param     connected     Bitfield of connected gamepads.
+/// Disconnected gamepads are centered and their smoothing is reset.
+/// @param[in] states        Raw state of #GAMEPAD_MAX_COUNT gamepads.
+/// @param     delta_seconds Time since last update, zero skips smoothing.
+attr_media_api void gamepad_processor_update(
+    GamepadProcessor* processor, uint8_t connected,
+    const GamepadState* states, float delta_seconds );
+/// @brief Query processed state of gamepad at given index.
+/// @param[in]  processor Gamepad processor.
+/// @param      index     Index of gamepad. Valid range is 0..#GAMEPAD_MAX_COUNT.
+/// @param[out] out_state Pointer to write processed state to.
+/// @return
+///     - true  : Gamepad was connected in last update.
+///     - false : Gamepad was not connected or index is out of bounds.
+attr_media_api _Bool gamepad_processor_query_state(
+    const GamepadProcessor* processor, uint32_t index,
+    GamepadProcessedState* out_state );
+
+#endif /* header guard */
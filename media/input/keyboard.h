@@ -283,6 +283,18 @@ typedef enum KeyboardCode : uint8_t {
     KB_COUNT = 128,
 } KeyboardCode;
 
+/// @brief Physical key location.
+/// @details
+/// Scancodes name keys by their position on a US QWERTY keyboard and
+/// do not change with keyboard layout, they use the same values as
+/// #KeyboardCode of key at that position.
+/// As an example: key left of S is #KB_A on QWERTY and AZERTY,
+/// while its key code is #KB_A on QWERTY and #KB_Q on AZERTY.
+///
+/// Use scancodes for bindings that depend on key placement (WASD)
+/// and key codes for bindings that depend on key label (Ctrl+Z).
+typedef KeyboardCode KeyboardScancode;
+
 /// @brief Packed boolean structure representing all key states.
 typedef struct KeyboardState {
     /// @brief Packed boolean array.
@@ -0,0 +1,70 @@
+#if !defined(MEDIA_INPUT_POINTER_H)
+#define MEDIA_INPUT_POINTER_H
+/**
+ * @file   pointer.h
+ * @brief  Touch and pen input handling.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 22, 2024
+*/
+#include "media/types.h"
+
+/// @brief Maximum number of touch/pen contacts tracked at the same time.
+#define POINTER_MAX_CONTACTS (16)
+/// @brief Maximum number of samples kept between input updates.
+/// @details Samples past this are only reflected in contacts.
+#define POINTER_HISTORY_CAP  (512)
+
+/// @brief Type of pointer device.
+typedef enum PointerType : uint8_t {
+    /// @brief Finger on a touch screen or touch pad.
+    POINTER_TYPE_TOUCH,
+    /// @brief Pen/stylus.
+    POINTER_TYPE_PEN,
+} PointerType;
+
+/// @brief Pointer sample state bitfield.
+typedef enum PointerState : uint8_t {
+    /// @brief Pointer is touching screen.
+    /// @details Pens can hover without touching surface.
+    POINTER_STATE_IN_CONTACT = (1 << 0),
+    /// @brief Pointer is primary pointer (first finger down or pen).
+    POINTER_STATE_PRIMARY    = (1 << 1),
+    /// @brief Pointer was lifted, left detection range or was canceled.
+    /// @details Contact is removed at next input_subsystem_update().
+    POINTER_STATE_RELEASED   = (1 << 2),
+    /// @brief Pointer was canceled by system (for example, palm rejection).
+    /// @details Input since pointer went down should be discarded.
+    POINTER_STATE_CANCELED   = (1 << 3),
+    /// @brief Pen barrel button is pressed.
+    POINTER_STATE_BARREL     = (1 << 4),
+    /// @brief Pen is inverted.
+    POINTER_STATE_INVERTED   = (1 << 5),
+    /// @brief Pen eraser button is pressed.
+    POINTER_STATE_ERASER     = (1 << 6),
+} PointerState;
+
+/// @brief Single touch or pen sample.
+typedef struct PointerSample {
+    /// @brief Identifier of contact, stays the same while contact is tracked.
+    uint32_t     id;
+    /// @brief Type of device.
+    PointerType  type;
+    /// @brief Sample state.
+    PointerState state;
+    /// @brief Absolute position in total monitor space,
+    /// see input_mouse_position_to_client().
+    int32_t x, y;
+    /// @brief Pressure in range 0..1.
+    /// @details 1 if device does not report pressure and pointer is in contact.
+    float pressure;
+    /// @brief Pen tilt in degrees, range -90..90.
+    /// @details Positive X tilts towards right, positive Y towards user.
+    /// Zero if device does not report tilt.
+    float tilt_x, tilt_y;
+    /// @brief Pen rotation or touch orientation in degrees, range 0..359.
+    float rotation;
+    /// @brief Monotonic time of sample in nanoseconds, see media_time_ns().
+    uint64_t time_ns;
+} PointerSample;
+
+#endif /* header guard */
@@ -0,0 +1,28 @@
+#if !defined(MEDIA_INTERNAL_ALLOC_H)
+#define MEDIA_INTERNAL_ALLOC_H
+/**
+ * @file   alloc.h
+ * @brief  Internal allocation functions.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 14, 2024
+*/
+#include "media/defines.h"
+#include "media/types.h"
+
+/// @brief Allocate transient memory.
+/// @details
+/// Tries scratch arena first (only on thread that owns it),
+/// then user allocator and then system heap.
+/// Safe to call from any thread.
+/// Returned memory is zeroed and aligned to #MEDIA_ALLOCATOR_DEFAULT_ALIGNMENT.
+/// Transient allocations must be freed in reverse order of allocation.
+void* media_alloc( uintptr_t size );
+/// @brief Free memory from media_alloc().
+void media_free( void* memory, uintptr_t size );
+
+/// @brief Platform heap allocation. Defined by platform layer.
+void* media_heap_alloc( uintptr_t size );
+/// @brief Platform heap free. Defined by platform layer.
+void media_heap_free( void* memory, uintptr_t size );
+
+#endif /* header guard */
@@ -3,6 +3,20 @@
 /**
  * @file   logging.h
  * @brief  Internal logging functions.
+ * @details
+ * media_warn_fmt()/media_error_fmt() capture a format string and up to
+ * MEDIA_LOG_ARG_CAP raw 64-bit arguments. Formatting only happens when a
+ * message is delivered to the logging callback, either immediately or
+ * when media_lib_flush_logging() drains deferred messages.
+ *
+ * Format strings must be string literals.
+ * Placeholders consume arguments in order:
+ *   - %u : unsigned decimal.
+ *   - %i : signed decimal.
+ *   - %x : hexadecimal.
+ *   - %s : null-terminated string with static lifetime.
+ *   - %e : platform error code description.
+ *   - %% : percent sign.
  * @author Alicia Amarilla (smushyaa@gmail.com)
  * @date   March 13, 2024
 */
@@ -10,7 +24,20 @@
 #include "media/types.h"
 #include "media/lib.h"
 
+/// @brief Maximum number of arguments for formatted log messages.
+#define MEDIA_LOG_ARG_CAP (4)
+
+/// @brief Log message without formatting.
 void media_log( enum MediaLoggingLevel level, uint32_t len, const char* message );
+/// @brief Log format string with raw arguments.
+void media_log_args(
+    enum MediaLoggingLevel level, uint32_t format_len, const char* format,
+    uint32_t argc, const uint64_t* args );
+
+/// @brief Write description of platform error code.
+/// Defined by platform layer.
+/// @return Number of bytes written.
+uint32_t media_log_platform_error_text( uint64_t code, uint32_t cap, char* buffer );
 
 #if defined(MEDIA_ENABLE_LOGGING)
 
@@ -19,10 +46,25 @@ void media_log( enum MediaLoggingLevel level, uint32_t len, const char* message
 #define media_error( message )\
     media_log( MEDIA_LOGGING_LEVEL_ERROR, sizeof(message) - 1, message )
 
+// NOTE(alicia): fixed size compound literal turns
+// too many arguments into a compile time diagnostic.
+#define media_log_fmt( level, format, ... )\
+    media_log_args(\
+        level, sizeof(format) - 1, format,\
+        sizeof((uint64_t[]){ __VA_ARGS__ }) / sizeof(uint64_t),\
+        (uint64_t[MEDIA_LOG_ARG_CAP]){ __VA_ARGS__ } )
+
+#define media_warn_fmt( format, ... )\
+    media_log_fmt( MEDIA_LOGGING_LEVEL_WARN, format, __VA_ARGS__ )
+#define media_error_fmt( format, ... )\
+    media_log_fmt( MEDIA_LOGGING_LEVEL_ERROR, format, __VA_ARGS__ )
+
 #else
 
 #define media_warn(...) unused(__VA_ARGS__)
 #define media_error(...) unused(__VA_ARGS__)
+#define media_warn_fmt(...) unused(__VA_ARGS__)
+#define media_error_fmt(...) unused(__VA_ARGS__)
 
 #endif
 
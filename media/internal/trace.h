@@ -0,0 +1,75 @@
+#if !defined(MEDIA_INTERNAL_TRACE_H)
+#define MEDIA_INTERNAL_TRACE_H
+/**
+ * @file   trace.h
+ * @brief  Internal trace scopes.
+ * @details
+ * media_trace_scope( name ) records a scope from the point it is declared
+ * until the enclosing block exits, including early returns.
+ * Compiles to nothing unless MEDIA_ENABLE_TRACE is defined.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 17, 2024
+*/
+#include "media/defines.h"
+#include "media/types.h"
+#include "media/time.h"
+
+#if !defined(MEDIA_TRACE_THREAD_CAP)
+    /// @brief Maximum number of threads that can record scopes.
+    #define MEDIA_TRACE_THREAD_CAP (16)
+#endif
+#if MEDIA_TRACE_THREAD_CAP > 64
+    #error "MEDIA_TRACE_THREAD_CAP must be 64 or less!"
+#endif
+#if !defined(MEDIA_TRACE_EVENT_CAP)
+    /// @brief Number of scopes kept per thread. Must be a power of two.
+    #define MEDIA_TRACE_EVENT_CAP (4096)
+#endif
+
+/// @brief Platform thread id. Defined by platform layer.
+uint32_t media_trace_platform_thread_id(void);
+/// @brief Trace ring of calling thread, NULL if it has none. Defined by platform layer.
+void* media_trace_platform_ring(void);
+/// @brief Store trace ring of calling thread. Defined by platform layer.
+/// @details Platform layer calls media_trace_ring_release() with it when thread exits.
+/// @return False if ring could not be stored.
+_Bool media_trace_platform_set_ring( void* ring );
+
+#if defined(MEDIA_ENABLE_TRACE)
+
+#define media_trace_timestamp() media_time_ticks()
+
+struct MediaTraceScope {
+    const char* name;
+    uint64_t    start;
+};
+
+/// @brief Record a complete scope.
+void media_trace_record( const char* name, uint64_t start, uint64_t end );
+/// @brief Return trace ring of exited thread so another thread can reuse it.
+void media_trace_ring_release( void* ring );
+
+attr_header attr_always_inline
+struct MediaTraceScope media_trace_scope_begin( const char* name ) {
+    struct MediaTraceScope scope;
+    scope.name  = name;
+    scope.start = media_trace_timestamp();
+    return scope;
+}
+attr_header attr_always_inline
+void media_trace_scope_end( struct MediaTraceScope* scope ) {
+    media_trace_record( scope->name, scope->start, media_trace_timestamp() );
+}
+
+#define media_trace_scope( name )\
+    struct MediaTraceScope media_trace_scope_current\
+        __attribute__((__cleanup__(media_trace_scope_end))) =\
+        media_trace_scope_begin( name )
+
+#else /* MEDIA_ENABLE_TRACE */
+
+#define media_trace_scope( name )
+
+#endif /* MEDIA_ENABLE_TRACE */
+
+#endif /* header guard */
@@ -0,0 +1,87 @@
+#if !defined(MEDIA_INTERNAL_UNICODE_H)
+#define MEDIA_INTERNAL_UNICODE_H
+/**
+ * @file   unicode.h
+ * @brief  Internal UTF-8, UTF-16 and UTF-32 transcoding.
+ * @details
+ * Conversions never allocate, output goes to a caller provided buffer
+ * (usually stack or media_alloc()). Invalid sequences are replaced
+ * with #MEDIA_UNICODE_REPLACEMENT and code points are never split
+ * when output buffer is too small.
+ *
+ * ASCII runs are converted in blocks with SSE2 or AVX2
+ * when compiler targets them.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 15, 2024
+*/
+#include "media/defines.h"
+#include "media/types.h"
+
+/// @brief Replacement character written in place of invalid sequences.
+#define MEDIA_UNICODE_REPLACEMENT (0xFFFD)
+/// @brief Code point returned by decode functions for invalid sequences.
+#define MEDIA_UNICODE_INVALID     (0xFFFFFFFF)
+
+/// @brief Decode one code point from UTF-8.
+/// @param      len    Length of @c utf8 in bytes. Must be non-zero.
+/// @param[in]  utf8   UTF-8 string.
+/// @param[out] out_cp Decoded code point or #MEDIA_UNICODE_INVALID.
+/// @return Number of bytes consumed. Always at least 1.
+uint32_t media_utf8_decode( uintptr_t len, const char* utf8, uint32_t* out_cp );
+/// @brief Encode one code point as UTF-8.
+/// @details Surrogates and out of range code points encode #MEDIA_UNICODE_REPLACEMENT.
+/// @param      cp  Code point.
+/// @param[out] out Buffer with space for at least 4 bytes.
+/// @return Number of bytes written.
+uint32_t media_utf8_encode( uint32_t cp, char* out );
+/// @brief Decode one code point from UTF-16.
+/// @param      len    Length of @c utf16 in code units. Must be non-zero.
+/// @param[in]  utf16  UTF-16 string.
+/// @param[out] out_cp Decoded code point or #MEDIA_UNICODE_INVALID.
+/// @return Number of code units consumed. Always at least 1.
+uint32_t media_utf16_decode( uintptr_t len, const uint16_t* utf16, uint32_t* out_cp );
+/// @brief Encode one code point as UTF-16.
+/// @details Surrogates and out of range code points encode #MEDIA_UNICODE_REPLACEMENT.
+/// @param      cp  Code point.
+/// @param[out] out Buffer with space for at least 2 code units.
+/// @return Number of code units written.
+uint32_t media_utf16_encode( uint32_t cp, uint16_t* out );
+
+/// @brief Check if UTF-8 string is well formed.
+_Bool media_utf8_validate( uintptr_t len, const char* utf8 );
+
+/// @brief Convert UTF-8 to UTF-16.
+/// @param      len          Length of @c utf8 in bytes.
+/// @param[in]  utf8         UTF-8 string.
+/// @param      cap          Capacity of @c opt_out in code units.
+/// @param[out] opt_out      (optional) Output buffer. NULL to only count.
+/// @param[out] opt_out_read (optional) Number of bytes consumed.
+/// @return Number of code units written or required if @c opt_out is NULL.
+uintptr_t media_utf8_to_utf16(
+    uintptr_t len, const char* utf8,
+    uintptr_t cap, uint16_t* opt_out, uintptr_t* opt_out_read );
+/// @brief Convert UTF-16 to UTF-8.
+/// @param      len          Length of @c utf16 in code units.
+/// @param[in]  utf16        UTF-16 string.
+/// @param      cap          Capacity of @c opt_out in bytes.
+/// @param[out] opt_out      (optional) Output buffer. NULL to only count.
+/// @param[out] opt_out_read (optional) Number of code units consumed.
+/// @return Number of bytes written or required if @c opt_out is NULL.
+uintptr_t media_utf16_to_utf8(
+    uintptr_t len, const uint16_t* utf16,
+    uintptr_t cap, char* opt_out, uintptr_t* opt_out_read );
+/// @brief Convert UTF-8 to UTF-32.
+/// @see media_utf8_to_utf16()
+uintptr_t media_utf8_to_utf32(
+    uintptr_t len, const char* utf8,
+    uintptr_t cap, uint32_t* opt_out, uintptr_t* opt_out_read );
+/// @brief Convert UTF-32 to UTF-8.
+/// @see media_utf16_to_utf8()
+uintptr_t media_utf32_to_utf8(
+    uintptr_t len, const uint32_t* utf32,
+    uintptr_t cap, char* opt_out, uintptr_t* opt_out_read );
+
+/// @brief Length of null-terminated UTF-16 string in code units.
+uintptr_t media_utf16_len( const uint16_t* utf16 );
+
+#endif /* header guard */
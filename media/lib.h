@@ -19,6 +19,28 @@ typedef enum MediaLoggingLevel {
     MEDIA_LOGGING_LEVEL_WARN,
 } MediaLoggingLevel;
 
+/// @brief Subsystems that can be loaded ahead of time with media_lib_preload().
+typedef enum MediaLibPreloadFlags {
+    /// @brief Surface functions and default surface class.
+    MEDIA_LIB_PRELOAD_SURFACE = (1 << 0),
+    /// @brief System cursors.
+    MEDIA_LIB_PRELOAD_CURSOR  = (1 << 1),
+    /// @brief Prompt functions.
+    MEDIA_LIB_PRELOAD_PROMPT  = (1 << 2),
+    /// @brief Audio functions.
+    MEDIA_LIB_PRELOAD_AUDIO   = (1 << 3),
+    /// @brief OpenGL library and functions.
+    /// @details Same as calling opengl_initialize().
+    MEDIA_LIB_PRELOAD_OPENGL  = (1 << 4),
+    /// @brief Preload every subsystem.
+    MEDIA_LIB_PRELOAD_ALL     =
+        MEDIA_LIB_PRELOAD_SURFACE |
+        MEDIA_LIB_PRELOAD_CURSOR  |
+        MEDIA_LIB_PRELOAD_PROMPT  |
+        MEDIA_LIB_PRELOAD_AUDIO   |
+        MEDIA_LIB_PRELOAD_OPENGL,
+} MediaLibPreloadFlags;
+
 /// @brief Function prototype for logging callback.
 /// @param     level   Logging level of message.
 /// @param     len     Length of message string.
@@ -54,6 +76,10 @@ typedef void MediaLoggingCallbackFN(
 /// @return Number of bytes required to initialize media library.
 attr_media_api uintptr_t media_lib_query_memory_requirement(void);
 /// @brief Initialize media library. Must be called before other library functions.
+/// @details
+/// Only initializes library state. System libraries used by each
+/// subsystem are loaded the first time that subsystem is used,
+/// use media_lib_preload() to load them ahead of time.
 /// @param     log_level               Logging level. Only relevant when media library is compiled with logging enabled.
 /// @param[in] opt_log_callback        (optional) Pointer to logging callback function.
 /// @param[in] opt_log_callback_params (optional) Pointer to logging callback user parameters.
@@ -66,6 +92,17 @@ attr_media_api _Bool media_lib_initialize(
     MediaLoggingCallbackFN* opt_log_callback,
     void*                   opt_log_callback_params,
     void*                   buffer );
+/// @brief Load subsystems ahead of their first use.
+/// @details
+/// When @c is_async is true, subsystems are loaded on a background thread
+/// and this function returns immediately. Using a subsystem while it is
+/// being loaded in the background waits for it to finish loading.
+/// @param flags    Bitfield of subsystems to preload.
+/// @param is_async Load subsystems on a background thread.
+/// @return
+///     - true  : Subsystems were loaded or background thread was started.
+///     - false : Failed to load a subsystem or start background thread.
+attr_media_api _Bool media_lib_preload( MediaLibPreloadFlags flags, _Bool is_async );
 /// @brief Shutdown media library.
 /// @details
 /// Buffer passed into media_lib_initialize() can be freed after calling this function.
@@ -93,6 +130,26 @@ attr_media_api MediaLoggingLevel media_lib_query_logging_level(void);
 /// @param[in] params   Pointer to callback user parameters.
 attr_media_api void media_lib_set_logging_callback(
     MediaLoggingCallbackFN* callback, void* params );
+/// @brief Defer formatting of log messages until media_lib_flush_logging().
+/// @details
+/// While deferred, log messages are captured as a format string and raw
+/// arguments into a lock-free ring buffer instead of being formatted
+/// and passed to logging callback on the thread that produced them.
+/// Messages that do not fit in the ring buffer are dropped.
+/// Disabling deferred logging flushes pending messages.
+/// Does nothing if library was compiled without logging support.
+/// @note This function is not thread safe.
+/// @param is_deferred True to defer log messages.
+attr_media_api void media_lib_set_logging_deferred( _Bool is_deferred );
+/// @brief Format deferred log messages and pass them to logging callback.
+/// @details
+/// Can be called from any thread, such as a dedicated logging thread.
+/// Returns immediately if another thread is already flushing.
+/// @return Number of messages passed to logging callback.
+attr_media_api uint32_t media_lib_flush_logging(void);
+/// @brief Query number of deferred log messages dropped because ring buffer was full.
+/// @return Total number of dropped messages.
+attr_media_api uint32_t media_lib_query_logging_dropped(void);
 /// @brief Clear logging callback for media library. Does nothing if library was compiled without logging support.
 /// @note This function is not thread safe.
 attr_header void media_lib_clear_logging_callback(void) {
@@ -0,0 +1,175 @@
+#if !defined(MEDIA_SPATIAL_H)
+#define MEDIA_SPATIAL_H
+/**
+ * @file   spatial.h
+ * @brief  3D positional audio with HRTF convolution.
+ * @details
+ * Spatializer mixes mono emitters (voices) into stereo audio buffers
+ * returned by audio_device_buffer_lock(). Each voice is convolved with
+ * head related impulse response closest to its direction using uniformly
+ * partitioned FFT convolution and is attenuated by distance and pitch shifted
+ * by Doppler effect.
+ *
+ * Library does not ship impulse responses, caller provides an HRTF set
+ * recorded at the same sample rate as the output device.
+ *
+ * Spatializer is not thread safe. Voices should be played and moved
+ * from the same thread that calls audio_spatializer_render()
+ * or under caller's own lock.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 20, 2024
+*/
+#include "media/defines.h" // IWYU pragma: keep
+#include "media/types.h"
+#include "media/audio.h"
+
+/// @brief Number of frames spatializer processes at a time.
+/// @details
+/// Latency added by spatializer is at most this many frames.
+#define AUDIO_SPATIALIZER_BLOCK_SIZE (128)
+/// @brief Invalid voice handle.
+#define AUDIO_SPATIALIZER_VOICE_INVALID (0xFFFFFFFF)
+/// @brief Speed of sound in meters per second.
+#define AUDIO_SPATIALIZER_DEFAULT_SPEED_OF_SOUND (343.3f)
+
+/// @brief Opaque pointer to a spatializer.
+typedef void AudioSpatializer;
+
+/// @brief Head related transfer function set.
+/// @details
+/// Directions are unit vectors in listener space:
+/// +X is right, +Y is up and +Z is forward.
+struct AudioHRTF {
+    /// @brief Number of taps in each impulse response.
+    uint32_t length;
+    /// @brief Number of measured directions.
+    uint32_t direction_count;
+    /// @brief Directions, @c direction_count * 3 floats.
+    const float* directions;
+    /// @brief Impulse responses, @c direction_count * 2 * @c length floats.
+    /// @details Left ear response followed by right ear response for each direction.
+    const float* impulse_responses;
+};
+/// @brief Description of a spatializer.
+struct AudioSpatializerDesc {
+    /// @brief Output sample rate, HRTF must be recorded at this rate.
+    uint32_t samples_per_second;
+    /// @brief Maximum number of voices playing at the same time.
+    /// @details Must be between 1 and 65535.
+    uint32_t voice_cap;
+    /// @brief Speed of sound in world units per second.
+    /// @details Zero selects #AUDIO_SPATIALIZER_DEFAULT_SPEED_OF_SOUND.
+    float    speed_of_sound;
+    /// @brief HRTF set. Spatializer keeps its own copy.
+    struct AudioHRTF hrtf;
+};
+/// @brief Position and orientation of listener.
+struct AudioSpatializerListener {
+    /// @brief World position.
+    float position[3];
+    /// @brief Velocity in world units per second, used for Doppler effect.
+    float velocity[3];
+    /// @brief Direction listener is facing, must be normalized.
+    float forward[3];
+    /// @brief Direction of top of listener's head, must be normalized.
+    float up[3];
+};
+/// @brief Description of a sound played by a voice.
+struct AudioSpatializerSource {
+    /// @brief Mono samples. Must outlive voice.
+    const float* samples;
+    /// @brief Number of samples.
+    uint32_t sample_count;
+    /// @brief Sample rate of @c samples.
+    uint32_t samples_per_second;
+    /// @brief Restart from beginning when end is reached.
+    _Bool loop;
+    /// @brief Volume multiplier.
+    float gain;
+    /// @brief Distance at which attenuation starts.
+    /// @details Zero is treated as 1.
+    float min_distance;
+    /// @brief Distance after which sound no longer gets quieter.
+    /// @details Zero means no limit.
+    float max_distance;
+    /// @brief How quickly sound gets quieter past @c min_distance.
+    /// @details
+    /// Gain at distance d is
+    /// min_distance / (min_distance + rolloff * (d - min_distance)).
+    float rolloff;
+    /// @brief World position.
+    float position[3];
+    /// @brief Velocity in world units per second, used for Doppler effect.
+    float velocity[3];
+};
+
+/// @brief Query memory requirement for spatializer.
+/// @param[in] desc Spatializer description.
+/// @return Bytes required for spatializer.
+attr_media_api uintptr_t audio_spatializer_query_memory_requirement(
+    const struct AudioSpatializerDesc* desc );
+/// @brief Create spatializer.
+/// @details
+/// Transforms every impulse response into frequency domain,
+/// expect this to take a while for large HRTF sets.
+/// @param[in]     desc                   Spatializer description.
+/// @param[in,out] in_out_spatializer     Pointer to buffer for spatializer.
+/// Must be able to hold result of audio_spatializer_query_memory_requirement().
+/// @return
+///     - true  : Created spatializer.
+///     - false : Description is invalid.
+attr_media_api _Bool audio_spatializer_create(
+    const struct AudioSpatializerDesc* desc, AudioSpatializer* in_out_spatializer );
+/// @brief Set listener position, velocity and orientation.
+/// @param[in] spatializer Pointer to spatializer.
+/// @param[in] listener    Listener.
+attr_media_api void audio_spatializer_set_listener(
+    AudioSpatializer* spatializer, const struct AudioSpatializerListener* listener );
+/// @brief Start playing source on a free voice.
+/// @param[in] spatializer Pointer to spatializer.
+/// @param[in] source      Source to play.
+/// @return Voice handle or #AUDIO_SPATIALIZER_VOICE_INVALID if all voices are in use.
+attr_media_api uint32_t audio_spatializer_voice_play(
+    AudioSpatializer* spatializer, const struct AudioSpatializerSource* source );
+/// @brief Move voice.
+/// @details Does nothing if voice finished playing.
+/// @param[in] spatializer Pointer to spatializer.
+/// @param     voice       Voice handle.
+/// @param[in] position    World position.
+/// @param[in] velocity    Velocity in world units per second.
+attr_media_api void audio_spatializer_voice_set_position(
+    AudioSpatializer* spatializer, uint32_t voice,
+    const float position[3], const float velocity[3] );
+/// @brief Stop voice immediately.
+/// @details Does nothing if voice finished playing.
+/// @param[in] spatializer Pointer to spatializer.
+/// @param     voice       Voice handle.
+attr_media_api void audio_spatializer_voice_stop(
+    AudioSpatializer* spatializer, uint32_t voice );
+/// @brief Check if voice is still playing.
+/// @details
+/// Non-looping voices finish once their source and
+/// impulse response tail have played.
+/// @param[in] spatializer Pointer to spatializer.
+/// @param     voice       Voice handle.
+/// @return
+///     - true  : Voice is playing.
+///     - false : Voice finished or was stopped.
+attr_media_api _Bool audio_spatializer_voice_is_playing(
+    AudioSpatializer* spatializer, uint32_t voice );
+/// @brief Render voices and mix them into audio buffer.
+/// @details
+/// Output is added to existing contents of @c buffer,
+/// clear it first if it does not hold other audio.
+/// Left and right ear are written to first two channels,
+/// mono buffers receive their average.
+/// 16 bits per sample is treated as signed integer and
+/// 32 bits per sample as float.
+/// @param[in]     spatializer Pointer to spatializer.
+/// @param[in]     format      Format of buffer, see audio_device_query_format().
+/// @param[in,out] buffer      Buffer to mix into.
+attr_media_api void audio_spatializer_render(
+    AudioSpatializer* spatializer,
+    const struct AudioBufferFormat* format, struct AudioBuffer* buffer );
+
+#endif /* header guard */
@@ -39,6 +39,10 @@ typedef enum SurfaceCreateFlags {
     /// Ignores @c y parameter when this flag is used.
     /// @note Not all platforms have a notion of surface position.
     SURFACE_CREATE_FLAG_Y_CENTERED  = (1 << 7),
+    /// @brief Surface should receive #SURFACE_CALLBACK_TYPE_LIVE_RESIZE
+    /// while user is resizing it.
+    /// @note Not all platforms block while surface is being resized.
+    SURFACE_CREATE_FLAG_LIVE_RESIZE = (1 << 8),
 
 
     /// @brief Surface should be created with OpenGL support.
@@ -73,8 +77,59 @@ typedef enum SurfaceStateFlags {
     SURFACE_STATE_IS_FOCUSED = (1 << 1),
     /// @brief Surface is fullscreen.
     SURFACE_STATE_FULLSCREEN = (1 << 2),
+    /// @brief Surface is exclusive fullscreen and owns mode of its display.
+    /// @details Always set together with #SURFACE_STATE_FULLSCREEN.
+    SURFACE_STATE_FULLSCREEN_EXCLUSIVE = (1 << 3),
+    /// @brief Surface is minimized.
+    SURFACE_STATE_IS_MINIMIZED = (1 << 4),
+    /// @brief Surface is not visible to user even though it is not
+    /// hidden or minimized.
+    /// @details
+    /// On Windows, surface is occluded while it is cloaked by
+    /// desktop window manager (for example, on another virtual desktop),
+    /// while session is locked or while displays are turned off.
+    /// Surfaces covered by other windows are not reported as occluded.
+    SURFACE_STATE_IS_OCCLUDED  = (1 << 5),
+    /// @brief Mouse is in relative mode while surface is focused.
+    /// @see surface_set_relative_mouse()
+    SURFACE_STATE_RELATIVE_MOUSE = (1 << 6),
+    /// @brief Text composition is drawn by application instead of platform.
+    /// @see surface_set_text_composition_inline()
+    SURFACE_STATE_INLINE_COMPOSITION = (1 << 7),
 } SurfaceStateFlags;
 
+/// @brief Hint for how surface contents should be rendered.
+typedef enum SurfaceFrameHint {
+    /// @brief Surface is visible, render normally.
+    SURFACE_FRAME_HINT_RENDER,
+    /// @brief Nothing that is rendered can be seen.
+    /// @details
+    /// Skip rendering and presenting, block in surface_wait_events()
+    /// instead of spinning until state changes.
+    SURFACE_FRAME_HINT_SKIP,
+} SurfaceFrameHint;
+
+struct DisplayMode;
+
+/// @brief Wait forever in surface_wait_events().
+#define SURFACE_WAIT_INFINITE    (0xFFFFFFFFFFFFFFFFULL)
+/// @brief Maximum number of extra handles surface_wait_events() can wait on.
+#define SURFACE_WAIT_MAX_HANDLES (60)
+
+/// @brief Reason surface_wait_events() returned.
+typedef enum SurfaceWaitResult {
+    /// @brief Timeout elapsed without any events.
+    SURFACE_WAIT_RESULT_TIMEOUT,
+    /// @brief Events are ready to be pumped.
+    SURFACE_WAIT_RESULT_EVENTS,
+    /// @brief surface_wake() was called.
+    SURFACE_WAIT_RESULT_WAKE,
+    /// @brief One of the extra handles was signaled.
+    SURFACE_WAIT_RESULT_HANDLE,
+    /// @brief Wait failed or too many handles were provided.
+    SURFACE_WAIT_RESULT_ERROR,
+} SurfaceWaitResult;
+
 /// @brief Types of media surface callbacks.
 typedef enum SurfaceCallbackType {
     /// @brief User is trying to close surface.
@@ -84,9 +139,13 @@ typedef enum SurfaceCallbackType {
     /// @see SurfaceCallbackData::focus
     SURFACE_CALLBACK_TYPE_FOCUS,
     /// @brief Surface's dimensions were updated.
+    /// @details Sent at most once per surface_pump_events(),
+    /// @c old_w and @c old_h are dimensions before pump.
     /// @see SurfaceCallbackData::resize
     SURFACE_CALLBACK_TYPE_RESIZE,
     /// @brief Surface's position has been updated.
+    /// @details Sent at most once per surface_pump_events(),
+    /// @c old_x and @c old_y are position before pump.
     /// @note Not all platforms support moving surfaces.
     /// @see SurfaceCallbackData::position
     SURFACE_CALLBACK_TYPE_POSITION,
@@ -116,10 +175,42 @@ typedef enum SurfaceCallbackType {
     /// @see SurfaceCallbackData::key
     SURFACE_CALLBACK_TYPE_KEY,
     /// @brief Text was typed.
-    /// @details Only the active surface receives this callback.
+    /// @details
+    /// Only the active surface receives this callback.
+    /// Not sent while surface has a text buffer, see surface_set_text_buffer().
     /// @note Not all platforms support keyboard input.
     /// @see SurfaceCallbackData::text
     SURFACE_CALLBACK_TYPE_TEXT,
+    /// @brief Surface's dimensions changed while user is resizing it.
+    /// @details
+    /// Only sent to surfaces created with #SURFACE_CREATE_FLAG_LIVE_RESIZE,
+    /// from inside surface_pump_events() while platform blocks it to resize surface.
+    /// Intended for presenting a frame at the new size,
+    /// #SURFACE_CALLBACK_TYPE_RESIZE is still sent once resizing ends.
+    /// @see SurfaceCallbackData::resize
+    SURFACE_CALLBACK_TYPE_LIVE_RESIZE,
+    /// @brief Surface was minimized or restored.
+    /// @see SurfaceCallbackData::minimize
+    SURFACE_CALLBACK_TYPE_MINIMIZE,
+    /// @brief Surface became occluded or visible again.
+    /// @see #SURFACE_STATE_IS_OCCLUDED
+    /// @see SurfaceCallbackData::occlusion
+    SURFACE_CALLBACK_TYPE_OCCLUSION,
+    /// @brief Text was committed since last surface_pump_events().
+    /// @details
+    /// Sent once at the end of surface_pump_events() instead of
+    /// #SURFACE_CALLBACK_TYPE_TEXT while surface has a text buffer.
+    /// @see surface_set_text_buffer()
+    /// @see SurfaceCallbackData::text_batch
+    SURFACE_CALLBACK_TYPE_TEXT_BATCH,
+    /// @brief Text composition (IME preedit) changed.
+    /// @details
+    /// Composed text is not committed yet, committed text arrives as
+    /// #SURFACE_CALLBACK_TYPE_TEXT or #SURFACE_CALLBACK_TYPE_TEXT_BATCH.
+    /// Empty composition means composition ended or was canceled.
+    /// @see surface_set_text_composition_inline()
+    /// @see SurfaceCallbackData::text_composition
+    SURFACE_CALLBACK_TYPE_TEXT_COMPOSITION,
 } SurfaceCallbackType;
 
 /// @brief Discriminated union of surface callback data.
@@ -135,9 +226,22 @@ typedef struct SurfaceCallbackData {
             /// @brief If focus was gained or lost.
             _Bool gained;
         } focus;
+        /// @brief Surface minimize callback data.
+        /// @see #SURFACE_CALLBACK_TYPE_MINIMIZE
+        struct {
+            /// @brief If surface was minimized or restored.
+            _Bool is_minimized;
+        } minimize;
+        /// @brief Surface occlusion callback data.
+        /// @see #SURFACE_CALLBACK_TYPE_OCCLUSION
+        struct {
+            /// @brief If surface became occluded or visible.
+            _Bool is_occluded;
+        } occlusion;
         /// @brief Surface resize callback data.
         /// @details Valid when surface is resized by user or through an API call.
         /// @see #SURFACE_CALLBACK_TYPE_RESIZE
+        /// @see #SURFACE_CALLBACK_TYPE_LIVE_RESIZE
         struct {
             /// @brief Old surface client area dimensions.
             int32_t old_w, old_h;
@@ -210,6 +314,9 @@ typedef struct SurfaceCallbackData {
         struct {
             /// @brief Code of key that was pressed/released.
             enum KeyboardCode code;
+            /// @brief Physical location of key that was pressed/released.
+            /// @see KeyboardScancode
+            enum KeyboardCode scancode;
             /// @brief Bitfield of current modifier keys.
             /// @note Only valid when input subsystem is initialized.
             enum KeyboardMod  mod;
@@ -223,6 +330,28 @@ typedef struct SurfaceCallbackData {
             /// @brief UTF-8 codepoints.
             char utf8[16];
         } text;
+        /// @brief Text batch callback data.
+        /// @see #SURFACE_CALLBACK_TYPE_TEXT_BATCH
+        struct {
+            /// @brief Pointer to start of text buffer (UTF-8, not null terminated).
+            const char* utf8;
+            /// @brief Length of text in bytes.
+            uint32_t    len;
+            /// @brief True if text did not fit in buffer.
+            /// @details Text is cut at a code point boundary.
+            _Bool       is_truncated;
+        } text_batch;
+        /// @brief Text composition callback data.
+        /// @see #SURFACE_CALLBACK_TYPE_TEXT_COMPOSITION
+        struct {
+            /// @brief Composition string (UTF-8, null terminated).
+            /// @details Only valid for the duration of callback.
+            const char* utf8;
+            /// @brief Length of composition string in bytes.
+            uint32_t    len;
+            /// @brief Byte offset of caret in composition string.
+            uint32_t    cursor;
+        } text_composition;
         /// @brief Raw callback data bytes.
         uint8_t raw[sizeof(uint64_t) * 2];
     };
@@ -263,7 +392,44 @@ attr_media_api _Bool surface_create(
 /// @param[in] surface Handle to surface to destroy.
 attr_media_api void surface_destroy( SurfaceHandle* surface );
 /// @brief Process surface events.
+/// @details
+/// Surfaces can be created on more than one thread,
+/// only events of surfaces created by the calling thread are processed.
 attr_media_api void surface_pump_events(void);
+/// @brief Process events for a subset of surfaces.
+/// @details
+/// Events of surfaces that are not in @c surfaces stay queued
+/// until they are pumped. Events not bound to a surface are always processed.
+/// @param     count    Number of surfaces in @c surfaces.
+/// @param[in] surfaces Surfaces to process events for.
+/// @warning Only the thread that created the surfaces should use this function!
+attr_media_api void surface_pump_events_subset(
+    uint32_t count, SurfaceHandle** surfaces );
+/// @brief Block until events are available, surface_wake() is called,
+/// an extra handle is signaled or timeout elapses.
+/// @details
+/// Does not process events, call surface_pump_events() afterwards.
+/// Input wakes the caller as soon as it is queued so waiting
+/// does not add input latency.
+///
+/// On Windows, extra handles are any HANDLE that can be
+/// passed to WaitForMultipleObjects().
+/// @param      timeout_ns           Nanoseconds to wait for.
+/// Zero checks without blocking, #SURFACE_WAIT_INFINITE never times out.
+/// @param      opt_handle_count     (optional) Number of handles in @c opt_handles.
+/// Must not exceed #SURFACE_WAIT_MAX_HANDLES.
+/// @param[in]  opt_handles          (optional) Extra handles to wait on.
+/// @param[out] opt_out_handle_index (optional) Pointer to write index of signaled handle to.
+/// @return Reason wait returned.
+/// @warning Only the thread that created the surfaces should use this function!
+attr_media_api SurfaceWaitResult surface_wait_events(
+    uint64_t timeout_ns, uint32_t opt_handle_count,
+    void* const* opt_handles, uint32_t* opt_out_handle_index );
+/// @brief Interrupt surface_wait_events().
+/// @details
+/// Safe to call from any thread. If no thread is waiting,
+/// next call to surface_wait_events() returns immediately.
+attr_media_api void surface_wake(void);
 /// @brief Set surface callback function.
 /// @param[in] surface             Surface to set callback for.
 /// @param     callback            Surface callback function.
@@ -323,12 +489,93 @@ attr_media_api void surface_set_dimensions(
 /// @param[in] surface Surface to query state of.
 /// @return State flags.
 attr_media_api SurfaceStateFlags surface_query_state( const SurfaceHandle* surface );
+/// @brief Query how surface contents should be rendered.
+/// @details Derived from surface state, cheap enough to call every frame.
+/// @param[in] surface Surface to query.
+/// @return
+///     - #SURFACE_FRAME_HINT_SKIP   : Surface is hidden, minimized or occluded.
+///     - #SURFACE_FRAME_HINT_RENDER : Otherwise.
+attr_header SurfaceFrameHint surface_query_frame_hint( const SurfaceHandle* surface ) {
+    SurfaceStateFlags hidden =
+        SURFACE_STATE_IS_HIDDEN | SURFACE_STATE_IS_MINIMIZED | SURFACE_STATE_IS_OCCLUDED;
+    if( surface_query_state( surface ) & hidden ) {
+        return SURFACE_FRAME_HINT_SKIP;
+    }
+    return SURFACE_FRAME_HINT_RENDER;
+}
 /// @brief Set surface fullscreen mode.
 /// @param[in] surface       Surface to set state.
 /// @param     is_fullscreen If surface should be fullscreen or not.
 /// @note Some platforms don't have a notion of fullscreen/windowed surfaces.
 attr_media_api void surface_set_fullscreen(
     SurfaceHandle* surface, _Bool is_fullscreen );
+/// @brief Set surface exclusive fullscreen with given display mode.
+/// @details
+/// Changes resolution and refresh rate of display that surface is on
+/// and makes surface cover it. Original mode is restored while surface
+/// is unfocused (surface is minimized until it is focused again),
+/// when surface leaves exclusive fullscreen, is destroyed or
+/// when library shuts down.
+///
+/// Calling surface_set_fullscreen() with false also leaves exclusive fullscreen.
+/// @param[in] surface  Surface to set state.
+/// @param[in] opt_mode (optional) Mode to switch to, one of display_query_modes().
+/// Zero refresh rate or color depth selects any. NULL leaves exclusive fullscreen
+/// and returns to windowed mode.
+/// @return
+///     - true  : Mode was changed.
+///     - false : Display does not support mode or platform does not
+///               support exclusive fullscreen. Surface that was already
+///               exclusive fullscreen stays fullscreen at original mode.
+attr_media_api _Bool surface_set_fullscreen_exclusive(
+    SurfaceHandle* surface, const struct DisplayMode* opt_mode );
+/// @brief Enable/disable relative mouse mode.
+/// @details
+/// While surface is focused, cursor is hidden and confined to
+/// surface client area and absolute mouse position stops updating.
+/// Motion is reported only through input_mouse_query_delta() and
+/// #SURFACE_CALLBACK_TYPE_MOUSE_MOVE_DELTA as raw, unaccelerated deltas.
+/// Confinement is released while surface is unfocused and
+/// restored when it is focused again.
+///
+/// Intended for mouse look, replaces calling cursor_center() every frame.
+/// @param[in] surface   Surface to set mode of.
+/// @param     is_enabled If relative mode should be enabled.
+attr_media_api void surface_set_relative_mouse( SurfaceHandle* surface, _Bool is_enabled );
+/// @brief Set buffer that committed text is collected in.
+/// @details
+/// While surface has a text buffer, committed text is appended to it
+/// and delivered in a single #SURFACE_CALLBACK_TYPE_TEXT_BATCH callback
+/// at the end of surface_pump_events() instead of one
+/// #SURFACE_CALLBACK_TYPE_TEXT callback per character.
+/// Buffer is overwritten by the next pump that receives text.
+/// @param[in] surface    Surface to set text buffer of.
+/// @param     cap        Capacity of @c opt_buffer in bytes.
+/// @param[in] opt_buffer (optional) Text buffer. NULL restores per character callbacks.
+/// @warning Buffer must stay valid until it is replaced or surface is destroyed.
+attr_media_api void surface_set_text_buffer(
+    SurfaceHandle* surface, uint32_t cap, char* opt_buffer );
+/// @brief Enable/disable inline text composition.
+/// @details
+/// By default, platform draws text being composed by an input method
+/// in its own window. When inline, platform does not draw composition
+/// and application is expected to draw contents of
+/// #SURFACE_CALLBACK_TYPE_TEXT_COMPOSITION at its text cursor.
+/// Composition callbacks are sent either way.
+/// @param[in] surface   Surface to set composition mode of.
+/// @param     is_inline If composition should be drawn by application.
+attr_media_api void surface_set_text_composition_inline(
+    SurfaceHandle* surface, _Bool is_inline );
+/// @brief Set area of text being edited.
+/// @details
+/// Input method candidate list is placed next to this area
+/// without covering it.
+/// @param[in] surface Surface to set area of.
+/// @param     x, y    Position of bottom left corner of area in client space,
+/// y is bottom to top of surface.
+/// @param     w, h    Dimensions of area.
+attr_media_api void surface_set_text_composition_rect(
+    SurfaceHandle* surface, int32_t x, int32_t y, int32_t w, int32_t h );
 /// @brief Hide/show surface.
 /// @param[in] surface   Surface to hide/show.
 /// @param     is_hidden If surface should be hidden or shown.
@@ -359,6 +606,11 @@ attr_header const char* surface_callback_type_to_string(
         case SURFACE_CALLBACK_TYPE_MOUSE_WHEEL:      result( "Mouse Wheel Scrolled" );
         case SURFACE_CALLBACK_TYPE_KEY:              result( "Key Press/Release" );
         case SURFACE_CALLBACK_TYPE_TEXT:             result( "Text Input" );
+        case SURFACE_CALLBACK_TYPE_LIVE_RESIZE:      result( "Surface Live Resize" );
+        case SURFACE_CALLBACK_TYPE_MINIMIZE:         result( "Surface Minimized/Restored" );
+        case SURFACE_CALLBACK_TYPE_OCCLUSION:        result( "Surface Occluded/Visible" );
+        case SURFACE_CALLBACK_TYPE_TEXT_BATCH:       result( "Text Input Batch" );
+        case SURFACE_CALLBACK_TYPE_TEXT_COMPOSITION: result( "Text Composition" );
     }
     result( "Unknown" );
     #undef result
@@ -0,0 +1,70 @@
+#if !defined(MEDIA_TIME_H)
+#define MEDIA_TIME_H
+/**
+ * @file   time.h
+ * @brief  Monotonic clock, timestamp counter and precise sleep.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 19, 2024
+*/
+#include "media/defines.h"
+#include "media/types.h"
+
+/// @brief Nanoseconds in a millisecond.
+#define MEDIA_TIME_NS_PER_MS (1000000ULL)
+/// @brief Nanoseconds in a second.
+#define MEDIA_TIME_NS_PER_SECOND (1000000000ULL)
+
+/// @brief Query monotonic time.
+/// @details
+/// Time is relative to an unspecified point in the past
+/// and never goes backwards.
+/// @return Time in nanoseconds.
+attr_media_api uint64_t media_time_ns(void);
+/// @brief Query how many nanoseconds a single timestamp counter tick lasts.
+/// @details
+/// Timestamp counter is calibrated against media_time_ns() on first call,
+/// which takes about 10 milliseconds. Result is cached afterwards.
+/// @return Nanoseconds per tick.
+attr_media_api double media_time_ns_per_tick(void);
+/// @brief Sleep current thread until monotonic time is reached.
+/// @details
+/// Sleeps with a high resolution timer when platform provides one and
+/// spins for the final part of the wait, so thread wakes up
+/// as close to @c deadline_ns as possible.
+/// Returns immediately if @c deadline_ns is in the past.
+/// @param deadline_ns Monotonic time to wake up at, see media_time_ns().
+/// @return Monotonic time in nanoseconds when thread woke up.
+attr_media_api uint64_t media_time_sleep_until_ns( uint64_t deadline_ns );
+
+/// @brief Read timestamp counter.
+/// @details
+/// Cheaper than media_time_ns() but in ticks with a machine specific
+/// frequency, convert with media_time_ticks_to_ns().
+/// Falls back to media_time_ns() when architecture has no timestamp counter.
+/// @return Timestamp counter ticks.
+attr_header attr_always_inline
+uint64_t media_time_ticks(void) {
+#if defined(MEDIA_ARCH_X86)
+    return __builtin_ia32_rdtsc();
+#else
+    return media_time_ns();
+#endif
+}
+/// @brief Convert timestamp counter ticks to nanoseconds.
+/// @param ticks Ticks, usually difference between two media_time_ticks().
+/// @return Nanoseconds.
+attr_header uint64_t media_time_ticks_to_ns( uint64_t ticks ) {
+#if defined(MEDIA_ARCH_X86)
+    return (uint64_t)((double)ticks * media_time_ns_per_tick());
+#else
+    return ticks;
+#endif
+}
+/// @brief Sleep current thread for given nanoseconds.
+/// @param ns Nanoseconds to sleep.
+/// @return Monotonic time in nanoseconds when thread woke up.
+attr_header uint64_t media_time_sleep_ns( uint64_t ns ) {
+    return media_time_sleep_until_ns( media_time_ns() + ns );
+}
+
+#endif /* header guard */
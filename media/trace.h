@@ -0,0 +1,43 @@
+#if !defined(MEDIA_TRACE_H)
+#define MEDIA_TRACE_H
+/**
+ * @file   trace.h
+ * @brief  Trace export.
+ * @details
+ * When media library is compiled with MEDIA_ENABLE_TRACE
+ * (./cbuild build -trace), surface_pump_events(), input_subsystem_update(),
+ * opengl_swap_buffers() and audio_device_buffer_lock() record trace scopes
+ * into per-thread ring buffers. Without it, scopes compile to nothing and
+ * exported traces are empty.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 17, 2024
+*/
+#include "media/defines.h"
+#include "media/types.h"
+
+/// @brief Function prototype for trace export writer.
+/// @param     len    Length of text.
+/// @param[in] text   Text to write. Not null-terminated.
+/// @param[in] params Parameters passed to export function.
+typedef void MediaTraceWriteFN( uint32_t len, const char* text, void* params );
+
+/// @brief Check if media library was compiled with tracing.
+/// @return True if trace scopes are recorded.
+attr_media_api _Bool media_trace_is_enabled(void);
+/// @brief Export recorded trace scopes as Chrome trace JSON.
+/// @details
+/// Output can be opened with chrome://tracing or https://ui.perfetto.dev.
+/// Only the most recent scopes of each thread are kept,
+/// older scopes are overwritten.
+/// @note Scopes recorded while exporting may be torn,
+/// export while traced threads are idle for exact results.
+/// @param[in] write  Function that receives JSON text.
+/// @param[in] params (optional) Parameters passed to @c write.
+/// @return Number of scopes exported.
+attr_media_api uint64_t media_trace_export_chrome_json(
+    MediaTraceWriteFN* write, void* params );
+/// @brief Discard every recorded trace scope.
+/// @note Not thread safe with respect to threads that are recording.
+attr_media_api void media_trace_clear(void);
+
+#endif /* header guard */
@@ -0,0 +1,53 @@
+#if !defined(MEDIA_VULKAN_H)
+#define MEDIA_VULKAN_H
+/**
+ * @file   vulkan.h
+ * @brief  Vulkan related functions.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 12, 2024
+*/
+#include "media/defines.h"
+#include "media/types.h"
+
+/// @brief Function prototype for vkGetInstanceProcAddr.
+/// @details
+/// Declared without Vulkan headers so that media library does not
+/// depend on them. Can be safely cast to PFN_vkGetInstanceProcAddr.
+/// @param[in] instance VkInstance or NULL for global functions.
+/// @param[in] name     Name of Vulkan function to load.
+/// @return Pointer to Vulkan function or NULL if not found.
+typedef void* VulkanGetInstanceProcAddrFN( void* instance, const char* name );
+
+/// @brief Query Vulkan instance extensions required to create a surface.
+/// @details
+/// Returned extension names should be added to
+/// VkInstanceCreateInfo::ppEnabledExtensionNames.
+/// @note This function does not load the Vulkan library.
+/// @param[out] out_count Pointer to write number of extensions to.
+/// @return Read-only array of extension names.
+attr_media_api const char* const* vulkan_query_instance_extensions(
+    uint32_t* out_count );
+/// @brief Query pointer to vkGetInstanceProcAddr.
+/// @details
+/// Vulkan library is opened the first time this function is called,
+/// applications that never call it do not pay for loading Vulkan.
+/// @return Pointer to vkGetInstanceProcAddr or NULL if Vulkan library
+/// could not be loaded.
+attr_media_api VulkanGetInstanceProcAddrFN* vulkan_query_instance_proc_addr(void);
+/// @brief Create a Vulkan surface for a media surface.
+/// @param[in]  surface        Surface to create Vulkan surface for.
+/// Should be created with #SURFACE_CREATE_FLAG_VULKAN.
+/// @param[in]  instance       VkInstance created with extensions from
+/// vulkan_query_instance_extensions().
+/// @param[in]  opt_allocator  (optional) Pointer to VkAllocationCallbacks.
+/// @param[out] out_vk_surface Pointer to VkSurfaceKHR to write result to.
+/// @return
+///     - true  : Created Vulkan surface successfully.
+///     - false : Failed to create Vulkan surface, check logs for more info.
+/// @note Resulting surface must be destroyed with vkDestroySurfaceKHR
+/// before destroying media surface.
+attr_media_api _Bool vulkan_surface_create(
+    SurfaceHandle* surface, void* instance,
+    const void* opt_allocator, void* out_vk_surface );
+
+#endif /* header guard */
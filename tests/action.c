@@ -0,0 +1,273 @@
+/**
+ * @file   action.c
+ * @brief  Golden tests for input action mapping.
+ * @details
+ * Checks binding validation, digital edges, opposing bindings,
+ * gamepad masks, axis deadzones and disconnected gamepads.
+ *
+ * Build:
+ *   clang -std=c11 -O2 tests/action.c -I. -lm -o build/test-action.exe
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 22, 2024
+*/
+// IWYU pragma: begin_keep
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "media/input.h"
+#include "impl/action.c"
+#include "tests/expect.h"
+// IWYU pragma: end_keep
+
+enum {
+    ACTION_JUMP,
+    ACTION_MOVE_X,
+    ACTION_FIRE,
+    ACTION_ACCELERATE,
+
+    ACTION_COUNT
+};
+
+static InputBinding bind_key( uint16_t action, KeyboardCode key, _Bool is_negative ) {
+    InputBinding result;
+    memset( &result, 0, sizeof(result) );
+    result.action      = action;
+    result.type        = INPUT_BINDING_TYPE_KEY;
+    result.is_negative = is_negative;
+    result.key         = key;
+    return result;
+}
+static InputBinding bind_axis(
+    uint16_t action, uint8_t gamepad, InputGamepadAxis axis,
+    float deadzone, _Bool is_negative
+) {
+    InputBinding result;
+    memset( &result, 0, sizeof(result) );
+    result.action                = action;
+    result.type                  = INPUT_BINDING_TYPE_GAMEPAD_AXIS;
+    result.gamepad               = gamepad;
+    result.is_negative           = is_negative;
+    result.gamepad_axis.axis     = axis;
+    result.gamepad_axis.deadzone = deadzone;
+    return result;
+}
+static InputActionMap* make_map( uint32_t binding_count, const InputBinding* bindings ) {
+    uintptr_t size = input_action_map_query_memory_requirement(
+        ACTION_COUNT, binding_count, bindings );
+    if( !size ) {
+        return NULL;
+    }
+    InputActionMap* map = aligned_alloc( 64, (size + 63) & ~(uintptr_t)63 );
+    if( !input_action_map_compile( ACTION_COUNT, binding_count, bindings, map ) ) {
+        free( map );
+        return NULL;
+    }
+    return map;
+}
+static InputActionMap* make_default_map(void) {
+    InputBinding bindings[8];
+    bindings[0] = bind_key( ACTION_JUMP, KB_SPACE, false );
+    bindings[1] = bind_key( ACTION_MOVE_X, KB_D, false );
+    bindings[2] = bind_key( ACTION_MOVE_X, KB_A, true );
+    bindings[3] = bind_axis(
+        ACTION_MOVE_X, INPUT_BINDING_ANY_GAMEPAD,
+        INPUT_GAMEPAD_AXIS_STICK_LEFT_X, 0.2f, false );
+    bindings[4] = bind_axis(
+        ACTION_MOVE_X, INPUT_BINDING_ANY_GAMEPAD,
+        INPUT_GAMEPAD_AXIS_STICK_LEFT_X, 0.2f, true );
+    memset( bindings + 5, 0, sizeof(bindings[0]) * 3 );
+    bindings[5].action         = ACTION_FIRE;
+    bindings[5].type           = INPUT_BINDING_TYPE_MOUSE_BUTTON;
+    bindings[5].mouse          = MB_LEFT;
+    bindings[6].action         = ACTION_JUMP;
+    bindings[6].type           = INPUT_BINDING_TYPE_GAMEPAD_BUTTON;
+    bindings[6].gamepad        = 1;
+    bindings[6].gamepad_button = GAMEPAD_BUTTON_FACE_DOWN;
+    bindings[7] = bind_axis(
+        ACTION_ACCELERATE, 0, INPUT_GAMEPAD_AXIS_TRIGGER_RIGHT, 0.0f, false );
+    return make_map( 8, bindings );
+}
+
+static void test_validation(void) {
+    expect( !input_action_map_query_memory_requirement( 0, 0, NULL ), "zero actions accepted" );
+    expect(
+        !input_action_map_query_memory_requirement( INPUT_ACTION_MAX_COUNT + 1, 0, NULL ),
+        "too many actions accepted" );
+
+    InputBinding binding = bind_key( ACTION_COUNT, KB_SPACE, false );
+    expect( !make_map( 1, &binding ), "out of bounds action accepted" );
+
+    binding = bind_key( ACTION_JUMP, KB_UNKNOWN, false );
+    expect( !make_map( 1, &binding ), "unknown key accepted" );
+
+    binding = bind_axis( ACTION_JUMP, 0, INPUT_GAMEPAD_AXIS_COUNT, 0.1f, false );
+    expect( !make_map( 1, &binding ), "out of bounds axis accepted" );
+
+    binding = bind_axis( ACTION_JUMP, 0, INPUT_GAMEPAD_AXIS_STICK_LEFT_X, 1.0f, false );
+    expect( !make_map( 1, &binding ), "deadzone of 1 accepted" );
+
+    binding = bind_axis( ACTION_JUMP, 0, INPUT_GAMEPAD_AXIS_STICK_LEFT_X, NAN, false );
+    expect( !make_map( 1, &binding ), "NaN deadzone accepted" );
+
+    binding = bind_axis( ACTION_JUMP, GAMEPAD_MAX_COUNT, INPUT_GAMEPAD_AXIS_STICK_LEFT_X, 0.1f, false );
+    expect( !make_map( 1, &binding ), "out of bounds gamepad accepted" );
+
+    InputActionMap* map = make_map( 0, NULL );
+    expect( map, "map without bindings rejected" );
+    expect( !input_action_query_state( map, ACTION_COUNT ), "out of bounds state" );
+    expect( input_action_query_value( map, ACTION_COUNT ) == 0.0f, "out of bounds value" );
+    free( map );
+}
+static void test_digital_edges(void) {
+    InputActionMap* map = make_default_map();
+    expect( map, "failed to compile map" );
+
+    InputSnapshot snapshot;
+    memset( &snapshot, 0, sizeof(snapshot) );
+
+    static const InputActionState expected[] = {
+        0,
+        INPUT_ACTION_STATE_HELD | INPUT_ACTION_STATE_PRESSED,
+        INPUT_ACTION_STATE_HELD,
+        INPUT_ACTION_STATE_RELEASED,
+        0,
+    };
+    static const _Bool space[] = { false, true, true, false, false };
+
+    for( uint32_t i = 0; i < sizeof(space) / sizeof(space[0]); ++i ) {
+        keyboard_state_set_key( &snapshot.keys, KB_SPACE, space[i] );
+        input_action_map_evaluate( map, &snapshot );
+
+        InputActionState state = input_action_query_state( map, ACTION_JUMP );
+        expect( state == expected[i], "frame %u: state %u, expected %u",
+            i, (unsigned)state, (unsigned)expected[i] );
+        expect( input_action_query_value( map, ACTION_JUMP ) == (space[i] ? 1.0f : 0.0f),
+            "frame %u: value mismatch", i );
+        expect( !input_action_query_state( map, ACTION_FIRE ),
+            "frame %u: unbound key activated fire", i );
+    }
+
+    snapshot.mouse = MB_RIGHT;
+    input_action_map_evaluate( map, &snapshot );
+    expect( !input_action_query_state( map, ACTION_FIRE ), "right mouse activated fire" );
+    snapshot.mouse = MB_LEFT | MB_RIGHT;
+    input_action_map_evaluate( map, &snapshot );
+    expect( input_action_query_state( map, ACTION_FIRE ) & INPUT_ACTION_STATE_PRESSED,
+        "left mouse did not activate fire" );
+
+    free( map );
+}
+static void test_opposing_keys(void) {
+    InputActionMap* map = make_default_map();
+    expect( map, "failed to compile map" );
+
+    InputSnapshot snapshot;
+    memset( &snapshot, 0, sizeof(snapshot) );
+
+    keyboard_state_set_key( &snapshot.keys, KB_D, true );
+    input_action_map_evaluate( map, &snapshot );
+    expect( input_action_query_value( map, ACTION_MOVE_X ) == 1.0f, "D is not 1" );
+
+    keyboard_state_set_key( &snapshot.keys, KB_A, true );
+    input_action_map_evaluate( map, &snapshot );
+    expect( input_action_query_value( map, ACTION_MOVE_X ) == 0.0f, "A + D is not 0" );
+    expect( input_action_query_state( map, ACTION_MOVE_X ) == INPUT_ACTION_STATE_HELD,
+        "A + D is not held" );
+
+    keyboard_state_set_key( &snapshot.keys, KB_D, false );
+    input_action_map_evaluate( map, &snapshot );
+    expect( input_action_query_value( map, ACTION_MOVE_X ) == -1.0f, "A is not -1" );
+
+    // NOTE(alicia): key code bindings must not read scancode state.
+    memset( &snapshot, 0, sizeof(snapshot) );
+    keyboard_state_set_key( &snapshot.scancodes, KB_D, true );
+    input_action_map_evaluate( map, &snapshot );
+    expect( input_action_query_value( map, ACTION_MOVE_X ) == 0.0f,
+        "scancode activated key binding" );
+
+    free( map );
+}
+static void test_gamepad(void) {
+    InputActionMap* map = make_default_map();
+    expect( map, "failed to compile map" );
+
+    InputSnapshot snapshot;
+    memset( &snapshot, 0, sizeof(snapshot) );
+
+    // NOTE(alicia): jump is bound to face down of gamepad 1 only.
+    snapshot.gamepad_connected = 0x3;
+    snapshot.gamepads[0].buttons = GAMEPAD_BUTTON_FACE_DOWN;
+    input_action_map_evaluate( map, &snapshot );
+    expect( !input_action_query_state( map, ACTION_JUMP ), "gamepad 0 activated jump" );
+
+    snapshot.gamepads[1].buttons = GAMEPAD_BUTTON_FACE_DOWN;
+    input_action_map_evaluate( map, &snapshot );
+    expect( input_action_query_state( map, ACTION_JUMP ) & INPUT_ACTION_STATE_HELD,
+        "gamepad 1 did not activate jump" );
+
+    snapshot.gamepad_connected = 0x1;
+    input_action_map_evaluate( map, &snapshot );
+    expect( input_action_query_state( map, ACTION_JUMP ) == INPUT_ACTION_STATE_RELEASED,
+        "disconnected gamepad did not release jump" );
+
+    free( map );
+}
+static void test_axis_trace(void) {
+    InputActionMap* map = make_default_map();
+    expect( map, "failed to compile map" );
+
+    InputSnapshot snapshot;
+    memset( &snapshot, 0, sizeof(snapshot) );
+    snapshot.gamepad_connected = 0x1;
+
+    // NOTE(alicia): recorded left stick X trace of a flick right and back,
+    // values past deadzone of 0.2 are rescaled to 0..1.
+    static const int16_t trace[] = {
+        0, 3000, 6553, 9830, 16384, 26214, 32767, 32767,
+        16384, 0, -16384, -32768, -6000, 0,
+    };
+    static const float expected[] = {
+        0.0f, 0.0f, 0.0f, 0.125f, 0.375f, 0.75f, 1.0f, 1.0f,
+        0.375f, 0.0f, -0.375f, -1.0f, 0.0f, 0.0f,
+    };
+    for( uint32_t i = 0; i < sizeof(trace) / sizeof(trace[0]); ++i ) {
+        snapshot.gamepads[0].stick_left_x = trace[i];
+        input_action_map_evaluate( map, &snapshot );
+
+        float value = input_action_query_value( map, ACTION_MOVE_X );
+        expect( fabsf( value - expected[i] ) < 1e-3f,
+            "sample %u: value %f, expected %f", i, value, expected[i] );
+        _Bool is_held =
+            (input_action_query_state( map, ACTION_MOVE_X ) & INPUT_ACTION_STATE_HELD) != 0;
+        expect( is_held == (expected[i] != 0.0f), "sample %u: held mismatch", i );
+    }
+
+    // NOTE(alicia): axis and key on same action are summed then clamped.
+    snapshot.gamepads[0].stick_left_x = 16384;
+    keyboard_state_set_key( &snapshot.keys, KB_D, true );
+    input_action_map_evaluate( map, &snapshot );
+    expect( input_action_query_value( map, ACTION_MOVE_X ) == 1.0f, "sum is not clamped" );
+
+    snapshot.gamepads[0].trigger_right = 51;
+    input_action_map_evaluate( map, &snapshot );
+    expect( fabsf( input_action_query_value( map, ACTION_ACCELERATE ) - 0.2f ) < 1e-3f,
+        "trigger value mismatch" );
+
+    snapshot.gamepad_connected = 0;
+    input_action_map_evaluate( map, &snapshot );
+    expect( input_action_query_value( map, ACTION_ACCELERATE ) == 0.0f,
+        "disconnected trigger is not zero" );
+
+    free( map );
+}
+
+int main(void) {
+    test_validation();
+    test_digital_edges();
+    test_opposing_keys();
+    test_gamepad();
+    test_axis_trace();
+
+    return test_report( "action" );
+}
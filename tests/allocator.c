@@ -0,0 +1,102 @@
+/**
+ * @file   allocator.c
+ * @brief  Tests for arena and scratch allocation.
+ * @details
+ * Checks that LIFO pops of unaligned sizes rewind arena
+ * to where it started and that scratch arena can be reset.
+ *
+ * Build:
+ *   clang -std=c11 -O2 tests/allocator.c -I. -o build/test-allocator.exe
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 24, 2024
+*/
+// IWYU pragma: begin_keep
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "impl/allocator.c"
+#include "tests/expect.h"
+// IWYU pragma: end_keep
+
+// NOTE(alicia): platform functions allocator needs.
+static uint32_t heap_calls = 0;
+void* media_heap_alloc( uintptr_t size ) {
+    heap_calls++;
+    return calloc( 1, size );
+}
+void media_heap_free( void* memory, uintptr_t size ) {
+    unused( size );
+    free( memory );
+}
+uint32_t media_trace_platform_thread_id(void) {
+    return 1;
+}
+
+static _Alignas(64) uint8_t buffer[4096];
+
+static void test_lifo_unaligned(void) {
+    MediaArena arena = media_arena_from_buffer( buffer, sizeof(buffer) );
+
+    // NOTE(alicia): sizes that leave padding in front of next allocation.
+    static const uintptr_t sizes[] = { 10, 3, 33, 1, 7, 100 };
+    static const uintptr_t alignments[] = { 16, 16, 64, 1, 8, 16 };
+    #define COUNT (sizeof(sizes) / sizeof(sizes[0]))
+
+    void* blocks[COUNT];
+    for( uint32_t round = 0; round < 4; ++round ) {
+        for( uint32_t i = 0; i < COUNT; ++i ) {
+            blocks[i] = media_arena_push( &arena, sizes[i], alignments[i] );
+            expect( blocks[i], "round %u: push %u failed", round, i );
+            expect( ((uintptr_t)blocks[i] & (alignments[i] - 1)) == 0,
+                "round %u: push %u is not aligned", round, i );
+        }
+        for( uint32_t i = COUNT; i-- > 0; ) {
+            media_arena_pop( &arena, blocks[i], sizes[i] );
+        }
+        expect( arena.offset == 0,
+            "round %u: offset %llu after popping everything",
+            round, (unsigned long long)arena.offset );
+    }
+
+    // NOTE(alicia): pop that is not most recent does nothing.
+    void* a = media_arena_push( &arena, 10, 16 );
+    void* b = media_arena_push( &arena, 10, 16 );
+    uintptr_t offset = arena.offset;
+    media_arena_pop( &arena, a, 10 );
+    expect( arena.offset == offset, "out of order pop changed offset" );
+    media_arena_pop( &arena, b, 10 );
+    media_arena_pop( &arena, a, 10 );
+    expect( arena.offset == 0, "arena did not rewind after in order pops" );
+
+    #undef COUNT
+}
+static void test_scratch(void) {
+    media_lib_set_scratch( buffer, sizeof(buffer) );
+
+    // NOTE(alicia): mirrors a title and filters allocated by prompt.
+    for( uint32_t frame = 0; frame < 1000; ++frame ) {
+        void* title   = media_alloc( 2 * 7 );
+        void* filters = media_alloc( 3 * 40 + 2 );
+        expect( title && filters, "frame %u: allocation failed", frame );
+        media_free( filters, 3 * 40 + 2 );
+        media_free( title, 2 * 7 );
+    }
+    expect( heap_calls == 0, "scratch fell back to heap %u time(s)", heap_calls );
+    expect( global_media_scratch.offset == 0, "scratch did not rewind" );
+
+    // NOTE(alicia): leaked allocations are reclaimed by reset.
+    for( uint32_t frame = 0; frame < 1000; ++frame ) {
+        expect( media_alloc( 100 ), "frame %u: allocation failed", frame );
+        media_lib_reset_scratch();
+    }
+    expect( heap_calls == 0, "scratch fell back to heap %u time(s)", heap_calls );
+
+    media_lib_set_scratch( NULL, 0 );
+}
+
+int main(void) {
+    test_lifo_unaligned();
+    test_scratch();
+
+    return test_report( "allocator" );
+}
@@ -0,0 +1,40 @@
+#if !defined(MEDIA_TEST_EXPECT_H)
+#define MEDIA_TEST_EXPECT_H
+/**
+ * @file   expect.h
+ * @brief  Assertions and summary for standalone tests.
+ * @details
+ * Only meant to be included once by each standalone test program.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 23, 2024
+*/
+// IWYU pragma: begin_keep
+#include <stdio.h>
+// IWYU pragma: end_keep
+
+static int failures = 0;
+
+/// @brief Report failure and return from current test if condition is false.
+#define expect( condition, ... ) do {\
+    if( !(condition) ) {\
+        printf( "FAILED %s:%i: ", __FILE__, __LINE__ );\
+        printf( __VA_ARGS__ );\
+        printf( "\n" );\
+        failures++;\
+        return;\
+    }\
+} while(0)
+
+/// @brief Print summary of test program.
+/// @param name Name of tested module.
+/// @return Exit code of test program.
+static int test_report( const char* name ) {
+    if( failures ) {
+        printf( "%s: %i test(s) failed.\n", name, failures );
+        return 1;
+    }
+    printf( "%s: all tests passed.\n", name );
+    return 0;
+}
+
+#endif /* header guard */
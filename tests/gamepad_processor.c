@@ -0,0 +1,328 @@
+/**
+ * @file   gamepad_processor.c
+ * @brief  Golden tests for gamepad processor.
+ * @details
+ * Checks deadzones, response curves and one-euro smoothing against
+ * hand computed values and a double precision reference on a
+ * recorded stick trace, and that gamepads in different lanes
+ * do not affect each other.
+ *
+ * Build:
+ *   clang -std=c11 -O2 tests/gamepad_processor.c -I. -lm -o build/test-gamepad-processor.exe
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 22, 2024
+*/
+// IWYU pragma: begin_keep
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "impl/gamepad_processor.c"
+#include "tests/expect.h"
+// IWYU pragma: end_keep
+
+#define TRACE_LENGTH (48)
+#define TRACE_DT     (1.0f / 60.0f)
+
+// NOTE(alicia): left stick of a flick towards upper right at 60 Hz,
+// resting jitter, push, hold, release with overshoot past center.
+static const int16_t trace_x[TRACE_LENGTH] = {
+    -102, -90, -372, 444, 414, 157, -666, 202, -676, 2739, 6312, 9493,
+    12503, 15210, 18792, 21416, 24622, 25012, 24581, 24551, 24436, 24930, 24779, 23954,
+    24717, 24959, 24174, 25027, 25336, 24807, 25006, 24578, 24373, 21148, 15923, 12957,
+    7493, 4269, -1933, -623, -664, 91, -184, -907, 180, -933, 233, -147,
+};
+static const int16_t trace_y[TRACE_LENGTH] = {
+    204, -126, -85, 169, 99, 74, 342, 199, -697, 1930, 4216, 6095,
+    8627, 11274, 13183, 14526, 16896, 17038, 16556, 17427, 17037, 16343, 17461, 16810,
+    16612, 16914, 17270, 17317, 17084, 16419, 16694, 16433, 16726, 13303, 11388, 8701,
+    4639, 2528, -625, -665, -348, -126, -48, 320, 74, -352, -795, 357,
+};
+
+static GamepadProcessor* make_processor( const GamepadProcessorDesc* desc ) {
+    GamepadProcessor* gp = malloc( gamepad_processor_query_memory_requirement() );
+    if( !gamepad_processor_create( desc, gp ) ) {
+        free( gp );
+        return NULL;
+    }
+    return gp;
+}
+static GamepadProcessedState process_one(
+    GamepadProcessor* gp, int16_t x, int16_t y, uint8_t trigger
+) {
+    GamepadState states[GAMEPAD_MAX_COUNT];
+    memset( states, 0, sizeof(states) );
+    states[0].stick_left_x = x;
+    states[0].stick_left_y = y;
+    states[0].trigger_left = trigger;
+    gamepad_processor_update( gp, 0x1, states, 0.0f );
+
+    GamepadProcessedState result;
+    memset( &result, 0, sizeof(result) );
+    gamepad_processor_query_state( gp, 0, &result );
+    return result;
+}
+static _Bool near( float a, double b ) {
+    return fabs( (double)a - b ) < 1e-4;
+}
+
+/// Double precision reference of one-euro filter.
+struct ReferenceFilter {
+    _Bool  has_history;
+    double x, dx;
+};
+static double reference_alpha( double cutoff, double dt ) {
+    double r = 2.0 * 3.14159265358979323846 * cutoff * dt;
+    return r / (r + 1.0);
+}
+static double reference_filter(
+    struct ReferenceFilter* f, double x, double dt, double min_cutoff, double beta
+) {
+    if( !f->has_history ) {
+        f->has_history = true;
+        f->x  = x;
+        f->dx = 0.0;
+        return x;
+    }
+    double dx = (x - f->x) / dt;
+    f->dx += reference_alpha( 1.0, dt ) * (dx - f->dx);
+    double cutoff = min_cutoff + beta * fabs( f->dx );
+    f->x += reference_alpha( cutoff, dt ) * (x - f->x);
+    return f->x;
+}
+/// Double precision reference of radial deadzone with linear response.
+static void reference_radial(
+    double x, double y, double inner, double outer, double* out_x, double* out_y
+) {
+    double magnitude = sqrt( x * x + y * y );
+    double t = (magnitude - inner) / (outer - inner);
+    t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+    *out_x = magnitude > 1e-6 ? x / magnitude * t : 0.0;
+    *out_y = magnitude > 1e-6 ? y / magnitude * t : 0.0;
+}
+static double normalize_stick( int16_t v ) {
+    double x = (double)v / 32767.0;
+    return x < -1.0 ? -1.0 : x;
+}
+
+static void test_validation(void) {
+    GamepadProcessorDesc desc;
+    memset( &desc, 0, sizeof(desc) );
+    GamepadProcessor* gp = make_processor( &desc );
+    expect( gp, "zeroed description rejected" );
+    free( gp );
+
+    desc.stick_deadzone_inner = 0.5f;
+    desc.stick_deadzone_outer = 0.4f;
+    expect( !make_processor( &desc ), "inner past outer accepted" );
+
+    desc.stick_deadzone_outer = 0.0f;
+    desc.stick_deadzone_inner = 1.0f;
+    expect( !make_processor( &desc ), "inner of 1 accepted" );
+
+    desc.stick_deadzone_inner = NAN;
+    expect( !make_processor( &desc ), "NaN deadzone accepted" );
+    desc.stick_deadzone_inner = 0.1f;
+
+    float one_point = 1.0f;
+    desc.stick_curve.point_count = 1;
+    desc.stick_curve.points      = &one_point;
+    expect( !make_processor( &desc ), "curve with one point accepted" );
+
+    float out_of_range[2] = { 0.0f, 1.5f };
+    desc.stick_curve.point_count = 2;
+    desc.stick_curve.points      = out_of_range;
+    expect( !make_processor( &desc ), "curve out of range accepted" );
+    memset( &desc.stick_curve, 0, sizeof(desc.stick_curve) );
+
+    desc.smoothing_beta = -1.0f;
+    expect( !make_processor( &desc ), "negative beta accepted" );
+}
+static void test_deadzones(void) {
+    GamepadProcessorDesc desc;
+    memset( &desc, 0, sizeof(desc) );
+    desc.stick_deadzone_inner   = 0.2f;
+    desc.stick_deadzone_outer   = 0.9f;
+    desc.trigger_deadzone_inner = 0.1f;
+    GamepadProcessor* gp = make_processor( &desc );
+    expect( gp, "failed to create processor" );
+
+    GamepadProcessedState s = process_one( gp, 3000, -3000, 20 );
+    expect( s.stick_left_x == 0.0f && s.stick_left_y == 0.0f, "stick inside deadzone" );
+    expect( s.trigger_left == 0.0f, "trigger inside deadzone" );
+
+    // NOTE(alicia): (0.50002 - 0.2) / 0.7
+    s = process_one( gp, 16384, 0, 128 );
+    expect( near( s.stick_left_x, 0.428599 ), "radial x %f", s.stick_left_x );
+    expect( s.stick_left_y == 0.0f, "radial y %f", s.stick_left_y );
+    // NOTE(alicia): (0.50196 - 0.1) / 0.9
+    expect( near( s.trigger_left, 0.446623 ), "trigger %f", s.trigger_left );
+
+    // NOTE(alicia): radial deadzone keeps direction.
+    s = process_one( gp, 10000, 10000, 255 );
+    expect( near( s.stick_left_x, s.stick_left_y ), "diagonal changed direction" );
+    expect( near( s.stick_left_x, 0.233915 ), "diagonal %f", s.stick_left_x );
+    expect( s.trigger_left == 1.0f, "full trigger %f", s.trigger_left );
+
+    // NOTE(alicia): corners past outer deadzone saturate on unit circle.
+    s = process_one( gp, 32767, -32768, 0 );
+    double length = sqrt(
+        (double)s.stick_left_x * s.stick_left_x + (double)s.stick_left_y * s.stick_left_y );
+    expect( near( (float)length, 1.0 ), "corner length %f", length );
+    expect( s.stick_left_x > 0.0f && s.stick_left_y < 0.0f, "corner direction" );
+    free( gp );
+
+    desc.stick_deadzone_type  = GAMEPAD_DEADZONE_TYPE_AXIAL;
+    desc.stick_deadzone_outer = 0.0f;
+    gp = make_processor( &desc );
+    expect( gp, "failed to create processor" );
+
+    // NOTE(alicia): small y is snapped to axis, (0.5 - 0.2) / 0.8
+    s = process_one( gp, 16384, 3000, 0 );
+    expect( near( s.stick_left_x, 0.375015 ), "axial x %f", s.stick_left_x );
+    expect( s.stick_left_y == 0.0f, "axial y %f", s.stick_left_y );
+    s = process_one( gp, -16384, -16384, 0 );
+    expect( near( s.stick_left_x, -0.375015 ) && near( s.stick_left_y, -0.375015 ),
+        "axial negative %f %f", s.stick_left_x, s.stick_left_y );
+    free( gp );
+}
+static void test_curve(void) {
+    static const float points[] = { 0.0f, 0.25f, 1.0f };
+
+    GamepadProcessorDesc desc;
+    memset( &desc, 0, sizeof(desc) );
+    desc.stick_deadzone_type       = GAMEPAD_DEADZONE_TYPE_AXIAL;
+    desc.stick_curve.point_count   = 3;
+    desc.stick_curve.points        = points;
+    desc.trigger_curve.point_count = 3;
+    desc.trigger_curve.points      = points;
+    GamepadProcessor* gp = make_processor( &desc );
+    expect( gp, "failed to create processor" );
+
+    static const struct { int16_t in; uint8_t trigger; double out; } golden[] = {
+        { 0,     0,   0.0    },
+        { 8192,  64,  0.1250 },
+        { 16384, 128, 0.2500 },
+        { 24576, 191, 0.6250 },
+        { 32767, 255, 1.0    },
+    };
+    for( uint32_t i = 0; i < sizeof(golden) / sizeof(golden[0]); ++i ) {
+        GamepadProcessedState s = process_one( gp, golden[i].in, (int16_t)-golden[i].in, golden[i].trigger );
+        expect( fabs( s.stick_left_x - golden[i].out ) < 2e-3,
+            "point %u: x %f, expected %f", i, s.stick_left_x, golden[i].out );
+        expect( fabs( s.stick_left_y + golden[i].out ) < 2e-3,
+            "point %u: y %f, expected %f", i, s.stick_left_y, -golden[i].out );
+        expect( fabs( s.trigger_left - golden[i].out ) < 4e-3,
+            "point %u: trigger %f, expected %f", i, s.trigger_left, golden[i].out );
+    }
+    free( gp );
+}
+static void test_trace(void) {
+    const double min_cutoff = 1.5, beta = 8.0;
+
+    GamepadProcessorDesc desc;
+    memset( &desc, 0, sizeof(desc) );
+    desc.stick_deadzone_inner = 0.1f;
+    desc.smoothing_min_cutoff = (float)min_cutoff;
+    desc.smoothing_beta       = (float)beta;
+    GamepadProcessor* gp = make_processor( &desc );
+    expect( gp, "failed to create processor" );
+
+    struct ReferenceFilter fx, fy;
+    memset( &fx, 0, sizeof(fx) );
+    memset( &fy, 0, sizeof(fy) );
+
+    GamepadState states[GAMEPAD_MAX_COUNT];
+    memset( states, 0, sizeof(states) );
+
+    double max_error = 0.0;
+    for( uint32_t i = 0; i < TRACE_LENGTH; ++i ) {
+        states[0].stick_left_x = trace_x[i];
+        states[0].stick_left_y = trace_y[i];
+        gamepad_processor_update( gp, 0x1, states, TRACE_DT );
+
+        double x = reference_filter( &fx, normalize_stick( trace_x[i] ), TRACE_DT, min_cutoff, beta );
+        double y = reference_filter( &fy, normalize_stick( trace_y[i] ), TRACE_DT, min_cutoff, beta );
+        double expected_x, expected_y;
+        reference_radial( x, y, 0.1, 1.0, &expected_x, &expected_y );
+
+        GamepadProcessedState s;
+        expect( gamepad_processor_query_state( gp, 0, &s ), "gamepad not connected" );
+        double error = fmax(
+            fabs( s.stick_left_x - expected_x ), fabs( s.stick_left_y - expected_y ) );
+        max_error = fmax( max_error, error );
+        expect( error < 1e-4, "sample %u: (%f, %f), expected (%f, %f)",
+            i, s.stick_left_x, s.stick_left_y, expected_x, expected_y );
+
+        // NOTE(alicia): resting jitter and overshoot stay inside deadzone.
+        if( i < 9 || i > 40 ) {
+            expect( s.stick_left_x == 0.0f && s.stick_left_y == 0.0f,
+                "sample %u: jitter leaked (%f, %f)", i, s.stick_left_x, s.stick_left_y );
+        }
+    }
+    expect( max_error < 1e-4, "max error %f", max_error );
+
+    // NOTE(alicia): reconnecting resets filter, first sample is not smoothed.
+    gamepad_processor_update( gp, 0x0, states, TRACE_DT );
+    GamepadProcessedState s;
+    expect( !gamepad_processor_query_state( gp, 0, &s ), "disconnected gamepad reported" );
+
+    states[0].stick_left_x = 32767;
+    states[0].stick_left_y = 0;
+    gamepad_processor_update( gp, 0x1, states, TRACE_DT );
+    expect( gamepad_processor_query_state( gp, 0, &s ), "reconnected gamepad not reported" );
+    expect( s.stick_left_x == 1.0f, "filter not reset %f", s.stick_left_x );
+    free( gp );
+}
+static void test_lanes(void) {
+    GamepadProcessorDesc desc;
+    memset( &desc, 0, sizeof(desc) );
+    desc.stick_deadzone_inner = 0.15f;
+    desc.smoothing_min_cutoff = 1.0f;
+    desc.smoothing_beta       = 4.0f;
+
+    GamepadProcessor* all = make_processor( &desc );
+    GamepadProcessor* one = make_processor( &desc );
+    expect( all && one, "failed to create processor" );
+
+    // NOTE(alicia): gamepad 2 plays trace rotated and with triggers,
+    // gamepad 3 stays disconnected. Gamepad 2 must match processing it alone.
+    GamepadState states[GAMEPAD_MAX_COUNT], alone[GAMEPAD_MAX_COUNT];
+    for( uint32_t i = 0; i < TRACE_LENGTH; ++i ) {
+        memset( states, 0, sizeof(states) );
+        for( uint32_t pad = 0; pad < 3; ++pad ) {
+            states[pad].buttons        = (GamepadButton)(1 << pad);
+            states[pad].stick_left_x   = pad == 1 ? trace_y[i] : trace_x[i];
+            states[pad].stick_left_y   = pad == 2 ? (int16_t)-trace_y[i] : trace_y[i];
+            states[pad].stick_right_x  = trace_x[TRACE_LENGTH - 1 - i];
+            states[pad].trigger_right  = (uint8_t)(i * 5 + pad);
+        }
+        states[3].stick_left_x = 32767;
+
+        memset( alone, 0, sizeof(alone) );
+        alone[0] = states[2];
+
+        gamepad_processor_update( all, 0x7, states, TRACE_DT );
+        gamepad_processor_update( one, 0x1, alone, TRACE_DT );
+
+        GamepadProcessedState a, b;
+        memset( &a, 0, sizeof(a) );
+        memset( &b, 0, sizeof(b) );
+        expect( gamepad_processor_query_state( all, 2, &a ), "gamepad 2 not connected" );
+        expect( gamepad_processor_query_state( one, 0, &b ), "gamepad 0 not connected" );
+        expect( !memcmp( &a, &b, sizeof(a) ), "sample %u: lanes differ", i );
+        expect( !gamepad_processor_query_state( all, 3, &a ), "gamepad 3 reported" );
+    }
+    free( all );
+    free( one );
+}
+
+int main(void) {
+    test_validation();
+    test_deadzones();
+    test_curve();
+    test_trace();
+    test_lanes();
+
+    return test_report( "gamepad processor" );
+}
@@ -0,0 +1,278 @@
+/**
+ * @file   spatial.c
+ * @brief  Golden tests for HRTF spatializer.
+ * @details
+ * Checks real FFT against a direct DFT, partitioned convolution against
+ * direct convolution, distance attenuation, Doppler pitch and
+ * voice lifetime.
+ *
+ * Build:
+ *   clang -std=c11 -O2 tests/spatial.c -I. -lm -o build/test-spatial.exe
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 20, 2024
+*/
+// IWYU pragma: begin_keep
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "impl/spatial.c"
+#include "tests/expect.h"
+// IWYU pragma: end_keep
+
+#define B  (AUDIO_SPATIALIZER_BLOCK_SIZE)
+#define N  (B * 2)
+#define HZ (48000)
+// NOTE(alicia): M_PI is not defined in strict C11.
+#define PI (3.14159265358979323846)
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+static float rng_float(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (float)((rng_state >> 40) & 0xFFFF) / 32768.0f - 1.0f;
+}
+
+/// Spatializer with one direction (straight ahead) and given responses.
+static AudioSpatializer* make_spatializer(
+    uint32_t length, const float* left, const float* right
+) {
+    static float direction[3] = { 0.0f, 0.0f, 1.0f };
+    float* responses = malloc( sizeof(float) * 2 * length );
+    memcpy( responses, left, sizeof(float) * length );
+    memcpy( responses + length, right, sizeof(float) * length );
+
+    struct AudioSpatializerDesc desc;
+    memset( &desc, 0, sizeof(desc) );
+    desc.samples_per_second     = HZ;
+    desc.voice_cap              = 4;
+    desc.hrtf.length            = length;
+    desc.hrtf.direction_count   = 1;
+    desc.hrtf.directions        = direction;
+    desc.hrtf.impulse_responses = responses;
+
+    AudioSpatializer* sp = malloc( audio_spatializer_query_memory_requirement( &desc ) );
+    if( !audio_spatializer_create( &desc, sp ) ) {
+        free( sp );
+        sp = NULL;
+    }
+    free( responses );
+    return sp;
+}
+static struct AudioSpatializerSource make_source( uint32_t count, const float* samples ) {
+    struct AudioSpatializerSource source;
+    memset( &source, 0, sizeof(source) );
+    source.samples            = samples;
+    source.sample_count       = count;
+    source.samples_per_second = HZ;
+    source.gain               = 1.0f;
+    source.min_distance       = 1.0f;
+    source.rolloff            = 1.0f;
+    source.position[2]        = 1.0f;
+    return source;
+}
+/// Render frames into stereo float buffer.
+static void render( AudioSpatializer* sp, uint32_t frames, float* out ) {
+    memset( out, 0, sizeof(float) * 2 * frames );
+    struct AudioBufferFormat format;
+    memset( &format, 0, sizeof(format) );
+    format.channel_count   = 2;
+    format.bits_per_sample = 32;
+
+    // NOTE(alicia): odd sized chunks to exercise partial blocks.
+    uint32_t done = 0;
+    while( done < frames ) {
+        uint32_t count = frames - done < 97 ? frames - done : 97;
+        struct AudioBuffer buffer;
+        buffer.sample_count = count;
+        buffer.size         = count * 2 * sizeof(float);
+        buffer.start        = out + done * 2;
+        audio_spatializer_render( sp, &format, &buffer );
+        done += count;
+    }
+}
+
+static void test_rfft(void) {
+    struct MediaSpatializer* sp = calloc( 1, sizeof(*sp) );
+    media_spatial_tables_init( sp );
+
+    float x[N];
+    for( uint32_t i = 0; i < N; ++i ) {
+        x[i] = rng_float();
+    }
+    float spectrum[N];
+    media_spatial_rfft( sp, x, spectrum );
+
+    for( uint32_t k = 0; k <= B; ++k ) {
+        double re = 0.0, im = 0.0;
+        for( uint32_t n = 0; n < N; ++n ) {
+            double a = -2.0 * PI * (double)k * (double)n / (double)N;
+            re += x[n] * cos( a );
+            im += x[n] * sin( a );
+        }
+        double got_re, got_im;
+        if( k == 0 ) {
+            got_re = spectrum[0];
+            got_im = 0.0;
+        } else if( k == B ) {
+            got_re = spectrum[B];
+            got_im = 0.0;
+        } else {
+            got_re = spectrum[k];
+            got_im = spectrum[B + k];
+        }
+        expect( fabs( got_re - re ) < 1e-3 && fabs( got_im - im ) < 1e-3,
+            "rfft bin %u: expected (%f, %f) got (%f, %f)", k, re, im, got_re, got_im );
+    }
+
+    float back[N];
+    media_spatial_irfft( sp, spectrum, back, sp->input );
+    for( uint32_t n = 0; n < N; ++n ) {
+        float value = back[n] / (float)N;
+        expect( fabsf( value - x[n] ) < 1e-4f,
+            "irfft sample %u: expected %f got %f", n, x[n], value );
+    }
+    free( sp );
+}
+static void test_convolution(void) {
+    // NOTE(alicia): length not a multiple of block size on purpose.
+    enum { LENGTH = 300, CLIP = 1000, FRAMES = CLIP + LENGTH + 2 * B };
+    float left[LENGTH], right[LENGTH];
+    for( uint32_t i = 0; i < LENGTH; ++i ) {
+        float decay = expf( -(float)i / 60.0f );
+        left[i]  = rng_float() * decay;
+        right[i] = rng_float() * decay * 0.5f;
+    }
+    float* clip = malloc( sizeof(float) * CLIP );
+    for( uint32_t i = 0; i < CLIP; ++i ) {
+        clip[i] = rng_float();
+    }
+
+    AudioSpatializer* sp = make_spatializer( LENGTH, left, right );
+    expect( sp, "failed to create spatializer" );
+
+    struct AudioSpatializerSource source = make_source( CLIP, clip );
+    uint32_t voice = audio_spatializer_voice_play( sp, &source );
+    expect( voice != AUDIO_SPATIALIZER_VOICE_INVALID, "failed to play voice" );
+
+    float* out = malloc( sizeof(float) * 2 * FRAMES );
+    render( sp, FRAMES, out );
+
+    double max_error = 0.0;
+    for( uint32_t n = 0; n < FRAMES; ++n ) {
+        double l = 0.0, r = 0.0;
+        for( uint32_t k = 0; k < LENGTH; ++k ) {
+            if( k > n ) {
+                break;
+            }
+            if( n - k < CLIP ) {
+                l += (double)clip[n - k] * left[k];
+                r += (double)clip[n - k] * right[k];
+            }
+        }
+        double el = fabs( l - out[n * 2] );
+        double er = fabs( r - out[n * 2 + 1] );
+        if( el > max_error ) {
+            max_error = el;
+        }
+        if( er > max_error ) {
+            max_error = er;
+        }
+    }
+    expect( max_error < 1e-4, "convolution max error %g", max_error );
+    expect( !audio_spatializer_voice_is_playing( sp, voice ),
+        "voice should finish after tail" );
+
+    free( out );
+    free( clip );
+    free( sp );
+}
+static void test_attenuation(void) {
+    float delta[1] = { 1.0f };
+    AudioSpatializer* sp = make_spatializer( 1, delta, delta );
+    expect( sp, "failed to create spatializer" );
+
+    float clip[4 * B];
+    for( uint32_t i = 0; i < 4 * B; ++i ) {
+        clip[i] = 1.0f;
+    }
+    struct AudioSpatializerSource source = make_source( 4 * B, clip );
+    source.loop        = true;
+    source.position[2] = 3.0f;
+    audio_spatializer_voice_play( sp, &source );
+
+    float out[2 * 2 * B];
+    render( sp, 2 * B, out );
+
+    // NOTE(alicia): inverse distance clamped: 1 / (1 + 1 * (3 - 1)).
+    float expected = 1.0f / 3.0f;
+    float got      = out[(2 * B - 1) * 2];
+    expect( fabsf( got - expected ) < 1e-4f,
+        "attenuation: expected %f got %f", expected, got );
+    free( sp );
+}
+static void test_doppler(void) {
+    float delta[1] = { 1.0f };
+    AudioSpatializer* sp = make_spatializer( 1, delta, delta );
+    expect( sp, "failed to create spatializer" );
+
+    // NOTE(alicia): ramp source makes read position visible in output.
+    enum { CLIP = 16 * B };
+    float* clip = malloc( sizeof(float) * CLIP );
+    for( uint32_t i = 0; i < CLIP; ++i ) {
+        clip[i] = (float)i / (float)CLIP;
+    }
+    struct AudioSpatializerSource source = make_source( CLIP, clip );
+    source.position[2] = 1.0f;
+    // moving towards listener at a tenth of speed of sound.
+    source.velocity[2] = -AUDIO_SPATIALIZER_DEFAULT_SPEED_OF_SOUND * 0.1f;
+    audio_spatializer_voice_play( sp, &source );
+
+    float out[2 * 4 * B];
+    render( sp, 4 * B, out );
+
+    float expected = 1.0f / 0.9f;
+    float slope = (out[(3 * B) * 2] - out[(2 * B) * 2]) * (float)CLIP / (float)B;
+    expect( fabsf( slope - expected ) < 1e-3f,
+        "doppler pitch: expected %f got %f", expected, slope );
+    free( clip );
+    free( sp );
+}
+static void test_voice_handles(void) {
+    float delta[1] = { 1.0f };
+    AudioSpatializer* sp = make_spatializer( 1, delta, delta );
+    expect( sp, "failed to create spatializer" );
+
+    float clip[B];
+    memset( clip, 0, sizeof(clip) );
+    struct AudioSpatializerSource source = make_source( B, clip );
+
+    uint32_t first = audio_spatializer_voice_play( sp, &source );
+    audio_spatializer_voice_stop( sp, first );
+    expect( !audio_spatializer_voice_is_playing( sp, first ), "stopped voice is playing" );
+
+    uint32_t second = audio_spatializer_voice_play( sp, &source );
+    expect( second != first, "reused slot must get new handle" );
+    audio_spatializer_voice_stop( sp, first );
+    expect( audio_spatializer_voice_is_playing( sp, second ),
+        "stale handle stopped new voice" );
+
+    for( uint32_t i = 1; i < 4; ++i ) {
+        expect( audio_spatializer_voice_play( sp, &source ) != AUDIO_SPATIALIZER_VOICE_INVALID,
+            "voice %u should fit", i );
+    }
+    expect( audio_spatializer_voice_play( sp, &source ) == AUDIO_SPATIALIZER_VOICE_INVALID,
+        "voice cap exceeded" );
+    free( sp );
+}
+
+int main(void) {
+    test_rfft();
+    test_convolution();
+    test_attenuation();
+    test_doppler();
+    test_voice_handles();
+
+    return test_report( "spatializer" );
+}
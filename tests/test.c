@@ -11,6 +11,8 @@
 #include "media/prompt.h"
 #include "media/audio.h"
 #include "media/cursor.h"
+#include "media/time.h"
+#include "media/display.h"
 // IWYU pragma: end_keep
 
 #define text( lit ) sizeof(lit) - 1, lit
@@ -50,18 +52,37 @@ void surface_callback(
                 printf( "focus lost.\n" );
             }
         } break;
+        case SURFACE_CALLBACK_TYPE_MINIMIZE: {
+            printf( "%s.\n", data->minimize.is_minimized ? "minimized" : "restored" );
+        } break;
+        case SURFACE_CALLBACK_TYPE_OCCLUSION: {
+            printf( "%s.\n", data->occlusion.is_occluded ? "occluded" : "visible" );
+        } break;
         case SURFACE_CALLBACK_TYPE_RESIZE: {
             /* printf( "resize: %i %i\n", data->resize.w, data->resize.h ); */
         } break;
         case SURFACE_CALLBACK_TYPE_POSITION: {
             /* printf( "move: %i %i\n", data->position.x, data->position.y ); */
         } break;
+        case SURFACE_CALLBACK_TYPE_LIVE_RESIZE: {
+            /* printf( "live resize: %i %i\n", data->resize.w, data->resize.h ); */
+        } break;
         case SURFACE_CALLBACK_TYPE_TEXT: {
             /* printf( */
             /*     "%c%c%c%c", */
             /*     data->text.utf8[0], data->text.utf8[1], */
             /*     data->text.utf8[2], data->text.utf8[3] ); */
         } break;
+        case SURFACE_CALLBACK_TYPE_TEXT_BATCH: {
+            printf(
+                "text: %.*s%s\n", (int)data->text_batch.len, data->text_batch.utf8,
+                data->text_batch.is_truncated ? " (truncated)" : "" );
+        } break;
+        case SURFACE_CALLBACK_TYPE_TEXT_COMPOSITION: {
+            printf(
+                "composition: %s (cursor %u)\n",
+                data->text_composition.utf8, data->text_composition.cursor );
+        } break;
         case SURFACE_CALLBACK_TYPE_MOUSE_BUTTON: {
             if( !data->mouse_button.delta ) {
                 return;
@@ -117,8 +138,6 @@ extern int SetConsoleOutputCP( unsigned int wCodePageID );
 #define CP_UTF8 65001
 #endif
 
-double get_ms(void);
-
 int main( int argc, char** argv ) {
     unused(argc, argv);
 
@@ -159,6 +178,20 @@ int main( int argc, char** argv ) {
         return -1;
     }
 
+    uint32_t display_count = display_query_count();
+    printf( "displays:\n" );
+    for( uint32_t i = 0; i < display_count; ++i ) {
+        struct DisplayInfo info;
+        if( !display_query_info( i, &info ) ) {
+            continue;
+        }
+        printf( "    %u: %.*s %ix%i @ %.3f Hz (%u/%u), %u dpi, %u modes%s\n",
+            i, (int)info.name_len, info.name, info.mode.w, info.mode.h,
+            display_refresh_rate_hz( &info.mode.refresh_rate ),
+            info.mode.refresh_rate.numerator, info.mode.refresh_rate.denominator,
+            info.dpi, info.mode_count, info.is_primary ? " (primary)" : "" );
+    }
+
     uintptr_t audio_device_list_size   = audio_device_list_query_memory_requirement();
     AudioDeviceList* audio_device_list = malloc( audio_device_list_size );
     memset( audio_device_list, 0, audio_device_list_size );
@@ -212,7 +245,7 @@ int main( int argc, char** argv ) {
     if( !audio_device_open(
         audio_device_list, &format,
         1000, AUDIO_DEVICE_TYPE_OUTPUT,
-        AUDIO_DEVICE_DEFAULT, audio_device
+        AUDIO_DEVICE_DEFAULT, AUDIO_DEVICE_OPEN_FLAG_FOLLOW_DEFAULT, audio_device
     ) ) {
         return -1;
     }
@@ -225,6 +258,7 @@ int main( int argc, char** argv ) {
     flags |= SURFACE_CREATE_FLAG_DARK_MODE;
     flags |= SURFACE_CREATE_FLAG_X_CENTERED;
     flags |= SURFACE_CREATE_FLAG_Y_CENTERED;
+    flags |= SURFACE_CREATE_FLAG_LIVE_RESIZE;
 
     bool is_running = true;
 
@@ -240,6 +274,9 @@ int main( int argc, char** argv ) {
         goto main_end;
     }
 
+    static char text_buffer[256];
+    surface_set_text_buffer( surface, sizeof(text_buffer), text_buffer );
+
     OpenGLRenderContext* rc = opengl_context_create( surface, NULL );
     if( !rc ) {
         return -1;
@@ -264,7 +301,7 @@ int main( int argc, char** argv ) {
     printf( "samples_per_second: %u\n", format.samples_per_second );
     printf( "sample_count:       %u\n", format.sample_count );
 
-    double last_ms = get_ms();
+    uint64_t start_ns = media_time_ns();
 
     uint32_t channel_sample_size =
         (format.bits_per_sample / 8);
@@ -297,6 +334,19 @@ int main( int argc, char** argv ) {
         input_subsystem_update();
         surface_pump_events();
 
+        PointerSample contacts[POINTER_MAX_CONTACTS];
+        uint32_t contact_count = input_pointer_query_contacts(
+            POINTER_MAX_CONTACTS, contacts );
+        for( uint32_t i = 0; i < contact_count; ++i ) {
+            if( contacts[i].state & POINTER_STATE_RELEASED ) {
+                printf(
+                    "%s %u released at %i, %i (%u samples this frame)\n",
+                    contacts[i].type == POINTER_TYPE_PEN ? "pen" : "touch",
+                    contacts[i].id, contacts[i].x, contacts[i].y,
+                    input_pointer_query_history( 0, NULL ) );
+            }
+        }
+
         int32_t x, y;
         input_mouse_query_position( &x, &y );
         input_mouse_position_to_client( surface, &x, &y );
@@ -324,8 +374,8 @@ int main( int argc, char** argv ) {
         glClearColor( r, g, b, 1.0 );
         glClear( GL_COLOR_BUFFER_BIT );
 
-        double elapsed = get_ms() - last_ms;
-        elapsed *= 0.001;
+        double elapsed =
+            (double)(media_time_ns() - start_ns) / (double)MEDIA_TIME_NS_PER_SECOND;
         r = (sin( elapsed + offset0 ) + 1.0) / 2.0;
         g = (cos( elapsed + offset1 ) + 1.0) / 2.0;
         b = (sin( elapsed + offset2 ) + 1.0) / 2.0;
@@ -357,6 +407,17 @@ int main( int argc, char** argv ) {
         opengl_swap_buffers( surface );
     }
 
+    struct AudioDeviceStats audio_stats;
+    if( audio_device_query_stats( audio_device, &audio_stats ) ) {
+        printf(
+            "audio: latency: %.2fms padding high water: %u "
+            "underruns: %u overruns: %u migrations: %u\n",
+            (double)audio_stats.latency_ns / (double)MEDIA_TIME_NS_PER_MS,
+            audio_stats.padding_high_water,
+            audio_stats.underrun_count, audio_stats.overrun_count,
+            audio_stats.migration_count );
+    }
+
     audio_device_stop( audio_device );
     audio_device_close( audio_device );
     free( audio_device );
@@ -374,21 +435,3 @@ main_end:
     return 0;
 }
 
-#if defined(MEDIA_PLATFORM_WINDOWS)
-#include <windows.h>
-double get_ms(void) {
-    LARGE_INTEGER qpc, qpf;
-    QueryPerformanceCounter( &qpc );
-    QueryPerformanceFrequency( &qpf );
-
-    return ((double)qpc.QuadPart / (double)qpf.QuadPart) * 1000.0;
-}
-#else
-#include <time.h>
-double get_ms(void) {
-    struct timespec ts;
-    clock_gettime( CLOCK_MONOTONIC, &ts );
-    return ((double)ts.tv_nsec / 1000000.0) + ((double)ts.tv_sec * 1000.0);
-}
-#endif
-
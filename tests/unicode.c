@@ -0,0 +1,274 @@
+/**
+ * @file   unicode.c
+ * @brief  Fuzz test for internal unicode transcoding.
+ * @details
+ * Generates random UTF-8 and UTF-16 strings (valid text, random bytes
+ * and long ASCII runs to exercise SIMD paths) and checks transcoding
+ * against a simple reference decoder.
+ *
+ * Arguments:
+ *   [iterations] [seed]
+ *
+ * Build:
+ *   clang -std=c11 -O2 tests/unicode.c -I. -o build/test-unicode.exe
+ *   clang -std=c11 -O2 -mavx2 tests/unicode.c -I. -o build/test-unicode-avx2.exe
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   September 15, 2024
+*/
+// IWYU pragma: begin_keep
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "impl/unicode.c"
+#include "tests/expect.h"
+// IWYU pragma: end_keep
+
+#define BUFFER_CAP (4096)
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (uint32_t)(rng_state >> 16);
+}
+
+// NOTE(alicia): reference decoder, deliberately written differently
+// from media_utf8_decode: decode greedily then check ranges.
+static uintptr_t reference_utf8_to_utf32(
+    uintptr_t len, const uint8_t* s, uint32_t* out
+) {
+    uintptr_t count = 0;
+    uintptr_t i     = 0;
+    while( i < len ) {
+        uint8_t b = s[i];
+        uint32_t need = 0;
+        uint32_t cp   = 0;
+        uint32_t min  = 0;
+        if( b < 0x80 ) {
+            out[count++] = b;
+            i++;
+            continue;
+        } else if( (b & 0xE0) == 0xC0 ) {
+            need = 1; cp = b & 0x1F; min = 0x80;
+        } else if( (b & 0xF0) == 0xE0 ) {
+            need = 2; cp = b & 0x0F; min = 0x800;
+        } else if( (b & 0xF8) == 0xF0 ) {
+            need = 3; cp = b & 0x07; min = 0x10000;
+        } else {
+            out[count++] = MEDIA_UNICODE_REPLACEMENT;
+            i++;
+            continue;
+        }
+
+        uint32_t got = 0;
+        while( got < need && i + 1 + got < len && (s[i + 1 + got] & 0xC0) == 0x80 ) {
+            cp = (cp << 6) | (s[i + 1 + got] & 0x3F);
+            got++;
+        }
+        _Bool valid =
+            got == need && cp >= min && cp <= 0x10FFFF &&
+            !(cp >= 0xD800 && cp <= 0xDFFF);
+        if( valid ) {
+            out[count++] = cp;
+            i += 1 + need;
+            continue;
+        }
+
+        // NOTE(alicia): maximal subpart: count continuation bytes that
+        // could still have led to a valid sequence.
+        uint32_t prefix = 1;
+        for( uint32_t k = 0; k < got; ++k ) {
+            uint8_t c = s[i + 1 + k];
+            _Bool ok = true;
+            if( k == 0 ) {
+                ok =
+                    (b >= 0xC2 && b <= 0xDF) ||
+                    (b == 0xE0 && c >= 0xA0) ||
+                    ((b >= 0xE1 && b <= 0xEC) || b == 0xEE || b == 0xEF) ||
+                    (b == 0xED && c <= 0x9F) ||
+                    (b == 0xF0 && c >= 0x90) ||
+                    (b >= 0xF1 && b <= 0xF3) ||
+                    (b == 0xF4 && c <= 0x8F);
+            }
+            if( !ok ) {
+                break;
+            }
+            prefix++;
+        }
+        if( !((b >= 0xC2 && b <= 0xF4)) ) {
+            prefix = 1;
+        }
+        out[count++] = MEDIA_UNICODE_REPLACEMENT;
+        i += prefix;
+    }
+    return count;
+}
+
+static uint32_t random_code_point(void) {
+    switch( rng() % 5 ) {
+        case 0:  return rng() % 0x80;
+        case 1:  return 0x80 + rng() % (0x800 - 0x80);
+        case 2: {
+            uint32_t cp = 0x800 + rng() % (0x10000 - 0x800);
+            return (cp >= 0xD800 && cp <= 0xDFFF) ? 0xE000 : cp;
+        }
+        case 3:  return 0x10000 + rng() % (0x110000 - 0x10000);
+        default: return rng();
+    }
+}
+static uintptr_t random_utf8( uint8_t* out ) {
+    uintptr_t len = 0;
+    uintptr_t target = rng() % (BUFFER_CAP / 4);
+    while( len + 64 < target ) {
+        switch( rng() % 4 ) {
+            case 0: {
+                uint32_t run = rng() % 64;
+                for( uint32_t i = 0; i < run; ++i ) {
+                    out[len++] = ' ' + rng() % 95;
+                }
+            } break;
+            case 1: {
+                out[len++] = (uint8_t)rng();
+            } break;
+            default: {
+                len += media_utf8_encode( random_code_point(), (char*)out + len );
+            } break;
+        }
+    }
+    return len;
+}
+static uintptr_t random_utf16( uint16_t* out ) {
+    uintptr_t len = rng() % (BUFFER_CAP / 4);
+    for( uintptr_t i = 0; i < len; ++i ) {
+        switch( rng() % 4 ) {
+            case 0:  out[i] = 0xD800 + rng() % 0x800; break;
+            case 1:  out[i] = (uint16_t)rng(); break;
+            default: out[i] = ' ' + rng() % 95; break;
+        }
+    }
+    return len;
+}
+
+static uint8_t  utf8[BUFFER_CAP];
+static uint8_t  utf8_b[BUFFER_CAP * 2];
+static uint16_t utf16[BUFFER_CAP];
+static uint16_t utf16_b[BUFFER_CAP];
+static uint32_t utf32[BUFFER_CAP];
+static uint32_t utf32_ref[BUFFER_CAP];
+
+static void fuzz_utf8(void) {
+    uintptr_t len = random_utf8( utf8 );
+
+    uintptr_t ref_len = reference_utf8_to_utf32( len, utf8, utf32_ref );
+    uintptr_t read    = 0;
+    uintptr_t len32   = media_utf8_to_utf32(
+        len, (const char*)utf8, BUFFER_CAP, utf32, &read );
+    expect( read == len, "utf8->utf32 did not consume input" );
+    expect( len32 == ref_len, "utf8->utf32 length %zu != reference %zu",
+        (size_t)len32, (size_t)ref_len );
+    expect( memcmp( utf32, utf32_ref, len32 * 4 ) == 0,
+        "utf8->utf32 does not match reference" );
+
+    _Bool is_valid = true;
+    for( uintptr_t i = 0; i < ref_len; ++i ) {
+        if( utf32_ref[i] == MEDIA_UNICODE_REPLACEMENT ) {
+            is_valid = false;
+        }
+    }
+    if( is_valid ) {
+        expect( media_utf8_validate( len, (const char*)utf8 ),
+            "valid string failed validation" );
+    }
+
+    uintptr_t required = media_utf8_to_utf16( len, (const char*)utf8, 0, 0, 0 );
+    uintptr_t len16 = media_utf8_to_utf16(
+        len, (const char*)utf8, BUFFER_CAP, utf16, &read );
+    expect( required == len16, "utf8->utf16 count %zu != written %zu",
+        (size_t)required, (size_t)len16 );
+    expect( read == len, "utf8->utf16 did not consume input" );
+
+    // NOTE(alicia): sanitized round trip must match utf32 path.
+    uintptr_t len8_a = media_utf16_to_utf8(
+        len16, utf16, sizeof(utf8_b), (char*)utf8_b, &read );
+    expect( read == len16, "utf16->utf8 did not consume input" );
+    expect( media_utf8_validate( len8_a, (const char*)utf8_b ),
+        "utf16->utf8 produced invalid UTF-8" );
+    uintptr_t len32_b = media_utf8_to_utf32(
+        len8_a, (const char*)utf8_b, BUFFER_CAP, utf32_ref, 0 );
+    expect( len32_b == len32, "round trip changed code point count" );
+    expect( memcmp( utf32, utf32_ref, len32 * 4 ) == 0,
+        "round trip changed code points" );
+
+    // NOTE(alicia): truncated output must never split a code point.
+    uintptr_t cap = len16 ? rng() % len16 : 0;
+    uintptr_t partial = media_utf8_to_utf16(
+        len, (const char*)utf8, cap, utf16_b, &read );
+    expect( partial <= cap, "utf8->utf16 wrote past capacity" );
+    expect( memcmp( utf16_b, utf16, partial * 2 ) == 0,
+        "truncated utf8->utf16 differs from full conversion" );
+    if( partial ) {
+        uint16_t last = utf16_b[partial - 1];
+        expect( !(last >= 0xD800 && last <= 0xDBFF), "split surrogate pair" );
+    }
+    uintptr_t rest = media_utf8_to_utf16(
+        len - read, (const char*)utf8 + read, BUFFER_CAP - partial, utf16_b + partial, 0 );
+    expect( partial + rest == len16, "resumed conversion length mismatch" );
+    expect( memcmp( utf16_b, utf16, len16 * 2 ) == 0,
+        "resumed conversion differs from full conversion" );
+}
+static void fuzz_utf16(void) {
+    uintptr_t len = random_utf16( utf16 );
+
+    uintptr_t required = media_utf16_to_utf8( len, utf16, 0, 0, 0 );
+    uintptr_t read = 0;
+    uintptr_t len8 = media_utf16_to_utf8(
+        len, utf16, sizeof(utf8_b), (char*)utf8_b, &read );
+    expect( required == len8, "utf16->utf8 count %zu != written %zu",
+        (size_t)required, (size_t)len8 );
+    expect( read == len, "utf16->utf8 did not consume input" );
+    expect( media_utf8_validate( len8, (const char*)utf8_b ),
+        "utf16->utf8 produced invalid UTF-8" );
+
+    uintptr_t cap = len8 ? rng() % len8 : 0;
+    uintptr_t partial = media_utf16_to_utf8(
+        len, utf16, cap, (char*)utf8, &read );
+    expect( partial <= cap, "utf16->utf8 wrote past capacity" );
+    expect( media_utf8_validate( partial, (const char*)utf8 ),
+        "truncated utf16->utf8 split a code point" );
+    expect( memcmp( utf8, utf8_b, partial ) == 0,
+        "truncated utf16->utf8 differs from full conversion" );
+}
+static void test_known(void) {
+    const char* text = "a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80";
+    uint16_t expected[] = { 'a', 0x00E9, 0x20AC, 0xD83D, 0xDE00 };
+    uint16_t out[8];
+    uintptr_t len = media_utf8_to_utf16( strlen(text), text, 8, out, 0 );
+    expect( len == 5, "known string length %zu", (size_t)len );
+    expect( memcmp( out, expected, sizeof(expected) ) == 0, "known string mismatch" );
+
+    const char* overlong = "\xC0\xAF\xE0\x80\xAF\xED\xA0\x80";
+    expect( !media_utf8_validate( strlen(overlong), overlong ),
+        "overlong/surrogate accepted" );
+}
+
+int main( int argc, char** argv ) {
+    uint32_t iterations = 10000;
+    if( argc > 1 ) {
+        iterations = (uint32_t)strtoul( argv[1], 0, 10 );
+    }
+    if( argc > 2 ) {
+        rng_state = strtoull( argv[2], 0, 10 ) | 1;
+    }
+
+    printf( "unicode: seed %llu, %u iterations\n",
+        (unsigned long long)rng_state, iterations );
+
+    test_known();
+    for( uint32_t i = 0; i < iterations && !failures; ++i ) {
+        fuzz_utf8();
+        fuzz_utf16();
+    }
+
+    return test_report( "unicode" );
+}